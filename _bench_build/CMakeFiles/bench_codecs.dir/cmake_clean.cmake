@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_codecs.dir/benchmarks/bench_codecs.cpp.o"
+  "CMakeFiles/bench_codecs.dir/benchmarks/bench_codecs.cpp.o.d"
+  "bin/bench_codecs"
+  "bin/bench_codecs.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_codecs.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
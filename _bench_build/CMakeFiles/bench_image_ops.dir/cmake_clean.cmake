@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_image_ops.dir/benchmarks/bench_image_ops.cpp.o"
+  "CMakeFiles/bench_image_ops.dir/benchmarks/bench_image_ops.cpp.o.d"
+  "bin/bench_image_ops"
+  "bin/bench_image_ops.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_image_ops.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,39 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/lib/batch_io.cpp" "CMakeFiles/libvanity.dir/src/lib/batch_io.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/batch_io.cpp.o.d"
+  "/root/repo/src/lib/checksum.cpp" "CMakeFiles/libvanity.dir/src/lib/checksum.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/checksum.cpp.o.d"
+  "/root/repo/src/lib/dct.cpp" "CMakeFiles/libvanity.dir/src/lib/dct.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/dct.cpp.o.d"
+  "/root/repo/src/lib/deflate.cpp" "CMakeFiles/libvanity.dir/src/lib/deflate.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/deflate.cpp.o.d"
+  "/root/repo/src/lib/image_buffer.cpp" "CMakeFiles/libvanity.dir/src/lib/image_buffer.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/image_buffer.cpp.o.d"
+  "/root/repo/src/lib/image_io.cpp" "CMakeFiles/libvanity.dir/src/lib/image_io.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/image_io.cpp.o.d"
+  "/root/repo/src/lib/image_ops.cpp" "CMakeFiles/libvanity.dir/src/lib/image_ops.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/image_ops.cpp.o.d"
+  "/root/repo/src/lib/image_sink.cpp" "CMakeFiles/libvanity.dir/src/lib/image_sink.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/image_sink.cpp.o.d"
+  "/root/repo/src/lib/inflate.cpp" "CMakeFiles/libvanity.dir/src/lib/inflate.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/inflate.cpp.o.d"
+  "/root/repo/src/lib/jpeg_border.cpp" "CMakeFiles/libvanity.dir/src/lib/jpeg_border.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/jpeg_border.cpp.o.d"
+  "/root/repo/src/lib/jpeg_common.cpp" "CMakeFiles/libvanity.dir/src/lib/jpeg_common.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/jpeg_common.cpp.o.d"
+  "/root/repo/src/lib/jpeg_reader.cpp" "CMakeFiles/libvanity.dir/src/lib/jpeg_reader.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/jpeg_reader.cpp.o.d"
+  "/root/repo/src/lib/jpeg_writer.cpp" "CMakeFiles/libvanity.dir/src/lib/jpeg_writer.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/jpeg_writer.cpp.o.d"
+  "/root/repo/src/lib/mapped_file.cpp" "CMakeFiles/libvanity.dir/src/lib/mapped_file.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/mapped_file.cpp.o.d"
+  "/root/repo/src/lib/pixel_kernels.cpp" "CMakeFiles/libvanity.dir/src/lib/pixel_kernels.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/pixel_kernels.cpp.o.d"
+  "/root/repo/src/lib/png_reader.cpp" "CMakeFiles/libvanity.dir/src/lib/png_reader.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/png_reader.cpp.o.d"
+  "/root/repo/src/lib/png_writer.cpp" "CMakeFiles/libvanity.dir/src/lib/png_writer.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/png_writer.cpp.o.d"
+  "/root/repo/src/lib/pnm.cpp" "CMakeFiles/libvanity.dir/src/lib/pnm.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/pnm.cpp.o.d"
+  "/root/repo/src/lib/qoi.cpp" "CMakeFiles/libvanity.dir/src/lib/qoi.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/qoi.cpp.o.d"
+  "/root/repo/src/lib/ring_compositor.cpp" "CMakeFiles/libvanity.dir/src/lib/ring_compositor.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/ring_compositor.cpp.o.d"
+  "/root/repo/src/lib/thread_pool.cpp" "CMakeFiles/libvanity.dir/src/lib/thread_pool.cpp.o" "gcc" "CMakeFiles/libvanity.dir/src/lib/thread_pool.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
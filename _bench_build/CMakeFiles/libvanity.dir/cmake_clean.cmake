@@ -0,0 +1,51 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/libvanity.dir/src/lib/batch_io.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/batch_io.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/checksum.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/checksum.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/dct.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/dct.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/deflate.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/deflate.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/image_buffer.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/image_buffer.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/image_io.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/image_io.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/image_ops.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/image_ops.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/image_sink.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/image_sink.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/inflate.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/inflate.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/jpeg_border.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/jpeg_border.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/jpeg_common.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/jpeg_common.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/jpeg_reader.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/jpeg_reader.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/jpeg_writer.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/jpeg_writer.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/mapped_file.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/mapped_file.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/pixel_kernels.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/pixel_kernels.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/png_reader.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/png_reader.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/png_writer.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/png_writer.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/pnm.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/pnm.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/qoi.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/qoi.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/ring_compositor.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/ring_compositor.cpp.o.d"
+  "CMakeFiles/libvanity.dir/src/lib/thread_pool.cpp.o"
+  "CMakeFiles/libvanity.dir/src/lib/thread_pool.cpp.o.d"
+  "lib/libvanity.a"
+  "lib/libvanity.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/libvanity.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
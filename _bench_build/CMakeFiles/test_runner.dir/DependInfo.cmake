@@ -0,0 +1,42 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/cli/border_pipeline.cpp" "CMakeFiles/test_runner.dir/src/cli/border_pipeline.cpp.o" "gcc" "CMakeFiles/test_runner.dir/src/cli/border_pipeline.cpp.o.d"
+  "/root/repo/tests/test_batch_io.cpp" "CMakeFiles/test_runner.dir/tests/test_batch_io.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_batch_io.cpp.o.d"
+  "/root/repo/tests/test_border_pipeline.cpp" "CMakeFiles/test_runner.dir/tests/test_border_pipeline.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_border_pipeline.cpp.o.d"
+  "/root/repo/tests/test_bounded_queue.cpp" "CMakeFiles/test_runner.dir/tests/test_bounded_queue.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_bounded_queue.cpp.o.d"
+  "/root/repo/tests/test_deflate.cpp" "CMakeFiles/test_runner.dir/tests/test_deflate.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_deflate.cpp.o.d"
+  "/root/repo/tests/test_image_buffer.cpp" "CMakeFiles/test_runner.dir/tests/test_image_buffer.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_image_buffer.cpp.o.d"
+  "/root/repo/tests/test_image_io.cpp" "CMakeFiles/test_runner.dir/tests/test_image_io.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_image_io.cpp.o.d"
+  "/root/repo/tests/test_image_ops.cpp" "CMakeFiles/test_runner.dir/tests/test_image_ops.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_image_ops.cpp.o.d"
+  "/root/repo/tests/test_image_sink.cpp" "CMakeFiles/test_runner.dir/tests/test_image_sink.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_image_sink.cpp.o.d"
+  "/root/repo/tests/test_image_view.cpp" "CMakeFiles/test_runner.dir/tests/test_image_view.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_image_view.cpp.o.d"
+  "/root/repo/tests/test_jpeg_border.cpp" "CMakeFiles/test_runner.dir/tests/test_jpeg_border.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_jpeg_border.cpp.o.d"
+  "/root/repo/tests/test_jpeg_reader.cpp" "CMakeFiles/test_runner.dir/tests/test_jpeg_reader.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_jpeg_reader.cpp.o.d"
+  "/root/repo/tests/test_jpeg_writer.cpp" "CMakeFiles/test_runner.dir/tests/test_jpeg_writer.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_jpeg_writer.cpp.o.d"
+  "/root/repo/tests/test_mapped_file.cpp" "CMakeFiles/test_runner.dir/tests/test_mapped_file.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_mapped_file.cpp.o.d"
+  "/root/repo/tests/test_memory_budget.cpp" "CMakeFiles/test_runner.dir/tests/test_memory_budget.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_memory_budget.cpp.o.d"
+  "/root/repo/tests/test_pixel_kernels.cpp" "CMakeFiles/test_runner.dir/tests/test_pixel_kernels.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_pixel_kernels.cpp.o.d"
+  "/root/repo/tests/test_png_reader.cpp" "CMakeFiles/test_runner.dir/tests/test_png_reader.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_png_reader.cpp.o.d"
+  "/root/repo/tests/test_png_writer.cpp" "CMakeFiles/test_runner.dir/tests/test_png_writer.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_png_writer.cpp.o.d"
+  "/root/repo/tests/test_pnm.cpp" "CMakeFiles/test_runner.dir/tests/test_pnm.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_pnm.cpp.o.d"
+  "/root/repo/tests/test_qoi.cpp" "CMakeFiles/test_runner.dir/tests/test_qoi.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_qoi.cpp.o.d"
+  "/root/repo/tests/test_thread_pool.cpp" "CMakeFiles/test_runner.dir/tests/test_thread_pool.cpp.o" "gcc" "CMakeFiles/test_runner.dir/tests/test_thread_pool.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench_build/CMakeFiles/libvanity.dir/DependInfo.cmake"
+  "/root/repo/_bench_build/_deps/googletest-build/googletest/CMakeFiles/gtest_main.dir/DependInfo.cmake"
+  "/root/repo/_bench_build/_deps/googletest-build/googletest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
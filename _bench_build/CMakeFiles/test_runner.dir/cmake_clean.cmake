@@ -0,0 +1,52 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_runner.dir/src/cli/border_pipeline.cpp.o"
+  "CMakeFiles/test_runner.dir/src/cli/border_pipeline.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_batch_io.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_batch_io.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_border_pipeline.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_border_pipeline.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_bounded_queue.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_bounded_queue.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_deflate.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_deflate.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_image_buffer.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_image_buffer.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_image_io.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_image_io.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_image_ops.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_image_ops.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_image_sink.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_image_sink.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_image_view.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_image_view.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_jpeg_border.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_jpeg_border.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_jpeg_reader.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_jpeg_reader.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_jpeg_writer.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_jpeg_writer.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_mapped_file.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_mapped_file.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_memory_budget.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_memory_budget.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_pixel_kernels.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_pixel_kernels.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_png_reader.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_png_reader.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_png_writer.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_png_writer.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_pnm.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_pnm.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_qoi.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_qoi.cpp.o.d"
+  "CMakeFiles/test_runner.dir/tests/test_thread_pool.cpp.o"
+  "CMakeFiles/test_runner.dir/tests/test_thread_pool.cpp.o.d"
+  "bin/test_runner"
+  "bin/test_runner.pdb"
+  "test_runner[1]_tests.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_runner.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
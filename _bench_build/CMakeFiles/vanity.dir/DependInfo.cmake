@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/cli/border_pipeline.cpp" "CMakeFiles/vanity.dir/src/cli/border_pipeline.cpp.o" "gcc" "CMakeFiles/vanity.dir/src/cli/border_pipeline.cpp.o.d"
+  "/root/repo/src/cli/command_registry.cpp" "CMakeFiles/vanity.dir/src/cli/command_registry.cpp.o" "gcc" "CMakeFiles/vanity.dir/src/cli/command_registry.cpp.o.d"
+  "/root/repo/src/cli/commands.cpp" "CMakeFiles/vanity.dir/src/cli/commands.cpp.o" "gcc" "CMakeFiles/vanity.dir/src/cli/commands.cpp.o.d"
+  "/root/repo/src/cli/commands/add_border_command.cpp" "CMakeFiles/vanity.dir/src/cli/commands/add_border_command.cpp.o" "gcc" "CMakeFiles/vanity.dir/src/cli/commands/add_border_command.cpp.o.d"
+  "/root/repo/src/cli/commands/info_command.cpp" "CMakeFiles/vanity.dir/src/cli/commands/info_command.cpp.o" "gcc" "CMakeFiles/vanity.dir/src/cli/commands/info_command.cpp.o.d"
+  "/root/repo/src/cli/image_files.cpp" "CMakeFiles/vanity.dir/src/cli/image_files.cpp.o" "gcc" "CMakeFiles/vanity.dir/src/cli/image_files.cpp.o.d"
+  "/root/repo/src/cli/main.cpp" "CMakeFiles/vanity.dir/src/cli/main.cpp.o" "gcc" "CMakeFiles/vanity.dir/src/cli/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench_build/CMakeFiles/libvanity.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
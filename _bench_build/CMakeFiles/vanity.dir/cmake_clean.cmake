@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/vanity.dir/src/cli/border_pipeline.cpp.o"
+  "CMakeFiles/vanity.dir/src/cli/border_pipeline.cpp.o.d"
+  "CMakeFiles/vanity.dir/src/cli/command_registry.cpp.o"
+  "CMakeFiles/vanity.dir/src/cli/command_registry.cpp.o.d"
+  "CMakeFiles/vanity.dir/src/cli/commands.cpp.o"
+  "CMakeFiles/vanity.dir/src/cli/commands.cpp.o.d"
+  "CMakeFiles/vanity.dir/src/cli/commands/add_border_command.cpp.o"
+  "CMakeFiles/vanity.dir/src/cli/commands/add_border_command.cpp.o.d"
+  "CMakeFiles/vanity.dir/src/cli/commands/info_command.cpp.o"
+  "CMakeFiles/vanity.dir/src/cli/commands/info_command.cpp.o.d"
+  "CMakeFiles/vanity.dir/src/cli/image_files.cpp.o"
+  "CMakeFiles/vanity.dir/src/cli/image_files.cpp.o.d"
+  "CMakeFiles/vanity.dir/src/cli/main.cpp.o"
+  "CMakeFiles/vanity.dir/src/cli/main.cpp.o.d"
+  "bin/vanity"
+  "bin/vanity.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/vanity.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_bench_build/test_runner[1]_tests.cmake")
+  include("/root/repo/_bench_build/test_runner[1]_tests.cmake")
+else()
+  add_test(test_runner_NOT_BUILT test_runner_NOT_BUILT)
+endif()
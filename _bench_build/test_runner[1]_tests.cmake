@@ -0,0 +1,301 @@
+add_test([=[BorderPipelineTest.EstimateCountsInputPaddedFrameAndScratch]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=BorderPipelineTest.EstimateCountsInputPaddedFrameAndScratch]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[BorderPipelineTest.EstimateCountsInputPaddedFrameAndScratch]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[BorderPipelineTest.EstimateDoesNotOverflowInt]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=BorderPipelineTest.EstimateDoesNotOverflowInt]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[BorderPipelineTest.EstimateDoesNotOverflowInt]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[BoundedQueueTest.PopsInFifoOrder]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=BoundedQueueTest.PopsInFifoOrder]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[BoundedQueueTest.PopsInFifoOrder]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[BoundedQueueTest.CloseDrainsThenStops]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=BoundedQueueTest.CloseDrainsThenStops]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[BoundedQueueTest.CloseDrainsThenStops]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[BoundedQueueTest.TryPopDoesNotBlock]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=BoundedQueueTest.TryPopDoesNotBlock]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[BoundedQueueTest.TryPopDoesNotBlock]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[BoundedQueueTest.ZeroCapacityIsTreatedAsOne]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=BoundedQueueTest.ZeroCapacityIsTreatedAsOne]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[BoundedQueueTest.ZeroCapacityIsTreatedAsOne]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[BoundedQueueTest.ProducerBlocksWhileFull]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=BoundedQueueTest.ProducerBlocksWhileFull]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[BoundedQueueTest.ProducerBlocksWhileFull]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ChecksumTest.KnownValues]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ChecksumTest.KnownValues]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ChecksumTest.KnownValues]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ChecksumTest.Adler32SurvivesLongRunsOfHighBytes]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ChecksumTest.Adler32SurvivesLongRunsOfHighBytes]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ChecksumTest.Adler32SurvivesLongRunsOfHighBytes]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ChecksumTest.Adler32CombineMatchesWholeBuffer]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ChecksumTest.Adler32CombineMatchesWholeBuffer]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ChecksumTest.Adler32CombineMatchesWholeBuffer]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[DeflateTest.EveryLevelRoundTrips]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=DeflateTest.EveryLevelRoundTrips]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[DeflateTest.EveryLevelRoundTrips]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[DeflateTest.PiecesMayReferenceEarlierHistory]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=DeflateTest.PiecesMayReferenceEarlierHistory]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[DeflateTest.PiecesMayReferenceEarlierHistory]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[DeflateTest.SyncFlushedPiecesConcatenate]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=DeflateTest.SyncFlushedPiecesConcatenate]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[DeflateTest.SyncFlushedPiecesConcatenate]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[DeflateTest.ZlibHeaderIsValid]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=DeflateTest.ZlibHeaderIsValid]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[DeflateTest.ZlibHeaderIsValid]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageBufferTest.ConstructorAllocatesMemory]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageBufferTest.ConstructorAllocatesMemory]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageBufferTest.ConstructorAllocatesMemory]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageBufferTest.MoveConstructorTransfersOwnership]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageBufferTest.MoveConstructorTransfersOwnership]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageBufferTest.MoveConstructorTransfersOwnership]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageBufferTest.MoveAssignmentTransfersOwnership]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageBufferTest.MoveAssignmentTransfersOwnership]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageBufferTest.MoveAssignmentTransfersOwnership]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageBufferTest.ReleaseTransfersOwnership]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageBufferTest.ReleaseTransfersOwnership]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageBufferTest.ReleaseTransfersOwnership]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[LoadedImageTest.InvalidPathReturnsNull]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=LoadedImageTest.InvalidPathReturnsNull]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[LoadedImageTest.InvalidPathReturnsNull]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[LoadedImageTest.MoveConstructorTransfersOwnership]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=LoadedImageTest.MoveConstructorTransfersOwnership]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[LoadedImageTest.MoveConstructorTransfersOwnership]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[LoadedImageTest.LoadPaddedPlacesPixelsInInterior]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=LoadedImageTest.LoadPaddedPlacesPixelsInInterior]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[LoadedImageTest.LoadPaddedPlacesPixelsInInterior]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[LoadedImageTest.LoadPaddedInvalidPathReturnsNull]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=LoadedImageTest.LoadPaddedInvalidPathReturnsNull]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[LoadedImageTest.LoadPaddedInvalidPathReturnsNull]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[LoadedImageTest.WideLoadsKeepOrWidenSamples]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=LoadedImageTest.WideLoadsKeepOrWidenSamples]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[LoadedImageTest.WideLoadsKeepOrWidenSamples]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.DetectFormatPNG]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.DetectFormatPNG]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.DetectFormatPNG]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.DetectFormatJPG]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.DetectFormatJPG]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.DetectFormatJPG]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.DetectFormatBMP]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.DetectFormatBMP]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.DetectFormatBMP]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.DetectFormatUnknown]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.DetectFormatUnknown]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.DetectFormatUnknown]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.HdrRoundTripsFloatViews]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.HdrRoundTripsFloatViews]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.HdrRoundTripsFloatViews]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.WideViewsOnlyWriteFormatsThatHoldThem]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.WideViewsOnlyWriteFormatsThatHoldThem]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.WideViewsOnlyWriteFormatsThatHoldThem]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.EncodeToMemoryRoundTripsPackedPixels]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.EncodeToMemoryRoundTripsPackedPixels]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.EncodeToMemoryRoundTripsPackedPixels]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.EncodeToMemoryUnknownFormatFails]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.EncodeToMemoryUnknownFormatFails]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.EncodeToMemoryUnknownFormatFails]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.EncodeToMemoryAndDecodeFromMemoryRoundTrip]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.EncodeToMemoryAndDecodeFromMemoryRoundTrip]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.EncodeToMemoryAndDecodeFromMemoryRoundTrip]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.EncodeToMemoryHandlesStridedViews]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.EncodeToMemoryHandlesStridedViews]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.EncodeToMemoryHandlesStridedViews]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.EncodeToMemoryReusesBuffer]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.EncodeToMemoryReusesBuffer]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.EncodeToMemoryReusesBuffer]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOTest.DecodeFromMemoryRejectsGarbage]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOTest.DecodeFromMemoryRejectsGarbage]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOTest.DecodeFromMemoryRejectsGarbage]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOIntegrationTest.WriteImagePNG]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOIntegrationTest.WriteImagePNG]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOIntegrationTest.WriteImagePNG]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOIntegrationTest.WriteImageJPG]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOIntegrationTest.WriteImageJPG]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOIntegrationTest.WriteImageJPG]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOIntegrationTest.WriteImageBMP]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOIntegrationTest.WriteImageBMP]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOIntegrationTest.WriteImageBMP]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOIntegrationTest.WriteImageUnknownFormat]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOIntegrationTest.WriteImageUnknownFormat]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOIntegrationTest.WriteImageUnknownFormat]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOIntegrationTest.ProbeImageReadsHeader]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOIntegrationTest.ProbeImageReadsHeader]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOIntegrationTest.ProbeImageReadsHeader]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageIOIntegrationTest.ProbeImageRejectsMissingAndGarbage]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageIOIntegrationTest.ProbeImageRejectsMissingAndGarbage]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageIOIntegrationTest.ProbeImageRejectsMissingAndGarbage]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.CalculateBorderedDimensions]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.CalculateBorderedDimensions]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.CalculateBorderedDimensions]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.FillBuffer]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.FillBuffer]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.FillBuffer]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.AddBorderCreatesCorrectDimensions]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.AddBorderCreatesCorrectDimensions]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.AddBorderCreatesCorrectDimensions]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.AddBorderWithLargerBorder]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.AddBorderWithLargerBorder]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.AddBorderWithLargerBorder]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.AddBorderRejectsInvalidParams]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.AddBorderRejectsInvalidParams]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.AddBorderRejectsInvalidParams]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.AddBorderWithZeroBorder]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.AddBorderWithZeroBorder]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.AddBorderWithZeroBorder]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.AddBorderMatchesReferenceForAllChannelCounts]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.AddBorderMatchesReferenceForAllChannelCounts]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.AddBorderMatchesReferenceForAllChannelCounts]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.AddBordersMatchesNestedAddBorder]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.AddBordersMatchesNestedAddBorder]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.AddBordersMatchesNestedAddBorder]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.AddBordersRejectsNegativeRing]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.AddBordersRejectsNegativeRing]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.AddBordersRejectsNegativeRing]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.AddBordersWithNoRingsCopiesImage]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.AddBordersWithNoRingsCopiesImage]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.AddBordersWithNoRingsCopiesImage]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.PaintBordersLeavesInteriorUntouched]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.PaintBordersLeavesInteriorUntouched]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.PaintBordersLeavesInteriorUntouched]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.PaintBordersRejectsRingsLargerThanImage]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.PaintBordersRejectsRingsLargerThanImage]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.PaintBordersRejectsRingsLargerThanImage]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.ParallelAddBordersMatchesSerial]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.ParallelAddBordersMatchesSerial]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.ParallelAddBordersMatchesSerial]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.ParallelFillBufferFillsEveryPixel]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.ParallelFillBufferFillsEveryPixel]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.ParallelFillBufferFillsEveryPixel]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.WideSamplesMatchEightBitBorders]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.WideSamplesMatchEightBitBorders]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.WideSamplesMatchEightBitBorders]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.WideFillBufferWidensColor]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.WideFillBufferWidensColor]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.WideFillBufferWidensColor]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageOpsTest.SpecializedKernelsMatchRuntimeSizeKernel]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageOpsTest.SpecializedKernelsMatchRuntimeSizeKernel]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageOpsTest.SpecializedKernelsMatchRuntimeSizeKernel]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageSinkTest.MemorySinkAppends]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageSinkTest.MemorySinkAppends]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageSinkTest.MemorySinkAppends]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageSinkTest.FileSinkCoalescesSmallAndPassesLargeWrites]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageSinkTest.FileSinkCoalescesSmallAndPassesLargeWrites]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageSinkTest.FileSinkCoalescesSmallAndPassesLargeWrites]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageSinkTest.FileSinkFailsForUnwritablePath]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageSinkTest.FileSinkFailsForUnwritablePath]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageSinkTest.FileSinkFailsForUnwritablePath]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageSinkTest.FdSinkWritesToPipeWithoutClosingIt]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageSinkTest.FdSinkWritesToPipeWithoutClosingIt]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageSinkTest.FdSinkWritesToPipeWithoutClosingIt]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageSinkTest.CallbackSinkStopsAfterFailure]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageSinkTest.CallbackSinkStopsAfterFailure]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageSinkTest.CallbackSinkStopsAfterFailure]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageSinkTest.WriteImageToSinkMatchesEncodeToMemory]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageSinkTest.WriteImageToSinkMatchesEncodeToMemory]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageSinkTest.WriteImageToSinkMatchesEncodeToMemory]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageSinkTest.WriteImageReportsSinkFailure]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageSinkTest.WriteImageReportsSinkFailure]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageSinkTest.WriteImageReportsSinkFailure]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageViewTest.PackedConstructorComputesStride]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageViewTest.PackedConstructorComputesStride]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageViewTest.PackedConstructorComputesStride]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageViewTest.WideSamplesKeepByteStrides]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageViewTest.WideSamplesKeepByteStrides]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageViewTest.WideSamplesKeepByteStrides]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageViewTest.DefaultViewIsEmpty]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageViewTest.DefaultViewIsEmpty]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageViewTest.DefaultViewIsEmpty]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageViewTest.SubviewSharesStride]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageViewTest.SubviewSharesStride]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageViewTest.SubviewSharesStride]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageViewTest.BuffersExposeViews]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageViewTest.BuffersExposeViews]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageViewTest.BuffersExposeViews]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageViewTest.FillBufferRespectsStride]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageViewTest.FillBufferRespectsStride]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageViewTest.FillBufferRespectsStride]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageViewTest.AddBorderFromSubviewIntoSubview]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageViewTest.AddBorderFromSubviewIntoSubview]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageViewTest.AddBorderFromSubviewIntoSubview]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ImageViewTest.AddBordersRejectsMismatchedViews]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ImageViewTest.AddBordersRejectsMismatchedViews]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ImageViewTest.AddBordersRejectsMismatchedViews]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegBorderTest.CoefficientsRoundTripUnchanged]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegBorderTest.CoefficientsRoundTripUnchanged]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegBorderTest.CoefficientsRoundTripUnchanged]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegBorderTest.InteriorIsLossless]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegBorderTest.InteriorIsLossless]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegBorderTest.InteriorIsLossless]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegBorderTest.SubsampledAndGrayscale]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegBorderTest.SubsampledAndGrayscale]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegBorderTest.SubsampledAndGrayscale]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegBorderTest.RejectsUnalignedInputs]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegBorderTest.RejectsUnalignedInputs]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegBorderTest.RejectsUnalignedInputs]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegBorderTest.ParallelMatchesSingleThreaded]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegBorderTest.ParallelMatchesSingleThreaded]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegBorderTest.ParallelMatchesSingleThreaded]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegReaderTest.InverseKernelsMatchReference]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegReaderTest.InverseKernelsMatchReference]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegReaderTest.InverseKernelsMatchReference]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegReaderTest.ColorKernelsAgree]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegReaderTest.ColorKernelsAgree]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegReaderTest.ColorKernelsAgree]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegReaderTest.MatchesStbDecode]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegReaderTest.MatchesStbDecode]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegReaderTest.MatchesStbDecode]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegReaderTest.RestartIntervalsDecode]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegReaderTest.RestartIntervalsDecode]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegReaderTest.RestartIntervalsDecode]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegReaderTest.RestartSegmentsDecodeInParallel]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegReaderTest.RestartSegmentsDecodeInParallel]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegReaderTest.RestartSegmentsDecodeInParallel]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegReaderTest.ScaledDecodeApproximatesBoxFilter]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegReaderTest.ScaledDecodeApproximatesBoxFilter]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegReaderTest.ScaledDecodeApproximatesBoxFilter]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegReaderTest.ParallelMatchesSingleThreaded]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegReaderTest.ParallelMatchesSingleThreaded]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegReaderTest.ParallelMatchesSingleThreaded]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegReaderTest.ProgressiveMatchesBaseline]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegReaderTest.ProgressiveMatchesBaseline]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegReaderTest.ProgressiveMatchesBaseline]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegWriterTest.DctKernelsMatchReference]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegWriterTest.DctKernelsMatchReference]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegWriterTest.DctKernelsMatchReference]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegWriterTest.ChannelCountsAndSubsamplingDecode]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegWriterTest.ChannelCountsAndSubsamplingDecode]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegWriterTest.ChannelCountsAndSubsamplingDecode]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegWriterTest.LargeImagesUseRestartIntervals]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegWriterTest.LargeImagesUseRestartIntervals]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegWriterTest.LargeImagesUseRestartIntervals]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegWriterTest.ParallelEncodeMatchesSingleThreaded]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegWriterTest.ParallelEncodeMatchesSingleThreaded]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegWriterTest.ParallelEncodeMatchesSingleThreaded]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[JpegWriterTest.StridedViewMatchesPacked]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=JpegWriterTest.StridedViewMatchesPacked]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[JpegWriterTest.StridedViewMatchesPacked]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MappedFileTest.MissingFileFails]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=MappedFileTest.MissingFileFails]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MappedFileTest.MissingFileFails]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MappedFileTest.RegularFileIsMapped]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=MappedFileTest.RegularFileIsMapped]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MappedFileTest.RegularFileIsMapped]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MappedFileTest.EmptyFileIsReadable]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=MappedFileTest.EmptyFileIsReadable]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MappedFileTest.EmptyFileIsReadable]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MappedFileTest.FifoFallsBackToBufferedReads]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=MappedFileTest.FifoFallsBackToBufferedReads]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MappedFileTest.FifoFallsBackToBufferedReads]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MemoryBudgetTest.UnlimitedNeverBlocks]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=MemoryBudgetTest.UnlimitedNeverBlocks]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MemoryBudgetTest.UnlimitedNeverBlocks]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MemoryBudgetTest.OversizedRequestRunsAlone]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=MemoryBudgetTest.OversizedRequestRunsAlone]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MemoryBudgetTest.OversizedRequestRunsAlone]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MemoryBudgetTest.TryAcquireFailsWhenFull]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=MemoryBudgetTest.TryAcquireFailsWhenFull]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MemoryBudgetTest.TryAcquireFailsWhenFull]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[MemoryBudgetTest.AcquireWaitsForRelease]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=MemoryBudgetTest.AcquireWaitsForRelease]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[MemoryBudgetTest.AcquireWaitsForRelease]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PixelKernelsTest.ScalarIsAlwaysAvailable]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PixelKernelsTest.ScalarIsAlwaysAvailable]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PixelKernelsTest.ScalarIsAlwaysAvailable]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PixelKernelsTest.FillPatternMatchesReference]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PixelKernelsTest.FillPatternMatchesReference]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PixelKernelsTest.FillPatternMatchesReference]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PixelKernelsTest.CopyRowMatchesSource]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PixelKernelsTest.CopyRowMatchesSource]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PixelKernelsTest.CopyRowMatchesSource]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PixelKernelsTest.SwapBytes16MatchesReference]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PixelKernelsTest.SwapBytes16MatchesReference]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PixelKernelsTest.SwapBytes16MatchesReference]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngReaderTest.UnfilterKernelsMatchScalar]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngReaderTest.UnfilterKernelsMatchScalar]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngReaderTest.UnfilterKernelsMatchScalar]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngReaderTest.InflatesLongCodes]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngReaderTest.InflatesLongCodes]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngReaderTest.InflatesLongCodes]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngReaderTest.DecodesZlibStreams]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngReaderTest.DecodesZlibStreams]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngReaderTest.DecodesZlibStreams]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngReaderTest.RoundTripsEveryLevelAndFilter]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngReaderTest.RoundTripsEveryLevelAndFilter]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngReaderTest.RoundTripsEveryLevelAndFilter]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngReaderTest.RejectsCorruptData]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngReaderTest.RejectsCorruptData]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngReaderTest.RejectsCorruptData]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngReaderTest.LeavesOtherVariantsToStb]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngReaderTest.LeavesOtherVariantsToStb]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngReaderTest.LeavesOtherVariantsToStb]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngWriterTest.FiltersInvertExactly]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngWriterTest.FiltersInvertExactly]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngWriterTest.FiltersInvertExactly]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngWriterTest.EveryLevelAndFilterDecodes]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngWriterTest.EveryLevelAndFilterDecodes]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngWriterTest.EveryLevelAndFilterDecodes]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngWriterTest.LargeImageSpansSeveralBlocksAndChunks]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngWriterTest.LargeImageSpansSeveralBlocksAndChunks]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngWriterTest.LargeImageSpansSeveralBlocksAndChunks]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngWriterTest.LowerLevelsTradeSizeForSpeed]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngWriterTest.LowerLevelsTradeSizeForSpeed]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngWriterTest.LowerLevelsTradeSizeForSpeed]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngWriterTest.StridedViewMatchesPacked]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngWriterTest.StridedViewMatchesPacked]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngWriterTest.StridedViewMatchesPacked]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngWriterTest.ParallelEncodeMatchesSingleThreaded]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngWriterTest.ParallelEncodeMatchesSingleThreaded]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngWriterTest.ParallelEncodeMatchesSingleThreaded]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngWriterTest.SixteenBitRoundTripsEveryFilter]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngWriterTest.SixteenBitRoundTripsEveryFilter]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngWriterTest.SixteenBitRoundTripsEveryFilter]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PngWriterTest.SixteenBitParallelEncodeMatchesSingleThreaded]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PngWriterTest.SixteenBitParallelEncodeMatchesSingleThreaded]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PngWriterTest.SixteenBitParallelEncodeMatchesSingleThreaded]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.DetectFormat]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.DetectFormat]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.DetectFormat]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.PamRoundTripsEveryChannelCount]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.PamRoundTripsEveryChannelCount]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.PamRoundTripsEveryChannelCount]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.PpmDropsAlpha]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.PpmDropsAlpha]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.PpmDropsAlpha]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.StridedViewIsWrittenRowByRow]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.StridedViewIsWrittenRowByRow]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.StridedViewIsWrittenRowByRow]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.ParsesCommentsAndRescalesMaxval]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.ParsesCommentsAndRescalesMaxval]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.ParsesCommentsAndRescalesMaxval]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.RejectsTruncatedAndMalformedInput]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.RejectsTruncatedAndMalformedInput]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.RejectsTruncatedAndMalformedInput]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.LoadsPamPaddedAndProbes]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.LoadsPamPaddedAndProbes]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.LoadsPamPaddedAndProbes]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.ProbesHeadersLongerThanTheFirstRead]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.ProbesHeadersLongerThanTheFirstRead]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.ProbesHeadersLongerThanTheFirstRead]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.SixteenBitRoundTripsThroughPamAndPpm]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.SixteenBitRoundTripsThroughPamAndPpm]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.SixteenBitRoundTripsThroughPamAndPpm]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[PnmTest.SixteenBitLoadRescalesShallowerSamples]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=PnmTest.SixteenBitLoadRescalesShallowerSamples]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[PnmTest.SixteenBitLoadRescalesShallowerSamples]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[QoiTest.RoundTripsRgbAndRgba]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=QoiTest.RoundTripsRgbAndRgba]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[QoiTest.RoundTripsRgbAndRgba]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[QoiTest.LongRunsSpanRowsAndRunLimit]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=QoiTest.LongRunsSpanRowsAndRunLimit]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[QoiTest.LongRunsSpanRowsAndRunLimit]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[QoiTest.GrayIsWidenedToRgb]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=QoiTest.GrayIsWidenedToRgb]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[QoiTest.GrayIsWidenedToRgb]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[QoiTest.StridedViewMatchesPacked]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=QoiTest.StridedViewMatchesPacked]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[QoiTest.StridedViewMatchesPacked]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[QoiTest.RejectsTruncatedAndCorruptStreams]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=QoiTest.RejectsTruncatedAndCorruptStreams]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[QoiTest.RejectsTruncatedAndCorruptStreams]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[QoiTest.LoadsPaddedThroughLoadedImage]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=QoiTest.LoadsPaddedThroughLoadedImage]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[QoiTest.LoadsPaddedThroughLoadedImage]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[QoiTest.WritesAndProbesQoiFiles]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=QoiTest.WritesAndProbesQoiFiles]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[QoiTest.WritesAndProbesQoiFiles]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ThreadPoolTest.DefaultSizeIsAtLeastOne]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ThreadPoolTest.DefaultSizeIsAtLeastOne]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ThreadPoolTest.DefaultSizeIsAtLeastOne]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ThreadPoolTest.DestructorRunsQueuedTasks]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ThreadPoolTest.DestructorRunsQueuedTasks]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ThreadPoolTest.DestructorRunsQueuedTasks]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ThreadPoolTest.ParallelForCoversEveryIndexOnce]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ThreadPoolTest.ParallelForCoversEveryIndexOnce]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ThreadPoolTest.ParallelForCoversEveryIndexOnce]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ThreadPoolTest.ParallelForHandlesEmptyAndSingleChunk]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ThreadPoolTest.ParallelForHandlesEmptyAndSingleChunk]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ThreadPoolTest.ParallelForHandlesEmptyAndSingleChunk]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ThreadPoolTest.NestedParallelForDoesNotDeadlock]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ThreadPoolTest.NestedParallelForDoesNotDeadlock]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ThreadPoolTest.NestedParallelForDoesNotDeadlock]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ThreadPoolTest.IdleWorkersStealTasksQueuedByABusyWorker]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=ThreadPoolTest.IdleWorkersStealTasksQueuedByABusyWorker]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ThreadPoolTest.IdleWorkersStealTasksQueuedByABusyWorker]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.WriteThenReadRoundTrips/Best  # GetParam() = true]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.WriteThenReadRoundTrips/Best]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.WriteThenReadRoundTrips/Best  # GetParam() = true]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.WriteThenReadRoundTrips/Pread  # GetParam() = false]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.WriteThenReadRoundTrips/Pread]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.WriteThenReadRoundTrips/Pread  # GetParam() = false]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.WriteTruncatesExistingFile/Best  # GetParam() = true]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.WriteTruncatesExistingFile/Best]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.WriteTruncatesExistingFile/Best  # GetParam() = true]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.WriteTruncatesExistingFile/Pread  # GetParam() = false]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.WriteTruncatesExistingFile/Pread]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.WriteTruncatesExistingFile/Pread  # GetParam() = false]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.MissingFileFailsAlone/Best  # GetParam() = true]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.MissingFileFailsAlone/Best]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.MissingFileFailsAlone/Best  # GetParam() = true]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.MissingFileFailsAlone/Pread  # GetParam() = false]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.MissingFileFailsAlone/Pread]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.MissingFileFailsAlone/Pread  # GetParam() = false]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.EmptyFileIsReadable/Best  # GetParam() = true]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.EmptyFileIsReadable/Best]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.EmptyFileIsReadable/Best  # GetParam() = true]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.EmptyFileIsReadable/Pread  # GetParam() = false]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.EmptyFileIsReadable/Pread]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.EmptyFileIsReadable/Pread  # GetParam() = false]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.WriteToMissingDirectoryFails/Best  # GetParam() = true]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.WriteToMissingDirectoryFails/Best]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.WriteToMissingDirectoryFails/Best  # GetParam() = true]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Backends/BatchFileIOTest.WriteToMissingDirectoryFails/Pread  # GetParam() = false]=]  /root/repo/_bench_build/bin/test_runner [==[--gtest_filter=Backends/BatchFileIOTest.WriteToMissingDirectoryFails/Pread]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Backends/BatchFileIOTest.WriteToMissingDirectoryFails/Pread  # GetParam() = false]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_bench_build SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  test_runner_TESTS BorderPipelineTest.EstimateCountsInputPaddedFrameAndScratch BorderPipelineTest.EstimateDoesNotOverflowInt BoundedQueueTest.PopsInFifoOrder BoundedQueueTest.CloseDrainsThenStops BoundedQueueTest.TryPopDoesNotBlock BoundedQueueTest.ZeroCapacityIsTreatedAsOne BoundedQueueTest.ProducerBlocksWhileFull ChecksumTest.KnownValues ChecksumTest.Adler32SurvivesLongRunsOfHighBytes ChecksumTest.Adler32CombineMatchesWholeBuffer DeflateTest.EveryLevelRoundTrips DeflateTest.PiecesMayReferenceEarlierHistory DeflateTest.SyncFlushedPiecesConcatenate DeflateTest.ZlibHeaderIsValid ImageBufferTest.ConstructorAllocatesMemory ImageBufferTest.MoveConstructorTransfersOwnership ImageBufferTest.MoveAssignmentTransfersOwnership ImageBufferTest.ReleaseTransfersOwnership LoadedImageTest.InvalidPathReturnsNull LoadedImageTest.MoveConstructorTransfersOwnership LoadedImageTest.LoadPaddedPlacesPixelsInInterior LoadedImageTest.LoadPaddedInvalidPathReturnsNull LoadedImageTest.WideLoadsKeepOrWidenSamples ImageIOTest.DetectFormatPNG ImageIOTest.DetectFormatJPG ImageIOTest.DetectFormatBMP ImageIOTest.DetectFormatUnknown ImageIOTest.HdrRoundTripsFloatViews ImageIOTest.WideViewsOnlyWriteFormatsThatHoldThem ImageIOTest.EncodeToMemoryRoundTripsPackedPixels ImageIOTest.EncodeToMemoryUnknownFormatFails ImageIOTest.EncodeToMemoryAndDecodeFromMemoryRoundTrip ImageIOTest.EncodeToMemoryHandlesStridedViews ImageIOTest.EncodeToMemoryReusesBuffer ImageIOTest.DecodeFromMemoryRejectsGarbage ImageIOIntegrationTest.WriteImagePNG ImageIOIntegrationTest.WriteImageJPG ImageIOIntegrationTest.WriteImageBMP ImageIOIntegrationTest.WriteImageUnknownFormat ImageIOIntegrationTest.ProbeImageReadsHeader ImageIOIntegrationTest.ProbeImageRejectsMissingAndGarbage ImageOpsTest.CalculateBorderedDimensions ImageOpsTest.FillBuffer ImageOpsTest.AddBorderCreatesCorrectDimensions ImageOpsTest.AddBorderWithLargerBorder ImageOpsTest.AddBorderRejectsInvalidParams ImageOpsTest.AddBorderWithZeroBorder ImageOpsTest.AddBorderMatchesReferenceForAllChannelCounts ImageOpsTest.AddBordersMatchesNestedAddBorder ImageOpsTest.AddBordersRejectsNegativeRing ImageOpsTest.AddBordersWithNoRingsCopiesImage ImageOpsTest.PaintBordersLeavesInteriorUntouched ImageOpsTest.PaintBordersRejectsRingsLargerThanImage ImageOpsTest.ParallelAddBordersMatchesSerial ImageOpsTest.ParallelFillBufferFillsEveryPixel ImageOpsTest.WideSamplesMatchEightBitBorders ImageOpsTest.WideFillBufferWidensColor ImageOpsTest.SpecializedKernelsMatchRuntimeSizeKernel ImageSinkTest.MemorySinkAppends ImageSinkTest.FileSinkCoalescesSmallAndPassesLargeWrites ImageSinkTest.FileSinkFailsForUnwritablePath ImageSinkTest.FdSinkWritesToPipeWithoutClosingIt ImageSinkTest.CallbackSinkStopsAfterFailure ImageSinkTest.WriteImageToSinkMatchesEncodeToMemory ImageSinkTest.WriteImageReportsSinkFailure ImageViewTest.PackedConstructorComputesStride ImageViewTest.WideSamplesKeepByteStrides ImageViewTest.DefaultViewIsEmpty ImageViewTest.SubviewSharesStride ImageViewTest.BuffersExposeViews ImageViewTest.FillBufferRespectsStride ImageViewTest.AddBorderFromSubviewIntoSubview ImageViewTest.AddBordersRejectsMismatchedViews JpegBorderTest.CoefficientsRoundTripUnchanged JpegBorderTest.InteriorIsLossless JpegBorderTest.SubsampledAndGrayscale JpegBorderTest.RejectsUnalignedInputs JpegBorderTest.ParallelMatchesSingleThreaded JpegReaderTest.InverseKernelsMatchReference JpegReaderTest.ColorKernelsAgree JpegReaderTest.MatchesStbDecode JpegReaderTest.RestartIntervalsDecode JpegReaderTest.RestartSegmentsDecodeInParallel JpegReaderTest.ScaledDecodeApproximatesBoxFilter JpegReaderTest.ParallelMatchesSingleThreaded JpegReaderTest.ProgressiveMatchesBaseline JpegWriterTest.DctKernelsMatchReference JpegWriterTest.ChannelCountsAndSubsamplingDecode JpegWriterTest.LargeImagesUseRestartIntervals JpegWriterTest.ParallelEncodeMatchesSingleThreaded JpegWriterTest.StridedViewMatchesPacked MappedFileTest.MissingFileFails MappedFileTest.RegularFileIsMapped MappedFileTest.EmptyFileIsReadable MappedFileTest.FifoFallsBackToBufferedReads MemoryBudgetTest.UnlimitedNeverBlocks MemoryBudgetTest.OversizedRequestRunsAlone MemoryBudgetTest.TryAcquireFailsWhenFull MemoryBudgetTest.AcquireWaitsForRelease PixelKernelsTest.ScalarIsAlwaysAvailable PixelKernelsTest.FillPatternMatchesReference PixelKernelsTest.CopyRowMatchesSource PixelKernelsTest.SwapBytes16MatchesReference PngReaderTest.UnfilterKernelsMatchScalar PngReaderTest.InflatesLongCodes PngReaderTest.DecodesZlibStreams PngReaderTest.RoundTripsEveryLevelAndFilter PngReaderTest.RejectsCorruptData PngReaderTest.LeavesOtherVariantsToStb PngWriterTest.FiltersInvertExactly PngWriterTest.EveryLevelAndFilterDecodes PngWriterTest.LargeImageSpansSeveralBlocksAndChunks PngWriterTest.LowerLevelsTradeSizeForSpeed PngWriterTest.StridedViewMatchesPacked PngWriterTest.ParallelEncodeMatchesSingleThreaded PngWriterTest.SixteenBitRoundTripsEveryFilter PngWriterTest.SixteenBitParallelEncodeMatchesSingleThreaded PnmTest.DetectFormat PnmTest.PamRoundTripsEveryChannelCount PnmTest.PpmDropsAlpha PnmTest.StridedViewIsWrittenRowByRow PnmTest.ParsesCommentsAndRescalesMaxval PnmTest.RejectsTruncatedAndMalformedInput PnmTest.LoadsPamPaddedAndProbes PnmTest.ProbesHeadersLongerThanTheFirstRead PnmTest.SixteenBitRoundTripsThroughPamAndPpm PnmTest.SixteenBitLoadRescalesShallowerSamples QoiTest.RoundTripsRgbAndRgba QoiTest.LongRunsSpanRowsAndRunLimit QoiTest.GrayIsWidenedToRgb QoiTest.StridedViewMatchesPacked QoiTest.RejectsTruncatedAndCorruptStreams QoiTest.LoadsPaddedThroughLoadedImage QoiTest.WritesAndProbesQoiFiles ThreadPoolTest.DefaultSizeIsAtLeastOne ThreadPoolTest.DestructorRunsQueuedTasks ThreadPoolTest.ParallelForCoversEveryIndexOnce ThreadPoolTest.ParallelForHandlesEmptyAndSingleChunk ThreadPoolTest.NestedParallelForDoesNotDeadlock ThreadPoolTest.IdleWorkersStealTasksQueuedByABusyWorker [==[Backends/BatchFileIOTest.WriteThenReadRoundTrips/Best  # GetParam() = true]==] [==[Backends/BatchFileIOTest.WriteThenReadRoundTrips/Pread  # GetParam() = false]==] [==[Backends/BatchFileIOTest.WriteTruncatesExistingFile/Best  # GetParam() = true]==] [==[Backends/BatchFileIOTest.WriteTruncatesExistingFile/Pread  # GetParam() = false]==] [==[Backends/BatchFileIOTest.MissingFileFailsAlone/Best  # GetParam() = true]==] [==[Backends/BatchFileIOTest.MissingFileFailsAlone/Pread  # GetParam() = false]==] [==[Backends/BatchFileIOTest.EmptyFileIsReadable/Best  # GetParam() = true]==] [==[Backends/BatchFileIOTest.EmptyFileIsReadable/Pread  # GetParam() = false]==] [==[Backends/BatchFileIOTest.WriteToMissingDirectoryFails/Best  # GetParam() = true]==] [==[Backends/BatchFileIOTest.WriteToMissingDirectoryFails/Pread  # GetParam() = false]==])
@@ -0,0 +1,127 @@
+// Encode and decode throughput of each output format on a synthetic
+// photo-like image (smooth gradients with sensor-style noise).
+//
+//   ./build/bin/bench_codecs [width] [height] [min_seconds_per_case]
+
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/thread_pool.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace vanity;
+
+namespace {
+
+// Average seconds per call, repeating until at least min_seconds have elapsed
+template <typename Fn>
+double time_call(Fn&& fn, double min_seconds) {
+    using clock = std::chrono::steady_clock;
+    long iterations = 0;
+    auto start = clock::now();
+    double elapsed = 0;
+    do {
+        fn();
+        iterations++;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < min_seconds);
+    return elapsed / iterations;
+}
+
+ImageBuffer photo_like(int width, int height, int channels) {
+    ImageBuffer image(width, height, channels);
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 2.5f);
+    unsigned char* p = image.get();
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            for (int c = 0; c < channels; c++) {
+                float base = 128.0f + 90.0f * ((x * (c + 1) + y * 2) % 512 - 256) / 256.0f;
+                float value = c == 3 ? 255.0f : base + noise(rng);
+                *p++ = static_cast<unsigned char>(value < 0 ? 0 : value > 255 ? 255 : value);
+            }
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int width = argc > 1 ? std::atoi(argv[1]) : 1920;
+    int height = argc > 2 ? std::atoi(argv[2]) : 1080;
+    double min_seconds = argc > 3 ? std::atof(argv[3]) : 0.5;
+
+    // PNG is listed at several compression levels (png is the default, 6),
+    // and PNG and JPEG also with row ranges encoded (and JPEG decoded)
+    // across all cores (-mt)
+    struct Format {
+        const char* label;
+        ImageFormat format;
+        int png_compression;
+        bool threaded;
+    };
+    const Format formats[] = {
+        {"png-0", ImageFormat::PNG, 0, false},
+        {"png-1", ImageFormat::PNG, 1, false},
+        {"png-3", ImageFormat::PNG, 3, false},
+        {"png", ImageFormat::PNG, 6, false},
+        {"png-9", ImageFormat::PNG, 9, false},
+        {"png-mt", ImageFormat::PNG, 6, true},
+        {"jpg", ImageFormat::JPG, 6, false},
+        {"jpg-mt", ImageFormat::JPG, 6, true},
+        {"bmp", ImageFormat::BMP, 6, false},
+        {"qoi", ImageFormat::QOI, 6, false},
+    };
+    ThreadPool pool;
+
+    std::printf("%dx%d\n\n", width, height);
+    std::printf("%-6s %3s %12s %12s %12s %12s\n", "format", "ch", "size (KiB)", "encode (ms)", "decode (ms)", "enc MB/s");
+
+    for (int channels : {3, 4}) {
+        ImageBuffer image = photo_like(width, height, channels);
+        double megabytes = image.byte_size() / 1e6;
+        for (const Format& f : formats) {
+            WriteOptions options;
+            options.png_compression = f.png_compression;
+            options.exec.pool = f.threaded ? &pool : nullptr;
+            DecodeOptions decode_options;
+            decode_options.exec = options.exec;
+            std::vector<std::byte> encoded;
+            double encode = time_call([&] { encode_to_memory(image.view(), f.format, options, encoded); },
+                                      min_seconds);
+            double decode = time_call([&] { decode_from_memory(encoded, decode_options); }, min_seconds);
+            std::printf("%-6s %3d %12.1f %12.2f %12.2f %12.1f\n", f.label, channels, encoded.size() / 1024.0,
+                        encode * 1e3, decode * 1e3, megabytes / encode);
+        }
+    }
+
+    // JPEG decoded at a fraction of its size straight from the coefficients
+    ImageBuffer image = photo_like(width, height, 3);
+    std::vector<std::byte> jpeg = encode_to_memory(image.view(), ImageFormat::JPG);
+    std::printf("\n%-6s %12s %12s\n", "scale", "output", "decode (ms)");
+    for (int scale : {1, 2, 4, 8}) {
+        DecodeOptions options;
+        options.scale_denom = scale;
+        LoadedImage decoded = decode_from_memory(jpeg, options);
+        double decode = time_call([&] { decode_from_memory(jpeg, options); }, min_seconds);
+        std::printf("1/%-4d %5dx%-6d %12.2f\n", scale, decoded.width(), decoded.height(), decode * 1e3);
+    }
+
+    // In-tree PNG and JPEG decoders against stb_image on the same files
+    std::printf("\n%-6s %12s %12s\n", "format", "in-tree (ms)", "stb (ms)");
+    for (ImageFormat format : {ImageFormat::PNG, ImageFormat::JPG}) {
+        std::vector<std::byte> encoded = encode_to_memory(image.view(), format);
+        DecodeOptions stb;
+        stb.use_stb = true;
+        double ours = time_call([&] { decode_from_memory(encoded); }, min_seconds);
+        double reference = time_call([&] { decode_from_memory(encoded, stb); }, min_seconds);
+        std::printf("%-6s %12.2f %12.2f\n", format == ImageFormat::PNG ? "png" : "jpg", ours * 1e3,
+                    reference * 1e3);
+    }
+
+    return 0;
+}
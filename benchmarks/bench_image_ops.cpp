@@ -0,0 +1,108 @@
+// Compares the channel-specialized ring compositor against the
+// runtime-channel kernel on the add_border test shapes and on large images,
+// then the output throughput of 8-bit, 16-bit and float images, which share
+// the same byte kernels.
+//
+//   ./build/bin/bench_image_ops [min_seconds_per_case]
+
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_ops.hpp"
+#include "../src/lib/pixel_kernels.hpp"
+#include "../src/lib/ring_compositor.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace vanity;
+
+namespace {
+
+struct Shape {
+    const char* label;
+    int width;
+    int height;
+    std::vector<BorderSpec> rings;
+};
+
+// Average seconds per call, repeating until at least min_seconds have elapsed
+template <typename T>
+double time_compose(const BasicImageView<T>& src, const BasicMutableImageView<T>& dst,
+                    const std::vector<BorderSpec>& rings, bool specialize, double min_seconds) {
+    using clock = std::chrono::steady_clock;
+    long iterations = 0;
+    auto start = clock::now();
+    double elapsed = 0;
+    do {
+        detail::compose_rings(src, dst, rings, 0, dst.height(), specialize);
+        iterations++;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < min_seconds);
+    return elapsed / iterations;
+}
+
+// GB/s of bordered output for one sample type
+template <typename T>
+double output_rate(const Shape& shape, int channels, double min_seconds) {
+    BasicImageBuffer<T> src(shape.width, shape.height, channels);
+    const unsigned char gray[4] = {128, 128, 128, 128};
+    fill_buffer(src.view(), gray);
+
+    int out_w, out_h;
+    calculate_bordered_dimensions(shape.width, shape.height, shape.rings, out_w, out_h);
+    BasicImageBuffer<T> dst(out_w, out_h, channels);
+    double seconds = time_compose<T>(src.view(), dst.view(), shape.rings, true, min_seconds);
+    return dst.byte_size() / seconds / 1e9;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double min_seconds = argc > 1 ? std::atof(argv[1]) : 0.2;
+
+    const BorderSpec white{0, {255, 255, 255, 255}};
+    auto ring = [](int width, BorderSpec spec) {
+        spec.width = width;
+        return spec;
+    };
+    const BorderSpec black{0, {0, 0, 0, 255}};
+
+    std::vector<Shape> shapes = {
+        {"2x2 +1 (test shape)", 2, 2, {ring(1, white)}},
+        {"1x1 +3 (test shape)", 1, 1, {ring(3, black)}},
+        {"7x5 +4 (test shape)", 7, 5, {ring(4, white)}},
+        {"1920x1080 +40", 1920, 1080, {ring(40, white)}},
+        {"6000x4000 +10+100 (inner)", 6000, 4000, {ring(10, black), ring(100, white)}},
+    };
+
+    std::printf("kernels: %s\n\n", detail::pixel_kernels().name);
+    std::printf("%-28s %3s %14s %14s %8s\n", "shape", "ch", "runtime (us)", "special (us)", "speedup");
+
+    for (const Shape& shape : shapes) {
+        for (int channels = 1; channels <= 4; channels++) {
+            ImageBuffer src(shape.width, shape.height, channels);
+            fill_buffer(src.get(), src.byte_size(), 128);
+
+            int out_w, out_h;
+            calculate_bordered_dimensions(shape.width, shape.height, shape.rings, out_w, out_h);
+            ImageBuffer dst(out_w, out_h, channels);
+
+            double generic = time_compose<unsigned char>(src.view(), dst.view(), shape.rings, false, min_seconds);
+            double special = time_compose<unsigned char>(src.view(), dst.view(), shape.rings, true, min_seconds);
+            std::printf("%-28s %3d %14.3f %14.3f %7.2fx\n", shape.label, channels,
+                        generic * 1e6, special * 1e6, generic / special);
+        }
+    }
+
+    std::printf("\n%-28s %3s %12s %12s %12s\n", "shape (output GB/s)", "ch", "u8", "u16", "f32");
+    for (size_t i = shapes.size() - 2; i < shapes.size(); i++) {
+        for (int channels : {3, 4}) {
+            std::printf("%-28s %3d %12.2f %12.2f %12.2f\n", shapes[i].label, channels,
+                        output_rate<unsigned char>(shapes[i], channels, min_seconds),
+                        output_rate<uint16_t>(shapes[i], channels, min_seconds),
+                        output_rate<float>(shapes[i], channels, min_seconds));
+        }
+    }
+
+    return 0;
+}
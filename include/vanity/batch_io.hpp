@@ -0,0 +1,51 @@
+#ifndef VANITY_BATCH_IO_HPP
+#define VANITY_BATCH_IO_HPP
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vanity {
+
+// Contents of one file read by BatchFileIO
+struct FileReadResult {
+    std::vector<unsigned char> bytes;
+    bool ok = false;
+};
+
+// One file to create (or truncate) and fill
+struct FileWriteRequest {
+    std::string path;
+    std::span<const unsigned char> bytes;
+};
+
+// Reads and writes whole files in batches
+// The io_uring backend submits the opens, size queries, reads/writes and
+// closes of a whole batch together, so a batch costs a handful of syscalls
+// rather than several per file. The fallback backend uses plain
+// open/pread/pwrite/close. Instances are not thread-safe; use one per thread.
+class BatchFileIO {
+public:
+    virtual ~BatchFileIO() = default;
+
+    // Read every file completely; out[i] corresponds to paths[i]
+    virtual void read_files(std::span<const std::string> paths, std::vector<FileReadResult>& out) = 0;
+
+    // Write every request; ok[i] reports whether requests[i] was fully written
+    virtual void write_files(std::span<const FileWriteRequest> requests, std::vector<bool>& ok) = 0;
+
+    // Backend name ("io_uring" or "pread")
+    virtual const char* name() const = 0;
+
+    // Best backend the kernel supports (override with VANITY_IO=pread)
+    // queue_depth: io_uring submission queue size
+    static std::unique_ptr<BatchFileIO> create(unsigned queue_depth = 64);
+
+    // Plain blocking backend, always available
+    static std::unique_ptr<BatchFileIO> create_fallback();
+};
+
+} // namespace vanity
+
+#endif // VANITY_BATCH_IO_HPP
@@ -1,87 +1,165 @@
 #ifndef VANITY_IMAGE_BUFFER_HPP
 #define VANITY_IMAGE_BUFFER_HPP
 
+#include "vanity/image_ops.hpp"
+#include "vanity/image_view.hpp"
 #include <cstddef>
+#include <cstdint>
 
 namespace vanity {
 
 // RAII wrapper for allocated image buffers (using new[]/delete[])
-class ImageBuffer {
+// T is the sample type; see ImageBuffer, ImageBuffer16 and ImageBufferF.
+template <typename T>
+class BasicImageBuffer {
 public:
     // Constructor: allocates buffer
-    ImageBuffer(int width, int height, int channels);
+    BasicImageBuffer(int width, int height, int channels);
 
     // Destructor: automatically frees buffer
-    ~ImageBuffer();
+    ~BasicImageBuffer();
 
     // Move constructor: transfer ownership
-    ImageBuffer(ImageBuffer&& other) noexcept;
+    BasicImageBuffer(BasicImageBuffer&& other) noexcept;
 
     // Move assignment: transfer ownership
-    ImageBuffer& operator=(ImageBuffer&& other) noexcept;
+    BasicImageBuffer& operator=(BasicImageBuffer&& other) noexcept;
 
     // Delete copy constructor and assignment (prevent double-free)
-    ImageBuffer(const ImageBuffer&) = delete;
-    ImageBuffer& operator=(const ImageBuffer&) = delete;
+    BasicImageBuffer(const BasicImageBuffer&) = delete;
+    BasicImageBuffer& operator=(const BasicImageBuffer&) = delete;
 
     // Accessors
-    unsigned char* get() { return data_; }
-    const unsigned char* get() const { return data_; }
+    T* get() { return data_; }
+    const T* get() const { return data_; }
     int width() const { return width_; }
     int height() const { return height_; }
     int channels() const { return channels_; }
-    size_t byte_size() const { return static_cast<size_t>(width_) * height_ * channels_; }
+    size_t byte_size() const { return static_cast<size_t>(width_) * height_ * channels_ * sizeof(T); }
+    BasicMutableImageView<T> view() { return BasicMutableImageView<T>(data_, width_, height_, channels_); }
+    BasicImageView<T> view() const { return BasicImageView<T>(data_, width_, height_, channels_); }
 
     // Release ownership (caller becomes responsible for delete[])
-    unsigned char* release();
+    T* release();
 
 private:
-    unsigned char* data_;
+    T* data_;
     int width_;
     int height_;
     int channels_;
 };
 
+using ImageBuffer = BasicImageBuffer<unsigned char>;
+using ImageBuffer16 = BasicImageBuffer<uint16_t>;
+using ImageBufferF = BasicImageBuffer<float>;
+
+extern template class BasicImageBuffer<unsigned char>;
+extern template class BasicImageBuffer<uint16_t>;
+extern template class BasicImageBuffer<float>;
+
+// Extra pixels to reserve around a decoded image
+struct Padding {
+    int top = 0;
+    int left = 0;
+    int right = 0;
+    int bottom = 0;
+};
+
+// Decoder settings for the LoadedImage factories
+struct DecodeOptions {
+    // Decode JPEGs at 1/scale_denom of their size (1, 2, 4 or 8, rounding
+    // up) straight from their DCT coefficients, far cheaper than a full
+    // decode followed by a resize. Other formats, the JPEGs left to stb
+    // (CMYK, arithmetic-coded) and 16-bit or float loads always decode at
+    // full size.
+    int scale_denom = 1;
+
+    // Pool for JPEG reconstruction and colour conversion in row bands
+    ExecutionOptions exec = {};
+
+    // Decode PNGs and JPEGs with stb_image instead of the in-tree decoders
+    // (SIMD PNG unfiltering and table-driven inflate; SIMD JPEG IDCT).
+    // Files the in-tree decoders do not handle always go to stb.
+    bool use_stb = false;
+};
+
 // RAII wrapper for stb-loaded images (using stbi_image_free)
-class LoadedImage {
+// LoadedImage holds 8-bit samples. LoadedImage16 keeps the full precision of
+// 16-bit PNG and netpbm files (stbi_load_16; 8-bit files are widened with
+// c * 257), and LoadedImageF holds float samples (stbi_loadf: HDR files as
+// stored, 8-bit files linearized as stb does). QOI and PAM, which stb cannot
+// read, are decoded in-tree and widened the same way.
+template <typename T>
+class BasicLoadedImage {
 public:
     // Factory method: loads image from file
-    static LoadedImage load(const char* path, int& width, int& height, int& channels);
+    static BasicLoadedImage load(const char* path, int& width, int& height, int& channels);
+    static BasicLoadedImage load(const char* path, const DecodeOptions& options, int& width, int& height,
+                                 int& channels);
+
+    // Factory method: loads image from file into the interior of a larger buffer
+    // The decoded allocation is grown in place and its rows moved to their
+    // padded positions, so no second full-frame buffer is ever allocated.
+    // width/height receive the padded dimensions; padding pixels are left
+    // uninitialized for the caller to paint (see paint_borders).
+    static BasicLoadedImage load_padded(const char* path, const Padding& padding,
+                                        int& width, int& height, int& channels);
+    static BasicLoadedImage load_padded(const char* path, const Padding& padding, const DecodeOptions& options,
+                                        int& width, int& height, int& channels);
+
+    // Factory methods: decode an encoded image already held in memory
+    static BasicLoadedImage load_from_memory(const unsigned char* data, size_t size,
+                                             int& width, int& height, int& channels);
+    static BasicLoadedImage load_padded_from_memory(const unsigned char* data, size_t size, const Padding& padding,
+                                                    int& width, int& height, int& channels);
+    static BasicLoadedImage load_padded_from_memory(const unsigned char* data, size_t size, const Padding& padding,
+                                                    const DecodeOptions& options, int& width, int& height,
+                                                    int& channels);
 
     // Constructor: takes ownership of stb-loaded data
-    LoadedImage(unsigned char* data, int width, int height, int channels);
+    BasicLoadedImage(T* data, int width, int height, int channels);
 
     // Destructor: automatically frees buffer with stbi_image_free
-    ~LoadedImage();
+    ~BasicLoadedImage();
 
     // Move constructor: transfer ownership
-    LoadedImage(LoadedImage&& other) noexcept;
+    BasicLoadedImage(BasicLoadedImage&& other) noexcept;
 
     // Move assignment: transfer ownership
-    LoadedImage& operator=(LoadedImage&& other) noexcept;
+    BasicLoadedImage& operator=(BasicLoadedImage&& other) noexcept;
 
     // Delete copy constructor and assignment (prevent double-free)
-    LoadedImage(const LoadedImage&) = delete;
-    LoadedImage& operator=(const LoadedImage&) = delete;
+    BasicLoadedImage(const BasicLoadedImage&) = delete;
+    BasicLoadedImage& operator=(const BasicLoadedImage&) = delete;
 
     // Accessors
-    unsigned char* get() { return data_; }
-    const unsigned char* get() const { return data_; }
+    T* get() { return data_; }
+    const T* get() const { return data_; }
     int width() const { return width_; }
     int height() const { return height_; }
     int channels() const { return channels_; }
-    size_t byte_size() const { return static_cast<size_t>(width_) * height_ * channels_; }
+    size_t byte_size() const { return static_cast<size_t>(width_) * height_ * channels_ * sizeof(T); }
+    BasicMutableImageView<T> view() { return BasicMutableImageView<T>(data_, width_, height_, channels_); }
+    BasicImageView<T> view() const { return BasicImageView<T>(data_, width_, height_, channels_); }
 
     // Release ownership (caller becomes responsible for stbi_image_free)
-    unsigned char* release();
+    T* release();
 
 private:
-    unsigned char* data_;
+    T* data_;
     int width_;
     int height_;
     int channels_;
 };
 
+using LoadedImage = BasicLoadedImage<unsigned char>;
+using LoadedImage16 = BasicLoadedImage<uint16_t>;
+using LoadedImageF = BasicLoadedImage<float>;
+
+extern template class BasicLoadedImage<unsigned char>;
+extern template class BasicLoadedImage<uint16_t>;
+extern template class BasicLoadedImage<float>;
+
 } // namespace vanity
 
 #endif // VANITY_IMAGE_BUFFER_HPP
@@ -1,18 +1,76 @@
 #ifndef VANITY_IMAGE_IO_HPP
 #define VANITY_IMAGE_IO_HPP
 
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_ops.hpp"
+#include "vanity/image_view.hpp"
+#include <cstddef>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace vanity {
 
+class ImageSink;
+
 // Supported image output formats
 enum class ImageFormat {
     PNG,
     JPG,
     BMP,
+    QOI,
+    PPM,    // binary PGM/PPM (P5/P6), no alpha
+    PAM,    // binary PAM (P7), 1-4 channels
+    HDR,    // Radiance RGBE, float images only
     UNKNOWN
 };
 
+// PNG row filter; Adaptive picks the best-looking filter per row
+enum class PngFilter {
+    Adaptive,
+    None,
+    Sub,
+    Up,
+    Average,
+    Paeth
+};
+
+// Per-call encoder settings
+struct WriteOptions {
+    // JPEG quality (0-100), ignored for other formats
+    int quality = 95;
+
+    // PNG deflate level, 0-9: 0 stores rows uncompressed, 1 only encodes
+    // runs of repeated bytes, 2-9 search progressively harder for matches
+    int png_compression = 6;
+
+    // PNG row filter (with png_compression 0, Adaptive means None)
+    PngFilter png_filter = PngFilter::Adaptive;
+
+    // Pool for filtering and compressing PNG row ranges in parallel; the
+    // output is byte-identical to a single-threaded encode
+    ExecutionOptions exec = {};
+};
+
+// Header fields of an encoded image, read without decoding its pixels
+struct ImageInfo {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    int bits_per_channel = 0;   // 8, 16, or 32 for HDR (float) images
+    bool is_hdr = false;
+    size_t file_size = 0;
+};
+
+// Frame of a JPEG that add_borders_jpeg can border without decoding it
+struct JpegBlockLayout {
+    int width = 0;
+    int height = 0;
+    int channels = 0;       // 1 (grayscale) or 3
+    int mcu_width = 0;      // 8 or 16 pixels for common chroma subsampling
+    int mcu_height = 0;
+};
+
 // Detect image format from file extension
 ImageFormat detect_format(const std::string& path);
 
@@ -21,6 +79,79 @@ ImageFormat detect_format(const std::string& path);
 bool write_image(const char* path, int width, int height, int channels,
                  const unsigned char* data, int quality = 95);
 
+// Encode image into a sink (file, file descriptor, memory or callback)
+// quality: JPEG quality (0-100), ignored for PNG/BMP
+bool write_image(ImageSink& sink, ImageFormat format, int width, int height, int channels,
+                 const unsigned char* data, int quality = 95);
+
+// Encode a (possibly strided) view into a sink
+bool write_image(ImageSink& sink, const ImageView& image, ImageFormat format,
+                 const WriteOptions& options = {});
+
+// Encode a (possibly strided) view into memory
+// Returns the encoded bytes, or an empty vector on failure
+std::vector<std::byte> encode_to_memory(const ImageView& image, ImageFormat format,
+                                        const WriteOptions& options = {});
+
+// Encode into a caller-supplied buffer, replacing its contents but reusing
+// its capacity so a long-lived buffer stops allocating after warm-up
+bool encode_to_memory(const ImageView& image, ImageFormat format, const WriteOptions& options,
+                      std::vector<std::byte>& out);
+
+// True if the format can store 16-bit samples (PNG, PPM and PAM)
+bool supports_16_bit(ImageFormat format);
+
+// Encode a 16-bit view as a 16-bit PNG, PPM or PAM (MAXVAL 65535); other
+// formats fail rather than silently dropping precision
+bool write_image(ImageSink& sink, const ImageView16& image, ImageFormat format,
+                 const WriteOptions& options = {});
+
+// Encode a float view as Radiance HDR; other formats fail
+bool write_image(ImageSink& sink, const ImageViewF& image, ImageFormat format,
+                 const WriteOptions& options = {});
+
+// In-memory counterparts of the 16-bit and float writers
+std::vector<std::byte> encode_to_memory(const ImageView16& image, ImageFormat format,
+                                        const WriteOptions& options = {});
+std::vector<std::byte> encode_to_memory(const ImageViewF& image, ImageFormat format,
+                                        const WriteOptions& options = {});
+bool encode_to_memory(const ImageView16& image, ImageFormat format, const WriteOptions& options,
+                      std::vector<std::byte>& out);
+bool encode_to_memory(const ImageViewF& image, ImageFormat format, const WriteOptions& options,
+                      std::vector<std::byte>& out);
+
+// Decode an encoded image (QOI, PAM or any format stb can read) held in memory
+// (LoadedImage::load_from_memory for byte spans, as produced by encode_to_memory)
+// Returns an image whose get() is nullptr on failure (see stbi_failure_reason)
+LoadedImage decode_from_memory(std::span<const std::byte> bytes);
+
+// Same, decoding JPEGs at a reduced scale or in parallel (see DecodeOptions)
+LoadedImage decode_from_memory(std::span<const std::byte> bytes, const DecodeOptions& options);
+
+// Read an image file's dimensions, channel count and bit depth from its
+// header only (QOI, PAM or any format stb can read)
+// Returns false if the file cannot be opened or its header is not recognized
+bool probe_image(const char* path, ImageInfo& out);
+
+// Same, for an encoded image held in memory (file_size is its length)
+bool probe_image(std::span<const std::byte> bytes, ImageInfo& out);
+
+// Check whether a JPEG can be bordered losslessly: it must be a sequential
+// Huffman-coded grayscale or three-component JPEG whose dimensions are whole
+// MCUs, so that the border does not expose the encoder's edge padding
+bool probe_jpeg_blocks(std::span<const std::byte> jpeg, JpegBlockLayout& out);
+
+// Add concentric borders to a JPEG without decoding it to pixels: the
+// interior keeps the input's coefficients and quantization tables exactly
+// (no generation loss), and only the border blocks and the entropy coding
+// are new. The total ring width must be a multiple of mcu_width and
+// mcu_height from probe_jpeg_blocks.
+// Returns false if the input is not eligible, the rings are not aligned, a
+// coefficient lies outside the baseline range the standard Huffman tables
+// can code (nothing is written then), or the sink fails
+bool add_borders_jpeg(std::span<const std::byte> jpeg, std::span<const BorderSpec> rings, ImageSink& sink,
+                      const ExecutionOptions& exec = {});
+
 } // namespace vanity
 
 #endif // VANITY_IMAGE_IO_HPP
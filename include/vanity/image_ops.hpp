@@ -1,17 +1,44 @@
 #ifndef VANITY_IMAGE_OPS_HPP
 #define VANITY_IMAGE_OPS_HPP
 
+#include "vanity/image_view.hpp"
 #include <cstddef>
+#include <span>
 
 namespace vanity {
 
+class ThreadPool;
+
+// How an operation may spread its work across threads
+struct ExecutionOptions {
+    // Pool used to process the destination in row bands (nullptr = single-threaded)
+    ThreadPool* pool = nullptr;
+
+    // Destinations smaller than this many bytes stay on the calling thread
+    size_t parallel_threshold = size_t(8) << 20;
+};
+
+// One concentric border ring: width in pixels and RGBA color (only uses channels needed)
+struct BorderSpec {
+    int width;
+    unsigned char color[4];
+};
+
 // Calculate dimensions for bordered image
 void calculate_bordered_dimensions(int src_width, int src_height, int border_width,
                                    int& out_width, int& out_height);
 
+// Calculate dimensions for an image surrounded by all of the given rings
+void calculate_bordered_dimensions(int src_width, int src_height, std::span<const BorderSpec> rings,
+                                   int& out_width, int& out_height);
+
 // Fill buffer with a single value
 void fill_buffer(unsigned char* buffer, size_t size, unsigned char value);
 
+// Fill every pixel of a view with an RGBA color (only uses channels needed)
+void fill_buffer(const MutableImageView& dst, const unsigned char color[4],
+                 const ExecutionOptions& exec = {});
+
 // Add border around image
 // src: source image buffer
 // src_width, src_height, channels: source image dimensions
@@ -22,6 +49,62 @@ void fill_buffer(unsigned char* buffer, size_t size, unsigned char value);
 bool add_border(const unsigned char* src, int src_width, int src_height, int channels,
                 unsigned char* dst, int border_width, const unsigned char border_color[4]);
 
+// Add border around image
+// dst: must be exactly border_width larger than src on every side, with the
+//      same channel count; either view may have padded rows
+// Returns: true on success, false on invalid parameters
+bool add_border(const ImageView& src, const MutableImageView& dst,
+                int border_width, const unsigned char border_color[4],
+                const ExecutionOptions& exec = {});
+
+// Add several concentric borders around image in a single pass
+// rings: ordered innermost first; each ring surrounds the previous one
+// dst: destination buffer (must be pre-allocated to the size given by
+//      calculate_bordered_dimensions for the same rings)
+// Returns: true on success, false on invalid parameters
+bool add_borders(const unsigned char* src, int src_width, int src_height, int channels,
+                 unsigned char* dst, std::span<const BorderSpec> rings);
+
+// Add several concentric borders around image in a single pass
+// dst: must match calculate_bordered_dimensions for the same rings
+// Returns: true on success, false on invalid parameters
+bool add_borders(const ImageView& src, const MutableImageView& dst,
+                 std::span<const BorderSpec> rings, const ExecutionOptions& exec = {});
+
+// Paint concentric borders in place around an image whose pixels already sit
+// in the interior of a larger buffer (e.g. from LoadedImage::load_padded)
+// image, width, height: the full bordered buffer and its dimensions
+// rings: ordered innermost first; interior pixels are left untouched
+// Returns: true on success, false on invalid parameters
+bool paint_borders(unsigned char* image, int width, int height, int channels,
+                   std::span<const BorderSpec> rings);
+
+// Paint concentric borders in place around the interior of a view
+bool paint_borders(const MutableImageView& image, std::span<const BorderSpec> rings,
+                   const ExecutionOptions& exec = {});
+
+// 16-bit and float images: the same operations on wider samples, sharing the
+// 8-bit vector kernels. Colors stay 8-bit RGBA and are widened to full scale
+// (c * 257 for 16-bit samples, c / 255 for float); 1-4 channels.
+void fill_buffer(const MutableImageView16& dst, const unsigned char color[4],
+                 const ExecutionOptions& exec = {});
+void fill_buffer(const MutableImageViewF& dst, const unsigned char color[4],
+                 const ExecutionOptions& exec = {});
+bool add_border(const ImageView16& src, const MutableImageView16& dst,
+                int border_width, const unsigned char border_color[4],
+                const ExecutionOptions& exec = {});
+bool add_border(const ImageViewF& src, const MutableImageViewF& dst,
+                int border_width, const unsigned char border_color[4],
+                const ExecutionOptions& exec = {});
+bool add_borders(const ImageView16& src, const MutableImageView16& dst,
+                 std::span<const BorderSpec> rings, const ExecutionOptions& exec = {});
+bool add_borders(const ImageViewF& src, const MutableImageViewF& dst,
+                 std::span<const BorderSpec> rings, const ExecutionOptions& exec = {});
+bool paint_borders(const MutableImageView16& image, std::span<const BorderSpec> rings,
+                   const ExecutionOptions& exec = {});
+bool paint_borders(const MutableImageViewF& image, std::span<const BorderSpec> rings,
+                   const ExecutionOptions& exec = {});
+
 } // namespace vanity
 
 #endif // VANITY_IMAGE_OPS_HPP
@@ -0,0 +1,110 @@
+#ifndef VANITY_IMAGE_SINK_HPP
+#define VANITY_IMAGE_SINK_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace vanity {
+
+// Destination for encoded image bytes
+// Encoders append with write() and call flush() once the image is complete.
+// Errors are sticky: after a failed write every later call returns false.
+class ImageSink {
+public:
+    virtual ~ImageSink() = default;
+
+    // Append bytes; returns false on error
+    virtual bool write(const void* data, size_t size) = 0;
+
+    // Push any buffered bytes to their destination; returns false on error
+    virtual bool flush() { return true; }
+};
+
+// Appends to a caller-owned vector of unsigned char or std::byte (whose
+// capacity is reused across images)
+template <typename Byte>
+class MemorySink : public ImageSink {
+    static_assert(sizeof(Byte) == 1, "MemorySink appends raw bytes");
+
+public:
+    explicit MemorySink(std::vector<Byte>& out) : out_(out) {}
+
+    bool write(const void* data, size_t size) override {
+        const auto* bytes = static_cast<const Byte*>(data);
+        out_.insert(out_.end(), bytes, bytes + size);
+        return true;
+    }
+
+private:
+    std::vector<Byte>& out_;
+};
+
+// Buffered writes to an already-open file descriptor (pipe, socket, file)
+// The descriptor is not closed by the sink.
+class FdSink : public ImageSink {
+public:
+    // buffer_size: bytes collected before each write(2); the buffer is page aligned
+    explicit FdSink(int fd, size_t buffer_size = size_t(1) << 20);
+    ~FdSink() override;
+
+    FdSink(const FdSink&) = delete;
+    FdSink& operator=(const FdSink&) = delete;
+
+    bool write(const void* data, size_t size) override;
+    bool flush() override;
+
+    int fd() const { return fd_; }
+
+protected:
+    bool write_through(const unsigned char* data, size_t size);
+
+    int fd_;
+    unsigned char* buffer_ = nullptr;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    bool failed_ = false;
+};
+
+// Buffered writes to a file that the sink creates (or replaces) and owns
+// The bytes go to a temporary file beside path that close() renames over it,
+// so a failed or abandoned encode never leaves path empty or truncated: a
+// sink destroyed without close() removes its temporary file. Paths that
+// exist but are not regular files (devices, FIFOs, symlinks) are written
+// in place.
+class FileSink : public FdSink {
+public:
+    // Opens path for writing; check ok() for failure
+    // buffer_size: bytes per write(2), tune upwards for network filesystems
+    explicit FileSink(const char* path, size_t buffer_size = size_t(4) << 20);
+    ~FileSink() override;
+
+    bool ok() const { return fd_ >= 0 && !failed_; }
+
+    // Flush, close and move the file into place; returns false if anything
+    // failed, leaving path as it was
+    bool close();
+
+private:
+    std::string path_;
+    std::string temp_path_;   // empty when path is written in place
+};
+
+// Forwards every write to a user callback (return false from it to abort)
+class CallbackSink : public ImageSink {
+public:
+    using Callback = std::function<bool(const void* data, size_t size)>;
+
+    explicit CallbackSink(Callback callback) : callback_(std::move(callback)) {}
+
+    bool write(const void* data, size_t size) override;
+
+private:
+    Callback callback_;
+    bool failed_ = false;
+};
+
+} // namespace vanity
+
+#endif // VANITY_IMAGE_SINK_HPP
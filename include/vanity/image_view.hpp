@@ -0,0 +1,117 @@
+#ifndef VANITY_IMAGE_VIEW_HPP
+#define VANITY_IMAGE_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vanity {
+
+// Non-owning view of interleaved pixels with an explicit row stride
+// Rows may be padded (stride > width * channels), which lets a view describe
+// a sub-rectangle of a larger image or an aligned buffer without copying.
+// T is the sample type (unsigned char, uint16_t or float); the stride is
+// always in bytes.
+template <typename T>
+class BasicImageView {
+public:
+    using Sample = T;
+
+    BasicImageView() = default;
+
+    // Tightly packed rows
+    BasicImageView(const T* data, int width, int height, int channels)
+        : BasicImageView(data, width, height, channels, static_cast<size_t>(width) * channels * sizeof(T)) {}
+
+    // Rows separated by `stride` bytes
+    BasicImageView(const T* data, int width, int height, int channels, size_t stride)
+        : data_(data), width_(width), height_(height), channels_(channels), stride_(stride) {}
+
+    // Accessors
+    const T* data() const { return data_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int channels() const { return channels_; }
+    size_t stride() const { return stride_; }
+    size_t row_bytes() const { return static_cast<size_t>(width_) * channels_ * sizeof(T); }
+    bool empty() const { return !data_ || width_ <= 0 || height_ <= 0 || channels_ <= 0; }
+    bool is_contiguous() const { return stride_ == row_bytes(); }
+
+    const T* row(int y) const {
+        return reinterpret_cast<const T*>(reinterpret_cast<const unsigned char*>(data_) + y * stride_);
+    }
+    const T* pixel(int x, int y) const { return row(y) + static_cast<size_t>(x) * channels_; }
+
+    // View of the w x h rectangle whose top-left pixel is (x, y); no bounds checking
+    BasicImageView subview(int x, int y, int w, int h) const {
+        return BasicImageView(pixel(x, y), w, h, channels_, stride_);
+    }
+
+private:
+    const T* data_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    int channels_ = 0;
+    size_t stride_ = 0;
+};
+
+// Writable counterpart of BasicImageView
+template <typename T>
+class BasicMutableImageView {
+public:
+    using Sample = T;
+
+    BasicMutableImageView() = default;
+
+    // Tightly packed rows
+    BasicMutableImageView(T* data, int width, int height, int channels)
+        : BasicMutableImageView(data, width, height, channels,
+                                static_cast<size_t>(width) * channels * sizeof(T)) {}
+
+    // Rows separated by `stride` bytes
+    BasicMutableImageView(T* data, int width, int height, int channels, size_t stride)
+        : data_(data), width_(width), height_(height), channels_(channels), stride_(stride) {}
+
+    // Accessors
+    T* data() const { return data_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int channels() const { return channels_; }
+    size_t stride() const { return stride_; }
+    size_t row_bytes() const { return static_cast<size_t>(width_) * channels_ * sizeof(T); }
+    bool empty() const { return !data_ || width_ <= 0 || height_ <= 0 || channels_ <= 0; }
+    bool is_contiguous() const { return stride_ == row_bytes(); }
+
+    T* row(int y) const { return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(data_) + y * stride_); }
+    T* pixel(int x, int y) const { return row(y) + static_cast<size_t>(x) * channels_; }
+
+    // View of the w x h rectangle whose top-left pixel is (x, y); no bounds checking
+    BasicMutableImageView subview(int x, int y, int w, int h) const {
+        return BasicMutableImageView(pixel(x, y), w, h, channels_, stride_);
+    }
+
+    // Read-only view of the same pixels
+    operator BasicImageView<T>() const { return BasicImageView<T>(data_, width_, height_, channels_, stride_); }
+
+private:
+    T* data_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    int channels_ = 0;
+    size_t stride_ = 0;
+};
+
+// 8-bit samples, the common case
+using ImageView = BasicImageView<unsigned char>;
+using MutableImageView = BasicMutableImageView<unsigned char>;
+
+// 16-bit samples (full range 0-65535, native byte order)
+using ImageView16 = BasicImageView<uint16_t>;
+using MutableImageView16 = BasicMutableImageView<uint16_t>;
+
+// 32-bit float samples (HDR; 1.0 is the 8-bit 255)
+using ImageViewF = BasicImageView<float>;
+using MutableImageViewF = BasicMutableImageView<float>;
+
+} // namespace vanity
+
+#endif // VANITY_IMAGE_VIEW_HPP
@@ -0,0 +1,68 @@
+#ifndef VANITY_MEMORY_BUDGET_HPP
+#define VANITY_MEMORY_BUDGET_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace vanity {
+
+// Counting limit on bytes held by concurrently running jobs
+// acquire() blocks until the request fits under the limit. A request larger
+// than the whole budget is admitted once nothing else is held, so a single
+// oversized job runs alone instead of deadlocking.
+class MemoryBudget {
+public:
+    // limit: total bytes that may be held at once (0 = unlimited)
+    explicit MemoryBudget(size_t limit) : limit_(limit) {}
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    // Block until `bytes` can be held, then reserve them
+    void acquire(size_t bytes) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return fits(bytes); });
+        in_use_ += bytes;
+    }
+
+    // Reserve `bytes` if they fit right now; returns false instead of blocking
+    bool try_acquire(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!fits(bytes)) {
+            return false;
+        }
+        in_use_ += bytes;
+        return true;
+    }
+
+    // Return bytes previously reserved with acquire()
+    void release(size_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_use_ -= bytes < in_use_ ? bytes : in_use_;
+        }
+        cv_.notify_all();
+    }
+
+    size_t limit() const { return limit_; }
+
+    size_t in_use() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return in_use_;
+    }
+
+private:
+    bool fits(size_t bytes) const {
+        return limit_ == 0 || in_use_ == 0 || in_use_ + bytes <= limit_;
+    }
+
+    size_t limit_;
+    size_t in_use_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+} // namespace vanity
+
+#endif // VANITY_MEMORY_BUDGET_HPP
@@ -0,0 +1,65 @@
+#ifndef VANITY_THREAD_POOL_HPP
+#define VANITY_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vanity {
+
+// Fixed-size work-stealing pool of worker threads
+// Each worker owns a task deque. Tasks submitted from a worker go to the
+// back of its own deque and are taken LIFO (cache-warm, depth-first);
+// tasks submitted from outside are spread round-robin. Idle workers steal
+// from the front of other workers' deques.
+class ThreadPool {
+public:
+    // Constructor: starts `threads` workers (0 means hardware concurrency)
+    explicit ThreadPool(unsigned threads = 0);
+
+    // Destructor: finishes queued tasks, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of worker threads
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Queue a task for execution on a worker
+    void submit(std::function<void()> task);
+
+    // Call fn(begin, end) for consecutive ranges of at most `grain` items
+    // covering [0, count), spread across the workers and the calling thread.
+    // Blocks until every range has been processed. Safe to call from a task
+    // running on this pool.
+    void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void worker_loop(size_t index);
+    bool try_pop(size_t index, std::function<void()>& task);
+    bool try_steal(size_t thief, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> next_queue_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stopping_ = false;
+};
+
+} // namespace vanity
+
+#endif // VANITY_THREAD_POOL_HPP
@@ -0,0 +1,346 @@
+#include "border_pipeline.hpp"
+#include "vanity/batch_io.hpp"
+#include "vanity/bounded_queue.hpp"
+#include "vanity/memory_budget.hpp"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/image_sink.hpp"
+#include "stb_image.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+namespace vanity {
+
+namespace {
+
+// State of one image as it moves through the stages
+struct PipelineItem {
+    const BorderTask* task = nullptr;
+    std::vector<unsigned char> file_bytes;
+    LoadedImage image{nullptr, 0, 0, 0};
+    LoadedImage16 image16{nullptr, 0, 0, 0};    // used instead for 16-bit inputs to 16-bit formats
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> encoded;
+    bool encoded_losslessly = false;
+    std::ostringstream log;
+    std::string error;
+    size_t reserved_bytes = 0;
+};
+
+using ItemPtr = std::unique_ptr<PipelineItem>;
+using ItemQueue = BoundedQueue<ItemPtr>;
+
+// Start `threads` workers that call fn(item) on everything popped from `in`
+// and forward it to `out`; `out` is closed once the last worker has finished.
+// Items that already carry an error are forwarded untouched.
+template <typename Fn>
+void start_stage(std::vector<std::thread>& threads_out, unsigned threads,
+                 ItemQueue& in, ItemQueue& out, Fn fn) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    auto remaining = std::make_shared<std::atomic<unsigned>>(threads);
+    for (unsigned i = 0; i < threads; i++) {
+        threads_out.emplace_back([&in, &out, fn, remaining] {
+            while (std::optional<ItemPtr> item = in.pop()) {
+                if ((*item)->error.empty()) {
+                    fn(**item);
+                }
+                out.push(std::move(*item));
+            }
+            if (remaining->fetch_sub(1) == 1) {
+                out.close();
+            }
+        });
+    }
+}
+
+} // namespace
+
+size_t estimate_peak_bytes(int width, int height, int channels, int total_border,
+                           size_t file_size, ImageFormat output_format) {
+    size_t frame = static_cast<size_t>(width) * height * channels;
+    size_t border = 2 * static_cast<size_t>(total_border);
+    size_t padded = (static_cast<size_t>(width) + border) * (static_cast<size_t>(height) + border) * channels;
+
+    // The padded buffer holds both the decoded pixels and the bordered result.
+    // On top of it, stb's decoder keeps roughly one more unpadded frame of
+    // working memory (PNG inflated scanlines, JPEG component planes), and the
+    // encoder keeps its output (PNG filters and compresses a few MiB at a time,
+    // so stored PNG is the worst case at about one frame).
+    size_t decode_scratch = frame;
+    size_t encode_scratch = padded;
+    if (output_format == ImageFormat::JPG) {
+        encode_scratch = padded / 2;
+    }
+
+    return file_size + padded + std::max(decode_scratch, encode_scratch);
+}
+
+size_t estimate_lossless_peak_bytes(int width, int height, int channels, int total_border, size_t file_size) {
+    size_t border = 2 * ((static_cast<size_t>(total_border) + 15) / 16 * 16);
+    size_t padded = (static_cast<size_t>(width) + border) * (static_cast<size_t>(height) + border) * channels;
+    return 2 * file_size + padded * sizeof(int16_t);
+}
+
+void run_border_pipeline(const std::vector<BorderTask>& tasks, std::span<const BorderSpec> rings,
+                         const PipelineConfig& config,
+                         const std::function<void(const BorderTaskResult&)>& on_done) {
+    int total_border = 0;
+    for (const BorderSpec& ring : rings) {
+        total_border += ring.width;
+    }
+    Padding padding{total_border, total_border, total_border, total_border};
+
+    MemoryBudget budget(config.max_memory);
+
+    ItemQueue read_out(config.queue_depth);
+    ItemQueue decode_out(config.queue_depth);
+    ItemQueue transform_out(config.queue_depth);
+    ItemQueue encode_out(config.queue_depth);
+    std::vector<std::thread> threads;
+
+    // Read: prefetch the encoded bytes of upcoming files in batches, once the
+    // memory budget has room for them
+    std::atomic<size_t> next_task{0};
+    size_t io_batch = config.io_batch ? config.io_batch : 1;
+    auto claim = [&]() -> ItemPtr {
+        size_t index = next_task.fetch_add(1);
+        if (index >= tasks.size()) {
+            return nullptr;
+        }
+        auto item = std::make_unique<PipelineItem>();
+        item->task = &tasks[index];
+        if (config.max_memory) {
+            std::error_code ec;
+            size_t file_size = std::filesystem::file_size(item->task->input_path, ec);
+            if (ec) {
+                file_size = 0;
+            }
+            // Unreadable headers fail in decode; only the file bytes are charged.
+            // 16-bit images kept at 16 bits count as twice the channels.
+            ImageFormat output_format = detect_format(item->task->output_path);
+            ImageInfo info;
+            if (probe_image(item->task->input_path.c_str(), info)) {
+                int width = info.width, height = info.height, channels = info.channels;
+                if (supports_16_bit(output_format) && info.bits_per_channel == 16) {
+                    channels *= 2;
+                }
+                item->reserved_bytes = estimate_peak_bytes(width, height, channels, total_border, file_size,
+                                                           output_format);
+                // JPEG to JPEG may take the lossless path instead; which one
+                // is only known once the bytes are read, so charge the larger
+                if (output_format == ImageFormat::JPG && detect_format(item->task->input_path) == ImageFormat::JPG) {
+                    item->reserved_bytes = std::max(item->reserved_bytes,
+                                                    estimate_lossless_peak_bytes(width, height, channels,
+                                                                                 total_border, file_size));
+                }
+            } else {
+                item->reserved_bytes = file_size;
+            }
+        }
+        return item;
+    };
+    auto readers_left = std::make_shared<std::atomic<unsigned>>(config.read_threads ? config.read_threads : 1);
+    for (unsigned i = 0; i < (config.read_threads ? config.read_threads : 1); i++) {
+        threads.emplace_back([&, readers_left] {
+            std::unique_ptr<BatchFileIO> io = BatchFileIO::create();
+            std::vector<ItemPtr> batch;
+            std::vector<std::string> paths;
+            std::vector<FileReadResult> results;
+            ItemPtr carried;
+            for (;;) {
+                // Only the first item of a batch waits for budget; a later one
+                // that does not fit yet starts the next batch instead, so a
+                // reader never blocks while holding reservations nobody can use
+                while (batch.size() < io_batch) {
+                    ItemPtr item = carried ? std::move(carried) : claim();
+                    if (!item) {
+                        break;
+                    }
+                    if (config.max_memory) {
+                        if (batch.empty()) {
+                            budget.acquire(item->reserved_bytes);
+                        } else if (!budget.try_acquire(item->reserved_bytes)) {
+                            carried = std::move(item);
+                            break;
+                        }
+                    }
+                    batch.push_back(std::move(item));
+                }
+                if (batch.empty()) {
+                    break;
+                }
+
+                paths.clear();
+                for (const ItemPtr& item : batch) {
+                    paths.push_back(item->task->input_path);
+                }
+                io->read_files(paths, results);
+                for (size_t j = 0; j < batch.size(); j++) {
+                    if (results[j].ok) {
+                        batch[j]->file_bytes = std::move(results[j].bytes);
+                    } else {
+                        batch[j]->error = "Error: Failed to read '" + batch[j]->task->input_path + "'";
+                    }
+                    read_out.push(std::move(batch[j]));
+                }
+                batch.clear();
+            }
+            if (readers_left->fetch_sub(1) == 1) {
+                read_out.close();
+            }
+        });
+    }
+
+    // JPEG to JPEG with the border on the block grid: re-entropy-code the
+    // input's coefficients with border blocks around them, no pixels at all
+    auto border_losslessly = [&](PipelineItem& item) {
+        JpegBlockLayout blocks;
+        std::span<const std::byte> bytes(reinterpret_cast<const std::byte*>(item.file_bytes.data()),
+                                         item.file_bytes.size());
+        if (detect_format(item.task->output_path) != ImageFormat::JPG || !probe_jpeg_blocks(bytes, blocks)) {
+            return false;
+        }
+        int align = std::lcm(blocks.mcu_width, blocks.mcu_height);
+        int extra = total_border % align == 0 ? 0 : align - total_border % align;
+        if (extra && !config.round_to_blocks) {
+            return false;
+        }
+        std::vector<BorderSpec> aligned(rings.begin(), rings.end());
+        aligned.back().width += extra;
+        item.encoded.clear();
+        MemorySink sink(item.encoded);
+        if (!add_borders_jpeg(bytes, aligned, sink)) {
+            item.encoded.clear();
+            return false;
+        }
+        item.width = blocks.width + 2 * (total_border + extra);
+        item.height = blocks.height + 2 * (total_border + extra);
+        if (extra) {
+            item.log << "Rounded border up by " << extra << "px to the " << blocks.mcu_width << "x"
+                     << blocks.mcu_height << " JPEG block grid\n";
+        }
+        item.log << "Loaded image: " << blocks.width << "x" << blocks.height << " with " << blocks.channels
+                 << " channels (bordered losslessly in the DCT domain)\n";
+        item.encoded_losslessly = true;
+        return true;
+    };
+
+    // Decode: straight into the interior of the bordered buffer
+    start_stage(threads, config.decode_threads, read_out, decode_out, [&](PipelineItem& item) {
+        if (border_losslessly(item)) {
+            item.file_bytes = {};
+            return;
+        }
+        int width, height, channels;
+        const unsigned char* bytes = item.file_bytes.data();
+        size_t size = item.file_bytes.size();
+        ImageInfo info;
+        bool wide = supports_16_bit(detect_format(item.task->output_path)) &&
+                    probe_image(std::span(reinterpret_cast<const std::byte*>(bytes), size), info) &&
+                    info.bits_per_channel == 16;
+        if (wide) {
+            item.image16 = LoadedImage16::load_padded_from_memory(bytes, size, padding, width, height, channels);
+        } else {
+            item.image = LoadedImage::load_padded_from_memory(bytes, size, padding, width, height, channels);
+        }
+        item.file_bytes = {};
+        if (!item.image.get() && !item.image16.get()) {
+            item.error = "Error: Failed to load image '" + item.task->input_path + "'\nReason: " +
+                         stbi_failure_reason();
+            return;
+        }
+        item.width = width;
+        item.height = height;
+        item.log << "Loaded image: " << width - 2 * total_border << "x" << height - 2 * total_border
+                 << " with " << channels << " channels" << (wide ? " (16-bit samples)" : "") << "\n";
+    });
+
+    // Transform: paint the rings around the decoded pixels
+    start_stage(threads, config.transform_threads, decode_out, transform_out, [&](PipelineItem& item) {
+        if (item.encoded_losslessly) {
+            return;
+        }
+        bool painted = item.image16.get() ? paint_borders(item.image16.view(), rings)
+                                          : paint_borders(item.image.view(), rings);
+        if (!painted) {
+            item.error = "Error: Failed to add border";
+        }
+    });
+
+    // Encode: compress into memory in the output file's format
+    start_stage(threads, config.encode_threads, transform_out, encode_out, [&](PipelineItem& item) {
+        if (item.encoded_losslessly) {
+            return;
+        }
+        item.encoded.clear();
+        MemorySink sink(item.encoded);
+        ImageFormat format = detect_format(item.task->output_path);
+        bool written = item.image16.get() ? write_image(sink, item.image16.view(), format, config.write_options)
+                                          : write_image(sink, item.image.view(), format, config.write_options);
+        if (!written) {
+            item.error = "Error: Failed to write image";
+        }
+        item.image = LoadedImage(nullptr, 0, 0, 0);
+        item.image16 = LoadedImage16(nullptr, 0, 0, 0);
+    });
+
+    // Write: flush whatever encoded outputs are ready in one batch, then report
+    for (unsigned i = 0; i < (config.write_threads ? config.write_threads : 1); i++) {
+        threads.emplace_back([&] {
+            std::unique_ptr<BatchFileIO> io = BatchFileIO::create();
+            std::vector<ItemPtr> batch;
+            std::vector<FileWriteRequest> requests;
+            std::vector<bool> written;
+            while (std::optional<ItemPtr> first = encode_out.pop()) {
+                batch.push_back(std::move(*first));
+                while (batch.size() < io_batch) {
+                    std::optional<ItemPtr> next = encode_out.try_pop();
+                    if (!next) {
+                        break;
+                    }
+                    batch.push_back(std::move(*next));
+                }
+
+                requests.clear();
+                for (const ItemPtr& item : batch) {
+                    if (item->error.empty()) {
+                        requests.push_back(FileWriteRequest{item->task->output_path, item->encoded});
+                    }
+                }
+                io->write_files(requests, written);
+
+                size_t request = 0;
+                for (ItemPtr& item : batch) {
+                    PipelineItem& it = *item;
+                    if (it.error.empty()) {
+                        if (written[request++]) {
+                            it.log << "Successfully wrote image: " << it.width << "x" << it.height
+                                   << " to '" << it.task->output_path << "'\n";
+                        } else {
+                            it.error = "Error: Failed to write image";
+                        }
+                    }
+                    it.encoded = {};
+                    budget.release(it.reserved_bytes);
+                    on_done(BorderTaskResult{it.task, it.error.empty(), it.log.str(), it.error});
+                }
+                batch.clear();
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace vanity
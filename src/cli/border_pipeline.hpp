@@ -0,0 +1,80 @@
+#ifndef VANITY_BORDER_PIPELINE_HPP
+#define VANITY_BORDER_PIPELINE_HPP
+
+#include "vanity/image_io.hpp"
+#include "vanity/image_ops.hpp"
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vanity {
+
+// Thread count of each pipeline stage and the capacity of the queues between them
+struct PipelineConfig {
+    unsigned read_threads = 2;
+    unsigned decode_threads = 1;
+    unsigned transform_threads = 1;
+    unsigned encode_threads = 1;
+    unsigned write_threads = 2;
+    size_t queue_depth = 4;
+
+    // Files each read or write thread opens, transfers and closes per batch
+    // (io_uring where available, see BatchFileIO)
+    size_t io_batch = 16;
+
+    // Upper bound on the estimated bytes held by all in-flight images
+    // (0 = unlimited); see estimate_peak_bytes
+    size_t max_memory = 0;
+
+    // Encoder settings (JPEG quality, PNG compression level and filter)
+    WriteOptions write_options;
+
+    // JPEG outputs whose border lies on the input's block grid are bordered
+    // losslessly in the DCT domain (add_borders_jpeg); with this set the
+    // outermost ring is widened to the grid so every eligible JPEG does
+    bool round_to_blocks = false;
+};
+
+// One image to border
+struct BorderTask {
+    std::string input_path;
+    std::string output_path;
+};
+
+// Outcome of one task, including everything it logged
+struct BorderTaskResult {
+    const BorderTask* task;
+    bool ok;
+    std::string log;
+    std::string error;
+};
+
+// Estimate the peak bytes one image holds while it moves through the pipeline,
+// from its header-probed dimensions and the size of its encoded input
+// channels: bytes per pixel (twice the channel count for 16-bit samples)
+size_t estimate_peak_bytes(int width, int height, int channels, int total_border,
+                           size_t file_size, ImageFormat output_format);
+
+// Same for a JPEG bordered losslessly: the input, 16-bit coefficients for
+// every sample of the bordered frame (border rounded up to a 16px MCU) and
+// the re-encoded output, taken to be about the size of the input
+size_t estimate_lossless_peak_bytes(int width, int height, int channels, int total_border, size_t file_size);
+
+// Run every task through read -> decode -> transform -> encode -> write
+// (JPEGs bordered losslessly are encoded in the decode stage and skip the two
+// after it). Stages run on their own threads and are connected by bounded
+// queues, so file I/O overlaps compute and the number of images in flight is
+// bounded by the queue depth and thread counts (their size is not; see
+// max_memory). With max_memory set, each file's dimensions are probed from
+// its header (no decode) before it is read, and it is only admitted while the
+// estimated total stays under the budget. on_done is called once per task,
+// possibly from several threads at the same time.
+void run_border_pipeline(const std::vector<BorderTask>& tasks, std::span<const BorderSpec> rings,
+                         const PipelineConfig& config,
+                         const std::function<void(const BorderTaskResult&)>& on_done);
+
+} // namespace vanity
+
+#endif // VANITY_BORDER_PIPELINE_HPP
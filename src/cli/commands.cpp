@@ -5,10 +5,12 @@ namespace vanity {
 
 // Forward declarations of command factory functions
 std::unique_ptr<Command> create_add_border_command();
+std::unique_ptr<Command> create_info_command();
 
 // Register all available commands
 void register_all_commands(CommandRegistry& registry) {
     registry.register_command(create_add_border_command());
+    registry.register_command(create_info_command());
     // Future commands will be registered here
 }
 
@@ -1,104 +1,320 @@
+#include "../border_pipeline.hpp"
 #include "../command_registry.hpp"
+#include "../image_files.hpp"
 #include "vanity/image_buffer.hpp"
 #include "vanity/image_ops.hpp"
 #include "vanity/image_io.hpp"
+#include "vanity/image_sink.hpp"
+#include "vanity/thread_pool.hpp"
 #include "stb_image.h"
 #include <iostream>
+#include <limits>
+#include <cctype>
+#include <climits>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <mutex>
+#include <numeric>
 #include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace vanity {
 
 class AddBorderCommand : public Command {
 private:
-    bool is_supported_image_file(const std::filesystem::path& path) const {
-        std::string ext = path.extension().string();
-        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-        return ext == ".jpg" || ext == ".jpeg" || ext == ".png";
+    // Parse a byte count with an optional K/M/G suffix (powers of 1024)
+    static bool parse_byte_size(const char* text, size_t& out) {
+        char* end = nullptr;
+        unsigned long long value = std::strtoull(text, &end, 10);
+        if (end == text || value == 0) {
+            return false;
+        }
+        int shift = 0;
+        switch (std::tolower(static_cast<unsigned char>(*end))) {
+            case '\0': break;
+            case 'k': shift = 10; end++; break;
+            case 'm': shift = 20; end++; break;
+            case 'g': shift = 30; end++; break;
+            default: return false;
+        }
+        if (value == ULLONG_MAX || value > (std::numeric_limits<size_t>::max() >> shift)) {
+            return false;
+        }
+        value <<= shift;
+        if (*end == 'b' || *end == 'B') {
+            end++;
+        }
+        if (*end != '\0') {
+            return false;
+        }
+        out = static_cast<size_t>(value);
+        return true;
     }
 
-    CommandResult process_single_file(const char* input_path, const char* output_path, int border_width, bool inner_border) {
-        // Load image
-        int width, height, channels;
-        LoadedImage img = LoadedImage::load(input_path, width, height, channels);
-
-        if (!img.get()) {
-            std::string error = "Error: Failed to load image '";
-            error += input_path;
-            error += "'\nReason: ";
-            error += stbi_failure_reason();
-            return {1, error};
+    // Map a --png-filter name to its filter
+    static bool parse_png_filter(const std::string& name, PngFilter& out) {
+        static const std::pair<const char*, PngFilter> filters[] = {
+            {"adaptive", PngFilter::Adaptive}, {"none", PngFilter::None}, {"sub", PngFilter::Sub},
+            {"up", PngFilter::Up}, {"average", PngFilter::Average}, {"paeth", PngFilter::Paeth}};
+        for (const auto& [filter_name, filter] : filters) {
+            if (name == filter_name) {
+                out = filter;
+                return true;
+            }
         }
+        return false;
+    }
 
-        std::cout << "Loaded image: " << width << "x" << height
-                  << " with " << channels << " channels\n";
+    // "-" stands for stdin (input) or stdout (output)
+    static bool is_stdio(const char* path) {
+        return std::strcmp(path, "-") == 0;
+    }
 
-        // If inner border is requested, first add a 10px black border
-        unsigned char* current_data = img.get();
-        int current_width = width;
-        int current_height = height;
-        std::optional<ImageBuffer> inner_buffer;
+    // Size of the bordered image in bytes, from the input's header (the
+    // border may still grow by a JPEG block when rounded)
+    static size_t bordered_bytes(const ImageInfo& info, int total_border) {
+        size_t width = static_cast<size_t>(info.width) + 2 * static_cast<size_t>(total_border);
+        size_t height = static_cast<size_t>(info.height) + 2 * static_cast<size_t>(total_border);
+        return width * height * static_cast<size_t>(info.channels) * (info.bits_per_channel / 8);
+    }
+
+    // Encode into output_path, or stdout for "-"; an existing output file is
+    // only replaced once the encode has succeeded
+    template <typename Encode>
+    static bool write_output(const char* output_path, const Encode& encode) {
+        if (is_stdio(output_path)) {
+            FdSink sink(STDOUT_FILENO);
+            return encode(sink);
+        }
+        FileSink sink(output_path);
+        if (!sink.ok() || !encode(sink)) {
+            return false;
+        }
+        return sink.close();
+    }
 
+    CommandResult process_single_file(const char* input_path, const char* output_path, int border_width, bool inner_border,
+                                      bool round_to_blocks, ImageFormat output_format,
+                                      WriteOptions write_options, std::ostream& log) {
+        // Rings are listed innermost first: optional 10px black, then white
+        std::vector<BorderSpec> rings;
         if (inner_border) {
-            const int inner_border_width = 10;
-            int inner_width, inner_height;
-            calculate_bordered_dimensions(width, height, inner_border_width, inner_width, inner_height);
+            rings.push_back({10, {0, 0, 0, 255}});
+        }
+        rings.push_back({border_width, {255, 255, 255, 255}});
 
-            inner_buffer.emplace(inner_width, inner_height, channels);
-            unsigned char black[4] = {0, 0, 0, 255};
+        int total_border = 0;
+        for (const BorderSpec& ring : rings) {
+            total_border += ring.width;
+        }
 
-            if (!add_border(img.get(), width, height, channels, inner_buffer->get(), inner_border_width, black)) {
-                return {1, "Error: Failed to add inner border"};
+        // JPEG to JPEG needs the encoded bytes up front to try the lossless
+        // DCT-domain path; everything else decodes from the mapped file
+        std::vector<unsigned char> bytes;
+        bool in_memory = is_stdio(input_path) ||
+                         (output_format == ImageFormat::JPG && detect_format(input_path) == ImageFormat::JPG);
+        if (is_stdio(input_path)) {
+            if (!read_stream(STDIN_FILENO, bytes)) {
+                return {1, "Error: Failed to read standard input"};
+            }
+        } else if (in_memory) {
+            int fd = ::open(input_path, O_RDONLY | O_CLOEXEC);
+            bool read_ok = fd >= 0 && read_stream(fd, bytes);
+            if (fd >= 0) {
+                ::close(fd);
             }
+            if (!read_ok) {
+                return {1, "Error: Failed to read '" + std::string(input_path) + "'"};
+            }
+        }
 
-            current_data = inner_buffer->get();
-            current_width = inner_width;
-            current_height = inner_height;
-            std::cout << "Added 10px black inner border\n";
+        // A large image is painted, decoded and (for PNG) filtered and
+        // compressed in row bands across all cores. Images whose bordered
+        // size stays under the parallel threshold never use the pool, so it
+        // is only started for larger ones (or when the header is unreadable)
+        std::span<const std::byte> encoded(reinterpret_cast<const std::byte*>(bytes.data()), bytes.size());
+        ImageInfo info;
+        bool probed = in_memory ? probe_image(encoded, info) : probe_image(input_path, info);
+        ExecutionOptions exec;
+        std::optional<ThreadPool> pool;
+        if (!probed || bordered_bytes(info, total_border) >= exec.parallel_threshold) {
+            pool.emplace();
+            exec.pool = &*pool;
+            write_options.exec = exec;
         }
 
-        // Calculate new dimensions for white border
-        int new_width, new_height;
-        calculate_bordered_dimensions(current_width, current_height, border_width, new_width, new_height);
+        JpegBlockLayout blocks;
+        if (output_format == ImageFormat::JPG && in_memory && probe_jpeg_blocks(encoded, blocks)) {
+            int align = std::lcm(blocks.mcu_width, blocks.mcu_height);
+            if (round_to_blocks && total_border % align != 0) {
+                int extra = align - total_border % align;
+                rings.back().width += extra;
+                total_border += extra;
+                log << "Rounded border up by " << extra << "px to the " << blocks.mcu_width << "x"
+                    << blocks.mcu_height << " JPEG block grid\n";
+            }
+            // Bordered in memory first: an input whose coefficients the
+            // standard tables cannot code is re-encoded from pixels instead
+            std::vector<unsigned char> bordered;
+            MemorySink bordered_sink(bordered);
+            if (total_border % align == 0 && add_borders_jpeg(encoded, rings, bordered_sink, exec)) {
+                log << "Loaded image: " << blocks.width << "x" << blocks.height << " with " << blocks.channels
+                    << " channels (bordered losslessly in the DCT domain)\n";
+                if (inner_border) {
+                    log << "Added 10px black inner border\n";
+                }
+                if (!write_output(output_path, [&](ImageSink& sink) {
+                        return sink.write(bordered.data(), bordered.size());
+                    })) {
+                    return {1, "Error: Failed to write image"};
+                }
+                log << "Successfully wrote image: " << blocks.width + 2 * total_border << "x"
+                    << blocks.height + 2 * total_border << " to "
+                    << (is_stdio(output_path) ? std::string("stdout") : "'" + std::string(output_path) + "'")
+                    << "\n";
+                return {0, ""};
+            }
+        }
 
-        // Create output buffer
-        ImageBuffer output(new_width, new_height, channels);
+        // Load image straight into the interior of the bordered buffer, at
+        // the sample type the output needs: float for HDR, 16-bit when a
+        // 16-bit input goes to PNG or netpbm, 8-bit otherwise
+        Padding padding{total_border, total_border, total_border, total_border};
+        DecodeOptions decode_options;
+        decode_options.exec = exec;
+        auto border_as = [&](auto sample) -> CommandResult {
+            using Image = BasicLoadedImage<decltype(sample)>;
+            int new_width, new_height, channels;
+            Image img(nullptr, 0, 0, 0);
+            if (in_memory) {
+                img = Image::load_padded_from_memory(bytes.data(), bytes.size(), padding, decode_options,
+                                                     new_width, new_height, channels);
+                bytes = {};
+            } else {
+                img = Image::load_padded(input_path, padding, decode_options, new_width, new_height, channels);
+            }
 
-        // Add white border
-        unsigned char white[4] = {255, 255, 255, 255};
-        if (!add_border(current_data, current_width, current_height, channels, output.get(), border_width, white)) {
-            return {1, "Error: Failed to add border"};
-        }
+            if (!img.get()) {
+                std::string error = "Error: Failed to load image '";
+                error += input_path;
+                error += "'\nReason: ";
+                error += stbi_failure_reason();
+                return {1, error};
+            }
 
-        // Write output image
-        if (!write_image(output_path, new_width, new_height, channels, output.get())) {
-            return {1, "Error: Failed to write image"};
-        }
+            log << "Loaded image: " << new_width - 2 * total_border << "x" << new_height - 2 * total_border
+                      << " with " << channels << " channels";
+            if (std::is_floating_point_v<decltype(sample)>) {
+                log << " (float samples)";
+            } else if (sizeof(sample) > 1) {
+                log << " (16-bit samples)";
+            }
+            log << "\n";
 
-        std::cout << "Successfully wrote image: " << new_width << "x" << new_height
-                  << " to '" << output_path << "'\n";
+            // Paint all rings around the decoded pixels in place
+            if (!paint_borders(img.view(), rings, exec)) {
+                return {1, "Error: Failed to add border"};
+            }
+            if (inner_border) {
+                log << "Added 10px black inner border\n";
+            }
 
-        return {0, ""};
+            // Write output image
+            if (!write_output(output_path, [&](ImageSink& sink) {
+                    return write_image(sink, img.view(), output_format, write_options);
+                })) {
+                return {1, "Error: Failed to write image"};
+            }
+
+            log << "Successfully wrote image: " << new_width << "x" << new_height << " to "
+                << (is_stdio(output_path) ? std::string("stdout") : "'" + std::string(output_path) + "'") << "\n";
+
+            return {0, ""};
+        };
+
+        if (output_format == ImageFormat::HDR) {
+            return border_as(float{});
+        }
+        if (supports_16_bit(output_format) && probed && info.bits_per_channel == 16) {
+            return border_as(uint16_t{});
+        }
+        return border_as(static_cast<unsigned char>(0));
     }
 
 public:
     CommandResult execute(int argc, char* argv[]) override {
         namespace fs = std::filesystem;
 
-        // Check for --inner flag
+        // Check for --inner, --lossless, --format, --png-compression, --png-filter, --jobs,
+        // --io-threads, --io-batch, --queue-depth and --max-memory flags
         bool inner_border = false;
+        bool round_to_blocks = false;
+        int jobs = static_cast<int>(std::thread::hardware_concurrency());
+        int io_threads = 2;
+        int queue_depth = 4;
+        int io_batch = 16;
+        size_t max_memory = 0;
+        ImageFormat format = ImageFormat::UNKNOWN;
+        WriteOptions write_options;
         std::vector<std::string> args;
         for (int i = 1; i < argc; i++) {
-            if (std::string(argv[i]) == "--inner") {
+            std::string arg = argv[i];
+            if (arg == "--inner") {
                 inner_border = true;
+            } else if (arg == "--lossless") {
+                round_to_blocks = true;
+            } else if (arg == "--jobs" || arg == "-j") {
+                if (i + 1 >= argc || (jobs = std::atoi(argv[++i])) <= 0) {
+                    return {1, "Error: --jobs requires a positive integer"};
+                }
+            } else if (arg == "--io-threads") {
+                if (i + 1 >= argc || (io_threads = std::atoi(argv[++i])) <= 0) {
+                    return {1, "Error: --io-threads requires a positive integer"};
+                }
+            } else if (arg == "--io-batch") {
+                if (i + 1 >= argc || (io_batch = std::atoi(argv[++i])) <= 0) {
+                    return {1, "Error: --io-batch requires a positive integer"};
+                }
+            } else if (arg == "--format") {
+                if (i + 1 >= argc || (format = detect_format(std::string(".") + argv[++i])) == ImageFormat::UNKNOWN) {
+                    return {1, "Error: --format requires one of png, jpg, bmp, qoi, ppm, pam or hdr"};
+                }
+            } else if (arg == "--png-compression") {
+                char* end = nullptr;
+                long level = i + 1 < argc ? std::strtol(argv[++i], &end, 10) : -1;
+                if (!end || *end != '\0' || level < 0 || level > 9) {
+                    return {1, "Error: --png-compression requires a level from 0 to 9"};
+                }
+                write_options.png_compression = static_cast<int>(level);
+            } else if (arg == "--png-filter") {
+                if (i + 1 >= argc || !parse_png_filter(argv[++i], write_options.png_filter)) {
+                    return {1, "Error: --png-filter requires one of adaptive, none, sub, up, average or paeth"};
+                }
+            } else if (arg == "--max-memory") {
+                if (i + 1 >= argc || !parse_byte_size(argv[++i], max_memory)) {
+                    return {1, "Error: --max-memory requires a size such as 512M or 8G"};
+                }
+            } else if (arg == "--queue-depth") {
+                if (i + 1 >= argc || (queue_depth = std::atoi(argv[++i])) <= 0) {
+                    return {1, "Error: --queue-depth requires a positive integer"};
+                }
             } else {
-                args.push_back(argv[i]);
+                args.push_back(arg);
             }
         }
+        if (jobs <= 0) {
+            jobs = 1;
+        }
 
         // Support two modes:
         // 1. File mode: vanity border <input_image> <output_image> <border_width> [--inner]
@@ -118,6 +334,11 @@ public:
                 return {1, "Error: Border width must be a positive integer"};
             }
 
+            // Each output keeps its input's format
+            if (format != ImageFormat::UNKNOWN) {
+                return {1, "Error: --format only applies in file mode"};
+            }
+
             fs::path directory(dir_path);
             if (!fs::exists(directory)) {
                 return {1, "Error: Directory does not exist"};
@@ -128,15 +349,10 @@ public:
             }
 
             // Collect all supported image files
-            std::vector<fs::path> image_files;
-            for (const auto& entry : fs::directory_iterator(directory)) {
-                if (entry.is_regular_file() && is_supported_image_file(entry.path())) {
-                    image_files.push_back(entry.path());
-                }
-            }
+            std::vector<fs::path> image_files = list_image_files(directory);
 
             if (image_files.empty()) {
-                return {1, "Error: No JPEG or PNG files found in directory"};
+                return {1, "Error: No supported image files found in directory"};
             }
 
             std::cout << "Found " << image_files.size() << " image file(s) to process\n";
@@ -144,32 +360,57 @@ public:
                 std::cout << "Inner border mode enabled (10px black border)\n";
             }
 
-            // Process each image file
-            int success_count = 0;
-            int failure_count = 0;
+            // Rings are listed innermost first: optional 10px black, then white
+            std::vector<BorderSpec> rings;
+            if (inner_border) {
+                rings.push_back({10, {0, 0, 0, 255}});
+            }
+            rings.push_back({border_width, {255, 255, 255, 255}});
+
+            // Generate output filenames: original_name_vanity_<border-size>.ext
+            std::vector<BorderTask> tasks;
             for (const auto& input_file : image_files) {
-                // Generate output filename: original_name_vanity_<border-size>.ext
                 std::string stem = input_file.stem().string();
                 std::string extension = input_file.extension().string();
                 std::string output_filename = stem + "_vanity_" + std::to_string(border_width) + extension;
-                fs::path output_file = input_file.parent_path() / output_filename;
-
-                std::cout << "\nProcessing: " << input_file.filename().string() << " -> " << output_filename << "\n";
-
-                CommandResult result = process_single_file(
-                    input_file.string().c_str(),
-                    output_file.string().c_str(),
-                    border_width,
-                    inner_border
-                );
+                tasks.push_back({input_file.string(), (input_file.parent_path() / output_filename).string()});
+            }
 
-                if (result.exit_code == 0) {
+            // --jobs is split across the compute stages so they do not
+            // oversubscribe the CPU: the border transform is cheap and gets an
+            // eighth, decode and encode dominate and share the rest (each stage
+            // keeps at least one thread). I/O threads mostly wait and come on top
+            int transform_threads = std::max(1, jobs / 8);
+            int coding_threads = std::max(2, jobs - transform_threads);
+            PipelineConfig config;
+            config.read_threads = io_threads;
+            config.write_threads = io_threads;
+            config.decode_threads = coding_threads / 2;
+            config.encode_threads = coding_threads - coding_threads / 2;
+            config.transform_threads = transform_threads;
+            config.queue_depth = queue_depth;
+            config.io_batch = io_batch;
+            config.max_memory = max_memory;
+            config.write_options = write_options;
+            config.round_to_blocks = round_to_blocks;
+
+            // Each file's log is written in one piece so output from
+            // different files never interleaves
+            int success_count = 0;
+            int failure_count = 0;
+            std::mutex output_mutex;
+            run_border_pipeline(tasks, rings, config, [&](const BorderTaskResult& result) {
+                std::lock_guard<std::mutex> lock(output_mutex);
+                std::cout << "\nProcessing: " << fs::path(result.task->input_path).filename().string()
+                          << " -> " << fs::path(result.task->output_path).filename().string() << "\n"
+                          << result.log << std::flush;
+                if (result.ok) {
                     success_count++;
                 } else {
                     failure_count++;
-                    std::cerr << result.message << "\n";
+                    std::cerr << result.error << "\n";
                 }
-            }
+            });
 
             std::cout << "\nCompleted: " << success_count << " successful, " << failure_count << " failed\n";
             return {failure_count > 0 ? 1 : 0, ""};
@@ -184,28 +425,67 @@ public:
                 return {1, "Error: Border width must be a positive integer"};
             }
 
+            // With the image going to stdout, progress goes to stderr; the
+            // output format comes from --format, else the extension, else PAM
+            bool to_stdout = is_stdio(output_path);
+            std::ostream& log = to_stdout ? std::cerr : std::cout;
+            if (format == ImageFormat::UNKNOWN) {
+                format = to_stdout ? ImageFormat::PAM : detect_format(output_path);
+            }
+            if (format == ImageFormat::UNKNOWN) {
+                return {1, "Error: Unknown output format for '" + std::string(output_path) +
+                           "' (use a known extension or --format)"};
+            }
+
             if (inner_border) {
-                std::cout << "Inner border mode enabled (10px black border)\n";
+                log << "Inner border mode enabled (10px black border)\n";
             }
 
-            return process_single_file(input_path, output_path, border_width, inner_border);
+            return process_single_file(input_path, output_path, border_width, inner_border, round_to_blocks, format,
+                                       write_options, log);
         }
     }
 
     void print_usage(const char* program_name) const override {
         std::cout << "Usage:\n";
-        std::cout << "  " << program_name << " <input_image> <output_image> <border_width> [--inner]\n";
-        std::cout << "  " << program_name << " <directory> <border_width> [--inner]\n\n";
+        std::cout << "  " << program_name << " <input_image> <output_image> <border_width> [--inner] [--lossless]\n";
+        std::cout << "      [--format FMT] [--png-compression N] [--png-filter NAME]\n";
+        std::cout << "  " << program_name << " <directory> <border_width> [--inner] [--lossless] [--jobs N]\n";
+        std::cout << "      [--io-threads N] [--io-batch N] [--queue-depth N] [--max-memory SIZE]\n";
+        std::cout << "      [--png-compression N] [--png-filter NAME]\n\n";
         std::cout << "File mode:\n";
-        std::cout << "  input_image:  Path to the input image file\n";
-        std::cout << "  output_image: Path to save the output image\n";
+        std::cout << "  input_image:  Path to the input image file, or - for stdin\n";
+        std::cout << "  output_image: Path to save the output image, or - for stdout\n";
+        std::cout << "                (logs then go to stderr; the format defaults to PAM)\n";
         std::cout << "  border_width: Width of the white border in pixels\n\n";
         std::cout << "Directory mode:\n";
         std::cout << "  directory:    Path to directory containing images\n";
         std::cout << "  border_width: Width of the white border in pixels\n";
-        std::cout << "                (processes all JPEG and PNG files, saves as filename_vanity_<border_width>.ext)\n\n";
+        std::cout << "                (processes all JPEG, PNG, QOI and PPM/PAM files, saves as filename_vanity_<border_width>.ext)\n\n";
         std::cout << "Options:\n";
         std::cout << "  --inner:      Add a 10px black border on the inside of the white border\n";
+        std::cout << "  --lossless:   Round the border up to the JPEG block grid (8 or 16px) so JPEG\n";
+        std::cout << "                to JPEG keeps the original pixels exactly; borders already on\n";
+        std::cout << "                the grid take this path without the flag\n";
+        std::cout << "  --format FMT: Output format in file mode: png, jpg, bmp, qoi, ppm, pam or hdr\n";
+        std::cout << "                (default: from the output extension; ppm and pam are uncompressed;\n";
+        std::cout << "                16-bit inputs stay 16-bit in png, ppm and pam)\n";
+        std::cout << "  --png-compression N: PNG deflate level, 0 (stored, fastest) to 9 (smallest)\n";
+        std::cout << "                (default: 6; 1 only encodes runs and suits flat artwork)\n";
+        std::cout << "  --png-filter NAME: PNG row filter: adaptive, none, sub, up, average or paeth\n";
+        std::cout << "                (default: adaptive, which picks one per row)\n";
+        std::cout << "  --jobs N:     Worker threads shared by decoding, bordering and encoding in\n";
+        std::cout << "                directory mode, at least one per stage (default: number of\n";
+        std::cout << "                hardware threads; --io-threads come on top)\n";
+        std::cout << "  --io-threads N:  File read and write threads in directory mode (default: 2)\n";
+        std::cout << "  --io-batch N:    Files opened, read or written and closed per batch in\n";
+        std::cout << "                   directory mode (default: 16; uses io_uring when available,\n";
+        std::cout << "                   set VANITY_IO=pread to force plain reads and writes)\n";
+        std::cout << "  --queue-depth N: Images buffered between pipeline stages in directory mode\n";
+        std::cout << "                   (default: 4; bounds memory use)\n";
+        std::cout << "  --max-memory SIZE: Memory budget for images in flight in directory mode,\n";
+        std::cout << "                   e.g. 512M or 8G; images are admitted based on dimensions\n";
+        std::cout << "                   read from their headers (default: unlimited)\n";
     }
 
     const char* name() const override {
@@ -0,0 +1,187 @@
+#include "../border_pipeline.hpp"
+#include "../command_registry.hpp"
+#include "../image_files.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/thread_pool.hpp"
+#include "stb_image.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vanity {
+
+class InfoCommand : public Command {
+private:
+    // Outcome of probing one file
+    struct ProbeResult {
+        std::string path;
+        ImageInfo info;
+        bool ok = false;
+        std::string error;
+    };
+
+    static std::string format_bytes(size_t bytes) {
+        static const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+        double value = static_cast<double>(bytes);
+        int unit = 0;
+        while (value >= 1024.0 && unit < 4) {
+            value /= 1024.0;
+            unit++;
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), unit == 0 ? "%.0f %s" : "%.1f %s", value, units[unit]);
+        return text;
+    }
+
+public:
+    CommandResult execute(int argc, char* argv[]) override {
+        namespace fs = std::filesystem;
+
+        // Check for --border, --inner and --jobs flags
+        int border_width = 0;
+        bool inner_border = false;
+        int jobs = static_cast<int>(std::thread::hardware_concurrency());
+        std::vector<std::string> args;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--inner") {
+                inner_border = true;
+            } else if (arg == "--border") {
+                if (i + 1 >= argc || (border_width = std::atoi(argv[++i])) <= 0) {
+                    return {1, "Error: --border requires a positive integer"};
+                }
+            } else if (arg == "--jobs" || arg == "-j") {
+                if (i + 1 >= argc || (jobs = std::atoi(argv[++i])) <= 0) {
+                    return {1, "Error: --jobs requires a positive integer"};
+                }
+            } else {
+                args.push_back(arg);
+            }
+        }
+        if (args.empty()) {
+            print_usage(argv[0]);
+            return {1, ""};
+        }
+
+        // Directories expand to the images directly inside them
+        std::vector<ProbeResult> results;
+        for (const std::string& arg : args) {
+            std::error_code ec;
+            if (fs::is_directory(arg, ec)) {
+                std::vector<fs::path> files = list_image_files(arg);
+                std::sort(files.begin(), files.end());
+                for (const fs::path& file : files) {
+                    ProbeResult result;
+                    result.path = file.string();
+                    results.push_back(std::move(result));
+                }
+            } else {
+                ProbeResult result;
+                result.path = arg;
+                results.push_back(std::move(result));
+            }
+        }
+        if (results.empty()) {
+            return {1, "Error: No supported image files found"};
+        }
+
+        // Probing is dominated by opening files and reading a few header
+        // bytes, so files are spread across threads
+        ThreadPool pool(static_cast<unsigned>(std::max(1, jobs)));
+        pool.parallel_for(results.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                ProbeResult& result = results[i];
+                result.ok = probe_image(result.path.c_str(), result.info);
+                std::error_code ec;
+                if (!result.ok && !fs::is_regular_file(result.path, ec)) {
+                    result.error = "cannot open file";
+                } else if (!result.ok) {
+                    result.error = stbi_failure_reason() ? stbi_failure_reason() : "unknown error";
+                }
+            }
+        });
+
+        int total_border = border_width + (inner_border ? 10 : 0);
+        size_t total_file_bytes = 0;
+        size_t total_peak = 0;
+        size_t largest_peak = 0;
+        int failure_count = 0;
+        for (const ProbeResult& result : results) {
+            if (!result.ok) {
+                std::cout << result.path << ": error: " << result.error << "\n";
+                failure_count++;
+                continue;
+            }
+
+            const ImageInfo& info = result.info;
+            std::cout << result.path << ": " << info.width << "x" << info.height << ", "
+                      << info.channels << " channel(s), " << info.bits_per_channel << "-bit"
+                      << (info.is_hdr ? " HDR" : "") << ", " << format_bytes(info.file_size) << "\n";
+
+            // Border output keeps the input's format, see the border command;
+            // 16-bit PNG and netpbm stay 16-bit and HDR is bordered as float
+            ImageFormat format = detect_format(result.path);
+            int sample_bytes = format == ImageFormat::HDR ? 4
+                             : supports_16_bit(format) && info.bits_per_channel == 16 ? 2 : 1;
+            int pixel_bytes = info.channels * sample_bytes;
+            int out_width = info.width + 2 * total_border;
+            int out_height = info.height + 2 * total_border;
+            size_t raw = static_cast<size_t>(out_width) * out_height * pixel_bytes;
+            size_t peak = estimate_peak_bytes(info.width, info.height, pixel_bytes, total_border,
+                                              info.file_size, format);
+            if (total_border > 0) {
+                std::cout << "  with " << total_border << "px border: " << out_width << "x" << out_height
+                          << ", " << format_bytes(raw) << " decoded";
+            } else {
+                std::cout << "  decoded: " << format_bytes(raw);
+            }
+            std::cout << ", estimated peak memory " << format_bytes(peak) << "\n";
+
+            total_file_bytes += info.file_size;
+            total_peak += peak;
+            largest_peak = std::max(largest_peak, peak);
+        }
+
+        size_t probed = results.size() - failure_count;
+        if (results.size() > 1) {
+            std::cout << "\n" << probed << " image(s), " << format_bytes(total_file_bytes) << " on disk\n";
+            std::cout << "Estimated peak memory: " << format_bytes(largest_peak) << " per image (largest), "
+                      << format_bytes(total_peak) << " for all at once\n";
+        }
+        if (failure_count > 0) {
+            return {1, "Error: " + std::to_string(failure_count) + " file(s) could not be probed"};
+        }
+        return {0, ""};
+    }
+
+    void print_usage(const char* program_name) const override {
+        std::cout << "Usage:\n";
+        std::cout << "  " << program_name << " <image|directory>... [--border N] [--inner] [--jobs N]\n\n";
+        std::cout << "Prints each image's dimensions, channels and bit depth, read from its header\n";
+        std::cout << "without decoding, with the bordered output size and estimated peak memory.\n\n";
+        std::cout << "Options:\n";
+        std::cout << "  --border N:   Border width to plan for (default: 0)\n";
+        std::cout << "  --inner:      Include the 10px black inner border\n";
+        std::cout << "  --jobs N:     Files probed in parallel (default: number of hardware threads)\n";
+    }
+
+    const char* name() const override {
+        return "info";
+    }
+
+    const char* description() const override {
+        return "Show image dimensions and predicted border output size and memory";
+    }
+};
+
+// Factory function to create the command (called from commands.cpp)
+std::unique_ptr<Command> create_info_command() {
+    return std::make_unique<InfoCommand>();
+}
+
+} // namespace vanity
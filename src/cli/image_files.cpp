@@ -0,0 +1,49 @@
+#include "image_files.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <string>
+#include <unistd.h>
+
+namespace vanity {
+
+bool is_supported_image_file(const std::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".qoi" ||
+           ext == ".ppm" || ext == ".pgm" || ext == ".pam";
+}
+
+std::vector<std::filesystem::path> list_image_files(const std::filesystem::path& directory) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file() && is_supported_image_file(entry.path())) {
+            files.push_back(entry.path());
+        }
+    }
+    return files;
+}
+
+bool read_stream(int fd, std::vector<unsigned char>& out) {
+    out.clear();
+    size_t used = 0;
+    for (;;) {
+        if (out.size() - used < (size_t(1) << 16)) {
+            out.resize(std::max<size_t>(size_t(1) << 20, out.size() * 2));
+        }
+        ssize_t n = ::read(fd, out.data() + used, out.size() - used);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            out.resize(used);
+            return true;
+        }
+        used += static_cast<size_t>(n);
+    }
+}
+
+} // namespace vanity
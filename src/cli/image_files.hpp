@@ -0,0 +1,20 @@
+#ifndef VANITY_IMAGE_FILES_HPP
+#define VANITY_IMAGE_FILES_HPP
+
+#include <filesystem>
+#include <vector>
+
+namespace vanity {
+
+// True if the path has an extension the directory-mode commands pick up
+bool is_supported_image_file(const std::filesystem::path& path);
+
+// Regular files directly inside `directory` with a supported extension
+std::vector<std::filesystem::path> list_image_files(const std::filesystem::path& directory);
+
+// Read everything from a descriptor (e.g. stdin) until end of file
+bool read_stream(int fd, std::vector<unsigned char>& out);
+
+} // namespace vanity
+
+#endif // VANITY_IMAGE_FILES_HPP
@@ -15,8 +15,9 @@ void print_vanity_usage(const char* program_name) {
 int main(int argc, char* argv[]) {
     using namespace vanity;
 
-    std::cout << "vanity  Copyright (C) 2025 steebe (steve@stevebass.me)\n";
-    std::cout << "    This program comes with ABSOLUTELY NO WARRANTY.\n\n";
+    // The banner goes to stderr so stdout stays clean for image data
+    std::cerr << "vanity  Copyright (C) 2025 steebe (steve@stevebass.me)\n";
+    std::cerr << "    This program comes with ABSOLUTELY NO WARRANTY.\n\n";
 
     if (argc < 2) {
         print_vanity_usage(argv[0]);
@@ -0,0 +1,708 @@
+#include "vanity/batch_io.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define VANITY_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#endif
+
+namespace vanity {
+
+namespace {
+
+// Chunk size for reading files whose size is not known up front
+constexpr size_t kReadChunk = size_t(1) << 20;
+
+bool read_fd_fully(int fd, std::vector<unsigned char>& out, size_t size_hint) {
+    out.clear();
+    out.resize(size_hint);
+    size_t used = 0;
+    for (;;) {
+        if (used == out.size()) {
+            out.resize(used + kReadChunk);
+        }
+        ssize_t n = ::pread(fd, out.data() + used, out.size() - used, static_cast<off_t>(used));
+        if (n < 0 && errno == ESPIPE) {
+            // Pipes and other streams only support sequential reads
+            n = ::read(fd, out.data() + used, out.size() - used);
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            out.clear();
+            return false;
+        }
+        if (n == 0) {
+            out.resize(used);
+            return true;
+        }
+        used += static_cast<size_t>(n);
+    }
+}
+
+bool read_path(const std::string& path, std::vector<unsigned char>& out) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    size_t hint = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) ? static_cast<size_t>(st.st_size) : 0;
+    bool ok = read_fd_fully(fd, out, hint);
+    ::close(fd);
+    return ok;
+}
+
+bool write_fd_fully(int fd, const unsigned char* data, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::pwrite(fd, data + done, size - done, static_cast<off_t>(done));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool write_path(const FileWriteRequest& request) {
+    int fd = ::open(request.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = write_fd_fully(fd, request.bytes.data(), request.bytes.size());
+    if (::close(fd) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+// Blocking open/pread/pwrite/close, one file at a time
+class PreadFileIO : public BatchFileIO {
+public:
+    void read_files(std::span<const std::string> paths, std::vector<FileReadResult>& out) override {
+        out.assign(paths.size(), FileReadResult{});
+        for (size_t i = 0; i < paths.size(); i++) {
+            out[i].ok = read_path(paths[i], out[i].bytes);
+        }
+    }
+
+    void write_files(std::span<const FileWriteRequest> requests, std::vector<bool>& ok) override {
+        ok.assign(requests.size(), false);
+        for (size_t i = 0; i < requests.size(); i++) {
+            ok[i] = write_path(requests[i]);
+        }
+    }
+
+    const char* name() const override { return "pread"; }
+};
+
+#if VANITY_HAVE_IO_URING
+
+// Minimal io_uring wrapper over the raw syscalls (no liburing dependency)
+class IoUring {
+public:
+    ~IoUring() {
+        if (sqes_) {
+            ::munmap(sqes_, sqes_size_);
+        }
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_) {
+            ::munmap(cq_ptr_, cq_size_);
+        }
+        if (sq_ptr_) {
+            ::munmap(sq_ptr_, sq_size_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    bool init(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            return false;
+        }
+
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_size_ = cq_size_ = sq_size_ > cq_size_ ? sq_size_ : cq_size_;
+        }
+
+        sq_ptr_ = map(sq_size_, IORING_OFF_SQ_RING);
+        if (!sq_ptr_) {
+            return false;
+        }
+        cq_ptr_ = single_mmap ? sq_ptr_ : map(cq_size_, IORING_OFF_CQ_RING);
+        if (!cq_ptr_) {
+            return false;
+        }
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+        if (!sqes_) {
+            return false;
+        }
+
+        auto* sq = static_cast<unsigned char*>(sq_ptr_);
+        auto* cq = static_cast<unsigned char*>(cq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        entries_ = params.sq_entries;
+        local_tail_ = *sq_tail_;
+        return true;
+    }
+
+    // True if the kernel implements every listed opcode
+    bool supports(std::initializer_list<int> opcodes) {
+        const unsigned count = 256;
+        size_t size = sizeof(io_uring_probe) + count * sizeof(io_uring_probe_op);
+        auto* probe = static_cast<io_uring_probe*>(std::calloc(1, size));
+        if (!probe) {
+            return false;
+        }
+        bool ok = ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, count) >= 0;
+        for (int op : opcodes) {
+            ok = ok && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+        }
+        std::free(probe);
+        return ok;
+    }
+
+    unsigned entries() const { return entries_; }
+
+    // Next free submission entry, zeroed, or nullptr if the queue is full
+    io_uring_sqe* get_sqe() {
+        unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        if (local_tail_ - head >= entries_) {
+            return nullptr;
+        }
+        unsigned index = local_tail_ & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[index] = index;
+        local_tail_++;
+        pending_++;
+        return sqe;
+    }
+
+    // Submit queued entries and wait until at least `wait` completions exist
+    bool submit_and_wait(unsigned wait) {
+        __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+        for (;;) {
+            long ret = ::syscall(__NR_io_uring_enter, fd_, pending_, wait,
+                                 wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            pending_ -= static_cast<unsigned>(ret);
+            return true;
+        }
+    }
+
+    // Pop one completion if available
+    bool pop_cqe(io_uring_cqe& out) {
+        unsigned head = *cq_head_;
+        if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        out = cqes_[head & cq_mask_];
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    void* map(size_t size, off_t offset) {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    int fd_ = -1;
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned entries_ = 0;
+    unsigned local_tail_ = 0;
+    unsigned pending_ = 0;
+};
+
+// Per-file state while a batch is in flight
+struct UringFile {
+    int fd = -1;
+    int error = 0;
+    struct statx stx{};
+    size_t size = 0;
+    size_t done = 0;
+    unsigned inflight = 0;      // submitted entries not yet completed
+};
+
+// Encode (file index, phase) in user_data
+constexpr uint64_t kOpOpen = 0;
+constexpr uint64_t kOpStat = 1;
+constexpr uint64_t kOpData = 2;
+constexpr uint64_t kOpClose = 3;
+
+// user_data of the cancel request, which belongs to no file
+constexpr uint64_t kCancelTag = ~uint64_t(0);
+
+uint64_t tag(size_t index, uint64_t op) { return (static_cast<uint64_t>(index) << 2) | op; }
+size_t tag_index(uint64_t user_data) { return static_cast<size_t>(user_data >> 2); }
+uint64_t tag_op(uint64_t user_data) { return user_data & 3; }
+
+class UringFileIO : public BatchFileIO {
+public:
+    bool init(unsigned queue_depth) {
+        return ring_.init(queue_depth) && ring_.entries() >= 2 &&
+               ring_.supports({IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ,
+                               IORING_OP_WRITE, IORING_OP_CLOSE});
+    }
+
+    void read_files(std::span<const std::string> paths, std::vector<FileReadResult>& out) override {
+        if (broken_) {
+            return fallback_.read_files(paths, out);
+        }
+        out.assign(paths.size(), FileReadResult{});
+        // Two entries (open + statx) per file in the first phase
+        size_t chunk = ring_.entries() / 2;
+        for (size_t begin = 0; begin < paths.size(); begin += chunk) {
+            size_t end = begin + chunk < paths.size() ? begin + chunk : paths.size();
+            read_chunk(paths, out, begin, end);
+        }
+    }
+
+    void write_files(std::span<const FileWriteRequest> requests, std::vector<bool>& ok) override {
+        if (broken_) {
+            return fallback_.write_files(requests, ok);
+        }
+        ok.assign(requests.size(), false);
+        size_t chunk = ring_.entries();
+        for (size_t begin = 0; begin < requests.size(); begin += chunk) {
+            size_t end = begin + chunk < requests.size() ? begin + chunk : requests.size();
+            write_chunk(requests, ok, begin, end);
+        }
+    }
+
+    const char* name() const override { return "io_uring"; }
+
+private:
+    // Take a submission entry for files[index], counting it as in flight
+    io_uring_sqe* get_sqe(std::vector<UringFile>& files, size_t index) {
+        io_uring_sqe* sqe = ring_.get_sqe();
+        if (sqe) {
+            files[index].inflight++;
+        }
+        return sqe;
+    }
+
+    // Pass every available completion of a file's entry to on_complete
+    template <typename Fn>
+    void reap(std::vector<UringFile>& files, size_t& outstanding, Fn& on_complete) {
+        io_uring_cqe cqe;
+        while (ring_.pop_cqe(cqe)) {
+            if (cqe.user_data == kCancelTag) {
+                cancel_pending_ = false;
+                continue;
+            }
+            files[tag_index(cqe.user_data)].inflight--;
+            outstanding--;
+            on_complete(cqe);
+        }
+    }
+
+    // Submit what is queued and handle completions until `outstanding` reaches zero
+    template <typename Fn>
+    bool drain(std::vector<UringFile>& files, size_t& outstanding, Fn on_complete) {
+        while (outstanding > 0) {
+            if (!ring_.submit_and_wait(1)) {
+                return false;
+            }
+            reap(files, outstanding, on_complete);
+        }
+        return true;
+    }
+
+    // After drain failed: cancel whatever is still in flight and wait for
+    // every completion, so that no buffer is reused, released or rewritten
+    // while the kernel may still access it (completion handlers see
+    // cancelling_ and must not resubmit). Transient errors are retried; if
+    // the ring stops working altogether, the files still in flight are
+    // failed, read buffers they target are kept alive, and the backend
+    // switches to plain reads and writes.
+    template <typename Fn>
+    void settle(std::vector<UringFile>& files, std::vector<FileReadResult>* out, size_t begin,
+                size_t& outstanding, Fn on_complete) {
+        cancelling_ = true;
+#ifdef IORING_ASYNC_CANCEL_ANY
+        if (io_uring_sqe* sqe = ring_.get_sqe()) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+            sqe->user_data = kCancelTag;
+            cancel_pending_ = true;
+        }
+#endif
+        // The cancel itself is waited for too: left queued, it would cancel
+        // the next batch's requests
+        while (outstanding > 0 || cancel_pending_) {
+            bool waited = ring_.submit_and_wait(1);
+            int wait_error = errno;
+            reap(files, outstanding, on_complete);
+            if (!waited && wait_error != EAGAIN && wait_error != EBUSY) {
+                break;
+            }
+        }
+        cancelling_ = false;
+        if (outstanding == 0 && !cancel_pending_) {
+            return;
+        }
+
+        broken_ = true;
+        for (size_t i = 0; i < files.size(); i++) {
+            if (files[i].inflight == 0) {
+                continue;
+            }
+            files[i].error = EIO;
+            files[i].fd = -1;   // its close may still be pending too; leak rather than double-close
+            if (out) {
+                orphaned_.push_back(std::move((*out)[begin + i].bytes));
+                (*out)[begin + i].bytes = {};
+            }
+        }
+    }
+
+    void close_all(std::vector<UringFile>& files) {
+        size_t outstanding = 0;
+        auto on_close = [&](const io_uring_cqe& cqe) {
+            if (cqe.res != -ECANCELED) {
+                files[tag_index(cqe.user_data)].fd = -1;
+            }
+        };
+        bool ring_ok = true;
+        for (size_t i = 0; ring_ok && i < files.size(); i++) {
+            if (files[i].fd < 0) {
+                continue;
+            }
+            io_uring_sqe* sqe = get_sqe(files, i);
+            if (!sqe) {
+                ring_ok = drain(files, outstanding, on_close);
+                sqe = ring_ok ? get_sqe(files, i) : nullptr;
+                if (!sqe) {
+                    break;
+                }
+            }
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = files[i].fd;
+            sqe->user_data = tag(i, kOpClose);
+            outstanding++;
+        }
+        if (!ring_ok || !drain(files, outstanding, on_close)) {
+            settle(files, nullptr, 0, outstanding, on_close);
+        }
+
+        // The ring broke down before these were closed; make sure nothing leaks
+        for (UringFile& file : files) {
+            if (file.fd >= 0) {
+                ::close(file.fd);
+                file.fd = -1;
+            }
+        }
+
+        // Entries abandoned in a broken ring may still write to the batch's statx buffers
+        if (broken_) {
+            orphaned_files_.push_back(std::move(files));
+        }
+    }
+
+    bool queue_io(std::vector<UringFile>& files, uint8_t opcode, size_t index, unsigned char* data,
+                  size_t remaining, size_t offset) {
+        io_uring_sqe* sqe = get_sqe(files, index);
+        if (!sqe) {
+            return false;
+        }
+        // Single operations are capped well below the 2 GiB syscall limit
+        size_t len = remaining < (size_t(1) << 30) ? remaining : (size_t(1) << 30);
+        sqe->opcode = opcode;
+        sqe->fd = files[index].fd;
+        sqe->addr = reinterpret_cast<uint64_t>(data + offset);
+        sqe->len = static_cast<unsigned>(len);
+        sqe->off = offset;
+        sqe->user_data = tag(index, kOpData);
+        return true;
+    }
+
+    void read_chunk(std::span<const std::string> paths, std::vector<FileReadResult>& out,
+                    size_t begin, size_t end) {
+        std::vector<UringFile> files(end - begin);
+        size_t outstanding = 0;
+
+        // Phase 1: open and size every file
+        for (size_t i = 0; i < files.size(); i++) {
+            io_uring_sqe* open_sqe = get_sqe(files, i);
+            open_sqe->opcode = IORING_OP_OPENAT;
+            open_sqe->fd = AT_FDCWD;
+            open_sqe->addr = reinterpret_cast<uint64_t>(paths[begin + i].c_str());
+            open_sqe->open_flags = O_RDONLY | O_CLOEXEC;
+            open_sqe->user_data = tag(i, kOpOpen);
+
+            io_uring_sqe* stat_sqe = get_sqe(files, i);
+            stat_sqe->opcode = IORING_OP_STATX;
+            stat_sqe->fd = AT_FDCWD;
+            stat_sqe->addr = reinterpret_cast<uint64_t>(paths[begin + i].c_str());
+            stat_sqe->len = STATX_TYPE | STATX_SIZE;
+            stat_sqe->off = reinterpret_cast<uint64_t>(&files[i].stx);
+            stat_sqe->user_data = tag(i, kOpStat);
+            outstanding += 2;
+        }
+        auto on_open = [&](const io_uring_cqe& cqe) {
+            UringFile& file = files[tag_index(cqe.user_data)];
+            if (cqe.res == -ECANCELED && cancelling_) {
+                return;
+            }
+            if (cqe.res < 0) {
+                file.error = -cqe.res;
+            } else if (tag_op(cqe.user_data) == kOpOpen) {
+                file.fd = cqe.res;
+            }
+        };
+        bool ring_ok = drain(files, outstanding, on_open);
+        if (!ring_ok) {
+            settle(files, &out, begin, outstanding, on_open);
+        }
+
+        // Phase 2: read every regular file in full, resubmitting short reads
+        auto on_read = [&](const io_uring_cqe& cqe) {
+            size_t i = tag_index(cqe.user_data);
+            UringFile& file = files[i];
+            if (cqe.res == -ECANCELED && cancelling_) {
+                return;
+            }
+            if (cqe.res < 0 && cqe.res != -EINTR && cqe.res != -EAGAIN) {
+                file.error = -cqe.res;
+                return;
+            }
+            if (cqe.res == 0) {
+                // File shrank since statx; keep what was read
+                file.size = file.done;
+                return;
+            }
+            if (cqe.res > 0) {
+                file.done += static_cast<size_t>(cqe.res);
+            }
+            if (file.done < file.size && !cancelling_) {
+                if (queue_io(files, IORING_OP_READ, i, out[begin + i].bytes.data(), file.size - file.done,
+                             file.done)) {
+                    outstanding++;
+                } else {
+                    file.error = EAGAIN;
+                }
+            }
+        };
+        for (size_t i = 0; ring_ok && i < files.size(); i++) {
+            UringFile& file = files[i];
+            if (file.fd < 0 || file.error || !S_ISREG(file.stx.stx_mode)) {
+                continue;
+            }
+            file.size = static_cast<size_t>(file.stx.stx_size);
+            out[begin + i].bytes.resize(file.size);
+            if (file.size == 0) {
+                continue;
+            }
+            bool queued = queue_io(files, IORING_OP_READ, i, out[begin + i].bytes.data(), file.size, 0);
+            if (!queued) {
+                ring_ok = drain(files, outstanding, on_read);
+                queued = ring_ok && queue_io(files, IORING_OP_READ, i, out[begin + i].bytes.data(), file.size, 0);
+            }
+            if (queued) {
+                outstanding++;
+            }
+        }
+        ring_ok = ring_ok && drain(files, outstanding, on_read);
+        if (!ring_ok) {
+            settle(files, &out, begin, outstanding, on_read);
+        }
+
+        // Non-regular files (and, once nothing is in flight, anything the
+        // ring could not finish) are read directly
+        for (size_t i = 0; i < files.size(); i++) {
+            UringFile& file = files[i];
+            FileReadResult& result = out[begin + i];
+            if (!ring_ok && file.fd < 0 && !file.error) {
+                result.ok = read_path(paths[begin + i], result.bytes);
+            } else if (file.fd >= 0 && !file.error && (!ring_ok || !S_ISREG(file.stx.stx_mode))) {
+                result.ok = read_fd_fully(file.fd, result.bytes, 0);
+            } else {
+                result.ok = file.fd >= 0 && !file.error && file.done == file.size;
+                result.bytes.resize(file.done);
+            }
+            if (!result.ok) {
+                result.bytes.clear();
+            }
+        }
+
+        // Phase 3: close everything that was opened
+        close_all(files);
+    }
+
+    void write_chunk(std::span<const FileWriteRequest> requests, std::vector<bool>& ok,
+                     size_t begin, size_t end) {
+        std::vector<UringFile> files(end - begin);
+        size_t outstanding = 0;
+
+        // Phase 1: create every output file
+        for (size_t i = 0; i < files.size(); i++) {
+            io_uring_sqe* sqe = get_sqe(files, i);
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = reinterpret_cast<uint64_t>(requests[begin + i].path.c_str());
+            sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+            sqe->len = 0666;
+            sqe->user_data = tag(i, kOpOpen);
+            outstanding++;
+        }
+        auto on_open = [&](const io_uring_cqe& cqe) {
+            UringFile& file = files[tag_index(cqe.user_data)];
+            if (cqe.res == -ECANCELED && cancelling_) {
+                return;
+            }
+            if (cqe.res < 0) {
+                file.error = -cqe.res;
+            } else {
+                file.fd = cqe.res;
+            }
+        };
+        bool ring_ok = drain(files, outstanding, on_open);
+        if (!ring_ok) {
+            settle(files, nullptr, 0, outstanding, on_open);
+        }
+
+        // Phase 2: write every buffer, resubmitting short writes
+        auto data_of = [&](size_t i) { return const_cast<unsigned char*>(requests[begin + i].bytes.data()); };
+        auto on_write = [&](const io_uring_cqe& cqe) {
+            size_t i = tag_index(cqe.user_data);
+            UringFile& file = files[i];
+            if (cqe.res == -ECANCELED && cancelling_) {
+                return;
+            }
+            if (cqe.res < 0 && cqe.res != -EINTR && cqe.res != -EAGAIN) {
+                file.error = -cqe.res;
+                return;
+            }
+            if (cqe.res > 0) {
+                file.done += static_cast<size_t>(cqe.res);
+            }
+            if (file.done < file.size && !cancelling_) {
+                if (queue_io(files, IORING_OP_WRITE, i, data_of(i), file.size - file.done, file.done)) {
+                    outstanding++;
+                } else {
+                    file.error = EAGAIN;
+                }
+            }
+        };
+        for (size_t i = 0; i < files.size(); i++) {
+            files[i].size = requests[begin + i].bytes.size();
+        }
+        for (size_t i = 0; ring_ok && i < files.size(); i++) {
+            UringFile& file = files[i];
+            if (file.fd < 0 || file.size == 0) {
+                continue;
+            }
+            bool queued = queue_io(files, IORING_OP_WRITE, i, data_of(i), file.size, 0);
+            if (!queued) {
+                ring_ok = drain(files, outstanding, on_write);
+                queued = ring_ok && queue_io(files, IORING_OP_WRITE, i, data_of(i), file.size, 0);
+            }
+            if (queued) {
+                outstanding++;
+            }
+        }
+        ring_ok = ring_ok && drain(files, outstanding, on_write);
+        if (!ring_ok) {
+            settle(files, nullptr, 0, outstanding, on_write);
+        }
+
+        for (size_t i = 0; i < files.size(); i++) {
+            UringFile& file = files[i];
+            if (!ring_ok && file.fd < 0 && !file.error) {
+                // Its open was cancelled; nothing is in flight for it any more
+                ok[begin + i] = write_path(requests[begin + i]);
+                continue;
+            }
+            if (file.fd >= 0 && !file.error && !ring_ok) {
+                // The ring failed mid-batch and nothing is in flight any
+                // more; finish this file synchronously
+                file.done = write_fd_fully(file.fd, data_of(i), file.size) ? file.size : 0;
+            }
+            ok[begin + i] = file.fd >= 0 && !file.error && file.done == file.size;
+        }
+
+        // Phase 3: close everything that was opened
+        close_all(files);
+    }
+
+    // Read and statx buffers the kernel may still write to after the ring
+    // broke down (declared before ring_ so they outlive it)
+    std::vector<std::vector<unsigned char>> orphaned_;
+    std::vector<std::vector<UringFile>> orphaned_files_;
+    IoUring ring_;
+    PreadFileIO fallback_;
+    bool cancelling_ = false;
+    bool cancel_pending_ = false;
+    bool broken_ = false;
+};
+
+#endif // VANITY_HAVE_IO_URING
+
+} // namespace
+
+std::unique_ptr<BatchFileIO> BatchFileIO::create(unsigned queue_depth) {
+#if VANITY_HAVE_IO_URING
+    const char* requested = std::getenv("VANITY_IO");
+    if (!requested || std::string_view(requested) != "pread") {
+        auto uring = std::make_unique<UringFileIO>();
+        if (uring->init(queue_depth)) {
+            return uring;
+        }
+    }
+#else
+    (void)queue_depth;
+#endif
+    return create_fallback();
+}
+
+std::unique_ptr<BatchFileIO> BatchFileIO::create_fallback() {
+    return std::make_unique<PreadFileIO>();
+}
+
+} // namespace vanity
@@ -0,0 +1,89 @@
+#include "checksum.hpp"
+#include <cstring>
+
+namespace vanity::detail {
+
+namespace {
+
+// Slicing-by-8 tables: table[k][b] is the CRC of byte b followed by k zero bytes
+struct Crc32Tables {
+    uint32_t table[8][256];
+
+    Crc32Tables() {
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t c = b;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            table[0][b] = c;
+        }
+        for (uint32_t b = 0; b < 256; b++) {
+            for (int k = 1; k < 8; k++) {
+                table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xff];
+            }
+        }
+    }
+};
+
+const Crc32Tables& crc32_tables() {
+    static const Crc32Tables tables;
+    return tables;
+}
+
+// Largest n such that 255 n (n + 1) / 2 + (n + 1) (65521 - 1) fits in 32 bits
+constexpr size_t kAdlerBlock = 5552;
+constexpr uint32_t kAdlerMod = 65521;
+
+} // namespace
+
+uint32_t crc32(uint32_t crc, const unsigned char* data, size_t size) {
+    const auto& t = crc32_tables().table;
+    crc = ~crc;
+    while (size >= 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, data, 4);
+        std::memcpy(&hi, data + 4, 4);
+        lo ^= crc;
+        crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = t[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t adler32(uint32_t adler, const unsigned char* data, size_t size) {
+    uint32_t a = adler & 0xffff;
+    uint32_t b = adler >> 16;
+    while (size > 0) {
+        size_t n = size < kAdlerBlock ? size : kAdlerBlock;
+        size -= n;
+        for (size_t i = 0; i < n; i++) {
+            a += data[i];
+            b += a;
+        }
+        data += n;
+        a %= kAdlerMod;
+        b %= kAdlerMod;
+    }
+    return (b << 16) | a;
+}
+
+uint32_t adler32_combine(uint32_t adler1, uint32_t adler2, size_t size2) {
+    // Appending size2 bytes adds size2 * a1 to b; the second piece's sums
+    // each started from 1, so one of each is taken back out
+    uint32_t rem = static_cast<uint32_t>(size2 % kAdlerMod);
+    uint32_t a1 = adler1 & 0xffff;
+    uint32_t b1 = adler1 >> 16;
+    uint32_t a2 = adler2 & 0xffff;
+    uint32_t b2 = adler2 >> 16;
+    uint32_t a = a1 + a2 + kAdlerMod - 1;
+    uint32_t b = static_cast<uint32_t>((uint64_t(rem) * a1 + b1 + b2 + kAdlerMod - rem) % kAdlerMod);
+    a %= kAdlerMod;
+    return (b << 16) | a;
+}
+
+} // namespace vanity::detail
@@ -0,0 +1,22 @@
+#ifndef VANITY_CHECKSUM_HPP
+#define VANITY_CHECKSUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vanity::detail {
+
+// CRC-32 (ISO-HDLC, as used by PNG chunks and gzip)
+// Continue a running checksum by passing the previous result; start with 0.
+uint32_t crc32(uint32_t crc, const unsigned char* data, size_t size);
+
+// Adler-32 (as used by the zlib stream wrapper); start with 1
+uint32_t adler32(uint32_t adler, const unsigned char* data, size_t size);
+
+// Adler-32 of two concatenated pieces from the checksums of each (both
+// started at 1) and the length of the second
+uint32_t adler32_combine(uint32_t adler1, uint32_t adler2, size_t size2);
+
+} // namespace vanity::detail
+
+#endif // VANITY_CHECKSUM_HPP
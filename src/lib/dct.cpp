@@ -0,0 +1,435 @@
+#include "dct.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VANITY_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace vanity::detail {
+
+namespace {
+
+// AAN rotation constants
+constexpr float kC4 = 0.707106781f;     // cos(4 pi / 16)
+constexpr float kC6 = 0.382683433f;     // cos(6 pi / 16)
+constexpr float kC2mC6 = 0.541196100f;  // cos(2 pi / 16) - cos(6 pi / 16)
+constexpr float kC2pC6 = 1.306562965f;  // cos(2 pi / 16) + cos(6 pi / 16)
+
+// AAN inverse constants
+constexpr float kSqrt2 = 1.414213562f;
+constexpr float kIdctZ5 = 1.847759065f;     // 2 cos(2 pi / 16)
+constexpr float kIdctZ12 = 1.082392200f;    // 2 (cos(2 pi / 16) - cos(6 pi / 16))
+constexpr float kIdctZ10 = -2.613125930f;   // -2 (cos(2 pi / 16) + cos(6 pi / 16))
+
+// AAN leaves coefficient (v, u) scaled by 8 * s[v] * s[u] and expects its
+// inverse input scaled by s[v] * s[u], where s[0] = 1 and
+// s[k] = cos(k pi / 16) * sqrt(2)
+constexpr float kAanScale[8] = {1.0f, 1.387039845f, 1.306562965f, 1.175875602f,
+                                1.0f, 0.785694958f, 0.541196100f, 0.275899379f};
+
+// JFIF YCbCr to RGB
+constexpr float kCrToR = 1.402f;
+constexpr float kCbToG = 0.344136f;
+constexpr float kCrToG = 0.714136f;
+constexpr float kCbToB = 1.772f;
+
+// One-dimensional AAN forward DCT of d[0], d[step], ..., d[7 * step]
+// The vector kernels apply exactly these operations in this order, so every
+// kernel produces the same coefficients.
+inline void fdct_1d(float* d, size_t step) {
+    float tmp0 = d[0] + d[7 * step];
+    float tmp7 = d[0] - d[7 * step];
+    float tmp1 = d[step] + d[6 * step];
+    float tmp6 = d[step] - d[6 * step];
+    float tmp2 = d[2 * step] + d[5 * step];
+    float tmp5 = d[2 * step] - d[5 * step];
+    float tmp3 = d[3 * step] + d[4 * step];
+    float tmp4 = d[3 * step] - d[4 * step];
+
+    // Even part
+    float tmp10 = tmp0 + tmp3;
+    float tmp13 = tmp0 - tmp3;
+    float tmp11 = tmp1 + tmp2;
+    float tmp12 = tmp1 - tmp2;
+    d[0] = tmp10 + tmp11;
+    d[4 * step] = tmp10 - tmp11;
+    float z1 = (tmp12 + tmp13) * kC4;
+    d[2 * step] = tmp13 + z1;
+    d[6 * step] = tmp13 - z1;
+
+    // Odd part
+    tmp10 = tmp4 + tmp5;
+    tmp11 = tmp5 + tmp6;
+    tmp12 = tmp6 + tmp7;
+    float z5 = (tmp10 - tmp12) * kC6;
+    float z2 = tmp10 * kC2mC6 + z5;
+    float z4 = tmp12 * kC2pC6 + z5;
+    float z3 = tmp11 * kC4;
+    float z11 = tmp7 + z3;
+    float z13 = tmp7 - z3;
+    d[5 * step] = z13 + z2;
+    d[3 * step] = z13 - z2;
+    d[step] = z11 + z4;
+    d[7 * step] = z11 - z4;
+}
+
+// Columns first, then rows (the order the vector kernels use)
+void forward_quantize_scalar(const float* src, size_t stride, const float* scales, int16_t* out) {
+    float block[64];
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            block[y * 8 + x] = src[y * stride + x];
+        }
+    }
+    for (int x = 0; x < 8; x++) {
+        fdct_1d(block + x, 8);
+    }
+    for (int y = 0; y < 8; y++) {
+        fdct_1d(block + y * 8, 1);
+    }
+    for (int i = 0; i < 64; i++) {
+        out[i] = static_cast<int16_t>(std::lrintf(block[i] * scales[i]));
+    }
+}
+
+// One-dimensional AAN inverse DCT of d[0], d[step], ..., d[7 * step] (the
+// IJG float IDCT); as with fdct_1d, the vector kernel repeats these exact
+// operations
+inline void idct_1d(float* d, size_t step) {
+    // Even part
+    float tmp0 = d[0];
+    float tmp1 = d[2 * step];
+    float tmp2 = d[4 * step];
+    float tmp3 = d[6 * step];
+    float tmp10 = tmp0 + tmp2;
+    float tmp11 = tmp0 - tmp2;
+    float tmp13 = tmp1 + tmp3;
+    float tmp12 = (tmp1 - tmp3) * kSqrt2 - tmp13;
+    tmp0 = tmp10 + tmp13;
+    tmp3 = tmp10 - tmp13;
+    tmp1 = tmp11 + tmp12;
+    tmp2 = tmp11 - tmp12;
+
+    // Odd part
+    float tmp4 = d[step];
+    float tmp5 = d[3 * step];
+    float tmp6 = d[5 * step];
+    float tmp7 = d[7 * step];
+    float z13 = tmp6 + tmp5;
+    float z10 = tmp6 - tmp5;
+    float z11 = tmp4 + tmp7;
+    float z12 = tmp4 - tmp7;
+    tmp7 = z11 + z13;
+    tmp11 = (z11 - z13) * kSqrt2;
+    float z5 = (z10 + z12) * kIdctZ5;
+    tmp10 = z12 * kIdctZ12 - z5;
+    tmp12 = z10 * kIdctZ10 + z5;
+    tmp6 = tmp12 - tmp7;
+    tmp5 = tmp11 - tmp6;
+    tmp4 = tmp10 + tmp5;
+
+    d[0] = tmp0 + tmp7;
+    d[7 * step] = tmp0 - tmp7;
+    d[step] = tmp1 + tmp6;
+    d[6 * step] = tmp1 - tmp6;
+    d[2 * step] = tmp2 + tmp5;
+    d[5 * step] = tmp2 - tmp5;
+    d[4 * step] = tmp3 + tmp4;
+    d[3 * step] = tmp3 - tmp4;
+}
+
+// Clamped in float first so that every kernel rounds the same values
+inline uint8_t to_sample(float value) {
+    return static_cast<uint8_t>(std::lrintf(std::min(std::max(value, 0.0f), 255.0f)));
+}
+
+void inverse_dequantize_scalar(const int16_t* in, const float* scales, uint8_t* out, size_t stride) {
+    float block[64];
+    for (int i = 0; i < 64; i++) {
+        block[i] = in[i] * scales[i];
+    }
+    for (int x = 0; x < 8; x++) {
+        idct_1d(block + x, 8);
+    }
+    for (int y = 0; y < 8; y++) {
+        idct_1d(block + y * 8, 1);
+    }
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            out[y * stride + x] = to_sample(block[y * 8 + x] + 128.0f);
+        }
+    }
+}
+
+inline void ycc_to_rgb_pixel(uint8_t y, uint8_t cb, uint8_t cr, uint8_t* out) {
+    float luma = y;
+    float blue = cb - 128.0f;
+    float red = cr - 128.0f;
+    out[0] = to_sample(luma + kCrToR * red);
+    out[1] = to_sample(luma - kCbToG * blue - kCrToG * red);
+    out[2] = to_sample(luma + kCbToB * blue);
+}
+
+void ycc_to_rgb_scalar(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        ycc_to_rgb_pixel(y[i], cb[i], cr[i], out + 3 * i);
+    }
+}
+
+#if VANITY_X86_KERNELS
+
+__attribute__((target("avx2")))
+inline void fdct_1d_avx2(__m256 d[8]) {
+    __m256 tmp0 = _mm256_add_ps(d[0], d[7]);
+    __m256 tmp7 = _mm256_sub_ps(d[0], d[7]);
+    __m256 tmp1 = _mm256_add_ps(d[1], d[6]);
+    __m256 tmp6 = _mm256_sub_ps(d[1], d[6]);
+    __m256 tmp2 = _mm256_add_ps(d[2], d[5]);
+    __m256 tmp5 = _mm256_sub_ps(d[2], d[5]);
+    __m256 tmp3 = _mm256_add_ps(d[3], d[4]);
+    __m256 tmp4 = _mm256_sub_ps(d[3], d[4]);
+
+    __m256 tmp10 = _mm256_add_ps(tmp0, tmp3);
+    __m256 tmp13 = _mm256_sub_ps(tmp0, tmp3);
+    __m256 tmp11 = _mm256_add_ps(tmp1, tmp2);
+    __m256 tmp12 = _mm256_sub_ps(tmp1, tmp2);
+    d[0] = _mm256_add_ps(tmp10, tmp11);
+    d[4] = _mm256_sub_ps(tmp10, tmp11);
+    __m256 z1 = _mm256_mul_ps(_mm256_add_ps(tmp12, tmp13), _mm256_set1_ps(kC4));
+    d[2] = _mm256_add_ps(tmp13, z1);
+    d[6] = _mm256_sub_ps(tmp13, z1);
+
+    tmp10 = _mm256_add_ps(tmp4, tmp5);
+    tmp11 = _mm256_add_ps(tmp5, tmp6);
+    tmp12 = _mm256_add_ps(tmp6, tmp7);
+    __m256 z5 = _mm256_mul_ps(_mm256_sub_ps(tmp10, tmp12), _mm256_set1_ps(kC6));
+    __m256 z2 = _mm256_add_ps(_mm256_mul_ps(tmp10, _mm256_set1_ps(kC2mC6)), z5);
+    __m256 z4 = _mm256_add_ps(_mm256_mul_ps(tmp12, _mm256_set1_ps(kC2pC6)), z5);
+    __m256 z3 = _mm256_mul_ps(tmp11, _mm256_set1_ps(kC4));
+    __m256 z11 = _mm256_add_ps(tmp7, z3);
+    __m256 z13 = _mm256_sub_ps(tmp7, z3);
+    d[5] = _mm256_add_ps(z13, z2);
+    d[3] = _mm256_sub_ps(z13, z2);
+    d[1] = _mm256_add_ps(z11, z4);
+    d[7] = _mm256_sub_ps(z11, z4);
+}
+
+__attribute__((target("avx2")))
+inline void transpose_8x8(__m256 r[8]) {
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, 0xee);
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, 0xee);
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, 0xee);
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, 0xee);
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+// Each register holds one row, so the first pass transforms all eight
+// columns at once; a transpose turns the rows into columns for the second
+__attribute__((target("avx2")))
+void forward_quantize_avx2(const float* src, size_t stride, const float* scales, int16_t* out) {
+    __m256 r[8];
+    for (int y = 0; y < 8; y++) {
+        r[y] = _mm256_loadu_ps(src + y * stride);
+    }
+    fdct_1d_avx2(r);
+    transpose_8x8(r);
+    fdct_1d_avx2(r);
+    transpose_8x8(r);
+    for (int y = 0; y < 8; y += 2) {
+        __m256i a = _mm256_cvtps_epi32(_mm256_mul_ps(r[y], _mm256_loadu_ps(scales + y * 8)));
+        __m256i b = _mm256_cvtps_epi32(_mm256_mul_ps(r[y + 1], _mm256_loadu_ps(scales + y * 8 + 8)));
+        // packs interleaves 128-bit lanes; the permute puts rows back in order
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + y * 8), packed);
+    }
+}
+
+__attribute__((target("avx2")))
+inline void idct_1d_avx2(__m256 d[8]) {
+    __m256 sqrt2 = _mm256_set1_ps(kSqrt2);
+    __m256 tmp10 = _mm256_add_ps(d[0], d[4]);
+    __m256 tmp11 = _mm256_sub_ps(d[0], d[4]);
+    __m256 tmp13 = _mm256_add_ps(d[2], d[6]);
+    __m256 tmp12 = _mm256_sub_ps(_mm256_mul_ps(_mm256_sub_ps(d[2], d[6]), sqrt2), tmp13);
+    __m256 tmp0 = _mm256_add_ps(tmp10, tmp13);
+    __m256 tmp3 = _mm256_sub_ps(tmp10, tmp13);
+    __m256 tmp1 = _mm256_add_ps(tmp11, tmp12);
+    __m256 tmp2 = _mm256_sub_ps(tmp11, tmp12);
+
+    __m256 z13 = _mm256_add_ps(d[5], d[3]);
+    __m256 z10 = _mm256_sub_ps(d[5], d[3]);
+    __m256 z11 = _mm256_add_ps(d[1], d[7]);
+    __m256 z12 = _mm256_sub_ps(d[1], d[7]);
+    __m256 tmp7 = _mm256_add_ps(z11, z13);
+    tmp11 = _mm256_mul_ps(_mm256_sub_ps(z11, z13), sqrt2);
+    __m256 z5 = _mm256_mul_ps(_mm256_add_ps(z10, z12), _mm256_set1_ps(kIdctZ5));
+    tmp10 = _mm256_sub_ps(_mm256_mul_ps(z12, _mm256_set1_ps(kIdctZ12)), z5);
+    tmp12 = _mm256_add_ps(_mm256_mul_ps(z10, _mm256_set1_ps(kIdctZ10)), z5);
+    __m256 tmp6 = _mm256_sub_ps(tmp12, tmp7);
+    __m256 tmp5 = _mm256_sub_ps(tmp11, tmp6);
+    __m256 tmp4 = _mm256_add_ps(tmp10, tmp5);
+
+    d[0] = _mm256_add_ps(tmp0, tmp7);
+    d[7] = _mm256_sub_ps(tmp0, tmp7);
+    d[1] = _mm256_add_ps(tmp1, tmp6);
+    d[6] = _mm256_sub_ps(tmp1, tmp6);
+    d[2] = _mm256_add_ps(tmp2, tmp5);
+    d[5] = _mm256_sub_ps(tmp2, tmp5);
+    d[4] = _mm256_add_ps(tmp3, tmp4);
+    d[3] = _mm256_sub_ps(tmp3, tmp4);
+}
+
+// Clamp to 0..255 in float and round, as to_sample does
+__attribute__((target("avx2")))
+inline __m256i to_samples_avx2(__m256 value) {
+    value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+    return _mm256_cvtps_epi32(value);
+}
+
+// Same layout as forward_quantize_avx2: rows in registers, columns first
+__attribute__((target("avx2")))
+void inverse_dequantize_avx2(const int16_t* in, const float* scales, uint8_t* out, size_t stride) {
+    __m256 r[8];
+    for (int y = 0; y < 8; y++) {
+        __m256i coefficients = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + y * 8)));
+        r[y] = _mm256_mul_ps(_mm256_cvtepi32_ps(coefficients), _mm256_loadu_ps(scales + y * 8));
+    }
+    idct_1d_avx2(r);
+    transpose_8x8(r);
+    idct_1d_avx2(r);
+    transpose_8x8(r);
+    __m256 bias = _mm256_set1_ps(128.0f);
+    for (int y = 0; y < 8; y += 2) {
+        __m256i a = to_samples_avx2(_mm256_add_ps(r[y], bias));
+        __m256i b = to_samples_avx2(_mm256_add_ps(r[y + 1], bias));
+        // Rows y and y + 1 end up in the low and high 8 bytes of the lane
+        __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8);
+        __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + y * stride), bytes);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + (y + 1) * stride), _mm_unpackhi_epi64(bytes, bytes));
+    }
+}
+
+__attribute__((target("avx2")))
+inline __m256 load_8_bytes_ps(const uint8_t* p) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+}
+
+// Eight pixels per step; the planar results are interleaved with byte shuffles
+__attribute__((target("avx2")))
+void ycc_to_rgb_avx2(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* out, size_t count) {
+    const __m128i r_b_lo = _mm_setr_epi8(0, -1, 8, 1, -1, 9, 2, -1, 10, 3, -1, 11, 4, -1, 12, 5);
+    const __m128i g_lo = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+    const __m128i r_b_hi = _mm_setr_epi8(-1, 13, 6, -1, 14, 7, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i g_hi = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    __m256 bias = _mm256_set1_ps(128.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 luma = load_8_bytes_ps(y + i);
+        __m256 blue = _mm256_sub_ps(load_8_bytes_ps(cb + i), bias);
+        __m256 red = _mm256_sub_ps(load_8_bytes_ps(cr + i), bias);
+        __m256i r = to_samples_avx2(_mm256_add_ps(luma, _mm256_mul_ps(_mm256_set1_ps(kCrToR), red)));
+        __m256i g = to_samples_avx2(_mm256_sub_ps(_mm256_sub_ps(luma, _mm256_mul_ps(_mm256_set1_ps(kCbToG), blue)),
+                                                  _mm256_mul_ps(_mm256_set1_ps(kCrToG), red)));
+        __m256i b = to_samples_avx2(_mm256_add_ps(luma, _mm256_mul_ps(_mm256_set1_ps(kCbToB), blue)));
+
+        // Lane 0 holds R0-7 then B0-7, lane 1 G0-7 then B0-7
+        __m256i rg = _mm256_permute4x64_epi64(_mm256_packs_epi32(r, g), 0xd8);
+        __m256i bb = _mm256_permute4x64_epi64(_mm256_packs_epi32(b, b), 0xd8);
+        __m256i bytes = _mm256_packus_epi16(rg, bb);
+        __m128i rb = _mm256_castsi256_si128(bytes);
+        __m128i gb = _mm256_extracti128_si256(bytes, 1);
+        __m128i first = _mm_or_si128(_mm_shuffle_epi8(rb, r_b_lo), _mm_shuffle_epi8(gb, g_lo));
+        __m128i second = _mm_or_si128(_mm_shuffle_epi8(rb, r_b_hi), _mm_shuffle_epi8(gb, g_hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 3 * i), first);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 3 * i + 16), second);
+    }
+    for (; i < count; i++) {
+        ycc_to_rgb_pixel(y[i], cb[i], cr[i], out + 3 * i);
+    }
+}
+
+#endif // VANITY_X86_KERNELS
+
+const DctKernels kScalarKernels{"scalar", forward_quantize_scalar, inverse_dequantize_scalar, ycc_to_rgb_scalar};
+#if VANITY_X86_KERNELS
+const DctKernels kAvx2Kernels{"avx2", forward_quantize_avx2, inverse_dequantize_avx2, ycc_to_rgb_avx2};
+#endif
+
+std::vector<const DctKernels*> detect_kernels() {
+    std::vector<const DctKernels*> kernels{&kScalarKernels};
+#if VANITY_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back(&kAvx2Kernels);
+    }
+#endif
+    return kernels;
+}
+
+const DctKernels* select_kernels() {
+    std::span<const DctKernels* const> kernels = available_dct_kernels();
+    if (const char* requested = std::getenv("VANITY_SIMD")) {
+        for (const DctKernels* k : kernels) {
+            if (std::string_view(requested) == k->name) {
+                return k;
+            }
+        }
+    }
+    return kernels.back();
+}
+
+} // namespace
+
+const DctKernels& dct_kernels() {
+    static const DctKernels* selected = select_kernels();
+    return *selected;
+}
+
+std::span<const DctKernels* const> available_dct_kernels() {
+    static const std::vector<const DctKernels*> kernels = detect_kernels();
+    return kernels;
+}
+
+void forward_dct_scales(const uint16_t quant[64], float scales[64]) {
+    for (int v = 0; v < 8; v++) {
+        for (int u = 0; u < 8; u++) {
+            scales[v * 8 + u] = 1.0f / (quant[v * 8 + u] * kAanScale[v] * kAanScale[u] * 8.0f);
+        }
+    }
+}
+
+void inverse_dct_scales(const uint16_t quant[64], float scales[64]) {
+    for (int v = 0; v < 8; v++) {
+        for (int u = 0; u < 8; u++) {
+            scales[v * 8 + u] = quant[v * 8 + u] * kAanScale[v] * kAanScale[u] / 8.0f;
+        }
+    }
+}
+
+} // namespace vanity::detail
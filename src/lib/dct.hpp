@@ -0,0 +1,47 @@
+#ifndef VANITY_DCT_HPP
+#define VANITY_DCT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace vanity::detail {
+
+// 8x8 DCT and colour kernels used by the JPEG codec. As with PixelKernels,
+// one table exists per instruction set and the best one the CPU supports is used.
+struct DctKernels {
+    const char* name;
+
+    // Forward DCT (AAN, float) of the 8x8 block at src, whose rows are
+    // `stride` floats apart and whose samples are level-shifted to -128..127,
+    // then quantization: out[i] = round(coefficient[i] * scales[i]), with
+    // out and scales in natural (row-major) order
+    void (*forward_quantize)(const float* src, size_t stride, const float* scales, int16_t* out);
+
+    // Dequantization and inverse DCT (AAN, float) of the natural-order
+    // coefficients in, with scales from inverse_dct_scales, then the level
+    // shift back to 0..255 into the 8x8 block at out whose rows are `stride`
+    // bytes apart
+    void (*inverse_dequantize)(const int16_t* in, const float* scales, uint8_t* out, size_t stride);
+
+    // JFIF YCbCr to interleaved RGB for count pixels
+    void (*ycc_to_rgb)(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* out, size_t count);
+};
+
+// Kernels selected for this CPU (override with VANITY_SIMD=scalar|avx2)
+const DctKernels& dct_kernels();
+
+// Every kernel table this CPU can run, scalar first (used by tests and benchmarks)
+std::span<const DctKernels* const> available_dct_kernels();
+
+// Multipliers for forward_quantize: the reciprocal of each quantizer times
+// the AAN output scale of its coefficient
+void forward_dct_scales(const uint16_t quant[64], float scales[64]);
+
+// Multipliers for inverse_dequantize: each quantizer times the AAN input
+// scale of its coefficient, with the final divide by 8 folded in
+void inverse_dct_scales(const uint16_t quant[64], float scales[64]);
+
+} // namespace vanity::detail
+
+#endif // VANITY_DCT_HPP
@@ -0,0 +1,338 @@
+#include "deflate.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace vanity::detail {
+
+namespace {
+
+constexpr int kWindowBits = 15;
+constexpr int32_t kWindowSize = 1 << kWindowBits;
+constexpr int32_t kWindowMask = kWindowSize - 1;
+constexpr int kHashBits = 15;
+constexpr int kMinMatch = 3;
+constexpr int kMaxMatch = 258;
+constexpr size_t kMaxStoredBlock = 65535;
+
+// Hash chain search depth and the match length that ends a search early,
+// indexed by level (levels 0 and 1 do not search)
+constexpr int kMaxChain[10] = {0, 0, 4, 8, 16, 32, 64, 128, 256, 4096};
+constexpr int kNiceLength[10] = {0, 0, 8, 16, 32, 64, 128, 258, 258, 258};
+
+constexpr uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                      2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t kDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                    6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+uint32_t reverse_bits(uint32_t code, int length) {
+    uint32_t result = 0;
+    for (int i = 0; i < length; i++) {
+        result = (result << 1) | ((code >> i) & 1);
+    }
+    return result;
+}
+
+// Fixed Huffman codes (RFC 1951 3.2.6), bit-reversed for LSB-first output
+struct FixedCodes {
+    uint16_t literal[288];
+    uint8_t literal_bits[288];
+    // Length symbol code plus its extra bits, for match lengths 3..258
+    uint32_t length[kMaxMatch + 1];
+    uint8_t length_bits[kMaxMatch + 1];
+    uint8_t distance_code[30];
+    // Distance symbol for (distance - 1) < 256, and for ((distance - 1) >> 7) above
+    uint8_t distance_small[256];
+    uint8_t distance_large[256];
+
+    FixedCodes() {
+        for (int sym = 0; sym < 288; sym++) {
+            uint32_t code;
+            int bits;
+            if (sym < 144) {
+                code = 0x30 + sym;
+                bits = 8;
+            } else if (sym < 256) {
+                code = 0x190 + (sym - 144);
+                bits = 9;
+            } else if (sym < 280) {
+                code = sym - 256;
+                bits = 7;
+            } else {
+                code = 0xc0 + (sym - 280);
+                bits = 8;
+            }
+            literal[sym] = static_cast<uint16_t>(reverse_bits(code, bits));
+            literal_bits[sym] = static_cast<uint8_t>(bits);
+        }
+
+        for (int sym = 0; sym < 29; sym++) {
+            int end = sym == 28 ? kMaxMatch + 1 : kLengthBase[sym + 1];
+            for (int len = kLengthBase[sym]; len < end; len++) {
+                int code_bits = literal_bits[257 + sym];
+                length[len] = literal[257 + sym] | (uint32_t(len - kLengthBase[sym]) << code_bits);
+                length_bits[len] = static_cast<uint8_t>(code_bits + kLengthExtra[sym]);
+            }
+        }
+
+        for (int sym = 0; sym < 30; sym++) {
+            distance_code[sym] = static_cast<uint8_t>(reverse_bits(sym, 5));
+        }
+        int sym = 0;
+        for (int d = 0; d < 256; d++) {
+            while (sym < 29 && kDistBase[sym + 1] - 1 <= d) {
+                sym++;
+            }
+            distance_small[d] = static_cast<uint8_t>(sym);
+        }
+        sym = 0;
+        for (int d = 0; d < 256; d++) {
+            while (sym < 29 && kDistBase[sym + 1] - 1 <= (d << 7)) {
+                sym++;
+            }
+            distance_large[d] = static_cast<uint8_t>(sym);
+        }
+    }
+};
+
+const FixedCodes& fixed_codes() {
+    static const FixedCodes codes;
+    return codes;
+}
+
+inline uint32_t hash3(const unsigned char* p) {
+    uint32_t v = p[0] | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16);
+    return (v * 0x9e3779b1u) >> (32 - kHashBits);
+}
+
+// Length of the common prefix of a and b, up to limit bytes
+inline int match_length(const unsigned char* a, const unsigned char* b, int limit) {
+    int len = 0;
+    while (len + 8 <= limit) {
+        uint64_t x, y;
+        std::memcpy(&x, a + len, 8);
+        std::memcpy(&y, b + len, 8);
+        if (x != y) {
+            return len + (__builtin_ctzll(x ^ y) >> 3);
+        }
+        len += 8;
+    }
+    while (len < limit && a[len] == b[len]) {
+        len++;
+    }
+    return len;
+}
+
+} // namespace
+
+DeflateEncoder::DeflateEncoder(int level) : level_(std::clamp(level, 0, 9)) {
+    if (level_ >= 2) {
+        head_.resize(size_t(1) << kHashBits);
+        prev_.resize(kWindowSize);
+    }
+}
+
+uint8_t DeflateEncoder::zlib_flags() const {
+    // FLEVEL in the top two bits, then FCHECK so that the header is a multiple of 31
+    uint8_t flevel = level_ < 2 ? 0 : level_ < 6 ? 1 : level_ == 6 ? 2 : 3;
+    uint8_t flags = static_cast<uint8_t>(flevel << 6);
+    return static_cast<uint8_t>(flags + (31 - (0x78 * 256 + flags) % 31));
+}
+
+void DeflateEncoder::begin_output(std::vector<unsigned char>& out, size_t max_bytes) {
+    size_t n = out.size();
+    out.resize(n + max_bytes);
+    cursor_ = out.data() + n;
+}
+
+void DeflateEncoder::end_output(std::vector<unsigned char>& out) {
+    out.resize(static_cast<size_t>(cursor_ - out.data()));
+    cursor_ = nullptr;
+}
+
+inline void DeflateEncoder::put_bits(uint32_t bits, int count) {
+    bit_buffer_ |= uint64_t(bits) << bit_count_;
+    bit_count_ += count;
+    if (bit_count_ >= 32) {
+        uint32_t word = static_cast<uint32_t>(bit_buffer_);
+        std::memcpy(cursor_, &word, 4);
+        cursor_ += 4;
+        bit_buffer_ >>= 32;
+        bit_count_ -= 32;
+    }
+}
+
+void DeflateEncoder::put_bytes(const unsigned char* data, size_t size) {
+    std::memcpy(cursor_, data, size);
+    cursor_ += size;
+}
+
+void DeflateEncoder::align() {
+    while (bit_count_ > 0) {
+        *cursor_++ = static_cast<unsigned char>(bit_buffer_);
+        bit_buffer_ >>= 8;
+        bit_count_ -= 8;
+    }
+    bit_buffer_ = 0;
+    bit_count_ = 0;
+}
+
+void DeflateEncoder::compress(const unsigned char* data, size_t history, size_t size,
+                              std::vector<unsigned char>& out) {
+    if (size == 0) {
+        return;
+    }
+    // Literals take at most 9 bits and matches fewer bits than the bytes
+    // they cover, so 9/8 of the input plus block overhead always fits
+    begin_output(out, size + size / 8 + 8 * (size / kMaxStoredBlock + 1) + 16);
+    if (level_ == 0) {
+        compress_stored(data + history, size);
+        end_output(out);
+        return;
+    }
+
+    // One fixed-Huffman block per call
+    put_bits(0, 1);
+    put_bits(1, 2);
+    if (level_ == 1) {
+        compress_rle(data, history, size);
+    } else {
+        compress_lz77(data, history, size);
+    }
+    put_bits(fixed_codes().literal[256], 7);
+    end_output(out);
+}
+
+void DeflateEncoder::finish(std::vector<unsigned char>& out) {
+    static const unsigned char empty[4] = {0x00, 0x00, 0xff, 0xff};
+    begin_output(out, 16);
+    if (level_ == 0) {
+        put_bits(1, 1);
+        put_bits(0, 2);
+        align();
+        put_bytes(empty, 4);
+    } else {
+        put_bits(1, 1);
+        put_bits(1, 2);
+        put_bits(fixed_codes().literal[256], 7);
+        align();
+    }
+    end_output(out);
+}
+
+void DeflateEncoder::sync_flush(std::vector<unsigned char>& out) {
+    static const unsigned char empty[4] = {0x00, 0x00, 0xff, 0xff};
+    begin_output(out, 16);
+    put_bits(0, 1);
+    put_bits(0, 2);
+    align();
+    put_bytes(empty, 4);
+    end_output(out);
+}
+
+void DeflateEncoder::compress_stored(const unsigned char* data, size_t size) {
+    while (size > 0) {
+        size_t n = std::min(size, kMaxStoredBlock);
+        put_bits(0, 1);
+        put_bits(0, 2);
+        align();
+        unsigned char header[4] = {static_cast<unsigned char>(n), static_cast<unsigned char>(n >> 8),
+                                   static_cast<unsigned char>(~n), static_cast<unsigned char>(~n >> 8)};
+        put_bytes(header, 4);
+        put_bytes(data, n);
+        data += n;
+        size -= n;
+    }
+}
+
+void DeflateEncoder::compress_rle(const unsigned char* data, size_t history, size_t size) {
+    const FixedCodes& codes = fixed_codes();
+    const uint32_t distance_one = codes.distance_code[0];
+    size_t pos = history;
+    size_t end = history + size;
+    while (pos < end) {
+        if (pos > 0 && data[pos] == data[pos - 1]) {
+            int limit = static_cast<int>(std::min<size_t>(kMaxMatch, end - pos));
+            int run = match_length(data + pos - 1, data + pos, limit);
+            if (run >= kMinMatch) {
+                put_bits(codes.length[run], codes.length_bits[run]);
+                put_bits(distance_one, 5);
+                pos += run;
+                continue;
+            }
+        }
+        put_bits(codes.literal[data[pos]], codes.literal_bits[data[pos]]);
+        pos++;
+    }
+}
+
+void DeflateEncoder::compress_lz77(const unsigned char* data, size_t history, size_t size) {
+    const FixedCodes& codes = fixed_codes();
+    const int max_chain = kMaxChain[level_];
+    const int nice = kNiceLength[level_];
+
+    // Positions are relative to the start of the history actually used
+    size_t skip = history > size_t(kWindowSize) ? history - kWindowSize : 0;
+    const unsigned char* base = data + skip;
+    const int32_t begin = static_cast<int32_t>(history - skip);
+    const int32_t end = static_cast<int32_t>(begin + size);
+    std::fill(head_.begin(), head_.end(), -1);
+
+    auto insert = [&](int32_t p) {
+        uint32_t h = hash3(base + p);
+        prev_[p & kWindowMask] = head_[h];
+        head_[h] = p;
+    };
+    for (int32_t p = 0; p < begin && p + kMinMatch <= end; p++) {
+        insert(p);
+    }
+
+    int32_t pos = begin;
+    while (pos < end) {
+        int best_len = 0;
+        int32_t best_dist = 0;
+        if (end - pos >= kMinMatch) {
+            int limit = std::min<int>(kMaxMatch, end - pos);
+            int32_t cand = head_[hash3(base + pos)];
+            insert(pos);
+            int chain = max_chain;
+            while (cand >= 0 && pos - cand <= kWindowSize && chain-- > 0) {
+                if (base[cand + best_len] == base[pos + best_len] && base[cand] == base[pos]) {
+                    int len = match_length(base + cand, base + pos, limit);
+                    if (len > best_len) {
+                        best_len = len;
+                        best_dist = pos - cand;
+                        if (len >= nice || len >= limit) {
+                            break;
+                        }
+                    }
+                }
+                int32_t next = prev_[cand & kWindowMask];
+                if (next >= cand) {
+                    break;
+                }
+                cand = next;
+            }
+        }
+
+        if (best_len >= kMinMatch) {
+            put_bits(codes.length[best_len], codes.length_bits[best_len]);
+            uint32_t d = static_cast<uint32_t>(best_dist - 1);
+            int sym = d < 256 ? codes.distance_small[d] : codes.distance_large[d >> 7];
+            put_bits(codes.distance_code[sym] | ((d - (kDistBase[sym] - 1)) << 5), 5 + kDistExtra[sym]);
+            for (int32_t p = pos + 1; p < pos + best_len && p + kMinMatch <= end; p++) {
+                insert(p);
+            }
+            pos += best_len;
+        } else {
+            put_bits(codes.literal[base[pos]], codes.literal_bits[base[pos]]);
+            pos++;
+        }
+    }
+}
+
+} // namespace vanity::detail
@@ -0,0 +1,62 @@
+#ifndef VANITY_DEFLATE_HPP
+#define VANITY_DEFLATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vanity::detail {
+
+// Raw deflate (RFC 1951) encoder using the fixed Huffman code
+// Compression levels follow zlib's scale:
+//   0      stored blocks, no compression
+//   1      run-length matches only (distance 1), like Z_RLE
+//   2 - 9  greedy LZ77 over hash chains, searching deeper as the level rises
+// Output is appended to a caller-owned vector; whole bytes may be taken from
+// it (and the vector cleared) between calls, since unfinished bits are kept
+// inside the encoder.
+class DeflateEncoder {
+public:
+    explicit DeflateEncoder(int level);
+
+    // Compress data[history, history + size)
+    // The `history` bytes before it (at most 32 KiB are used) are the
+    // preceding uncompressed stream and may be referenced by matches.
+    // Callers feed the stream in pieces of a few MiB (well below 2 GiB).
+    void compress(const unsigned char* data, size_t history, size_t size, std::vector<unsigned char>& out);
+
+    // End the stream with a final block and pad to a byte boundary
+    void finish(std::vector<unsigned char>& out);
+
+    // Pad to a byte boundary with an empty stored block, leaving the stream
+    // open; independently compressed pieces can be concatenated this way
+    void sync_flush(std::vector<unsigned char>& out);
+
+    int level() const { return level_; }
+
+    // Second byte of the zlib stream header for this level (the first is 0x78)
+    uint8_t zlib_flags() const;
+
+private:
+    // Output goes through a raw cursor into space reserved by begin_output;
+    // end_output trims the vector back to the bytes actually written
+    void begin_output(std::vector<unsigned char>& out, size_t max_bytes);
+    void end_output(std::vector<unsigned char>& out);
+    void put_bits(uint32_t bits, int count);
+    void put_bytes(const unsigned char* data, size_t size);
+    void align();
+    void compress_stored(const unsigned char* data, size_t size);
+    void compress_rle(const unsigned char* data, size_t history, size_t size);
+    void compress_lz77(const unsigned char* data, size_t history, size_t size);
+
+    int level_;
+    uint64_t bit_buffer_ = 0;
+    int bit_count_ = 0;
+    unsigned char* cursor_ = nullptr;
+    std::vector<int32_t> head_;
+    std::vector<int32_t> prev_;
+};
+
+} // namespace vanity::detail
+
+#endif // VANITY_DEFLATE_HPP
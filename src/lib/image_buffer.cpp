@@ -1,24 +1,36 @@
 #include "vanity/image_buffer.hpp"
+#include "jpeg_reader.hpp"
+#include "mapped_file.hpp"
+#include "png_reader.hpp"
+#include "pnm.hpp"
+#include "qoi.hpp"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include <climits>
+#include <cstring>
+#include <string>
+#include <type_traits>
 #include <utility>
 
 namespace vanity {
 
-// ImageBuffer implementation
+// BasicImageBuffer implementation
 
-ImageBuffer::ImageBuffer(int width, int height, int channels)
-    : data_(new unsigned char[static_cast<size_t>(width) * height * channels])
+template <typename T>
+BasicImageBuffer<T>::BasicImageBuffer(int width, int height, int channels)
+    : data_(new T[static_cast<size_t>(width) * height * channels])
     , width_(width)
     , height_(height)
     , channels_(channels) {
 }
 
-ImageBuffer::~ImageBuffer() {
+template <typename T>
+BasicImageBuffer<T>::~BasicImageBuffer() {
     delete[] data_;
 }
 
-ImageBuffer::ImageBuffer(ImageBuffer&& other) noexcept
+template <typename T>
+BasicImageBuffer<T>::BasicImageBuffer(BasicImageBuffer&& other) noexcept
     : data_(other.data_)
     , width_(other.width_)
     , height_(other.height_)
@@ -29,7 +41,8 @@ ImageBuffer::ImageBuffer(ImageBuffer&& other) noexcept
     other.channels_ = 0;
 }
 
-ImageBuffer& ImageBuffer::operator=(ImageBuffer&& other) noexcept {
+template <typename T>
+BasicImageBuffer<T>& BasicImageBuffer<T>::operator=(BasicImageBuffer&& other) noexcept {
     if (this != &other) {
         delete[] data_;
 
@@ -46,8 +59,9 @@ ImageBuffer& ImageBuffer::operator=(ImageBuffer&& other) noexcept {
     return *this;
 }
 
-unsigned char* ImageBuffer::release() {
-    unsigned char* ptr = data_;
+template <typename T>
+T* BasicImageBuffer<T>::release() {
+    T* ptr = data_;
     data_ = nullptr;
     width_ = 0;
     height_ = 0;
@@ -55,27 +69,303 @@ unsigned char* ImageBuffer::release() {
     return ptr;
 }
 
-// LoadedImage implementation
+template class BasicImageBuffer<unsigned char>;
+template class BasicImageBuffer<uint16_t>;
+template class BasicImageBuffer<float>;
 
-LoadedImage LoadedImage::load(const char* path, int& width, int& height, int& channels) {
-    unsigned char* img = stbi_load(path, &width, &height, &channels, 0);
-    return LoadedImage(img, width, height, channels);
+// BasicLoadedImage implementation
+
+template <typename T>
+BasicLoadedImage<T> BasicLoadedImage<T>::load(const char* path, int& width, int& height, int& channels) {
+    return load_padded(path, Padding{}, width, height, channels);
+}
+
+template <typename T>
+BasicLoadedImage<T> BasicLoadedImage<T>::load(const char* path, const DecodeOptions& options, int& width,
+                                              int& height, int& channels) {
+    return load_padded(path, Padding{}, options, width, height, channels);
+}
+
+namespace {
+
+bool valid_padding(const Padding& padding) {
+    if (padding.top < 0 || padding.left < 0 || padding.right < 0 || padding.bottom < 0) {
+        stbi__err("bad padding", "Padding must not be negative");
+        return false;
+    }
+    return true;
+}
+
+// Take ownership of a freshly decoded stb image and grow it to the padded size
+template <typename T>
+BasicLoadedImage<T> pad_decoded(T* img, int src_width, int src_height, int channels,
+                                const Padding& padding, int& width, int& height) {
+    if (!img) {
+        return BasicLoadedImage<T>(nullptr, 0, 0, 0);
+    }
+
+    width = src_width + padding.left + padding.right;
+    height = src_height + padding.top + padding.bottom;
+    size_t pixel_bytes = static_cast<size_t>(channels) * sizeof(T);
+    size_t src_row = static_cast<size_t>(src_width) * pixel_bytes;
+    size_t dst_row = static_cast<size_t>(width) * pixel_bytes;
+
+    // Grow the stb allocation; large blocks are remapped rather than copied
+    unsigned char* padded = static_cast<unsigned char*>(
+        STBI_REALLOC(img, dst_row * static_cast<size_t>(height)));
+    if (!padded) {
+        stbi_image_free(img);
+        stbi__err("outofmem", "Out of memory");
+        return BasicLoadedImage<T>(nullptr, 0, 0, 0);
+    }
+
+    // Every row moves forward, so walking from the last row up never
+    // overwrites a row that has not been moved yet
+    size_t left = static_cast<size_t>(padding.left) * pixel_bytes;
+    for (int y = src_height - 1; y >= 0; y--) {
+        unsigned char* dst = padded + (padding.top + y) * dst_row + left;
+        std::memmove(dst, padded + y * src_row, src_row);
+    }
+
+    return BasicLoadedImage<T>(reinterpret_cast<T*>(padded), width, height, channels);
+}
+
+// Allocate the padded buffer and let decode(interior) fill its interior
+// In-tree decoders (QOI, netpbm, PNG, JPEG) write there directly, so unlike stb
+// images nothing is moved afterwards. stb's allocator is used so the
+// result is freed like any other LoadedImage.
+template <typename T, typename Decode>
+BasicLoadedImage<T> decode_into_padded(int src_width, int src_height, int channels, const Padding& padding,
+                                       int& width, int& height, Decode&& decode) {
+    if (src_width > INT_MAX - padding.left - padding.right ||
+        src_height > INT_MAX - padding.top - padding.bottom) {
+        stbi__err("too large", "Padded image is too large");
+        return BasicLoadedImage<T>(nullptr, 0, 0, 0);
+    }
+
+    width = src_width + padding.left + padding.right;
+    height = src_height + padding.top + padding.bottom;
+    auto* pixels = static_cast<T*>(
+        STBI_MALLOC(static_cast<size_t>(width) * height * channels * sizeof(T)));
+    if (!pixels) {
+        stbi__err("outofmem", "Out of memory");
+        return BasicLoadedImage<T>(nullptr, 0, 0, 0);
+    }
+
+    BasicLoadedImage<T> image(pixels, width, height, channels);
+    if (!decode(image.view().subview(padding.left, padding.top, src_width, src_height))) {
+        return BasicLoadedImage<T>(nullptr, 0, 0, 0);
+    }
+    return image;
+}
+
+LoadedImage decode_qoi(const unsigned char* data, size_t size, const Padding& padding,
+                       int& width, int& height, int& channels) {
+    int src_width, src_height;
+    if (!detail::qoi_read_header(data, size, src_width, src_height, channels)) {
+        stbi__err("bad QOI header", "Corrupt QOI header");
+        return LoadedImage(nullptr, 0, 0, 0);
+    }
+    return decode_into_padded<unsigned char>(src_width, src_height, channels, padding, width, height,
+                                             [&](const MutableImageView& interior) {
+        if (!detail::qoi_decode(data, size, interior)) {
+            stbi__err("bad QOI", "Corrupt QOI data");
+            return false;
+        }
+        return true;
+    });
+}
+
+// Netpbm of any depth: 8-bit loads take maxval <= 255, 16-bit loads any maxval
+template <typename T>
+BasicLoadedImage<T> decode_pnm(const detail::PnmHeader& header, const unsigned char* data, size_t size,
+                               const Padding& padding, int& width, int& height, int& channels) {
+    channels = header.channels;
+    return decode_into_padded<T>(header.width, header.height, channels, padding, width, height,
+                                 [&](const BasicMutableImageView<T>& interior) {
+        if (!detail::pnm_decode(data, size, interior)) {
+            stbi__err("bad PNM", "Corrupt or truncated PNM data");
+            return false;
+        }
+        return true;
+    });
+}
+
+LoadedImage decode_png(const detail::PngHeader& header, const unsigned char* data, size_t size,
+                       const Padding& padding, int& width, int& height, int& channels) {
+    channels = header.channels;
+    return decode_into_padded<unsigned char>(header.width, header.height, channels, padding, width, height,
+                                             [&](const MutableImageView& interior) {
+        if (!detail::png_decode(data, size, header, interior)) {
+            stbi__err("bad PNG", "Corrupt PNG data");
+            return false;
+        }
+        return true;
+    });
+}
+
+LoadedImage decode_jpeg(const detail::JpegHeader& header, const unsigned char* data, size_t size,
+                        const Padding& padding, const DecodeOptions& options, int& width, int& height,
+                        int& channels) {
+    int src_width, src_height;
+    detail::jpeg_scaled_size(header, options.scale_denom, src_width, src_height);
+    channels = header.components.size() == 1 ? 1 : 3;
+    return decode_into_padded<unsigned char>(src_width, src_height, channels, padding, width, height,
+                                             [&](const MutableImageView& interior) {
+        std::string error;
+        if (!detail::jpeg_decode(data, size, header, options.scale_denom, interior, options.exec, error)) {
+            stbi__err("bad JPEG", "Corrupt JPEG data");
+            return false;
+        }
+        return true;
+    });
 }
 
-LoadedImage::LoadedImage(unsigned char* data, int width, int height, int channels)
+// 8-bit loads: in-tree decoders first, then stb
+LoadedImage load_8bit(const unsigned char* data, size_t size, const Padding& padding,
+                      const DecodeOptions& options, int& width, int& height, int& channels) {
+    if (detail::is_qoi(data, size)) {
+        return decode_qoi(data, size, padding, width, height, channels);
+    }
+    // 8-bit netpbm (including PAM, which stb cannot read); 16-bit PGM/PPM goes to stb
+    detail::PnmHeader pnm;
+    if (detail::is_pnm(data, size) && detail::pnm_read_header(data, size, pnm) && pnm.maxval <= 255) {
+        return decode_pnm<unsigned char>(pnm, data, size, padding, width, height, channels);
+    }
+    // 8-bit, non-interlaced PNGs; stb keeps the rest, which the header parser rejects
+    detail::PngHeader png;
+    if (!options.use_stb && detail::is_png(data, size) && detail::png_read_header(data, size, png)) {
+        return decode_png(png, data, size, padding, width, height, channels);
+    }
+    // Gray and three-component Huffman JPEGs; stb keeps CMYK, 12-bit and
+    // arithmetic-coded files, which the header parser rejects
+    detail::JpegHeader jpeg;
+    std::string error;
+    if (!options.use_stb && size >= 2 && data[0] == 0xff && data[1] == 0xd8 &&
+        detail::jpeg_read_header(data, size, jpeg, error)) {
+        return decode_jpeg(jpeg, data, size, padding, options, width, height, channels);
+    }
+    if (size > static_cast<size_t>(INT_MAX)) {
+        stbi__err("too large", "Encoded image is too large");
+        return LoadedImage(nullptr, 0, 0, 0);
+    }
+
+    int src_width, src_height;
+    unsigned char* img = stbi_load_from_memory(data, static_cast<int>(size), &src_width, &src_height, &channels, 0);
+    return pad_decoded(img, src_width, src_height, channels, padding, width, height);
+}
+
+// 16-bit and float loads: netpbm in-tree at full depth (16-bit only), then
+// stb's 16-bit or float loader; formats stb cannot read are decoded at 8
+// bits and widened with stb's own conversion
+template <typename T>
+BasicLoadedImage<T> load_wide(const unsigned char* data, size_t size, const Padding& padding,
+                              int& width, int& height, int& channels) {
+    if constexpr (std::is_same_v<T, uint16_t>) {
+        detail::PnmHeader pnm;
+        if (detail::is_pnm(data, size) && detail::pnm_read_header(data, size, pnm)) {
+            return decode_pnm<T>(pnm, data, size, padding, width, height, channels);
+        }
+    }
+    if (size > static_cast<size_t>(INT_MAX)) {
+        stbi__err("too large", "Encoded image is too large");
+        return BasicLoadedImage<T>(nullptr, 0, 0, 0);
+    }
+
+    int src_width, src_height;
+    if (!stbi_info_from_memory(data, static_cast<int>(size), &src_width, &src_height, &channels)) {
+        LoadedImage narrow = load_8bit(data, size, Padding{}, DecodeOptions{}, src_width, src_height, channels);
+        if (!narrow.get()) {
+            return BasicLoadedImage<T>(nullptr, 0, 0, 0);
+        }
+        T* wide;
+        if constexpr (std::is_same_v<T, uint16_t>) {
+            wide = stbi__convert_8_to_16(narrow.release(), src_width, src_height, channels);
+        } else {
+            wide = stbi__ldr_to_hdr(narrow.release(), src_width, src_height, channels);
+        }
+        return pad_decoded(wide, src_width, src_height, channels, padding, width, height);
+    }
+
+    T* img;
+    if constexpr (std::is_same_v<T, uint16_t>) {
+        img = stbi_load_16_from_memory(data, static_cast<int>(size), &src_width, &src_height, &channels, 0);
+    } else {
+        img = stbi_loadf_from_memory(data, static_cast<int>(size), &src_width, &src_height, &channels, 0);
+    }
+    return pad_decoded(img, src_width, src_height, channels, padding, width, height);
+}
+
+} // namespace
+
+template <typename T>
+BasicLoadedImage<T> BasicLoadedImage<T>::load_padded(const char* path, const Padding& padding,
+                                                     int& width, int& height, int& channels) {
+    return load_padded(path, padding, DecodeOptions{}, width, height, channels);
+}
+
+template <typename T>
+BasicLoadedImage<T> BasicLoadedImage<T>::load_padded(const char* path, const Padding& padding,
+                                                     const DecodeOptions& options, int& width, int& height,
+                                                     int& channels) {
+    if (!valid_padding(padding)) {
+        return BasicLoadedImage(nullptr, 0, 0, 0);
+    }
+
+    // Decode from the page cache via mmap instead of stdio reads
+    detail::MappedFile file = detail::MappedFile::open(path);
+    if (!file.ok()) {
+        stbi__err("can't fopen", "Unable to open file");
+        return BasicLoadedImage(nullptr, 0, 0, 0);
+    }
+    return load_padded_from_memory(file.data(), file.size(), padding, options, width, height, channels);
+}
+
+template <typename T>
+BasicLoadedImage<T> BasicLoadedImage<T>::load_from_memory(const unsigned char* data, size_t size,
+                                                          int& width, int& height, int& channels) {
+    return load_padded_from_memory(data, size, Padding{}, width, height, channels);
+}
+
+template <typename T>
+BasicLoadedImage<T> BasicLoadedImage<T>::load_padded_from_memory(const unsigned char* data, size_t size,
+                                                                 const Padding& padding, int& width,
+                                                                 int& height, int& channels) {
+    return load_padded_from_memory(data, size, padding, DecodeOptions{}, width, height, channels);
+}
+
+template <typename T>
+BasicLoadedImage<T> BasicLoadedImage<T>::load_padded_from_memory(const unsigned char* data, size_t size,
+                                                                 const Padding& padding,
+                                                                 const DecodeOptions& options, int& width,
+                                                                 int& height, int& channels) {
+    if (!valid_padding(padding)) {
+        return BasicLoadedImage(nullptr, 0, 0, 0);
+    }
+    if constexpr (std::is_same_v<T, unsigned char>) {
+        return load_8bit(data, size, padding, options, width, height, channels);
+    } else {
+        return load_wide<T>(data, size, padding, width, height, channels);
+    }
+}
+
+template <typename T>
+BasicLoadedImage<T>::BasicLoadedImage(T* data, int width, int height, int channels)
     : data_(data)
     , width_(width)
     , height_(height)
     , channels_(channels) {
 }
 
-LoadedImage::~LoadedImage() {
+template <typename T>
+BasicLoadedImage<T>::~BasicLoadedImage() {
     if (data_) {
         stbi_image_free(data_);
     }
 }
 
-LoadedImage::LoadedImage(LoadedImage&& other) noexcept
+template <typename T>
+BasicLoadedImage<T>::BasicLoadedImage(BasicLoadedImage&& other) noexcept
     : data_(other.data_)
     , width_(other.width_)
     , height_(other.height_)
@@ -86,7 +376,8 @@ LoadedImage::LoadedImage(LoadedImage&& other) noexcept
     other.channels_ = 0;
 }
 
-LoadedImage& LoadedImage::operator=(LoadedImage&& other) noexcept {
+template <typename T>
+BasicLoadedImage<T>& BasicLoadedImage<T>::operator=(BasicLoadedImage&& other) noexcept {
     if (this != &other) {
         if (data_) {
             stbi_image_free(data_);
@@ -105,8 +396,9 @@ LoadedImage& LoadedImage::operator=(LoadedImage&& other) noexcept {
     return *this;
 }
 
-unsigned char* LoadedImage::release() {
-    unsigned char* ptr = data_;
+template <typename T>
+T* BasicLoadedImage<T>::release() {
+    T* ptr = data_;
     data_ = nullptr;
     width_ = 0;
     height_ = 0;
@@ -114,4 +406,8 @@ unsigned char* LoadedImage::release() {
     return ptr;
 }
 
+template class BasicLoadedImage<unsigned char>;
+template class BasicLoadedImage<uint16_t>;
+template class BasicLoadedImage<float>;
+
 } // namespace vanity
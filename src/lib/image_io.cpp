@@ -2,8 +2,18 @@
 #include "stb_image_write.h"
 
 #include "vanity/image_io.hpp"
+#include "vanity/image_sink.hpp"
+#include "jpeg_border.hpp"
+#include "jpeg_writer.hpp"
+#include "png_writer.hpp"
+#include "pnm.hpp"
+#include "qoi.hpp"
+#include "stb_image.h"
 #include <algorithm>
 #include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstring>
 
 namespace vanity {
 
@@ -19,6 +29,14 @@ ImageFormat detect_format(const std::string& path) {
         return ImageFormat::JPG;
     } else if (lower_path.ends_with(".bmp")) {
         return ImageFormat::BMP;
+    } else if (lower_path.ends_with(".qoi")) {
+        return ImageFormat::QOI;
+    } else if (lower_path.ends_with(".ppm") || lower_path.ends_with(".pgm")) {
+        return ImageFormat::PPM;
+    } else if (lower_path.ends_with(".pam")) {
+        return ImageFormat::PAM;
+    } else if (lower_path.ends_with(".hdr")) {
+        return ImageFormat::HDR;
     }
 
     return ImageFormat::UNKNOWN;
@@ -27,22 +45,306 @@ ImageFormat detect_format(const std::string& path) {
 bool write_image(const char* path, int width, int height, int channels,
                  const unsigned char* data, int quality) {
     ImageFormat format = detect_format(path);
+    if (format == ImageFormat::UNKNOWN) {
+        return false;
+    }
+
+    // A failed encode leaves the sink unclosed, which discards the partial file
+    FileSink sink(path);
+    if (!sink.ok() || !write_image(sink, format, width, height, channels, data, quality)) {
+        return false;
+    }
+    return sink.close();
+}
+
+namespace {
+
+// stb reports output through a void callback; remember whether the sink failed
+struct SinkContext {
+    ImageSink* sink;
+    bool ok;
+};
+
+void write_to_sink(void* context, void* data, int size) {
+    auto* ctx = static_cast<SinkContext*>(context);
+    if (ctx->ok) {
+        ctx->ok = ctx->sink->write(data, static_cast<size_t>(size));
+    }
+}
+
+} // namespace
+
+bool write_image(ImageSink& sink, ImageFormat format, int width, int height, int channels,
+                 const unsigned char* data, int quality) {
+    SinkContext ctx{&sink, true};
+    int encoded = 0;
 
     switch (format) {
         case ImageFormat::PNG:
-            return stbi_write_png(path, width, height, channels, data, width * channels) != 0;
+            return detail::png_encode(ImageView(data, width, height, channels), sink, WriteOptions{quality}) &&
+                   sink.flush();
 
-        case ImageFormat::JPG:
-            return stbi_write_jpg(path, width, height, channels, data, quality) != 0;
+        case ImageFormat::JPG: {
+            WriteOptions options;
+            options.quality = quality;
+            return detail::jpeg_encode(ImageView(data, width, height, channels), sink, options) && sink.flush();
+        }
 
         case ImageFormat::BMP:
-            return stbi_write_bmp(path, width, height, channels, data) != 0;
+            encoded = stbi_write_bmp_to_func(write_to_sink, &ctx, width, height, channels, data);
+            break;
+
+        case ImageFormat::QOI:
+            return detail::qoi_encode(ImageView(data, width, height, channels), sink) && sink.flush();
+
+        case ImageFormat::PPM:
+        case ImageFormat::PAM:
+            return detail::pnm_encode(ImageView(data, width, height, channels), sink,
+                                      format == ImageFormat::PAM) && sink.flush();
 
+        // HDR holds float samples; see the ImageViewF overload
+        case ImageFormat::HDR:
         case ImageFormat::UNKNOWN:
             return false;
     }
 
+    return encoded != 0 && ctx.ok && sink.flush();
+}
+
+bool write_image(ImageSink& sink, const ImageView& image, ImageFormat format,
+                 const WriteOptions& options) {
+    if (image.empty()) {
+        return false;
+    }
+
+    // PNG, JPEG, QOI and netpbm take a row stride directly; BMP needs packed rows
+    if (format == ImageFormat::PNG) {
+        return detail::png_encode(image, sink, options) && sink.flush();
+    }
+    if (format == ImageFormat::JPG) {
+        return detail::jpeg_encode(image, sink, options) && sink.flush();
+    }
+    if (format == ImageFormat::QOI) {
+        return detail::qoi_encode(image, sink) && sink.flush();
+    }
+    if (format == ImageFormat::PPM || format == ImageFormat::PAM) {
+        return detail::pnm_encode(image, sink, format == ImageFormat::PAM) && sink.flush();
+    }
+    if (format == ImageFormat::HDR) {
+        return false;
+    }
+    if (!image.is_contiguous()) {
+        ImageBuffer packed(image.width(), image.height(), image.channels());
+        for (int y = 0; y < image.height(); y++) {
+            std::memcpy(packed.view().row(y), image.row(y), image.row_bytes());
+        }
+        return write_image(sink, format, image.width(), image.height(), image.channels(),
+                           packed.get(), options.quality);
+    }
+    return write_image(sink, format, image.width(), image.height(), image.channels(),
+                       image.data(), options.quality);
+}
+
+std::vector<std::byte> encode_to_memory(const ImageView& image, ImageFormat format,
+                                        const WriteOptions& options) {
+    std::vector<std::byte> out;
+    if (!encode_to_memory(image, format, options, out)) {
+        out.clear();
+    }
+    return out;
+}
+
+bool encode_to_memory(const ImageView& image, ImageFormat format, const WriteOptions& options,
+                      std::vector<std::byte>& out) {
+    out.clear();
+    MemorySink sink(out);
+    return write_image(sink, image, format, options);
+}
+
+bool supports_16_bit(ImageFormat format) {
+    return format == ImageFormat::PNG || format == ImageFormat::PPM || format == ImageFormat::PAM;
+}
+
+bool write_image(ImageSink& sink, const ImageView16& image, ImageFormat format,
+                 const WriteOptions& options) {
+    if (image.empty() || !supports_16_bit(format)) {
+        return false;
+    }
+    if (format == ImageFormat::PNG) {
+        return detail::png_encode(image, sink, options) && sink.flush();
+    }
+    return detail::pnm_encode(image, sink, format == ImageFormat::PAM) && sink.flush();
+}
+
+bool write_image(ImageSink& sink, const ImageViewF& image, ImageFormat format,
+                 const WriteOptions& /*options*/) {
+    if (image.empty() || format != ImageFormat::HDR) {
+        return false;
+    }
+
+    // stb's HDR writer needs packed rows
+    BasicImageBuffer<float> packed(0, 0, 0);
+    const float* pixels = image.data();
+    if (!image.is_contiguous()) {
+        packed = BasicImageBuffer<float>(image.width(), image.height(), image.channels());
+        for (int y = 0; y < image.height(); y++) {
+            std::memcpy(packed.view().row(y), image.row(y), image.row_bytes());
+        }
+        pixels = packed.get();
+    }
+    SinkContext ctx{&sink, true};
+    int encoded = stbi_write_hdr_to_func(write_to_sink, &ctx, image.width(), image.height(), image.channels(),
+                                         pixels);
+    return encoded != 0 && ctx.ok && sink.flush();
+}
+
+namespace {
+
+template <typename T>
+bool encode_view(const BasicImageView<T>& image, ImageFormat format, const WriteOptions& options,
+                 std::vector<std::byte>& out) {
+    out.clear();
+    MemorySink sink(out);
+    return write_image(sink, image, format, options);
+}
+
+template <typename T>
+std::vector<std::byte> encode_view(const BasicImageView<T>& image, ImageFormat format,
+                                   const WriteOptions& options) {
+    std::vector<std::byte> out;
+    if (!encode_view(image, format, options, out)) {
+        out.clear();
+    }
+    return out;
+}
+
+} // namespace
+
+std::vector<std::byte> encode_to_memory(const ImageView16& image, ImageFormat format,
+                                        const WriteOptions& options) {
+    return encode_view(image, format, options);
+}
+
+std::vector<std::byte> encode_to_memory(const ImageViewF& image, ImageFormat format,
+                                        const WriteOptions& options) {
+    return encode_view(image, format, options);
+}
+
+bool encode_to_memory(const ImageView16& image, ImageFormat format, const WriteOptions& options,
+                      std::vector<std::byte>& out) {
+    return encode_view(image, format, options, out);
+}
+
+bool encode_to_memory(const ImageViewF& image, ImageFormat format, const WriteOptions& options,
+                      std::vector<std::byte>& out) {
+    return encode_view(image, format, options, out);
+}
+
+LoadedImage decode_from_memory(std::span<const std::byte> bytes) {
+    int width, height, channels;
+    return LoadedImage::load_from_memory(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size(),
+                                         width, height, channels);
+}
+
+LoadedImage decode_from_memory(std::span<const std::byte> bytes, const DecodeOptions& options) {
+    int width, height, channels;
+    return LoadedImage::load_padded_from_memory(reinterpret_cast<const unsigned char*>(bytes.data()),
+                                                bytes.size(), Padding{}, options, width, height, channels);
+}
+
+namespace {
+
+// Header fields of the formats stb does not know (QOI and netpbm)
+// Returns false with `known` cleared if the bytes are neither
+bool probe_own_format(const unsigned char* header, size_t size, ImageInfo& out, bool& known) {
+    known = true;
+    if (detail::is_qoi(header, size)) {
+        out.bits_per_channel = 8;
+        return detail::qoi_read_header(header, size, out.width, out.height, out.channels);
+    }
+    if (detail::is_pnm(header, size)) {
+        detail::PnmHeader pnm;
+        if (!detail::pnm_read_header(header, size, pnm)) {
+            return false;
+        }
+        out.width = pnm.width;
+        out.height = pnm.height;
+        out.channels = pnm.channels;
+        out.bits_per_channel = pnm.maxval > 255 ? 16 : 8;
+        return true;
+    }
+    known = false;
     return false;
 }
 
+} // namespace
+
+bool probe_image(const char* path, ImageInfo& out) {
+    out = ImageInfo{};
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    // QOI headers are short, but netpbm headers may carry any number of
+    // comment lines, so the read grows until the header parses or the file ends
+    std::vector<unsigned char> header(512);
+    size_t header_size = std::fread(header.data(), 1, header.size(), file);
+    detail::PnmHeader pnm;
+    while (header_size == header.size() && detail::is_pnm(header.data(), header_size) &&
+           !detail::pnm_read_header(header.data(), header_size, pnm)) {
+        header.resize(header.size() * 2);
+        header_size += std::fread(header.data() + header_size, 1, header.size() - header_size, file);
+    }
+    std::rewind(file);
+
+    bool known;
+    bool ok = probe_own_format(header.data(), header_size, out, known);
+    if (!known && stbi_info_from_file(file, &out.width, &out.height, &out.channels)) {
+        // One open for all three queries; each stbi_*_from_file call rewinds
+        // to where it started, and none of them touch more than the header
+        ok = true;
+        out.is_hdr = stbi_is_hdr_from_file(file) != 0;
+        out.bits_per_channel = out.is_hdr ? 32 : stbi_is_16_bit_from_file(file) ? 16 : 8;
+    }
+    if (ok) {
+        if (std::fseek(file, 0, SEEK_END) == 0) {
+            long size = std::ftell(file);
+            out.file_size = size > 0 ? static_cast<size_t>(size) : 0;
+        }
+    }
+    std::fclose(file);
+    return ok;
+}
+
+bool probe_image(std::span<const std::byte> bytes, ImageInfo& out) {
+    out = ImageInfo{};
+    const auto* data = reinterpret_cast<const unsigned char*>(bytes.data());
+    bool known;
+    bool ok = probe_own_format(data, bytes.size(), out, known);
+    if (!known && bytes.size() <= static_cast<size_t>(INT_MAX)) {
+        int size = static_cast<int>(bytes.size());
+        if (stbi_info_from_memory(data, size, &out.width, &out.height, &out.channels)) {
+            ok = true;
+            out.is_hdr = stbi_is_hdr_from_memory(data, size) != 0;
+            out.bits_per_channel = out.is_hdr ? 32 : stbi_is_16_bit_from_memory(data, size) ? 16 : 8;
+        }
+    }
+    if (ok) {
+        out.file_size = bytes.size();
+    }
+    return ok;
+}
+
+bool probe_jpeg_blocks(std::span<const std::byte> jpeg, JpegBlockLayout& out) {
+    return detail::jpeg_probe_blocks(reinterpret_cast<const unsigned char*>(jpeg.data()), jpeg.size(), out);
+}
+
+bool add_borders_jpeg(std::span<const std::byte> jpeg, std::span<const BorderSpec> rings, ImageSink& sink,
+                      const ExecutionOptions& exec) {
+    return detail::jpeg_add_borders(reinterpret_cast<const unsigned char*>(jpeg.data()), jpeg.size(), rings, sink,
+                                    exec) &&
+           sink.flush();
+}
+
 } // namespace vanity
@@ -1,50 +1,240 @@
 #include "vanity/image_ops.hpp"
+#include "pixel_kernels.hpp"
+#include "ring_compositor.hpp"
+#include "vanity/thread_pool.hpp"
+#include <algorithm>
 #include <cstring>
 
 namespace vanity {
 
+namespace {
+
+void fill_pattern(unsigned char* dst, size_t count, const unsigned char* pixel, int channels) {
+    detail::pixel_kernels().fill_pattern(dst, count, pixel, channels);
+}
+
+void copy_row(unsigned char* dst, const unsigned char* src, size_t bytes) {
+    detail::pixel_kernels().copy_row(dst, src, bytes);
+}
+
+bool valid_rings(std::span<const BorderSpec> rings) {
+    for (const BorderSpec& ring : rings) {
+        if (ring.width < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int total_ring_width(std::span<const BorderSpec> rings) {
+    int total = 0;
+    for (const BorderSpec& ring : rings) {
+        total += ring.width;
+    }
+    return total;
+}
+
+// Rows per band never drop below this, so bands stay large enough to amortize scheduling
+constexpr int kMinBandRows = 16;
+
+// Call fn(y_begin, y_end) over all rows of dst: in row bands on the pool when
+// one is given and dst is large enough, otherwise once on the calling thread
+template <typename T, typename Fn>
+void for_each_row_band(const BasicMutableImageView<T>& dst, const ExecutionOptions& exec, Fn&& fn) {
+    size_t bytes = dst.row_bytes() * static_cast<size_t>(dst.height());
+    if (!exec.pool || exec.pool->size() < 2 || bytes < exec.parallel_threshold) {
+        fn(0, dst.height());
+        return;
+    }
+
+    // A few bands per thread keeps the load balanced when band costs differ
+    // (pure border bands are cheaper than interior rows)
+    size_t bands = static_cast<size_t>(exec.pool->size()) * 4;
+    size_t rows = std::max<size_t>(kMinBandRows, (dst.height() + bands - 1) / bands);
+    exec.pool->parallel_for(dst.height(), rows, [&](size_t begin, size_t end) {
+        fn(static_cast<int>(begin), static_cast<int>(end));
+    });
+}
+
+// View operations for every sample type; rows are filled and copied as
+// bytes, so wider samples run through the same kernels as 8-bit ones
+
+template <typename T>
+void fill_view(const BasicMutableImageView<T>& dst, const unsigned char color[4], const ExecutionOptions& exec) {
+    if (dst.empty()) {
+        return;
+    }
+    const unsigned char* pixel = color;
+    unsigned char widened[4 * sizeof(T)];
+    if constexpr (sizeof(T) > 1) {
+        detail::widen_color<T>(color, dst.channels(), widened);
+        pixel = widened;
+    }
+    int pixel_bytes = dst.channels() * static_cast<int>(sizeof(T));
+    auto* bytes = reinterpret_cast<unsigned char*>(dst.data());
+    if (dst.is_contiguous() && !exec.pool) {
+        fill_pattern(bytes, static_cast<size_t>(dst.width()) * dst.height(), pixel, pixel_bytes);
+        return;
+    }
+    for_each_row_band(dst, exec, [&](int y_begin, int y_end) {
+        auto* first = reinterpret_cast<unsigned char*>(dst.row(y_begin));
+        fill_pattern(first, dst.width(), pixel, pixel_bytes);
+        for (int y = y_begin + 1; y < y_end; y++) {
+            copy_row(reinterpret_cast<unsigned char*>(dst.row(y)), first, dst.row_bytes());
+        }
+    });
+}
+
+template <typename T>
+bool add_borders_view(const BasicImageView<T>& src, const BasicMutableImageView<T>& dst,
+                      std::span<const BorderSpec> rings, const ExecutionOptions& exec) {
+    // Validate parameters
+    if (src.empty() || dst.empty() || src.channels() != dst.channels() || !valid_rings(rings)) {
+        return false;
+    }
+
+    int new_width, new_height;
+    calculate_bordered_dimensions(src.width(), src.height(), rings, new_width, new_height);
+    if (dst.width() != new_width || dst.height() != new_height) {
+        return false;
+    }
+
+    for_each_row_band(dst, exec, [&](int y_begin, int y_end) {
+        detail::compose_rings(src, dst, rings, y_begin, y_end);
+    });
+    return true;
+}
+
+template <typename T>
+bool paint_borders_view(const BasicMutableImageView<T>& image, std::span<const BorderSpec> rings,
+                        const ExecutionOptions& exec) {
+    if (image.empty() || !valid_rings(rings)) {
+        return false;
+    }
+
+    int total = total_ring_width(rings);
+    if (2 * total >= image.width() || 2 * total >= image.height()) {
+        return false;
+    }
+
+    for_each_row_band(image, exec, [&](int y_begin, int y_end) {
+        detail::compose_rings(BasicImageView<T>(), image, rings, y_begin, y_end);
+    });
+    return true;
+}
+
+} // namespace
+
 void calculate_bordered_dimensions(int src_width, int src_height, int border_width,
                                    int& out_width, int& out_height) {
     out_width = src_width + 2 * border_width;
     out_height = src_height + 2 * border_width;
 }
 
+void calculate_bordered_dimensions(int src_width, int src_height, std::span<const BorderSpec> rings,
+                                   int& out_width, int& out_height) {
+    calculate_bordered_dimensions(src_width, src_height, total_ring_width(rings), out_width, out_height);
+}
+
 void fill_buffer(unsigned char* buffer, size_t size, unsigned char value) {
     std::memset(buffer, value, size);
 }
 
+void fill_buffer(const MutableImageView& dst, const unsigned char color[4],
+                 const ExecutionOptions& exec) {
+    fill_view(dst, color, exec);
+}
+
+void fill_buffer(const MutableImageView16& dst, const unsigned char color[4],
+                 const ExecutionOptions& exec) {
+    if (dst.channels() <= 4) {
+        fill_view(dst, color, exec);
+    }
+}
+
+void fill_buffer(const MutableImageViewF& dst, const unsigned char color[4],
+                 const ExecutionOptions& exec) {
+    if (dst.channels() <= 4) {
+        fill_view(dst, color, exec);
+    }
+}
+
 bool add_border(const unsigned char* src, int src_width, int src_height, int channels,
                 unsigned char* dst, int border_width, const unsigned char border_color[4]) {
+    BorderSpec ring{border_width, {border_color[0], border_color[1], border_color[2], border_color[3]}};
+    return add_borders(src, src_width, src_height, channels, dst, std::span<const BorderSpec>(&ring, 1));
+}
+
+bool add_border(const ImageView& src, const MutableImageView& dst,
+                int border_width, const unsigned char border_color[4],
+                const ExecutionOptions& exec) {
+    BorderSpec ring{border_width, {border_color[0], border_color[1], border_color[2], border_color[3]}};
+    return add_borders(src, dst, std::span<const BorderSpec>(&ring, 1), exec);
+}
+
+bool add_border(const ImageView16& src, const MutableImageView16& dst,
+                int border_width, const unsigned char border_color[4],
+                const ExecutionOptions& exec) {
+    BorderSpec ring{border_width, {border_color[0], border_color[1], border_color[2], border_color[3]}};
+    return add_borders(src, dst, std::span<const BorderSpec>(&ring, 1), exec);
+}
+
+bool add_border(const ImageViewF& src, const MutableImageViewF& dst,
+                int border_width, const unsigned char border_color[4],
+                const ExecutionOptions& exec) {
+    BorderSpec ring{border_width, {border_color[0], border_color[1], border_color[2], border_color[3]}};
+    return add_borders(src, dst, std::span<const BorderSpec>(&ring, 1), exec);
+}
+
+bool add_borders(const unsigned char* src, int src_width, int src_height, int channels,
+                 unsigned char* dst, std::span<const BorderSpec> rings) {
     // Validate parameters
-    if (!src || !dst || border_width < 0 || src_width <= 0 || src_height <= 0 || channels <= 0) {
+    if (!src || !dst || src_width <= 0 || src_height <= 0 || channels <= 0 || !valid_rings(rings)) {
         return false;
     }
 
-    // Calculate new dimensions
-    int new_width = src_width + 2 * border_width;
-    int new_height = src_height + 2 * border_width;
+    int new_width, new_height;
+    calculate_bordered_dimensions(src_width, src_height, rings, new_width, new_height);
+    return add_borders(ImageView(src, src_width, src_height, channels),
+                       MutableImageView(dst, new_width, new_height, channels), rings);
+}
 
-    // Fill destination buffer with border color
-    size_t new_size = static_cast<size_t>(new_width) * new_height * channels;
-    for (size_t i = 0; i < new_size; i += channels) {
-        for (int c = 0; c < channels; c++) {
-            dst[i + c] = border_color[c];
-        }
-    }
+bool add_borders(const ImageView& src, const MutableImageView& dst,
+                 std::span<const BorderSpec> rings, const ExecutionOptions& exec) {
+    return add_borders_view(src, dst, rings, exec);
+}
 
-    // Copy original image to center of new image
-    for (int y = 0; y < src_height; y++) {
-        for (int x = 0; x < src_width; x++) {
-            int src_idx = (y * src_width + x) * channels;
-            int dst_idx = ((y + border_width) * new_width + (x + border_width)) * channels;
+bool add_borders(const ImageView16& src, const MutableImageView16& dst,
+                 std::span<const BorderSpec> rings, const ExecutionOptions& exec) {
+    return dst.channels() <= 4 && add_borders_view(src, dst, rings, exec);
+}
 
-            for (int c = 0; c < channels; c++) {
-                dst[dst_idx + c] = src[src_idx + c];
-            }
-        }
+bool add_borders(const ImageViewF& src, const MutableImageViewF& dst,
+                 std::span<const BorderSpec> rings, const ExecutionOptions& exec) {
+    return dst.channels() <= 4 && add_borders_view(src, dst, rings, exec);
+}
+
+bool paint_borders(unsigned char* image, int width, int height, int channels,
+                   std::span<const BorderSpec> rings) {
+    if (!image) {
+        return false;
     }
+    return paint_borders(MutableImageView(image, width, height, channels), rings);
+}
 
-    return true;
+bool paint_borders(const MutableImageView& image, std::span<const BorderSpec> rings,
+                   const ExecutionOptions& exec) {
+    return paint_borders_view(image, rings, exec);
+}
+
+bool paint_borders(const MutableImageView16& image, std::span<const BorderSpec> rings,
+                   const ExecutionOptions& exec) {
+    return image.channels() <= 4 && paint_borders_view(image, rings, exec);
+}
+
+bool paint_borders(const MutableImageViewF& image, std::span<const BorderSpec> rings,
+                   const ExecutionOptions& exec) {
+    return image.channels() <= 4 && paint_borders_view(image, rings, exec);
 }
 
 } // namespace vanity
@@ -0,0 +1,165 @@
+#include "vanity/image_sink.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vanity {
+
+namespace {
+
+// Alignment of FdSink buffers (a page, which also suits O_DIRECT-style consumers)
+constexpr size_t kSinkAlignment = 4096;
+
+// Create a uniquely named file beside path for FileSink to write, with the
+// permissions of the file it will replace
+int open_temporary(const std::string& path, std::string& temp_path) {
+    static std::atomic<unsigned> counter{0};
+    struct stat st{};
+    bool replaces = ::stat(path.c_str(), &st) == 0;
+    for (int attempt = 0; attempt < 16; attempt++) {
+        temp_path = path + ".tmp-" + std::to_string(::getpid()) + "-" + std::to_string(counter++);
+        int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+        if (fd >= 0) {
+            if (replaces) {
+                ::fchmod(fd, st.st_mode & 07777);
+            }
+            return fd;
+        }
+        if (errno != EEXIST) {
+            break;
+        }
+    }
+    temp_path.clear();
+    return -1;
+}
+
+} // namespace
+
+// FdSink implementation
+
+FdSink::FdSink(int fd, size_t buffer_size)
+    : fd_(fd) {
+    if (buffer_size > 0) {
+        size_t rounded = (buffer_size + kSinkAlignment - 1) / kSinkAlignment * kSinkAlignment;
+        buffer_ = static_cast<unsigned char*>(std::aligned_alloc(kSinkAlignment, rounded));
+        capacity_ = buffer_ ? rounded : 0;
+    }
+}
+
+FdSink::~FdSink() {
+    flush();
+    std::free(buffer_);
+}
+
+bool FdSink::write_through(const unsigned char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd_, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed_ = true;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool FdSink::write(const void* data, size_t size) {
+    if (failed_ || fd_ < 0) {
+        return false;
+    }
+    const auto* bytes = static_cast<const unsigned char*>(data);
+
+    // Small writes are coalesced; anything at least a buffer long goes straight through
+    if (used_ + size <= capacity_) {
+        std::memcpy(buffer_ + used_, bytes, size);
+        used_ += size;
+        return true;
+    }
+    if (!flush()) {
+        return false;
+    }
+    if (size >= capacity_) {
+        return write_through(bytes, size);
+    }
+    std::memcpy(buffer_, bytes, size);
+    used_ = size;
+    return true;
+}
+
+bool FdSink::flush() {
+    if (failed_ || fd_ < 0) {
+        return false;
+    }
+    size_t pending = used_;
+    used_ = 0;
+    return write_through(buffer_, pending);
+}
+
+// FileSink implementation
+
+FileSink::FileSink(const char* path, size_t buffer_size)
+    : FdSink(-1, buffer_size), path_(path) {
+    // Anything but a regular file (or nothing) is written in place, as is a
+    // path whose directory does not let us create the temporary file
+    struct stat st{};
+    if (::lstat(path, &st) != 0 || S_ISREG(st.st_mode)) {
+        fd_ = open_temporary(path_, temp_path_);
+    }
+    if (fd_ < 0) {
+        fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    }
+}
+
+FileSink::~FileSink() {
+    if (temp_path_.empty()) {
+        close();
+        return;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    ::unlink(temp_path_.c_str());
+}
+
+bool FileSink::close() {
+    if (fd_ < 0) {
+        return false;
+    }
+    bool ok = flush();
+    if (::close(fd_) != 0) {
+        ok = false;
+    }
+    fd_ = -1;
+    if (!temp_path_.empty()) {
+        if (ok && ::rename(temp_path_.c_str(), path_.c_str()) != 0) {
+            ok = false;
+        }
+        if (!ok) {
+            ::unlink(temp_path_.c_str());
+        }
+        temp_path_.clear();
+    }
+    return ok;
+}
+
+// CallbackSink implementation
+
+bool CallbackSink::write(const void* data, size_t size) {
+    if (failed_) {
+        return false;
+    }
+    failed_ = !callback_(data, size);
+    return !failed_;
+}
+
+} // namespace vanity
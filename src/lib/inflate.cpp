@@ -0,0 +1,522 @@
+#include "inflate.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+namespace vanity::detail {
+
+namespace {
+
+// Codes up to this long are decoded with a single table lookup
+constexpr int kFastBits = 11;
+constexpr uint32_t kFastMask = (1u << kFastBits) - 1;
+
+// Base values and extra bit counts of the length and distance symbols (RFC 1951 3.2.5)
+constexpr uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                      2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t kDistanceBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,    49,    65,    97,    129,
+                                        193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                        6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Order in which the code length code lengths are stored
+constexpr uint8_t kCodeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// A table entry holds the code bits to consume (bits 0-5, so that x86
+// shifts the bit buffer by the entry without masking it first), its kind
+// (bits 8-10), an extra bit count (bits 11-15), and a payload in bits
+// 16-31: one or two literals (low byte first), or a base value
+enum EntryKind : uint32_t {
+    kInvalid = 0,
+    kLiteral = 1,       // also a code length or distance symbol
+    kLiteralPair = 2,
+    kBaseExtra = 3,     // a match length, or a distance
+    kEndOfBlock = 4,
+    kLongCode = 5,      // longer than kFastBits: decode canonically
+};
+
+constexpr uint32_t make_entry(uint32_t bits, EntryKind kind, uint32_t payload = 0, uint32_t extra = 0) {
+    return bits | kind << 8 | extra << 11 | payload << 16;
+}
+
+inline uint32_t entry_bits(uint32_t entry) { return entry & 63; }
+inline uint32_t entry_kind(uint32_t entry) { return (entry >> 8) & 7; }
+inline uint32_t entry_extra(uint32_t entry) { return (entry >> 11) & 31; }
+inline uint32_t entry_payload(uint32_t entry) { return entry >> 16; }
+
+enum class Alphabet { CodeLength, LiteralLength, Distance };
+
+uint32_t symbol_entry(Alphabet alphabet, int symbol, int bits) {
+    switch (alphabet) {
+        case Alphabet::CodeLength:
+            return make_entry(bits, kLiteral, symbol);
+        case Alphabet::LiteralLength:
+            if (symbol < 256) {
+                return make_entry(bits, kLiteral, symbol);
+            }
+            if (symbol == 256) {
+                return make_entry(bits, kEndOfBlock);
+            }
+            if (symbol <= 285) {
+                return make_entry(bits, kBaseExtra, kLengthBase[symbol - 257], kLengthExtra[symbol - 257]);
+            }
+            break;
+        case Alphabet::Distance:
+            if (symbol < 30) {
+                return make_entry(bits, kBaseExtra, kDistanceBase[symbol], kDistanceExtra[symbol]);
+            }
+            break;
+    }
+    return make_entry(bits, kInvalid);
+}
+
+// Decoding tables for one Huffman code
+struct Huffman {
+    Alphabet alphabet = Alphabet::CodeLength;
+    uint32_t fast[1 << kFastBits];
+    uint16_t count[16];         // codes of each length
+    uint16_t symbols[288];      // ordered by code length, then symbol
+
+    // Returns false for an over-subscribed code; incomplete codes are
+    // allowed (a single distance code is common) and leave invalid entries
+    bool build(const uint8_t* lengths, int n, Alphabet kind) {
+        alphabet = kind;
+        std::fill(std::begin(count), std::end(count), 0);
+        for (int s = 0; s < n; s++) {
+            count[lengths[s]]++;
+        }
+        count[0] = 0;
+        int left = 1;
+        uint16_t offsets[16];
+        offsets[1] = 0;
+        for (int length = 1; length < 16; length++) {
+            left = (left << 1) - count[length];
+            if (left < 0) {
+                return false;
+            }
+            if (length < 15) {
+                offsets[length + 1] = static_cast<uint16_t>(offsets[length] + count[length]);
+            }
+        }
+        uint32_t next[16];
+        uint32_t code = 0;
+        for (int length = 1; length < 16; length++) {
+            code = (code + count[length - 1]) << 1;
+            next[length] = code;
+        }
+
+        std::fill(std::begin(fast), std::end(fast), make_entry(0, kInvalid));
+        for (int s = 0; s < n; s++) {
+            int length = lengths[s];
+            if (length == 0) {
+                continue;
+            }
+            symbols[offsets[length]++] = static_cast<uint16_t>(s);
+            // Deflate packs codes starting from their most significant bit,
+            // so the table is indexed by the bit-reversed code
+            uint32_t reversed = 0;
+            for (uint32_t c = next[length]++, i = 0; i < static_cast<uint32_t>(length); i++, c >>= 1) {
+                reversed = reversed << 1 | (c & 1);
+            }
+            if (length <= kFastBits) {
+                uint32_t entry = symbol_entry(kind, s, length);
+                for (uint32_t i = reversed; i < (1u << kFastBits); i += 1u << length) {
+                    fast[i] = entry;
+                }
+            } else {
+                fast[reversed & kFastMask] = make_entry(0, kLongCode);
+            }
+        }
+
+        // Two literals whose codes fit in kFastBits together share an entry
+        if (kind == Alphabet::LiteralLength) {
+            std::array<uint32_t, 1 << kFastBits> single;
+            std::copy(std::begin(fast), std::end(fast), single.begin());
+            for (uint32_t i = 0; i < (1u << kFastBits); i++) {
+                uint32_t first = single[i];
+                uint32_t first_bits = entry_bits(first);
+                if (entry_kind(first) != kLiteral || first_bits >= static_cast<uint32_t>(kFastBits)) {
+                    continue;
+                }
+                // The remaining bits index the table correctly for any code
+                // that fits in them, since shorter codes repeat across it
+                uint32_t second = single[i >> first_bits];
+                if (entry_kind(second) == kLiteral && first_bits + entry_bits(second) <= kFastBits) {
+                    fast[i] = make_entry(first_bits + entry_bits(second), kLiteralPair,
+                                         entry_payload(first) | entry_payload(second) << 8);
+                }
+            }
+        }
+        return true;
+    }
+};
+
+const Huffman& fixed_literal_table() {
+    static const Huffman table = [] {
+        uint8_t lengths[288];
+        std::fill(lengths, lengths + 144, 8);
+        std::fill(lengths + 144, lengths + 256, 9);
+        std::fill(lengths + 256, lengths + 280, 7);
+        std::fill(lengths + 280, lengths + 288, 8);
+        Huffman h;
+        h.build(lengths, 288, Alphabet::LiteralLength);
+        return h;
+    }();
+    return table;
+}
+
+const Huffman& fixed_distance_table() {
+    static const Huffman table = [] {
+        uint8_t lengths[30];
+        std::fill(lengths, lengths + 30, 5);
+        Huffman h;
+        h.build(lengths, 30, Alphabet::Distance);
+        return h;
+    }();
+    return table;
+}
+
+// LSB-first bit buffer over the compressed input. The hot loop keeps a
+// copy in locals: its output stores are through unsigned char pointers,
+// which may alias any member, so state kept in *this would be reloaded
+// after every byte written.
+struct BitReader {
+    const unsigned char* in;
+    const unsigned char* end;
+    uint64_t bits = 0;
+    int count = 0;
+    int overrun = 0;        // zero bytes appended past the end of the input
+
+    // Top the buffer up to at least 56 bits. The fast path loads eight
+    // bytes but only counts the whole bytes that fit; the bits above the
+    // count are the next input bytes, which later refills OR in again.
+    void refill() {
+        if (std::endian::native == std::endian::little && end - in >= 8) {
+            uint64_t word;
+            std::memcpy(&word, in, 8);
+            bits |= word << count;
+            in += (63 - count) >> 3;
+            count |= 56;
+            return;
+        }
+        while (count <= 56) {
+            uint64_t byte = 0;
+            if (in < end) {
+                byte = *in++;
+            } else {
+                overrun++;
+            }
+            bits |= byte << count;
+            count += 8;
+        }
+    }
+
+    void consume(uint32_t n) {
+        bits >>= n;
+        count -= static_cast<int>(n);
+    }
+
+    uint32_t take(int n) {
+        uint32_t value = static_cast<uint32_t>(bits & ((uint64_t(1) << n) - 1));
+        consume(static_cast<uint32_t>(n));
+        return value;
+    }
+
+    // Whether zero bits past the end of the input have been consumed
+    bool truncated() const { return count < 8 * overrun; }
+};
+
+// Table entry for the code at the bottom of bits, which must hold at least
+// 15 bits; long codes are decoded canonically, one bit at a time (as in
+// zlib's puff), into an entry carrying their full length
+uint32_t lookup(const Huffman& h, uint64_t bits) {
+    uint32_t entry = h.fast[bits & kFastMask];
+    if (entry_kind(entry) != kLongCode) {
+        return entry;
+    }
+    int code = 0, first = 0, index = 0;
+    for (int length = 1; length < 16; length++) {
+        code |= static_cast<int>((bits >> (length - 1)) & 1);
+        int count = h.count[length];
+        if (code - count < first) {
+            return symbol_entry(h.alphabet, h.symbols[index + code - first], length);
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return make_entry(0, kInvalid);
+}
+
+// Copy a match of length bytes from distance bytes back, clipped to end
+unsigned char* copy_match(unsigned char* out, unsigned char* end, size_t length, size_t distance) {
+    size_t room = static_cast<size_t>(end - out);
+    length = std::min(length, room);
+    const unsigned char* src = out - distance;
+    if (distance == 1) {
+        std::memset(out, src[0], length);
+    } else if (room < length + 8) {
+        for (size_t i = 0; i < length; i++) {
+            out[i] = src[i];
+        }
+    } else if (distance >= 8) {
+        // Eight bytes at a time; each load only reads bytes already written
+        unsigned char* dst = out;
+        unsigned char* stop = out + length;
+        do {
+            std::memcpy(dst, src, 8);
+            dst += 8;
+            src += 8;
+        } while (dst < stop);
+    } else {
+        // Shorter distances (3 and 4 are common in PNG rows) repeat a
+        // pattern: write it eight bytes at a time, stepping by the largest
+        // multiple of the distance that fits
+        static constexpr size_t kStep[8] = {0, 8, 8, 6, 8, 5, 6, 7};
+        unsigned char pattern[8];
+        std::memcpy(pattern, src, distance);
+        for (size_t i = distance; i < 8; i++) {
+            pattern[i] = pattern[i - distance];
+        }
+        size_t step = kStep[distance];
+        for (size_t done = 0; done < length; done += step) {
+            std::memcpy(out + done, pattern, 8);
+        }
+    }
+    return out + length;
+}
+
+class Inflater {
+public:
+    Inflater(const unsigned char* data, size_t size, unsigned char* out, size_t out_size)
+        : input_{data, data + size}, out_begin_(out), out_(out), out_end_(out + out_size) {}
+
+    size_t written() const { return static_cast<size_t>(out_ - out_begin_); }
+
+    bool run() {
+        if (input_.end - input_.in < 2) {
+            return false;
+        }
+        int cmf = input_.in[0], flg = input_.in[1];
+        if ((cmf & 15) != 8 || (cmf >> 4) > 7 || (cmf * 256 + flg) % 31 != 0 || (flg & 0x20)) {
+            return false;
+        }
+        input_.in += 2;
+        if (out_ == out_end_) {
+            return true;
+        }
+
+        bool last = false;
+        while (!last) {
+            input_.refill();
+            last = input_.take(1) != 0;
+            Result result = kError;
+            switch (input_.take(2)) {
+                case 0:
+                    result = stored_block();
+                    break;
+                case 1:
+                    result = huffman_block(fixed_literal_table(), fixed_distance_table());
+                    break;
+                case 2:
+                    if (read_dynamic_tables()) {
+                        result = huffman_block(literals_, distances_);
+                    }
+                    break;
+                default:
+                    break;
+            }
+            if (result == kError) {
+                return false;
+            }
+            if (result == kFull) {
+                return true;
+            }
+        }
+        return true;
+    }
+
+private:
+    enum Result { kError, kBlockEnd, kFull };
+
+    Result stored_block() {
+        // Back up to the byte boundary: whole bytes still in the buffer are unread input
+        BitReader& input = input_;
+        input.take(input.count & 7);
+        int unread = input.count / 8 - input.overrun;
+        if (unread < 0) {
+            return kError;
+        }
+        const unsigned char* in = input.in - unread;
+        input = BitReader{in, input.end};
+        if (input.end - in < 4) {
+            return kError;
+        }
+        size_t length = in[0] | in[1] << 8;
+        size_t complement = in[2] | in[3] << 8;
+        in += 4;
+        if ((length ^ 0xffff) != complement || static_cast<size_t>(input.end - in) < length) {
+            return kError;
+        }
+        size_t copied = std::min(length, static_cast<size_t>(out_end_ - out_));
+        std::memcpy(out_, in, copied);
+        input.in = in + length;
+        out_ += copied;
+        return out_ == out_end_ ? kFull : kBlockEnd;
+    }
+
+    bool read_dynamic_tables() {
+        BitReader& input = input_;
+        input.refill();
+        int literal_count = static_cast<int>(input.take(5)) + 257;
+        int distance_count = static_cast<int>(input.take(5)) + 1;
+        int code_length_count = static_cast<int>(input.take(4)) + 4;
+        if (literal_count > 286 || distance_count > 30) {
+            return false;
+        }
+        uint8_t code_length_lengths[19] = {};
+        for (int i = 0; i < code_length_count; i++) {
+            input.refill();
+            code_length_lengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(input.take(3));
+        }
+        if (!code_lengths_.build(code_length_lengths, 19, Alphabet::CodeLength)) {
+            return false;
+        }
+
+        uint8_t lengths[286 + 30];
+        int total = literal_count + distance_count;
+        for (int n = 0; n < total;) {
+            input.refill();
+            uint32_t entry = lookup(code_lengths_, input.bits);
+            if (entry_kind(entry) != kLiteral) {
+                return false;
+            }
+            input.consume(entry_bits(entry));
+            int symbol = static_cast<int>(entry_payload(entry));
+            if (symbol < 16) {
+                lengths[n++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+            uint8_t value = 0;
+            int repeat;
+            if (symbol == 16) {
+                if (n == 0) {
+                    return false;
+                }
+                value = lengths[n - 1];
+                repeat = 3 + static_cast<int>(input.take(2));
+            } else if (symbol == 17) {
+                repeat = 3 + static_cast<int>(input.take(3));
+            } else {
+                repeat = 11 + static_cast<int>(input.take(7));
+            }
+            if (n + repeat > total) {
+                return false;
+            }
+            std::fill(lengths + n, lengths + n + repeat, value);
+            n += repeat;
+        }
+        if (lengths[256] == 0 || input.truncated()) {
+            return false;
+        }
+        return literals_.build(lengths, literal_count, Alphabet::LiteralLength) &&
+               distances_.build(lengths + literal_count, distance_count, Alphabet::Distance);
+    }
+
+    Result huffman_block(const Huffman& literals, const Huffman& distances) {
+        BitReader input = input_;
+        unsigned char* out = out_;
+        unsigned char* const out_end = out_end_;
+        auto finish = [&](Result result) {
+            input_ = input;
+            out_ = out;
+            return result;
+        };
+        auto full = [&] { return finish(input.truncated() ? kError : kFull); };
+
+        for (;;) {
+            // 56 bits cover the longest symbol: a 15-bit length code with 5
+            // extra bits and a 15-bit distance code with 13
+            input.refill();
+            uint32_t entry = literals.fast[input.bits & kFastMask];
+
+            // Runs of literals: up to three table entries of at most
+            // kFastBits each per refill. Both bytes of an entry are stored
+            // (a single literal's second byte is overwritten next) and the
+            // kind, 1 or 2, is how many of them count.
+            if (entry_kind(entry) - kLiteral < 2 && out_end - out >= 6) {
+                for (int i = 0; i < 3 && entry_kind(entry) - kLiteral < 2; i++) {
+                    out[0] = static_cast<unsigned char>(entry >> 16);
+                    out[1] = static_cast<unsigned char>(entry >> 24);
+                    out += entry_kind(entry);
+                    input.consume(entry_bits(entry));
+                    entry = literals.fast[input.bits & kFastMask];
+                }
+                if (out == out_end) {
+                    return full();
+                }
+                continue;
+            }
+
+            entry = lookup(literals, input.bits);
+            input.consume(entry_bits(entry));
+            switch (entry_kind(entry)) {
+                case kLiteralPair:
+                    *out++ = static_cast<unsigned char>(entry >> 16);
+                    if (out == out_end) {
+                        return full();
+                    }
+                    *out++ = static_cast<unsigned char>(entry >> 24);
+                    break;
+                case kLiteral:
+                    *out++ = static_cast<unsigned char>(entry >> 16);
+                    break;
+                case kEndOfBlock:
+                    return finish(input.truncated() ? kError : kBlockEnd);
+                case kBaseExtra: {
+                    size_t length = entry_payload(entry) + input.take(static_cast<int>(entry_extra(entry)));
+                    uint32_t distance_entry = lookup(distances, input.bits);
+                    input.consume(entry_bits(distance_entry));
+                    if (entry_kind(distance_entry) != kBaseExtra) {
+                        return finish(kError);
+                    }
+                    size_t distance =
+                        entry_payload(distance_entry) + input.take(static_cast<int>(entry_extra(distance_entry)));
+                    if (distance > static_cast<size_t>(out - out_begin_)) {
+                        return finish(kError);
+                    }
+                    out = copy_match(out, out_end, length, distance);
+                    break;
+                }
+                default:
+                    return finish(kError);
+            }
+            if (out == out_end) {
+                return full();
+            }
+        }
+    }
+
+    BitReader input_;
+    unsigned char* out_begin_;
+    unsigned char* out_;
+    unsigned char* out_end_;
+    Huffman code_lengths_;
+    Huffman literals_;
+    Huffman distances_;
+};
+
+} // namespace
+
+bool zlib_inflate(const unsigned char* data, size_t size, unsigned char* out, size_t out_size, size_t& written) {
+    Inflater inflater(data, size, out, out_size);
+    bool ok = inflater.run();
+    written = inflater.written();
+    return ok;
+}
+
+} // namespace vanity::detail
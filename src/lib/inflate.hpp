@@ -0,0 +1,23 @@
+#ifndef VANITY_INFLATE_HPP
+#define VANITY_INFLATE_HPP
+
+#include <cstddef>
+
+namespace vanity::detail {
+
+// zlib (RFC 1950) / deflate (RFC 1951) decoder for the PNG reader
+// Huffman codes are resolved through lookup tables indexed by the next
+// input bits: a literal/length code or distance code of up to 11 bits
+// takes one lookup, and two short literal codes in a row come out of a
+// single lookup together. Longer codes fall back to a canonical decode.
+
+// Decompress a zlib stream into out, stopping at the end of the final
+// block or as soon as out_size bytes have been written, whichever comes
+// first. written receives the number of bytes produced. As in stb_image,
+// the Adler-32 trailer is not checked. Returns false for a corrupt or
+// truncated stream or a preset dictionary.
+bool zlib_inflate(const unsigned char* data, size_t size, unsigned char* out, size_t out_size, size_t& written);
+
+} // namespace vanity::detail
+
+#endif // VANITY_INFLATE_HPP
@@ -0,0 +1,222 @@
+#include "jpeg_border.hpp"
+#include "dct.hpp"
+#include "jpeg_reader.hpp"
+#include "jpeg_writer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vanity::detail {
+
+namespace {
+
+// Sequential, 8-bit, Huffman-coded (jpeg_read_header rejects the rest),
+// whole MCUs, and every component's sampling divides the frame's
+bool eligible(const JpegHeader& header) {
+    if (header.progressive) {
+        return false;
+    }
+    for (const JpegComponent& c : header.components) {
+        if (!header.has_quant[c.quant_table] || header.h_max % c.h != 0 || header.v_max % c.v != 0) {
+            return false;
+        }
+    }
+    return header.width % (8 * header.h_max) == 0 && header.height % (8 * header.v_max) == 0;
+}
+
+// Level-shifted value of each ring's colour in each component, converted
+// to YCbCr as jpeg_encode does unless the JPEG stores gray or RGB
+std::vector<float> ring_samples(const JpegHeader& header, std::span<const BorderSpec> rings) {
+    size_t components = header.components.size();
+    bool rgb = header.is_rgb();
+    std::vector<float> samples(rings.size() * components);
+    for (size_t r = 0; r < rings.size(); r++) {
+        const unsigned char* color = rings[r].color;
+        float* out = samples.data() + r * components;
+        if (components == 1 || rgb) {
+            for (size_t c = 0; c < components; c++) {
+                out[c] = color[c] - 128.0f;
+            }
+            continue;
+        }
+        float red = color[0], green = color[1], blue = color[2];
+        out[0] = 0.299f * red + 0.587f * green + 0.114f * blue - 128.0f;
+        out[1] = -0.168736f * red - 0.331264f * green + 0.5f * blue;
+        out[2] = 0.5f * red - 0.418688f * green - 0.081312f * blue;
+    }
+    return samples;
+}
+
+// Whether every block fits the baseline ranges of the Annex K tables that
+// jpeg_encode_coefficients codes with: DC in [-1024, 1023] (so differences
+// stay within category 11) and AC within category 10. Inputs coded with
+// their own tables may exceed them
+bool baseline_range(const JpegCoefficientPlane& plane, size_t blocks_x, size_t blocks_y) {
+    for (size_t by = 0; by < blocks_y; by++) {
+        for (size_t bx = 0; bx < blocks_x; bx++) {
+            const int16_t* block = plane.block(bx, by);
+            if (block[0] < -1024 || block[0] > 1023) {
+                return false;
+            }
+            for (int k = 1; k < 64; k++) {
+                if (block[k] < -1023 || block[k] > 1023) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool jpeg_probe_blocks(const unsigned char* data, size_t size, JpegBlockLayout& out) {
+    out = JpegBlockLayout{};
+    JpegHeader header;
+    std::string error;
+    if (!jpeg_read_header(data, size, header, error) || !eligible(header)) {
+        return false;
+    }
+    out.width = header.width;
+    out.height = header.height;
+    out.channels = static_cast<int>(header.components.size());
+    out.mcu_width = 8 * header.h_max;
+    out.mcu_height = 8 * header.v_max;
+    return true;
+}
+
+bool jpeg_add_borders(const unsigned char* data, size_t size, std::span<const BorderSpec> rings, ImageSink& sink,
+                      const ExecutionOptions& exec) {
+    JpegHeader header;
+    std::string error;
+    if (rings.empty() || !jpeg_read_header(data, size, header, error) || !eligible(header)) {
+        return false;
+    }
+    int total = 0;
+    for (const BorderSpec& ring : rings) {
+        if (ring.width < 0) {
+            return false;
+        }
+        total += ring.width;
+    }
+    int mcu_width = 8 * header.h_max;
+    int mcu_height = 8 * header.v_max;
+    int width = header.width + 2 * total;
+    int height = header.height + 2 * total;
+    if (total % mcu_width != 0 || total % mcu_height != 0 || width > 65535 || height > 65535) {
+        return false;
+    }
+
+    // One plane per component covering the bordered frame; the input's
+    // coefficients are decoded straight into its interior
+    JpegCoefficientFrame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.components = header.components;
+    std::memcpy(frame.quant, header.quant, sizeof(frame.quant));
+    frame.adobe_transform = header.adobe_transform;
+    int mcus_x = width / mcu_width;
+    int mcus_y = height / mcu_height;
+    std::vector<std::unique_ptr<int16_t[]>> storage;
+    std::vector<JpegCoefficientPlane> interiors;
+    for (const JpegComponent& c : header.components) {
+        size_t stride = static_cast<size_t>(mcus_x) * c.h;
+        size_t rows = static_cast<size_t>(mcus_y) * c.v;
+        storage.push_back(std::make_unique_for_overwrite<int16_t[]>(stride * rows * 64));
+        JpegCoefficientPlane plane{storage.back().get(), stride};
+        frame.planes.push_back(plane);
+        size_t left = static_cast<size_t>(total / mcu_width) * c.h;
+        size_t top = static_cast<size_t>(total / mcu_height) * c.v;
+        interiors.push_back(JpegCoefficientPlane{plane.block(left, top), stride});
+    }
+    if (!jpeg_decode_coefficients(data, size, header, interiors, error, exec)) {
+        return false;
+    }
+    for (size_t i = 0; i < interiors.size(); i++) {
+        const JpegComponent& c = header.components[i];
+        size_t blocks_x = static_cast<size_t>(header.width / mcu_width) * c.h;
+        size_t blocks_y = static_cast<size_t>(header.height / mcu_height) * c.v;
+        if (!baseline_range(interiors[i], blocks_x, blocks_y)) {
+            return false;
+        }
+    }
+
+    // Ring index of an output pixel, innermost ring 0
+    auto ring_at = [&](int x, int y) {
+        int depth = std::min({x, y, width - 1 - x, height - 1 - y});
+        int edge = 0;
+        for (size_t r = rings.size(); r-- > 0;) {
+            edge += rings[r].width;
+            if (depth < edge) {
+                return r;
+            }
+        }
+        return size_t(0);
+    };
+
+    // Border blocks: most lie inside one ring and reuse that ring's constant
+    // block; blocks straddling two rings go through the forward DCT
+    const DctKernels& kernels = dct_kernels();
+    std::vector<float> values = ring_samples(header, rings);
+    size_t components = header.components.size();
+    alignas(32) float samples[64];
+    alignas(32) int16_t coefficients[64];
+    for (size_t i = 0; i < components; i++) {
+        const JpegComponent& c = header.components[i];
+        const JpegCoefficientPlane& plane = frame.planes[i];
+        float scales[64];
+        forward_dct_scales(header.quant[c.quant_table], scales);
+        std::vector<int16_t> constant(rings.size() * 64);
+        for (size_t r = 0; r < rings.size(); r++) {
+            std::fill(samples, samples + 64, values[r * components + i]);
+            kernels.forward_quantize(samples, 8, scales, constant.data() + r * 64);
+        }
+
+        // Output pixels covered by one sample of this component
+        int sx = header.h_max / c.h;
+        int sy = header.v_max / c.v;
+        int left = total / (8 * sx);
+        int top = total / (8 * sy);
+        int right = left + header.width / (8 * sx);
+        int bottom = top + header.height / (8 * sy);
+        int blocks_x = mcus_x * c.h;
+        int blocks_y = mcus_y * c.v;
+        float area = static_cast<float>(sx * sy);
+        for (int by = 0; by < blocks_y; by++) {
+            bool interior_row = by >= top && by < bottom;
+            for (int bx = 0; bx < blocks_x; bx++) {
+                if (interior_row && bx == left) {
+                    bx = right - 1;
+                    continue;
+                }
+                size_t first = ring_at(bx * 8 * sx, by * 8 * sy);
+                bool uniform = true;
+                for (int y = 0; y < 8; y++) {
+                    for (int x = 0; x < 8; x++) {
+                        float sum = 0;
+                        for (int dy = 0; dy < sy; dy++) {
+                            for (int dx = 0; dx < sx; dx++) {
+                                size_t r = ring_at((bx * 8 + x) * sx + dx, (by * 8 + y) * sy + dy);
+                                uniform = uniform && r == first;
+                                sum += values[r * components + i];
+                            }
+                        }
+                        samples[y * 8 + x] = sum / area;
+                    }
+                }
+                const int16_t* block = constant.data() + first * 64;
+                if (!uniform) {
+                    kernels.forward_quantize(samples, 8, scales, coefficients);
+                    block = coefficients;
+                }
+                std::memcpy(plane.block(bx, by), block, sizeof(coefficients));
+            }
+        }
+    }
+
+    return jpeg_encode_coefficients(frame, sink, exec);
+}
+
+} // namespace vanity::detail
@@ -0,0 +1,30 @@
+#ifndef VANITY_JPEG_BORDER_HPP
+#define VANITY_JPEG_BORDER_HPP
+
+#include "vanity/image_io.hpp"
+#include "vanity/image_ops.hpp"
+#include <cstddef>
+#include <span>
+
+namespace vanity {
+class ImageSink;
+}
+
+namespace vanity::detail {
+
+// Lossless JPEG bordering in the DCT domain, as jpegtran transforms: the
+// input's quantized coefficients become the interior of the output frame
+// unchanged, the border blocks are computed from the ring colours alone,
+// and the whole frame is entropy-coded again without any IDCT
+
+// Read the frame header and check that the JPEG can be bordered this way
+bool jpeg_probe_blocks(const unsigned char* data, size_t size, JpegBlockLayout& out);
+
+// Surround the JPEG with the rings (innermost first); their total width must
+// be a multiple of both MCU dimensions reported by jpeg_probe_blocks
+bool jpeg_add_borders(const unsigned char* data, size_t size, std::span<const BorderSpec> rings, ImageSink& sink,
+                      const ExecutionOptions& exec);
+
+} // namespace vanity::detail
+
+#endif // VANITY_JPEG_BORDER_HPP
@@ -0,0 +1,52 @@
+#ifndef VANITY_JPEG_COMMON_HPP
+#define VANITY_JPEG_COMMON_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vanity::detail {
+
+// Natural (row-major) index of each coefficient in zig-zag order
+extern const uint8_t kJpegZigzag[64];
+
+// Huffman table as stored in a DHT segment: the number of codes of each
+// length 1-16, then the symbols in order of increasing code length
+struct JpegHuffmanSpec {
+    uint8_t counts[16];
+    const uint8_t* symbols;
+    int symbol_count;
+};
+
+// The typical tables from ITU-T T.81 Annex K.3
+extern const JpegHuffmanSpec kJpegDcLuminance;
+extern const JpegHuffmanSpec kJpegAcLuminance;
+extern const JpegHuffmanSpec kJpegDcChrominance;
+extern const JpegHuffmanSpec kJpegAcChrominance;
+
+// One component of a JPEG frame
+struct JpegComponent {
+    int id = 0;
+    int h = 1;              // sampling factors
+    int v = 1;
+    int quant_table = 0;
+    int blocks_x = 0;       // blocks covering the component's samples
+    int blocks_y = 0;
+};
+
+// One component's quantized coefficients: 64 natural-order values per
+// block, blocks row-major with `stride` blocks per row. A plane covers the
+// whole MCUs of the frame (mcus_x * h by mcus_y * v blocks).
+struct JpegCoefficientPlane {
+    int16_t* blocks = nullptr;
+    size_t stride = 0;
+
+    int16_t* block(size_t bx, size_t by) const { return blocks + (by * stride + bx) * 64; }
+};
+
+// Annex K.1 quantization tables (natural order) scaled to quality 1-100
+// with the IJG formula, as libjpeg and stb_image_write do
+void jpeg_quant_table(bool chrominance, int quality, uint8_t out[64]);
+
+} // namespace vanity::detail
+
+#endif // VANITY_JPEG_COMMON_HPP
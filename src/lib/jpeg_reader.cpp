@@ -0,0 +1,1039 @@
+#include "jpeg_reader.hpp"
+#include "dct.hpp"
+#include "vanity/thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+namespace vanity::detail {
+
+namespace {
+
+// Codes up to this long are decoded with a single table lookup
+constexpr int kFastBits = 9;
+
+inline int read_u16(const unsigned char* p) {
+    return (p[0] << 8) | p[1];
+}
+
+// Decoding tables for one Huffman table
+struct HuffmanDecoder {
+    bool defined = false;
+    uint8_t symbols[256] = {};
+    // (code length << 8) | symbol for every kFastBits-bit prefix of a short
+    // code, 0 where the code is longer
+    uint16_t fast[1 << kFastBits] = {};
+    // For AC tables: (value << 8) | (run << 4) | total length of a short
+    // code together with its value bits, 0 where they do not fit
+    int16_t fast_ac[1 << kFastBits] = {};
+    // One past the largest code of each length, left-aligned to 16 bits
+    uint32_t limit[18] = {};
+    // Index in symbols of the first code of each length, minus that code
+    int delta[17] = {};
+
+    bool build(const uint8_t counts[16], const uint8_t* values, int count) {
+        std::memcpy(symbols, values, count);
+        std::memset(fast, 0, sizeof(fast));
+        uint32_t code = 0;
+        int k = 0;
+        for (int length = 1; length <= 16; length++) {
+            // More codes than this length can hold means a corrupt table;
+            // checked before filling so an over-full one cannot overrun fast
+            if (code + counts[length - 1] > (1u << length)) {
+                return false;
+            }
+            delta[length] = k - static_cast<int>(code);
+            for (int i = 0; i < counts[length - 1]; i++, k++, code++) {
+                if (length <= kFastBits) {
+                    uint32_t first = code << (kFastBits - length);
+                    for (uint32_t j = 0; j < (1u << (kFastBits - length)); j++) {
+                        fast[first + j] = static_cast<uint16_t>(length << 8 | values[k]);
+                    }
+                }
+            }
+            limit[length] = code << (16 - length);
+            code <<= 1;
+        }
+        limit[17] = 0xffffffffu;
+
+        for (uint32_t i = 0; i < (1u << kFastBits); i++) {
+            int length = fast[i] >> 8;
+            int run = (fast[i] >> 4) & 15;
+            int size = fast[i] & 15;
+            fast_ac[i] = 0;
+            if (length == 0 || size == 0 || length + size > kFastBits) {
+                continue;
+            }
+            int value = static_cast<int>((i << length) & ((1u << kFastBits) - 1)) >> (kFastBits - size);
+            if (value < (1 << (size - 1))) {
+                value -= (1 << size) - 1;
+            }
+            if (value >= -128 && value <= 127) {
+                fast_ac[i] = static_cast<int16_t>(value * 256 + run * 16 + length + size);
+            }
+        }
+        defined = true;
+        return true;
+    }
+};
+
+// MSB-first reader of entropy-coded data that removes stuffed zero bytes
+// and reads zeros once it reaches a marker
+class BitReader {
+public:
+    BitReader(const unsigned char* begin, const unsigned char* end) : pos_(begin), end_(end) {}
+
+    const unsigned char* position() const { return pos_; }
+
+    // Decode one Huffman symbol, or return -1 for an invalid code
+    int decode(const HuffmanDecoder& table) {
+        if (count_ < 16) {
+            fill();
+        }
+        uint16_t entry = table.fast[buffer_ >> (64 - kFastBits)];
+        if (entry >> 8) {
+            consume(entry >> 8);
+            return entry & 0xff;
+        }
+        uint32_t code = static_cast<uint32_t>(buffer_ >> 48);
+        int length = kFastBits + 1;
+        while (code >= table.limit[length]) {
+            length++;
+        }
+        if (length > 16) {
+            return -1;
+        }
+        consume(length);
+        return table.symbols[static_cast<int>(code >> (16 - length)) + table.delta[length]];
+    }
+
+    // Next kFastBits bits, for the HuffmanDecoder::fast_ac lookup
+    unsigned peek() {
+        if (count_ < 16) {
+            fill();
+        }
+        return static_cast<unsigned>(buffer_ >> (64 - kFastBits));
+    }
+
+    void skip(int bits) { consume(bits); }
+
+    // Read a `bits`-bit magnitude category value and sign-extend it (T.81 F.2.2.1)
+    int receive_extend(int bits) {
+        if (bits == 0) {
+            return 0;
+        }
+        if (count_ < bits) {
+            fill();
+        }
+        int value = static_cast<int>(buffer_ >> (64 - bits));
+        consume(bits);
+        return value < (1 << (bits - 1)) ? value - (1 << bits) + 1 : value;
+    }
+
+    // Read `bits` raw bits (1-16)
+    int bits(int bits) {
+        if (count_ < bits) {
+            fill();
+        }
+        int value = static_cast<int>(buffer_ >> (64 - bits));
+        consume(bits);
+        return value;
+    }
+
+    // Skip to just past the next RSTn marker and start a fresh bit stream
+    void restart() {
+        while (pos_ + 1 < end_ && !(pos_[0] == 0xff && pos_[1] >= 0xd0 && pos_[1] <= 0xd7)) {
+            pos_++;
+        }
+        pos_ = std::min(pos_ + 2, end_);
+        buffer_ = 0;
+        count_ = 0;
+        at_marker_ = false;
+    }
+
+private:
+    void fill() {
+        // Whole bytes of one unaligned load when none of them is 0xff, so
+        // there is no stuffing or marker to look for
+        if (std::endian::native == std::endian::little && !at_marker_ && end_ - pos_ >= 8) {
+            uint64_t word;
+            std::memcpy(&word, pos_, 8);
+            uint64_t inverted = ~word;
+            if (((inverted - 0x0101010101010101ull) & ~inverted & 0x8080808080808080ull) == 0) {
+                int take = (64 - count_) >> 3;
+                uint64_t bytes = __builtin_bswap64(word) & (~0ull << (64 - 8 * take));
+                buffer_ |= bytes >> count_;
+                count_ += 8 * take;
+                pos_ += take;
+                return;
+            }
+        }
+        while (count_ <= 56) {
+            unsigned byte = 0;
+            if (!at_marker_ && pos_ < end_) {
+                byte = *pos_;
+                if (byte == 0xff) {
+                    if (pos_ + 1 < end_ && pos_[1] == 0) {
+                        pos_ += 2;
+                    } else {
+                        at_marker_ = true;
+                        byte = 0;
+                    }
+                } else {
+                    pos_++;
+                }
+            }
+            buffer_ |= uint64_t(byte) << (56 - count_);
+            count_ += 8;
+        }
+    }
+
+    void consume(int bits) {
+        buffer_ <<= bits;
+        count_ -= bits;
+    }
+
+    const unsigned char* pos_;
+    const unsigned char* end_;
+    uint64_t buffer_ = 0;
+    int count_ = 0;
+    bool at_marker_ = false;
+};
+
+// Called after each MCU row of a streamed scan with the row's index
+using RowCallback = std::function<bool(int)>;
+
+// Walks the marker segments of one JPEG; without decode_scans it stops at
+// the first scan. With on_row set, the planes hold a single MCU row that is
+// handed over as soon as it is decoded, which only a sequential JPEG with
+// one interleaved scan supports. Given a pool, sequential scans with
+// restart markers are decoded a restart segment per task.
+class Parser {
+public:
+    Parser(const unsigned char* data, size_t size, JpegHeader& header, std::string& error,
+           ThreadPool* pool = nullptr)
+        : data_(data), size_(size), header_(header), error_(error), pool_(pool) {}
+
+    bool run(std::span<const JpegCoefficientPlane> planes, bool decode_scans, const RowCallback* on_row = nullptr) {
+        on_row_ = on_row;
+        if (size_ < 4 || data_[0] != 0xff || data_[1] != 0xd8) {
+            return fail("not a JPEG file");
+        }
+        size_t pos = 2;
+        bool frame = false;
+        for (;;) {
+            // Skip anything up to the next marker, then any fill bytes
+            while (pos < size_ && data_[pos] != 0xff) {
+                pos++;
+            }
+            while (pos < size_ && data_[pos] == 0xff) {
+                pos++;
+            }
+            if (pos >= size_) {
+                return decode_scans && scans_ > 0 ? true : fail("truncated JPEG file");
+            }
+            int marker = data_[pos++];
+            if (marker == 0xd9) {
+                return decode_scans && scans_ > 0 ? true : fail("no image data");
+            }
+            if ((marker >= 0xd0 && marker <= 0xd7) || marker == 0x01) {
+                continue;
+            }
+            if (pos + 2 > size_) {
+                return fail("truncated JPEG file");
+            }
+            size_t length = read_u16(data_ + pos);
+            if (length < 2 || pos + length > size_) {
+                return fail("corrupt JPEG segment length");
+            }
+            const unsigned char* segment = data_ + pos + 2;
+            size_t segment_size = length - 2;
+            pos += length;
+
+            switch (marker) {
+                case 0xc0:
+                case 0xc1:
+                case 0xc2:
+                    if (frame) {
+                        return fail("more than one frame");
+                    }
+                    if (!read_frame(segment, segment_size, marker == 0xc2)) {
+                        return false;
+                    }
+                    frame = true;
+                    break;
+                case 0xc3: case 0xc5: case 0xc6: case 0xc7:
+                case 0xc9: case 0xca: case 0xcb: case 0xcd: case 0xce: case 0xcf:
+                    return fail("unsupported JPEG process (lossless, hierarchical or arithmetic-coded)");
+                case 0xc4:
+                    if (!read_huffman_tables(segment, segment_size)) {
+                        return false;
+                    }
+                    break;
+                case 0xdb:
+                    if (!read_quant_tables(segment, segment_size)) {
+                        return false;
+                    }
+                    break;
+                case 0xdd:
+                    if (segment_size < 2) {
+                        return fail("corrupt DRI segment");
+                    }
+                    header_.restart_interval = read_u16(segment);
+                    break;
+                case 0xee:
+                    if (segment_size >= 12 && std::memcmp(segment, "Adobe", 5) == 0) {
+                        header_.adobe_transform = segment[11];
+                    }
+                    break;
+                case 0xda: {
+                    if (!frame) {
+                        return fail("scan before frame header");
+                    }
+                    if (!decode_scans) {
+                        header_.first_scan_components = segment_size >= 1 ? segment[0] : 0;
+                        return true;
+                    }
+                    const unsigned char* end = nullptr;
+                    if (!decode_scan(segment, segment_size, data_ + pos, planes, end)) {
+                        return false;
+                    }
+                    pos = static_cast<size_t>(end - data_);
+                    scans_++;
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+private:
+    bool fail(const char* message) {
+        error_ = message;
+        return false;
+    }
+
+    bool read_frame(const unsigned char* p, size_t size, bool progressive) {
+        if (size < 6 || p[0] != 8) {
+            return fail(size >= 1 && p[0] != 8 ? "only 8-bit JPEG samples are supported" : "corrupt frame header");
+        }
+        header_.progressive = progressive;
+        header_.height = read_u16(p + 1);
+        header_.width = read_u16(p + 3);
+        int count = p[5];
+        if (header_.width == 0 || header_.height == 0) {
+            return fail("JPEG dimensions missing (DNL is not supported)");
+        }
+        if ((count != 1 && count != 3) || size < 6 + 3 * static_cast<size_t>(count)) {
+            return fail("only grayscale and three-component JPEGs are supported");
+        }
+        header_.components.clear();
+        header_.h_max = header_.v_max = 1;
+        for (int i = 0; i < count; i++) {
+            JpegComponent c;
+            c.id = p[6 + 3 * i];
+            c.h = p[7 + 3 * i] >> 4;
+            c.v = p[7 + 3 * i] & 15;
+            c.quant_table = p[8 + 3 * i];
+            if (c.h < 1 || c.h > 4 || c.v < 1 || c.v > 4 || c.quant_table > 3) {
+                return fail("corrupt frame header");
+            }
+            // A lone component's sampling factors mean nothing: its MCU is one block
+            if (count == 1) {
+                c.h = c.v = 1;
+            }
+            header_.h_max = std::max(header_.h_max, c.h);
+            header_.v_max = std::max(header_.v_max, c.v);
+            header_.components.push_back(c);
+        }
+        header_.mcus_x = (header_.width + 8 * header_.h_max - 1) / (8 * header_.h_max);
+        header_.mcus_y = (header_.height + 8 * header_.v_max - 1) / (8 * header_.v_max);
+        for (JpegComponent& c : header_.components) {
+            int samples_x = (header_.width * c.h + header_.h_max - 1) / header_.h_max;
+            int samples_y = (header_.height * c.v + header_.v_max - 1) / header_.v_max;
+            c.blocks_x = (samples_x + 7) / 8;
+            c.blocks_y = (samples_y + 7) / 8;
+        }
+        return true;
+    }
+
+    bool read_huffman_tables(const unsigned char* p, size_t size) {
+        while (size > 0) {
+            if (size < 17) {
+                return fail("corrupt DHT segment");
+            }
+            int table_class = p[0] >> 4;
+            int id = p[0] & 15;
+            int total = 0;
+            for (int i = 0; i < 16; i++) {
+                total += p[1 + i];
+            }
+            if (table_class > 1 || id > 3 || total > 256 || size < 17 + static_cast<size_t>(total)) {
+                return fail("corrupt DHT segment");
+            }
+            HuffmanDecoder& table = table_class == 0 ? dc_[id] : ac_[id];
+            if (!table.build(p + 1, p + 17, total)) {
+                return fail("corrupt Huffman table");
+            }
+            p += 17 + total;
+            size -= 17 + total;
+        }
+        return true;
+    }
+
+    bool read_quant_tables(const unsigned char* p, size_t size) {
+        while (size > 0) {
+            int precision = p[0] >> 4;
+            int id = p[0] & 15;
+            size_t bytes = precision ? 129 : 65;
+            if (precision > 1 || id > 3 || size < bytes) {
+                return fail("corrupt DQT segment");
+            }
+            for (int k = 0; k < 64; k++) {
+                int value = precision ? read_u16(p + 1 + 2 * k) : p[1 + k];
+                header_.quant[id][kJpegZigzag[k]] = static_cast<uint16_t>(value);
+            }
+            header_.has_quant[id] = true;
+            p += bytes;
+            size -= bytes;
+        }
+        return true;
+    }
+
+    // The block decoders return false on corrupt data and leave reporting it
+    // to decode_scan, so that restart segments can be decoded concurrently
+    static bool decode_block(BitReader& bits, int16_t* block, int& dc, const HuffmanDecoder& dc_table,
+                      const HuffmanDecoder& ac_table) {
+        std::memset(block, 0, 64 * sizeof(int16_t));
+        int category = bits.decode(dc_table);
+        if (category < 0 || category > 11) {
+            return false;
+        }
+        dc += bits.receive_extend(category);
+        block[0] = static_cast<int16_t>(dc);
+        for (int k = 1; k < 64;) {
+            // Most coefficients are a short code and a small value
+            int fast = ac_table.fast_ac[bits.peek()];
+            if (fast) {
+                bits.skip(fast & 15);
+                k += (fast >> 4) & 15;
+                if (k > 63) {
+                    return false;
+                }
+                block[kJpegZigzag[k++]] = static_cast<int16_t>(fast >> 8);
+                continue;
+            }
+            int symbol = bits.decode(ac_table);
+            if (symbol < 0) {
+                return false;
+            }
+            int run = symbol >> 4;
+            int size = symbol & 15;
+            if (size == 0) {
+                if (run != 15) {
+                    break;      // end of block
+                }
+                k += 16;
+                continue;
+            }
+            k += run;
+            if (k > 63) {
+                return false;
+            }
+            block[kJpegZigzag[k++]] = static_cast<int16_t>(bits.receive_extend(size));
+        }
+        return true;
+    }
+
+    // Progressive scans (T.81 G.1.2): the first scan of a band stores the
+    // coefficients shifted left by al, refinement scans add one more bit
+    bool decode_dc_first(BitReader& bits, int16_t* block, int& dc, const HuffmanDecoder& table, int al) {
+        int category = bits.decode(table);
+        if (category < 0 || category > 11) {
+            return false;
+        }
+        dc += bits.receive_extend(category);
+        block[0] = static_cast<int16_t>(dc * (1 << al));
+        return true;
+    }
+
+    bool decode_ac_first(BitReader& bits, int16_t* block, const HuffmanDecoder& table, int ss, int se, int al) {
+        if (eobrun_ > 0) {
+            eobrun_--;
+            return true;
+        }
+        for (int k = ss; k <= se;) {
+            int symbol = bits.decode(table);
+            if (symbol < 0) {
+                return false;
+            }
+            int run = symbol >> 4;
+            int size = symbol & 15;
+            if (size == 0) {
+                if (run < 15) {
+                    // This block and the next eobrun_ blocks end here
+                    eobrun_ = (1 << run) - 1;
+                    if (run) {
+                        eobrun_ += bits.bits(run);
+                    }
+                    break;
+                }
+                k += 16;
+                continue;
+            }
+            k += run;
+            if (k > se) {
+                return false;
+            }
+            block[kJpegZigzag[k++]] = static_cast<int16_t>(bits.receive_extend(size) * (1 << al));
+        }
+        return true;
+    }
+
+    bool decode_ac_refine(BitReader& bits, int16_t* block, const HuffmanDecoder& table, int ss, int se, int al) {
+        int p1 = 1 << al;
+        int m1 = -p1;
+        // Every coefficient already nonzero gets a correction bit as it is passed
+        auto refine = [&](int16_t& coefficient) {
+            if (bits.bits(1) && (coefficient & p1) == 0) {
+                coefficient = static_cast<int16_t>(coefficient + (coefficient >= 0 ? p1 : m1));
+            }
+        };
+        int k = ss;
+        if (eobrun_ == 0) {
+            for (; k <= se; k++) {
+                int symbol = bits.decode(table);
+                if (symbol < 0) {
+                    return false;
+                }
+                int run = symbol >> 4;
+                int size = symbol & 15;
+                int value = 0;
+                if (size) {
+                    if (size != 1) {
+                        return false;
+                    }
+                    value = bits.bits(1) ? p1 : m1;
+                } else if (run != 15) {
+                    eobrun_ = 1 << run;
+                    if (run) {
+                        eobrun_ += bits.bits(run);
+                    }
+                    break;
+                }
+                // Skip `run` zero coefficients; the new one goes in the next zero
+                for (; k <= se; k++) {
+                    int16_t& coefficient = block[kJpegZigzag[k]];
+                    if (coefficient != 0) {
+                        refine(coefficient);
+                    } else if (run-- == 0) {
+                        break;
+                    }
+                }
+                if (value) {
+                    if (k > se) {
+                        return false;
+                    }
+                    block[kJpegZigzag[k]] = static_cast<int16_t>(value);
+                }
+            }
+        }
+        if (eobrun_ > 0) {
+            for (; k <= se; k++) {
+                int16_t& coefficient = block[kJpegZigzag[k]];
+                if (coefficient != 0) {
+                    refine(coefficient);
+                }
+            }
+            eobrun_--;
+        }
+        return true;
+    }
+
+    bool decode_scan(const unsigned char* p, size_t size, const unsigned char* data,
+                     std::span<const JpegCoefficientPlane> planes, const unsigned char*& end) {
+        int count = size >= 1 ? p[0] : 0;
+        if (count < 1 || count > 4 || size < 4 + 2 * static_cast<size_t>(count)) {
+            return fail("corrupt scan header");
+        }
+        int ss = p[1 + 2 * count];
+        int se = p[2 + 2 * count];
+        int ah = p[3 + 2 * count] >> 4;
+        int al = p[3 + 2 * count] & 15;
+        bool progressive = header_.progressive;
+        if (progressive && (se < ss || se > 63 || (ss == 0) != (se == 0) || (ss > 0 && count != 1) ||
+                            al > 13 || ah > 13)) {
+            return fail("corrupt progressive scan header");
+        }
+        bool dc_scan = !progressive || ss == 0;
+        bool ac_scan = !progressive || se > 0;
+
+        int index[4];
+        const HuffmanDecoder* dc_tables[4];
+        const HuffmanDecoder* ac_tables[4];
+        for (int i = 0; i < count; i++) {
+            int id = p[1 + 2 * i];
+            auto it = std::find_if(header_.components.begin(), header_.components.end(),
+                                   [&](const JpegComponent& c) { return c.id == id; });
+            int dc = p[2 + 2 * i] >> 4;
+            int ac = p[2 + 2 * i] & 15;
+            if (it == header_.components.end() || dc > 3 || ac > 3) {
+                return fail("corrupt scan header");
+            }
+            // DC refinement reads raw bits only
+            if ((dc_scan && !(progressive && ah > 0 && !ac_scan) && !dc_[dc].defined) ||
+                (ac_scan && !ac_[ac].defined)) {
+                return fail("scan uses an undefined Huffman table");
+            }
+            index[i] = static_cast<int>(it - header_.components.begin());
+            dc_tables[i] = &dc_[dc];
+            ac_tables[i] = &ac_[ac];
+        }
+        if (planes.size() < header_.components.size()) {
+            return fail("missing coefficient planes");
+        }
+        bool streamed = on_row_ != nullptr;
+        if (streamed && (progressive || count != static_cast<int>(header_.components.size()))) {
+            return fail("only a single interleaved sequential scan can be streamed");
+        }
+
+        auto decode = [&](BitReader& bits, int* dc_pred, int i, int16_t* block) {
+            if (!progressive) {
+                return decode_block(bits, block, dc_pred[i], *dc_tables[i], *ac_tables[i]);
+            }
+            if (ss == 0) {
+                if (ah == 0) {
+                    return decode_dc_first(bits, block, dc_pred[i], *dc_tables[i], al);
+                }
+                if (bits.bits(1)) {
+                    block[0] = static_cast<int16_t>(block[0] | (1 << al));
+                }
+                return true;
+            }
+            return ah == 0 ? decode_ac_first(bits, block, *ac_tables[i], ss, se, al)
+                           : decode_ac_refine(bits, block, *ac_tables[i], ss, se, al);
+        };
+
+        // A non-interleaved scan has one block per MCU and covers only the
+        // component's own blocks; streamed, that is grayscale, where a block
+        // row is an MCU row
+        const JpegComponent& single = header_.components[index[0]];
+        long mcus_per_row = count == 1 ? single.blocks_x : header_.mcus_x;
+        long total = mcus_per_row * (count == 1 ? single.blocks_y : header_.mcus_y);
+        auto decode_mcu = [&](BitReader& bits, int* dc_pred, long mcu) {
+            long row = mcu / mcus_per_row;
+            long column = mcu % mcus_per_row;
+            if (count == 1) {
+                return decode(bits, dc_pred, 0, planes[index[0]].block(column, streamed ? 0 : row));
+            }
+            for (int i = 0; i < count; i++) {
+                const JpegComponent& c = header_.components[index[i]];
+                const JpegCoefficientPlane& plane = planes[index[i]];
+                for (int v = 0; v < c.v; v++) {
+                    for (int h = 0; h < c.h; h++) {
+                        size_t bx = static_cast<size_t>(column) * c.h + h;
+                        size_t by = streamed ? v : static_cast<size_t>(row) * c.v + v;
+                        if (!decode(bits, dc_pred, i, plane.block(bx, by))) {
+                            return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        };
+
+        int interval = header_.restart_interval;
+        eobrun_ = 0;
+        if (pool_ && !progressive && interval > 0 && !streamed) {
+            // Restart segments are independent: each starts with fresh DC
+            // predictors on a byte boundary, so once the markers are found
+            // the segments decode on the pool in any order
+            size_t segments = static_cast<size_t>((total + interval - 1) / interval);
+            std::vector<const unsigned char*> starts = find_restart_segments(data, segments);
+            if (starts.size() == segments && segments >= 2) {
+                std::vector<const unsigned char*> ends(segments);
+                std::vector<char> ok(segments);
+                pool_->parallel_for(segments, 1, [&](size_t begin, size_t end) {
+                    for (size_t s = begin; s < end; s++) {
+                        BitReader bits(starts[s], data_ + size_);
+                        int dc_pred[4] = {0, 0, 0, 0};
+                        long last = std::min(total, static_cast<long>(s + 1) * interval);
+                        ok[s] = true;
+                        for (long mcu = static_cast<long>(s) * interval; mcu < last && ok[s]; mcu++) {
+                            ok[s] = decode_mcu(bits, dc_pred, mcu);
+                        }
+                        ends[s] = bits.position();
+                    }
+                });
+                if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+                    return fail("corrupt JPEG data");
+                }
+                end = ends.back();
+                return true;
+            }
+        }
+
+        BitReader bits(data, data_ + size_);
+        int dc_pred[4] = {0, 0, 0, 0};
+        for (long mcu = 0; mcu < total; mcu++) {
+            if (interval && mcu > 0 && mcu % interval == 0) {
+                bits.restart();
+                std::fill(dc_pred, dc_pred + 4, 0);
+                eobrun_ = 0;
+            }
+            if (!decode_mcu(bits, dc_pred, mcu)) {
+                return fail("corrupt JPEG data");
+            }
+            if (streamed && (mcu + 1) % mcus_per_row == 0 && !(*on_row_)(static_cast<int>(mcu / mcus_per_row))) {
+                return false;
+            }
+        }
+        end = bits.position();
+        return true;
+    }
+
+    // Start of each restart segment of the entropy-coded data at data, the
+    // first being data itself. Stops early, returning fewer than segments
+    // starts, at any other marker or an RSTn out of sequence.
+    std::vector<const unsigned char*> find_restart_segments(const unsigned char* data, size_t segments) const {
+        std::vector<const unsigned char*> starts;
+        starts.reserve(segments);
+        starts.push_back(data);
+        const unsigned char* limit = data_ + size_;
+        const unsigned char* p = data;
+        while (starts.size() < segments) {
+            p = static_cast<const unsigned char*>(std::memchr(p, 0xff, limit - p));
+            if (!p || p + 1 >= limit) {
+                break;
+            }
+            int next = p[1];
+            if (next == 0x00 || next == 0xff) {
+                p += next == 0x00 ? 2 : 1;  // stuffed byte or fill
+                continue;
+            }
+            if (next != 0xd0 + static_cast<int>((starts.size() - 1) % 8)) {
+                break;
+            }
+            p += 2;
+            starts.push_back(p);
+        }
+        return starts;
+    }
+
+    const unsigned char* data_;
+    size_t size_;
+    JpegHeader& header_;
+    std::string& error_;
+    HuffmanDecoder dc_[4];
+    HuffmanDecoder ac_[4];
+    ThreadPool* pool_;
+    const RowCallback* on_row_ = nullptr;
+    int eobrun_ = 0;
+    int scans_ = 0;
+};
+
+} // namespace
+
+bool JpegHeader::is_rgb() const {
+    if (components.size() != 3) {
+        return false;
+    }
+    if (adobe_transform >= 0) {
+        return adobe_transform == 0;
+    }
+    return components[0].id == 'R' && components[1].id == 'G' && components[2].id == 'B';
+}
+
+bool jpeg_read_header(const unsigned char* data, size_t size, JpegHeader& header, std::string& error) {
+    header = JpegHeader();
+    return Parser(data, size, header, error).run({}, false);
+}
+
+bool jpeg_decode_coefficients(const unsigned char* data, size_t size, const JpegHeader& header,
+                              std::span<const JpegCoefficientPlane> planes, std::string& error,
+                              const ExecutionOptions& exec) {
+    // Tables are re-read as the scans go, since a DHT may sit between scans
+    JpegHeader scratch = header;
+    size_t coefficient_bytes = static_cast<size_t>(header.width) * header.height * header.components.size() * 2;
+    bool parallel = exec.pool && exec.pool->size() >= 2 && coefficient_bytes >= exec.parallel_threshold;
+    return Parser(data, size, scratch, error, parallel ? exec.pool : nullptr).run(planes, true);
+}
+
+namespace {
+
+// basis[u * N + x] of the orthonormal N-point inverse DCT
+template <int N>
+const std::array<float, N * N>& idct_basis() {
+    static const auto basis = [] {
+        std::array<float, N * N> b{};
+        for (int u = 0; u < N; u++) {
+            double c = u == 0 ? std::sqrt(1.0 / N) : std::sqrt(2.0 / N);
+            for (int x = 0; x < N; x++) {
+                b[u * N + x] = static_cast<float>(c * std::cos((2 * x + 1) * u * M_PI / (2 * N)));
+            }
+        }
+        return b;
+    }();
+    return basis;
+}
+
+// Inverse DCT of a block's lowest N x N frequencies into N x N samples
+// (N 1, 2 or 4), which is the block downscaled by 8 / N. scales holds the
+// quantizers times N / 8: the coefficients are orthonormal, so that keeps
+// the mean of the smaller block equal to that of the full one. Both passes
+// accumulate whole rows so that the compiler keeps them in vectors.
+template <int N>
+void scaled_idct(const int16_t* in, const float* scales, const std::array<float, N * N>& basis, uint8_t* out,
+                 size_t stride) {
+    float rows[N * N] = {};
+    for (int v = 0; v < N; v++) {
+        for (int u = 0; u < N; u++) {
+            float coefficient = in[v * 8 + u] * scales[v * 8 + u];
+            for (int x = 0; x < N; x++) {
+                rows[v * N + x] += coefficient * basis[u * N + x];
+            }
+        }
+    }
+    for (int y = 0; y < N; y++) {
+        float samples[N];
+        for (int x = 0; x < N; x++) {
+            samples[x] = 128.0f;
+        }
+        for (int v = 0; v < N; v++) {
+            for (int x = 0; x < N; x++) {
+                samples[x] += basis[v * N + y] * rows[v * N + x];
+            }
+        }
+        for (int x = 0; x < N; x++) {
+            // Truncation rounds every value that survives the clamp
+            out[y * stride + x] = static_cast<uint8_t>(std::clamp(static_cast<int>(samples[x] + 0.5f), 0, 255));
+        }
+    }
+}
+
+// Reconstructed samples of one component at its own resolution
+struct SamplePlane {
+    std::unique_ptr<uint8_t[]> samples;
+    size_t stride = 0;
+    int sx = 1;             // output pixels per sample, horizontally and vertically
+    int sy = 1;
+    int columns = 0;        // samples covering the output; the rest is MCU padding
+    int rows = 0;
+
+    const uint8_t* row(int y) const { return samples.get() + static_cast<size_t>(y) * stride; }
+};
+
+// Upsample row y of the output from a plane into out (at least 2 * columns
+// bytes). 2x horizontal, 2x vertical and 2x2 subsampling use the triangle
+// filter of libjpeg's "fancy" upsampling; other factors replicate samples.
+const uint8_t* upsample_row(const SamplePlane& plane, int y, int width, uint8_t* out, std::vector<int>& sums) {
+    if (plane.sx == 1 && plane.sy == 1) {
+        return plane.row(y);
+    }
+    int last = plane.columns - 1;
+    // Vertically, the nearer of the rows above and below gets a quarter of
+    // the weight; horizontally likewise for the nearer column
+    const uint8_t* cur = plane.row(y / plane.sy);
+    const uint8_t* near = cur;
+    if (plane.sy == 2) {
+        near = plane.row(std::clamp(y / 2 + (y & 1 ? 1 : -1), 0, plane.rows - 1));
+    }
+    if (plane.sx == 1 && plane.sy == 2) {
+        for (int x = 0; x < width; x++) {
+            out[x] = static_cast<uint8_t>((3 * cur[x] + near[x] + 2) >> 2);
+        }
+        return out;
+    }
+    if (plane.sx == 2 && plane.sy <= 2) {
+        int* sum = sums.data();
+        for (int x = 0; x <= last; x++) {
+            sum[x] = 3 * cur[x] + near[x];
+        }
+        for (int x = 0; x <= last; x++) {
+            out[2 * x] = static_cast<uint8_t>((3 * sum[x] + sum[std::max(x - 1, 0)] + 8) >> 4);
+            out[2 * x + 1] = static_cast<uint8_t>((3 * sum[x] + sum[std::min(x + 1, last)] + 8) >> 4);
+        }
+        return out;
+    }
+    const uint8_t* src = plane.row(y / plane.sy);
+    for (int x = 0; x < width; x++) {
+        out[x] = src[x / plane.sx];
+    }
+    return out;
+}
+
+} // namespace
+
+void jpeg_scaled_size(const JpegHeader& header, int scale_denom, int& width, int& height) {
+    width = (header.width + scale_denom - 1) / scale_denom;
+    height = (header.height + scale_denom - 1) / scale_denom;
+}
+
+bool jpeg_decode(const unsigned char* data, size_t size, const JpegHeader& header, int scale_denom,
+                 const MutableImageView& dst, const ExecutionOptions& exec, std::string& error) {
+    if (scale_denom != 1 && scale_denom != 2 && scale_denom != 4 && scale_denom != 8) {
+        error = "scale must be 1, 2, 4 or 8";
+        return false;
+    }
+    size_t component_count = header.components.size();
+    int width, height;
+    jpeg_scaled_size(header, scale_denom, width, height);
+    if (dst.width() != width || dst.height() != height || dst.channels() != (component_count == 1 ? 1 : 3)) {
+        error = "destination does not match the JPEG";
+        return false;
+    }
+    for (const JpegComponent& c : header.components) {
+        if (!header.has_quant[c.quant_table]) {
+            error = "component uses an undefined quantization table";
+            return false;
+        }
+        if (header.h_max % c.h != 0 || header.v_max % c.v != 0) {
+            error = "unsupported chroma subsampling";
+            return false;
+        }
+    }
+
+    const DctKernels& kernels = dct_kernels();
+    int block = 8 / scale_denom;
+    std::vector<SamplePlane> planes(component_count);
+    std::vector<std::array<float, 64>> scales(component_count);
+    for (size_t i = 0; i < component_count; i++) {
+        const JpegComponent& c = header.components[i];
+        SamplePlane& plane = planes[i];
+        plane.sx = header.h_max / c.h;
+        plane.sy = header.v_max / c.v;
+        plane.stride = static_cast<size_t>(header.mcus_x) * c.h * block;
+        plane.samples = std::make_unique_for_overwrite<uint8_t[]>(plane.stride * header.mcus_y * c.v * block);
+        plane.columns = (width + plane.sx - 1) / plane.sx;
+        plane.rows = (height + plane.sy - 1) / plane.sy;
+        if (block == 8) {
+            inverse_dct_scales(header.quant[c.quant_table], scales[i].data());
+        } else {
+            for (int k = 0; k < 64; k++) {
+                scales[i][k] = header.quant[c.quant_table][k] * block / 8.0f;
+            }
+        }
+    }
+
+    const auto& basis1 = idct_basis<1>();
+    const auto& basis2 = idct_basis<2>();
+    const auto& basis4 = idct_basis<4>();
+
+    // Inverse DCT of MCU row my of every component; streamed coefficient
+    // planes hold just that row
+    auto reconstruct_row = [&](std::span<const JpegCoefficientPlane> coefficients, bool streamed, int my) {
+        for (size_t i = 0; i < component_count; i++) {
+            const JpegComponent& c = header.components[i];
+            const SamplePlane& plane = planes[i];
+            const float* scale = scales[i].data();
+            for (int v = 0; v < c.v; v++) {
+                uint8_t* out = plane.samples.get() + static_cast<size_t>(my * c.v + v) * block * plane.stride;
+                const int16_t* in = coefficients[i].block(0, streamed ? v : my * c.v + v);
+                int blocks = header.mcus_x * c.h;
+                for (int bx = 0; bx < blocks; bx++, in += 64) {
+                    switch (block) {
+                        case 8:
+                            kernels.inverse_dequantize(in, scale, out + bx * 8, plane.stride);
+                            break;
+                        case 4:
+                            scaled_idct<4>(in, scale, basis4, out + bx * 4, plane.stride);
+                            break;
+                        case 2:
+                            scaled_idct<2>(in, scale, basis2, out + bx * 2, plane.stride);
+                            break;
+                        default:
+                            scaled_idct<1>(in, scale, basis1, out + bx, plane.stride);
+                            break;
+                    }
+                }
+            }
+        }
+    };
+
+    bool parallel = exec.pool && exec.pool->size() >= 2 &&
+                    static_cast<size_t>(width) * height * dst.channels() >= exec.parallel_threshold;
+    std::vector<std::vector<int16_t>> storage(component_count);
+    std::vector<JpegCoefficientPlane> coefficients(component_count);
+    JpegHeader scratch = header;
+    bool single_scan = !header.progressive && header.first_scan_components == static_cast<int>(component_count);
+    if (single_scan && !(parallel && header.restart_interval > 0)) {
+        // One interleaved scan: each MCU row is reconstructed as soon as it
+        // is decoded, while its coefficients are still in cache
+        for (size_t i = 0; i < component_count; i++) {
+            const JpegComponent& c = header.components[i];
+            size_t stride = static_cast<size_t>(header.mcus_x) * c.h;
+            storage[i].resize(stride * c.v * 64);
+            coefficients[i] = JpegCoefficientPlane{storage[i].data(), stride};
+        }
+        RowCallback on_row = [&](int my) {
+            reconstruct_row(coefficients, true, my);
+            return true;
+        };
+        if (!Parser(data, size, scratch, error).run(coefficients, true, &on_row)) {
+            return false;
+        }
+    } else {
+        // Progressive or multi-scan: every scan has to be in before any block
+        // is final. With restart markers and a pool, a sequential scan also
+        // lands here so that its restart segments decode in parallel.
+        for (size_t i = 0; i < component_count; i++) {
+            const JpegComponent& c = header.components[i];
+            size_t stride = static_cast<size_t>(header.mcus_x) * c.h;
+            storage[i].resize(stride * header.mcus_y * c.v * 64);
+            coefficients[i] = JpegCoefficientPlane{storage[i].data(), stride};
+        }
+        if (!Parser(data, size, scratch, error, parallel ? exec.pool : nullptr).run(coefficients, true)) {
+            return false;
+        }
+        auto reconstruct = [&](size_t begin, size_t end) {
+            for (size_t my = begin; my < end; my++) {
+                reconstruct_row(coefficients, false, static_cast<int>(my));
+            }
+        };
+        if (parallel) {
+            exec.pool->parallel_for(header.mcus_y, 4, reconstruct);
+        } else {
+            reconstruct(0, header.mcus_y);
+        }
+    }
+    storage.clear();
+
+    // Upsample and convert to the output colour space in row bands
+    bool rgb = header.is_rgb();
+    auto convert = [&](size_t begin, size_t end) {
+        std::vector<uint8_t> upsampled(component_count * (static_cast<size_t>(width) + 16));
+        std::vector<int> sums(static_cast<size_t>(width) + 16);
+        const uint8_t* rows[3];
+        for (size_t y = begin; y < end; y++) {
+            for (size_t i = 0; i < component_count; i++) {
+                rows[i] = upsample_row(planes[i], static_cast<int>(y), width,
+                                       upsampled.data() + i * (static_cast<size_t>(width) + 16), sums);
+            }
+            unsigned char* out = dst.row(static_cast<int>(y));
+            if (component_count == 1) {
+                std::memcpy(out, rows[0], width);
+            } else if (rgb) {
+                for (int x = 0; x < width; x++) {
+                    out[3 * x] = rows[0][x];
+                    out[3 * x + 1] = rows[1][x];
+                    out[3 * x + 2] = rows[2][x];
+                }
+            } else {
+                kernels.ycc_to_rgb(rows[0], rows[1], rows[2], out, width);
+            }
+        }
+    };
+    if (parallel) {
+        exec.pool->parallel_for(height, 64, convert);
+    } else {
+        convert(0, height);
+    }
+    return true;
+}
+
+} // namespace vanity::detail
@@ -0,0 +1,66 @@
+#ifndef VANITY_JPEG_READER_HPP
+#define VANITY_JPEG_READER_HPP
+
+#include "jpeg_common.hpp"
+#include "vanity/image_ops.hpp"
+#include "vanity/image_view.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vanity::detail {
+
+// Frame parameters and the tables defined before the first scan
+struct JpegHeader {
+    int width = 0;
+    int height = 0;
+    bool progressive = false;
+    std::vector<JpegComponent> components;
+    int h_max = 1;
+    int v_max = 1;
+    int mcus_x = 0;         // MCUs of the interleaved layout
+    int mcus_y = 0;
+    int restart_interval = 0;
+    uint16_t quant[4][64] = {};     // natural order
+    bool has_quant[4] = {};
+    int adobe_transform = -1;       // APP14 color transform, -1 without APP14
+    int first_scan_components = 0;
+
+    // Whether three components hold RGB rather than YCbCr
+    bool is_rgb() const;
+};
+
+// Parse markers up to the first scan: frame header, quantization tables,
+// restart interval and APP14. Arithmetic-coded and lossless or
+// hierarchical frames are rejected. error explains a false return.
+bool jpeg_read_header(const unsigned char* data, size_t size, JpegHeader& header, std::string& error);
+
+// Entropy-decode every scan of a Huffman JPEG into planes, one per
+// component, without dequantizing or any IDCT. Progressive scans only add
+// to what is there, so for a progressive JPEG the planes must start zeroed.
+// Sequential scans with restart markers decode one restart segment per
+// task on exec.pool; without markers the entropy stream is decoded serially.
+bool jpeg_decode_coefficients(const unsigned char* data, size_t size, const JpegHeader& header,
+                              std::span<const JpegCoefficientPlane> planes, std::string& error,
+                              const ExecutionOptions& exec = {});
+
+// Output size of jpeg_decode at 1/scale_denom (1, 2, 4 or 8), rounded up
+void jpeg_scaled_size(const JpegHeader& header, int scale_denom, int& width, int& height);
+
+// Decode a sequential or progressive JPEG to gray (one component) or RGB
+// (three) at 1/scale_denom of its size into dst, whose dimensions must
+// match jpeg_scaled_size. Scaled decodes run a reduced inverse DCT on each
+// block's lowest frequencies instead of decoding and then downsampling.
+// A sequential JPEG with one interleaved scan is reconstructed one MCU row
+// at a time as it is entropy-decoded, unless it has restart markers and
+// exec allows threads: then its restart segments are entropy-decoded in
+// parallel and the MCU rows reconstructed in parallel afterwards. Colour
+// conversion runs in row bands on exec.pool. error explains a false return.
+bool jpeg_decode(const unsigned char* data, size_t size, const JpegHeader& header, int scale_denom,
+                 const MutableImageView& dst, const ExecutionOptions& exec, std::string& error);
+
+} // namespace vanity::detail
+
+#endif // VANITY_JPEG_READER_HPP
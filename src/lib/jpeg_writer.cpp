@@ -0,0 +1,527 @@
+#include "jpeg_writer.hpp"
+#include "dct.hpp"
+#include "jpeg_common.hpp"
+#include "vanity/image_sink.hpp"
+#include "vanity/thread_pool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace vanity::detail {
+
+namespace {
+
+// Pixels per stripe of MCU rows; each stripe is one restart interval
+constexpr size_t kStripePixels = size_t(1) << 18;
+
+// Code and code length of every symbol of one Huffman table
+struct HuffmanCodes {
+    uint16_t code[256] = {};
+    uint8_t size[256] = {};
+
+    explicit HuffmanCodes(const JpegHuffmanSpec& spec) {
+        // Canonical codes (T.81 Annex C): consecutive within a length, and
+        // shifted left by one for each step to the next length
+        uint32_t next = 0;
+        int k = 0;
+        for (int length = 1; length <= 16; length++) {
+            for (int i = 0; i < spec.counts[length - 1]; i++) {
+                code[spec.symbols[k]] = static_cast<uint16_t>(next++);
+                size[spec.symbols[k]] = static_cast<uint8_t>(length);
+                k++;
+            }
+            next <<= 1;
+        }
+    }
+};
+
+const HuffmanCodes& dc_codes(bool chrominance) {
+    static const HuffmanCodes luminance(kJpegDcLuminance);
+    static const HuffmanCodes chroma(kJpegDcChrominance);
+    return chrominance ? chroma : luminance;
+}
+
+const HuffmanCodes& ac_codes(bool chrominance) {
+    static const HuffmanCodes luminance(kJpegAcLuminance);
+    static const HuffmanCodes chroma(kJpegAcChrominance);
+    return chrominance ? chroma : luminance;
+}
+
+// MSB-first bit writer with 0xFF byte stuffing into a growing vector
+class EntropyWriter {
+public:
+    explicit EntropyWriter(std::vector<unsigned char>& out) : out_(out), pos_(out.size()) {}
+
+    // Make room for `bytes` more output (with stuffing) before a run of put calls
+    void reserve(size_t bytes) {
+        if (pos_ + bytes > out_.size()) {
+            out_.resize(std::max(out_.size() * 2, pos_ + bytes));
+        }
+    }
+
+    // Append the low `count` bits of bits (count <= 32)
+    void put(uint32_t bits, int count) {
+        buffer_ = (buffer_ << count) | bits;
+        count_ += count;
+        if (count_ >= 32) {
+            count_ -= 32;
+            emit_word(static_cast<uint32_t>(buffer_ >> count_));
+        }
+    }
+
+    // Pad the last byte with 1 bits, as T.81 requires before a marker, append
+    // the marker (unless 0) and trim the vector to the bytes written
+    void finish_with_marker(unsigned char marker) {
+        int pad = (8 - count_ % 8) % 8;
+        put((1u << pad) - 1, pad);
+        while (count_ > 0) {
+            count_ -= 8;
+            emit_byte(static_cast<unsigned char>(buffer_ >> count_));
+        }
+        if (marker) {
+            out_[pos_++] = 0xff;
+            out_[pos_++] = marker;
+        }
+        out_.resize(pos_);
+    }
+
+private:
+    void emit_byte(unsigned char byte) {
+        out_[pos_++] = byte;
+        if (byte == 0xff) {
+            out_[pos_++] = 0;
+        }
+    }
+
+    void emit_word(uint32_t word) {
+        // Only a 0xff byte needs stuffing; words without one go out whole
+        uint32_t inverted = ~word;
+        if (((inverted - 0x01010101u) & ~inverted & 0x80808080u) == 0) {
+            out_[pos_] = static_cast<unsigned char>(word >> 24);
+            out_[pos_ + 1] = static_cast<unsigned char>(word >> 16);
+            out_[pos_ + 2] = static_cast<unsigned char>(word >> 8);
+            out_[pos_ + 3] = static_cast<unsigned char>(word);
+            pos_ += 4;
+            return;
+        }
+        emit_byte(static_cast<unsigned char>(word >> 24));
+        emit_byte(static_cast<unsigned char>(word >> 16));
+        emit_byte(static_cast<unsigned char>(word >> 8));
+        emit_byte(static_cast<unsigned char>(word));
+    }
+
+    std::vector<unsigned char>& out_;
+    size_t pos_;
+    uint64_t buffer_ = 0;
+    int count_ = 0;
+};
+
+// Worst case for one block: 64 codes of up to 16 + 11 bits, every byte stuffed
+constexpr size_t kMaxBlockBytes = 2 * (64 * 27 / 8 + 1);
+
+// Huffman code plus magnitude bits of value, as one field of up to 27 bits
+inline void put_coded(EntropyWriter& writer, const HuffmanCodes& codes, int run, int value) {
+    unsigned magnitude = static_cast<unsigned>(value < 0 ? -value : value);
+    int bits = magnitude ? 32 - __builtin_clz(magnitude) : 0;
+    int symbol = (run << 4) | bits;
+    // Negative values are sent as value - 1 in `bits` bits (one's complement)
+    uint32_t extra = static_cast<uint32_t>(value < 0 ? value - 1 : value) & ((1u << bits) - 1);
+    writer.put((uint32_t(codes.code[symbol]) << bits) | extra, codes.size[symbol] + bits);
+}
+
+void encode_block(EntropyWriter& writer, const int16_t* coefficients, int& last_dc, const HuffmanCodes& dc,
+                  const HuffmanCodes& ac) {
+    put_coded(writer, dc, 0, coefficients[0] - last_dc);
+    last_dc = coefficients[0];
+
+    int run = 0;
+    for (int k = 1; k < 64; k++) {
+        int value = coefficients[kJpegZigzag[k]];
+        if (value == 0) {
+            run++;
+            continue;
+        }
+        while (run >= 16) {
+            writer.put(ac.code[0xf0], ac.size[0xf0]);
+            run -= 16;
+        }
+        put_coded(writer, ac, run, value);
+        run = 0;
+    }
+    if (run > 0) {
+        writer.put(ac.code[0x00], ac.size[0x00]);
+    }
+}
+
+// Frame layout and tables shared by all stripes of one image
+struct FrameLayout {
+    int width = 0;
+    int height = 0;
+    std::vector<JpegComponent> components;
+    uint16_t quant[4][64] = {};
+    int adobe_transform = -1;
+    int h_max = 1;
+    int v_max = 1;
+    int mcus_x = 0;
+    int mcus_y = 0;
+    int rows_per_stripe = 0;    // MCU rows per restart interval
+    int stripes = 0;
+
+    // Derive the MCU grid and the stripes from the dimensions and components
+    void plan() {
+        for (const JpegComponent& c : components) {
+            h_max = std::max(h_max, c.h);
+            v_max = std::max(v_max, c.v);
+        }
+        mcus_x = (width + 8 * h_max - 1) / (8 * h_max);
+        mcus_y = (height + 8 * v_max - 1) / (8 * v_max);
+        size_t row_pixels = static_cast<size_t>(mcus_x) * 64 * h_max * v_max;
+        // The restart interval (in MCUs) is a 16-bit field
+        rows_per_stripe = static_cast<int>(std::clamp<size_t>(kStripePixels / row_pixels, 1, 65535 / mcus_x));
+        stripes = (mcus_y + rows_per_stripe - 1) / rows_per_stripe;
+    }
+};
+
+// Encode the MCU rows of one stripe into out, ending with the restart marker
+// that separates it from the next stripe. Source supplies the quantized
+// blocks: start_row(mcu_row) is called before each MCU row, then
+// block(component, bx, by) for every block of the row in scan order.
+template <typename Source>
+void encode_stripe(const FrameLayout& layout, Source& source, int stripe, std::vector<unsigned char>& out) {
+    const HuffmanCodes& dc_luma = dc_codes(false);
+    const HuffmanCodes& ac_luma = ac_codes(false);
+    const HuffmanCodes& dc_chroma = dc_codes(true);
+    const HuffmanCodes& ac_chroma = ac_codes(true);
+
+    out.clear();
+    EntropyWriter writer(out);
+    int last_dc[3] = {0, 0, 0};
+    size_t blocks_per_mcu = 0;
+    for (const JpegComponent& c : layout.components) {
+        blocks_per_mcu += static_cast<size_t>(c.h) * c.v;
+    }
+
+    int first_row = stripe * layout.rows_per_stripe;
+    int end_row = std::min(layout.mcus_y, first_row + layout.rows_per_stripe);
+    for (int mcu_row = first_row; mcu_row < end_row; mcu_row++) {
+        source.start_row(mcu_row);
+        for (int mcu = 0; mcu < layout.mcus_x; mcu++) {
+            writer.reserve(blocks_per_mcu * kMaxBlockBytes);
+            for (size_t i = 0; i < layout.components.size(); i++) {
+                const JpegComponent& c = layout.components[i];
+                const HuffmanCodes& dc = i == 0 ? dc_luma : dc_chroma;
+                const HuffmanCodes& ac = i == 0 ? ac_luma : ac_chroma;
+                for (int v = 0; v < c.v; v++) {
+                    for (int h = 0; h < c.h; h++) {
+                        const int16_t* block = source.block(static_cast<int>(i), mcu * c.h + h, mcu_row * c.v + v);
+                        encode_block(writer, block, last_dc[i], dc, ac);
+                    }
+                }
+            }
+        }
+    }
+
+    writer.reserve(16);
+    writer.finish_with_marker(stripe + 1 < layout.stripes ? static_cast<unsigned char>(0xd0 + stripe % 8) : 0);
+}
+
+// Converts pixel rows to level-shifted Y/Cb/Cr (or gray) planes one MCU row
+// at a time and quantizes blocks from them on request
+class PixelSource {
+public:
+    PixelSource(const FrameLayout& layout, const ImageView& image, const float* luma_scales,
+                const float* chroma_scales)
+        : image_(image), gray_(layout.components.size() == 1),
+          subsample_(!gray_ && layout.h_max == 2), mcu_height_(8 * layout.v_max),
+          plane_width_(layout.mcus_x * 8 * layout.h_max), chroma_width_(subsample_ ? plane_width_ / 2 : plane_width_),
+          luma_scales_(luma_scales), chroma_scales_(chroma_scales), forward_(dct_kernels().forward_quantize) {
+        size_t plane_size = static_cast<size_t>(plane_width_) * mcu_height_;
+        y_plane_.resize(plane_size);
+        if (!gray_) {
+            cb_plane_.resize(plane_size);
+            cr_plane_.resize(plane_size);
+        }
+        if (subsample_) {
+            cb_small_.resize(static_cast<size_t>(chroma_width_) * 8);
+            cr_small_.resize(static_cast<size_t>(chroma_width_) * 8);
+        }
+    }
+
+    void start_row(int mcu_row) {
+        mcu_row_ = mcu_row;
+        int width = image_.width();
+        int channels = image_.channels();
+        // Rows and columns past the edge repeat the last pixel
+        for (int r = 0; r < mcu_height_; r++) {
+            int y = std::min(mcu_row * mcu_height_ + r, image_.height() - 1);
+            const unsigned char* src = image_.row(y);
+            float* yp = y_plane_.data() + static_cast<size_t>(r) * plane_width_;
+            if (gray_) {
+                for (int x = 0; x < width; x++) {
+                    yp[x] = src[x * channels] - 128.0f;
+                }
+            } else {
+                float* cbp = cb_plane_.data() + static_cast<size_t>(r) * plane_width_;
+                float* crp = cr_plane_.data() + static_cast<size_t>(r) * plane_width_;
+                for (int x = 0; x < width; x++) {
+                    float red = src[x * channels];
+                    float green = src[x * channels + 1];
+                    float blue = src[x * channels + 2];
+                    yp[x] = 0.299f * red + 0.587f * green + 0.114f * blue - 128.0f;
+                    cbp[x] = -0.168736f * red - 0.331264f * green + 0.5f * blue;
+                    crp[x] = 0.5f * red - 0.418688f * green - 0.081312f * blue;
+                }
+                std::fill(cbp + width, cbp + plane_width_, cbp[width - 1]);
+                std::fill(crp + width, crp + plane_width_, crp[width - 1]);
+            }
+            std::fill(yp + width, yp + plane_width_, yp[width - 1]);
+        }
+        // With subsampling, chroma is averaged over 2x2 pixels
+        if (subsample_) {
+            for (int r = 0; r < 8; r++) {
+                const float* cb0 = cb_plane_.data() + static_cast<size_t>(2 * r) * plane_width_;
+                const float* cr0 = cr_plane_.data() + static_cast<size_t>(2 * r) * plane_width_;
+                float* cbs = cb_small_.data() + static_cast<size_t>(r) * chroma_width_;
+                float* crs = cr_small_.data() + static_cast<size_t>(r) * chroma_width_;
+                for (int x = 0; x < chroma_width_; x++) {
+                    cbs[x] = 0.25f * (cb0[2 * x] + cb0[2 * x + 1] + cb0[plane_width_ + 2 * x] +
+                                      cb0[plane_width_ + 2 * x + 1]);
+                    crs[x] = 0.25f * (cr0[2 * x] + cr0[2 * x + 1] + cr0[plane_width_ + 2 * x] +
+                                      cr0[plane_width_ + 2 * x + 1]);
+                }
+            }
+        }
+    }
+
+    const int16_t* block(int component, int bx, int by) {
+        if (component == 0) {
+            int row = by - mcu_row_ * (mcu_height_ / 8);
+            forward_(y_plane_.data() + static_cast<size_t>(row) * 8 * plane_width_ + bx * 8, plane_width_,
+                     luma_scales_, coefficients_);
+        } else {
+            const std::vector<float>& plane = component == 1 ? (subsample_ ? cb_small_ : cb_plane_)
+                                                             : (subsample_ ? cr_small_ : cr_plane_);
+            forward_(plane.data() + bx * 8, chroma_width_, chroma_scales_, coefficients_);
+        }
+        return coefficients_;
+    }
+
+private:
+    const ImageView& image_;
+    bool gray_;
+    bool subsample_;
+    int mcu_height_;
+    int plane_width_;
+    int chroma_width_;
+    const float* luma_scales_;
+    const float* chroma_scales_;
+    void (*forward_)(const float*, size_t, const float*, int16_t*);
+    int mcu_row_ = 0;
+    std::vector<float> y_plane_, cb_plane_, cr_plane_, cb_small_, cr_small_;
+    alignas(32) int16_t coefficients_[64];
+};
+
+// Reads blocks straight from coefficient planes
+class CoefficientSource {
+public:
+    explicit CoefficientSource(std::span<const JpegCoefficientPlane> planes) : planes_(planes) {}
+
+    void start_row(int) {}
+
+    const int16_t* block(int component, int bx, int by) const { return planes_[component].block(bx, by); }
+
+private:
+    std::span<const JpegCoefficientPlane> planes_;
+};
+
+void put_u16(std::vector<unsigned char>& out, int value) {
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+void put_huffman_table(std::vector<unsigned char>& out, int table_class, int id, const JpegHuffmanSpec& spec) {
+    out.push_back(static_cast<unsigned char>(table_class << 4 | id));
+    out.insert(out.end(), spec.counts, spec.counts + 16);
+    out.insert(out.end(), spec.symbols, spec.symbols + spec.symbol_count);
+}
+
+// Markers from SOI up to and including the scan header
+std::vector<unsigned char> frame_headers(const FrameLayout& layout) {
+    // Everything up to the scan comes to about 600 bytes for a colour image
+    std::vector<unsigned char> header;
+    header.reserve(1024);
+    put_u16(header, 0xffd8);
+    if (layout.adobe_transform >= 0) {
+        header.insert(header.end(), {0xff, 0xee, 0, 14, 'A', 'd', 'o', 'b', 'e', 0, 100, 0, 0, 0, 0});
+        header.push_back(static_cast<unsigned char>(layout.adobe_transform));
+    } else {
+        header.insert(header.end(), {0xff, 0xe0, 0, 16, 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0});
+    }
+
+    // Quantization tables in use, in zig-zag order; 16-bit entries make the
+    // frame extended rather than baseline
+    bool used[4] = {};
+    for (const JpegComponent& c : layout.components) {
+        used[c.quant_table] = true;
+    }
+    bool extended = false;
+    for (int t = 0; t < 4; t++) {
+        if (!used[t]) {
+            continue;
+        }
+        bool wide = std::any_of(layout.quant[t], layout.quant[t] + 64, [](uint16_t q) { return q > 255; });
+        extended = extended || wide;
+        put_u16(header, 0xffdb);
+        put_u16(header, wide ? 131 : 67);
+        header.push_back(static_cast<unsigned char>((wide ? 0x10 : 0) | t));
+        for (int k = 0; k < 64; k++) {
+            uint16_t q = layout.quant[t][kJpegZigzag[k]];
+            if (wide) {
+                header.push_back(static_cast<unsigned char>(q >> 8));
+            }
+            header.push_back(static_cast<unsigned char>(q));
+        }
+    }
+
+    int components = static_cast<int>(layout.components.size());
+    put_u16(header, extended ? 0xffc1 : 0xffc0);
+    put_u16(header, 8 + 3 * components);
+    header.push_back(8);
+    put_u16(header, layout.height);
+    put_u16(header, layout.width);
+    header.push_back(static_cast<unsigned char>(components));
+    for (const JpegComponent& c : layout.components) {
+        header.push_back(static_cast<unsigned char>(c.id));
+        header.push_back(static_cast<unsigned char>(c.h << 4 | c.v));
+        header.push_back(static_cast<unsigned char>(c.quant_table));
+    }
+
+    // Huffman tables: the first component uses the luminance pair, the others chrominance
+    put_u16(header, 0xffc4);
+    size_t length_at = header.size();
+    put_u16(header, 0);
+    put_huffman_table(header, 0, 0, kJpegDcLuminance);
+    put_huffman_table(header, 1, 0, kJpegAcLuminance);
+    if (components > 1) {
+        put_huffman_table(header, 0, 1, kJpegDcChrominance);
+        put_huffman_table(header, 1, 1, kJpegAcChrominance);
+    }
+    size_t length = header.size() - length_at;
+    header[length_at] = static_cast<unsigned char>(length >> 8);
+    header[length_at + 1] = static_cast<unsigned char>(length);
+
+    if (layout.stripes > 1) {
+        header.insert(header.end(), {0xff, 0xdd, 0, 4});
+        put_u16(header, layout.rows_per_stripe * layout.mcus_x);
+    }
+
+    put_u16(header, 0xffda);
+    put_u16(header, 6 + 2 * components);
+    header.push_back(static_cast<unsigned char>(components));
+    for (int i = 0; i < components; i++) {
+        header.push_back(static_cast<unsigned char>(layout.components[i].id));
+        header.push_back(i == 0 ? 0x00 : 0x11);
+    }
+    header.insert(header.end(), {0, 63, 0});
+    return header;
+}
+
+// Write the headers, then the stripes a batch at a time in order (as
+// png_encode does with its row ranges); make_source(stripe) creates the
+// block source for one stripe's encoder
+template <typename MakeSource>
+bool write_frame(const FrameLayout& layout, ImageSink& sink, const ExecutionOptions& exec, size_t frame_bytes,
+                 const MakeSource& make_source) {
+    std::vector<unsigned char> header = frame_headers(layout);
+    if (!sink.write(header.data(), header.size())) {
+        return false;
+    }
+
+    size_t stripe_count = static_cast<size_t>(layout.stripes);
+    bool parallel = exec.pool && exec.pool->size() >= 2 && stripe_count > 1 && frame_bytes >= exec.parallel_threshold;
+    size_t batch = parallel ? 2 * (static_cast<size_t>(exec.pool->size()) + 1) : 1;
+    std::vector<std::vector<unsigned char>> stripes(std::min(batch, stripe_count));
+    auto encode = [&](size_t stripe, std::vector<unsigned char>& out) {
+        auto source = make_source();
+        encode_stripe(layout, source, static_cast<int>(stripe), out);
+    };
+
+    for (size_t done = 0; done < stripe_count; done += stripes.size()) {
+        size_t count = std::min(stripes.size(), stripe_count - done);
+        if (parallel && count > 1) {
+            exec.pool->parallel_for(count, 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    encode(done + i, stripes[i]);
+                }
+            });
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                encode(done + i, stripes[i]);
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (!sink.write(stripes[i].data(), stripes[i].size())) {
+                return false;
+            }
+        }
+    }
+
+    static const unsigned char eoi[2] = {0xff, 0xd9};
+    return sink.write(eoi, 2);
+}
+
+} // namespace
+
+bool jpeg_encode(const ImageView& image, ImageSink& sink, const WriteOptions& options) {
+    int channels = image.channels();
+    if (image.empty() || channels < 1 || channels > 4 || image.width() > 65535 || image.height() > 65535) {
+        return false;
+    }
+
+    FrameLayout layout;
+    layout.width = image.width();
+    layout.height = image.height();
+    bool gray = channels < 3;
+    bool subsample = !gray && options.quality <= 90;
+    layout.components.push_back(JpegComponent{1, subsample ? 2 : 1, subsample ? 2 : 1, 0});
+    if (!gray) {
+        layout.components.push_back(JpegComponent{2, 1, 1, 1});
+        layout.components.push_back(JpegComponent{3, 1, 1, 1});
+    }
+    layout.plan();
+
+    uint8_t luma_quant[64];
+    uint8_t chroma_quant[64];
+    jpeg_quant_table(false, options.quality, luma_quant);
+    jpeg_quant_table(true, options.quality, chroma_quant);
+    std::copy(luma_quant, luma_quant + 64, layout.quant[0]);
+    std::copy(chroma_quant, chroma_quant + 64, layout.quant[1]);
+    float luma_scales[64];
+    float chroma_scales[64];
+    forward_dct_scales(layout.quant[0], luma_scales);
+    forward_dct_scales(layout.quant[1], chroma_scales);
+
+    size_t frame_bytes = static_cast<size_t>(image.height()) * image.row_bytes();
+    return write_frame(layout, sink, options.exec, frame_bytes,
+                       [&] { return PixelSource(layout, image, luma_scales, chroma_scales); });
+}
+
+bool jpeg_encode_coefficients(const JpegCoefficientFrame& frame, ImageSink& sink, const ExecutionOptions& exec) {
+    if (frame.width < 1 || frame.height < 1 || frame.width > 65535 || frame.height > 65535 ||
+        (frame.components.size() != 1 && frame.components.size() != 3) ||
+        frame.planes.size() != frame.components.size()) {
+        return false;
+    }
+    FrameLayout layout;
+    layout.width = frame.width;
+    layout.height = frame.height;
+    layout.components = frame.components;
+    std::memcpy(layout.quant, frame.quant, sizeof(layout.quant));
+    layout.adobe_transform = frame.adobe_transform;
+    layout.plan();
+
+    size_t frame_bytes = static_cast<size_t>(frame.width) * frame.height * frame.components.size();
+    return write_frame(layout, sink, exec, frame_bytes, [&] { return CoefficientSource(frame.planes); });
+}
+
+} // namespace vanity::detail
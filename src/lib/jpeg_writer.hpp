@@ -0,0 +1,40 @@
+#ifndef VANITY_JPEG_WRITER_HPP
+#define VANITY_JPEG_WRITER_HPP
+
+#include "jpeg_common.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/image_view.hpp"
+#include <vector>
+
+namespace vanity {
+class ImageSink;
+}
+
+namespace vanity::detail {
+
+// Encode an 8-bit, 1-4 channel view as baseline JPEG at options.quality
+// 1-2 channels become grayscale and alpha is dropped. Color images use
+// 4:2:0 chroma subsampling at quality 90 and below, 4:4:4 above (as
+// stb_image_write did). Larger images are cut into stripes of MCU rows
+// separated by restart markers, which options.exec encodes in parallel;
+// the output does not depend on the thread count.
+bool jpeg_encode(const ImageView& image, ImageSink& sink, const WriteOptions& options);
+
+// Already quantized coefficients of a whole frame, e.g. from
+// jpeg_decode_coefficients
+struct JpegCoefficientFrame {
+    int width = 0;
+    int height = 0;
+    std::vector<JpegComponent> components;      // 1 or 3; id, sampling and quant_table are used
+    std::vector<JpegCoefficientPlane> planes;   // one per component
+    uint16_t quant[4][64] = {};                 // natural order
+    int adobe_transform = -1;                   // written as APP14 when >= 0, else JFIF
+};
+
+// Entropy-code a coefficient frame with the standard Huffman tables, in the
+// same restart stripes (and on the same threads) as jpeg_encode
+bool jpeg_encode_coefficients(const JpegCoefficientFrame& frame, ImageSink& sink, const ExecutionOptions& exec);
+
+} // namespace vanity::detail
+
+#endif // VANITY_JPEG_WRITER_HPP
@@ -0,0 +1,118 @@
+#include "mapped_file.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace vanity::detail {
+
+namespace {
+
+// Chunk size for buffered reads of pipes and other unmappable files
+constexpr size_t kReadChunk = size_t(1) << 20;
+
+bool read_all(int fd, std::vector<unsigned char>& out, size_t size_hint) {
+    out.clear();
+    out.reserve(size_hint ? size_hint : kReadChunk);
+    for (;;) {
+        size_t used = out.size();
+        out.resize(used + kReadChunk);
+        ssize_t n = ::read(fd, out.data() + used, kReadChunk);
+        if (n < 0) {
+            if (errno == EINTR) {
+                out.resize(used);
+                continue;
+            }
+            out.clear();
+            return false;
+        }
+        out.resize(used + static_cast<size_t>(n));
+        if (n == 0) {
+            return true;
+        }
+    }
+}
+
+} // namespace
+
+MappedFile MappedFile::open(const char* path) {
+    MappedFile file;
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return file;
+    }
+
+    // Zeroed so a failed fstat reads as "not a regular file" below
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        size_t size = static_cast<size_t>(st.st_size);
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            ::madvise(mapping, size, MADV_SEQUENTIAL);
+            ::madvise(mapping, size, MADV_WILLNEED);
+            ::close(fd);
+            file.ok_ = true;
+            file.mapping_ = mapping;
+            file.data_ = static_cast<const unsigned char*>(mapping);
+            file.size_ = size;
+            return file;
+        }
+    }
+
+    // Pipes, devices, empty files and mmap failures: read it all
+    size_t hint = S_ISREG(st.st_mode) ? static_cast<size_t>(st.st_size) : 0;
+    file.ok_ = read_all(fd, file.buffer_, hint);
+    ::close(fd);
+    file.data_ = file.buffer_.data();
+    file.size_ = file.buffer_.size();
+    return file;
+}
+
+MappedFile::~MappedFile() {
+    reset();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : ok_(other.ok_)
+    , mapping_(other.mapping_)
+    , data_(other.data_)
+    , size_(other.size_)
+    , buffer_(std::move(other.buffer_)) {
+    other.ok_ = false;
+    other.mapping_ = nullptr;
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        reset();
+
+        ok_ = other.ok_;
+        mapping_ = other.mapping_;
+        data_ = other.data_;
+        size_ = other.size_;
+        buffer_ = std::move(other.buffer_);
+
+        other.ok_ = false;
+        other.mapping_ = nullptr;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void MappedFile::reset() {
+    if (mapping_) {
+        ::munmap(mapping_, size_);
+    }
+    ok_ = false;
+    mapping_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+}
+
+} // namespace vanity::detail
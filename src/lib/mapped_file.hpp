@@ -0,0 +1,44 @@
+#ifndef VANITY_MAPPED_FILE_HPP
+#define VANITY_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace vanity::detail {
+
+// Read-only contents of a file held in memory
+// Regular files are mmap'd (with sequential/will-need advice) so the page
+// cache is decoded from directly; pipes, character devices and anything
+// mmap refuses fall back to buffered reads into an owned buffer.
+class MappedFile {
+public:
+    // Factory method: opens and maps (or reads) the file; check ok() for failure
+    static MappedFile open(const char* path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool ok() const { return ok_; }
+    bool is_mapped() const { return mapping_ != nullptr; }
+    const unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    MappedFile() = default;
+    void reset();
+
+    bool ok_ = false;
+    void* mapping_ = nullptr;
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<unsigned char> buffer_;
+};
+
+} // namespace vanity::detail
+
+#endif // VANITY_MAPPED_FILE_HPP
@@ -0,0 +1,276 @@
+#include "pixel_kernels.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VANITY_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace vanity::detail {
+
+namespace {
+
+// Scalar fallback: seed one pixel, then double the filled prefix with memcpy
+void fill_pattern_scalar(unsigned char* dst, size_t count, const unsigned char* pixel, int pixel_bytes) {
+    if (count == 0) {
+        return;
+    }
+    if (pixel_bytes == 1) {
+        std::memset(dst, pixel[0], count);
+        return;
+    }
+
+    size_t total = count * pixel_bytes;
+    std::memcpy(dst, pixel, pixel_bytes);
+    size_t filled = pixel_bytes;
+    while (filled < total) {
+        size_t chunk = filled < total - filled ? filled : total - filled;
+        std::memcpy(dst + filled, dst, chunk);
+        filled += chunk;
+    }
+}
+
+void copy_row_scalar(unsigned char* dst, const unsigned char* src, size_t bytes) {
+    std::memcpy(dst, src, bytes);
+}
+
+void swap_bytes16_scalar(unsigned char* dst, const unsigned char* src, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        unsigned char hi = src[2 * i];
+        dst[2 * i] = src[2 * i + 1];
+        dst[2 * i + 1] = hi;
+    }
+}
+
+#if VANITY_X86_KERNELS
+
+// Patterns at most this many bytes long use the vector paths
+constexpr int kMaxVectorPattern = 16;
+
+// Below this many output bytes, building the vector pattern costs more than it saves
+constexpr size_t kMinVectorFill = 256;
+
+// Lay out the pattern so that it repeats with a period that is a whole number
+// of vectors: lcm(pixel_bytes, vector_bytes) = vector_bytes * registers.
+// Returns the register count.
+int build_vector_pattern(unsigned char* pattern, const unsigned char* pixel, int pixel_bytes, int vector_bytes) {
+    int registers = pixel_bytes / std::gcd(pixel_bytes, vector_bytes);
+    int period = registers * vector_bytes;
+    for (int i = 0; i < period; i++) {
+        pattern[i] = pixel[i % pixel_bytes];
+    }
+    return registers;
+}
+
+void fill_pattern_sse2(unsigned char* dst, size_t count, const unsigned char* pixel, int pixel_bytes) {
+    size_t total = count * pixel_bytes;
+    if (pixel_bytes == 1 || pixel_bytes > kMaxVectorPattern || total < kMinVectorFill) {
+        fill_pattern_scalar(dst, count, pixel, pixel_bytes);
+        return;
+    }
+
+    alignas(16) unsigned char pattern[kMaxVectorPattern * 16];
+    int registers = build_vector_pattern(pattern, pixel, pixel_bytes, 16);
+    __m128i v[kMaxVectorPattern];
+    for (int r = 0; r < registers; r++) {
+        v[r] = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern) + r);
+    }
+
+    size_t period = static_cast<size_t>(registers) * 16;
+    size_t i = 0;
+    for (; i + period <= total; i += period) {
+        for (int r = 0; r < registers; r++) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i) + r, v[r]);
+        }
+    }
+    std::memcpy(dst + i, pattern, total - i);
+}
+
+void copy_row_sse2(unsigned char* dst, const unsigned char* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 32), c);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 48), d);
+    }
+    std::memcpy(dst + i, src + i, bytes - i);
+}
+
+void swap_bytes16_sse2(unsigned char* dst, const unsigned char* src, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), v);
+    }
+    swap_bytes16_scalar(dst + 2 * i, src + 2 * i, count - i);
+}
+
+__attribute__((target("avx2")))
+void fill_pattern_avx2(unsigned char* dst, size_t count, const unsigned char* pixel, int pixel_bytes) {
+    size_t total = count * pixel_bytes;
+    if (pixel_bytes == 1 || pixel_bytes > kMaxVectorPattern || total < kMinVectorFill) {
+        fill_pattern_scalar(dst, count, pixel, pixel_bytes);
+        return;
+    }
+
+    alignas(32) unsigned char pattern[kMaxVectorPattern * 32];
+    int registers = build_vector_pattern(pattern, pixel, pixel_bytes, 32);
+    __m256i v[kMaxVectorPattern];
+    for (int r = 0; r < registers; r++) {
+        v[r] = _mm256_load_si256(reinterpret_cast<const __m256i*>(pattern) + r);
+    }
+
+    size_t period = static_cast<size_t>(registers) * 32;
+    size_t i = 0;
+    for (; i + period <= total; i += period) {
+        for (int r = 0; r < registers; r++) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i) + r, v[r]);
+        }
+    }
+    std::memcpy(dst + i, pattern, total - i);
+}
+
+__attribute__((target("avx2")))
+void copy_row_avx2(unsigned char* dst, const unsigned char* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 128 <= bytes; i += 128) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 64));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 96));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), b);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 64), c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 96), d);
+    }
+    std::memcpy(dst + i, src + i, bytes - i);
+}
+
+__attribute__((target("avx2")))
+void swap_bytes16_avx2(unsigned char* dst, const unsigned char* src, size_t count) {
+    const __m256i order = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                           1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 2 * i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), _mm256_shuffle_epi8(v, order));
+    }
+    swap_bytes16_scalar(dst + 2 * i, src + 2 * i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void fill_pattern_avx512(unsigned char* dst, size_t count, const unsigned char* pixel, int pixel_bytes) {
+    size_t total = count * pixel_bytes;
+    if (pixel_bytes == 1 || pixel_bytes > kMaxVectorPattern || total < kMinVectorFill) {
+        fill_pattern_scalar(dst, count, pixel, pixel_bytes);
+        return;
+    }
+
+    alignas(64) unsigned char pattern[kMaxVectorPattern * 64];
+    int registers = build_vector_pattern(pattern, pixel, pixel_bytes, 64);
+    __m512i v[kMaxVectorPattern];
+    for (int r = 0; r < registers; r++) {
+        v[r] = _mm512_load_si512(pattern + r * 64);
+    }
+
+    size_t period = static_cast<size_t>(registers) * 64;
+    size_t i = 0;
+    for (; i + period <= total; i += period) {
+        for (int r = 0; r < registers; r++) {
+            _mm512_storeu_si512(dst + i + r * 64, v[r]);
+        }
+    }
+    std::memcpy(dst + i, pattern, total - i);
+}
+
+__attribute__((target("avx512f")))
+void copy_row_avx512(unsigned char* dst, const unsigned char* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 256 <= bytes; i += 256) {
+        __m512i a = _mm512_loadu_si512(src + i);
+        __m512i b = _mm512_loadu_si512(src + i + 64);
+        __m512i c = _mm512_loadu_si512(src + i + 128);
+        __m512i d = _mm512_loadu_si512(src + i + 192);
+        _mm512_storeu_si512(dst + i, a);
+        _mm512_storeu_si512(dst + i + 64, b);
+        _mm512_storeu_si512(dst + i + 128, c);
+        _mm512_storeu_si512(dst + i + 192, d);
+    }
+    std::memcpy(dst + i, src + i, bytes - i);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+void swap_bytes16_avx512(unsigned char* dst, const unsigned char* src, size_t count) {
+    // Bytes 1, 0, 3, 2, ... 15, 14 of every 128-bit lane, as in the AVX2 kernel
+    const long long low = 0x0607040502030001, high = 0x0e0f0c0d0a0b0809;
+    const __m512i order = _mm512_set_epi64(high, low, high, low, high, low, high, low);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m512i v = _mm512_loadu_si512(src + 2 * i);
+        _mm512_storeu_si512(dst + 2 * i, _mm512_shuffle_epi8(v, order));
+    }
+    swap_bytes16_scalar(dst + 2 * i, src + 2 * i, count - i);
+}
+
+#endif // VANITY_X86_KERNELS
+
+const PixelKernels kScalarKernels{"scalar", fill_pattern_scalar, copy_row_scalar, swap_bytes16_scalar};
+#if VANITY_X86_KERNELS
+const PixelKernels kSse2Kernels{"sse2", fill_pattern_sse2, copy_row_sse2, swap_bytes16_sse2};
+const PixelKernels kAvx2Kernels{"avx2", fill_pattern_avx2, copy_row_avx2, swap_bytes16_avx2};
+const PixelKernels kAvx512Kernels{"avx512", fill_pattern_avx512, copy_row_avx512, swap_bytes16_avx512};
+#endif
+
+std::vector<const PixelKernels*> detect_kernels() {
+    std::vector<const PixelKernels*> kernels{&kScalarKernels};
+#if VANITY_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        kernels.push_back(&kSse2Kernels);
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back(&kAvx2Kernels);
+    }
+    // The byte swap needs AVX-512BW, which every AVX-512 CPU but Xeon Phi has
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        kernels.push_back(&kAvx512Kernels);
+    }
+#endif
+    return kernels;
+}
+
+const PixelKernels* select_kernels() {
+    std::span<const PixelKernels* const> kernels = available_pixel_kernels();
+    if (const char* requested = std::getenv("VANITY_SIMD")) {
+        for (const PixelKernels* k : kernels) {
+            if (std::string_view(requested) == k->name) {
+                return k;
+            }
+        }
+    }
+    return kernels.back();
+}
+
+} // namespace
+
+const PixelKernels& pixel_kernels() {
+    static const PixelKernels* selected = select_kernels();
+    return *selected;
+}
+
+std::span<const PixelKernels* const> available_pixel_kernels() {
+    static const std::vector<const PixelKernels*> kernels = detect_kernels();
+    return kernels;
+}
+
+} // namespace vanity::detail
@@ -0,0 +1,35 @@
+#ifndef VANITY_PIXEL_KERNELS_HPP
+#define VANITY_PIXEL_KERNELS_HPP
+
+#include <cstddef>
+#include <span>
+
+namespace vanity::detail {
+
+// Low-level row kernels shared by image_ops and the codecs. They work on
+// bytes, so 16-bit and float images reuse them with pixel_bytes = channels *
+// sample size. One table exists per instruction set; the best one supported
+// by the running CPU is picked on first use.
+struct PixelKernels {
+    const char* name;
+
+    // Fill `count` pixels at dst with a repeating `pixel_bytes`-byte pattern
+    void (*fill_pattern)(unsigned char* dst, size_t count, const unsigned char* pixel, int pixel_bytes);
+
+    // Copy `bytes` bytes between non-overlapping rows
+    void (*copy_row)(unsigned char* dst, const unsigned char* src, size_t bytes);
+
+    // Reverse the byte order of `count` 16-bit samples (big-endian PNG and
+    // netpbm samples to native and back); dst may equal src
+    void (*swap_bytes16)(unsigned char* dst, const unsigned char* src, size_t count);
+};
+
+// Kernels selected for this CPU (override with VANITY_SIMD=scalar|sse2|avx2|avx512)
+const PixelKernels& pixel_kernels();
+
+// Every kernel table this CPU can run, scalar first (used by tests and benchmarks)
+std::span<const PixelKernels* const> available_pixel_kernels();
+
+} // namespace vanity::detail
+
+#endif // VANITY_PIXEL_KERNELS_HPP
@@ -0,0 +1,432 @@
+#include "png_reader.hpp"
+#include "inflate.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VANITY_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace vanity::detail {
+
+namespace {
+
+constexpr unsigned char kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+// Same limit as stb_image
+constexpr uint32_t kMaxDimension = uint32_t(1) << 24;
+
+constexpr uint32_t chunk_type(const char (&name)[5]) {
+    return uint32_t(uint8_t(name[0])) << 24 | uint32_t(uint8_t(name[1])) << 16 |
+           uint32_t(uint8_t(name[2])) << 8 | uint32_t(uint8_t(name[3]));
+}
+
+inline uint32_t read_u32(const unsigned char* p) {
+    return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | uint32_t(p[3]);
+}
+
+struct Chunk {
+    uint32_t type = 0;
+    const unsigned char* data = nullptr;
+    uint32_t length = 0;
+    size_t next = 0;        // offset of the following chunk
+};
+
+// Read the chunk at offset; fails if it runs past the end of the data
+// CRCs are not checked, as in stb_image.
+bool read_chunk(const unsigned char* data, size_t size, size_t offset, Chunk& chunk) {
+    if (offset > size || size - offset < 12) {
+        return false;
+    }
+    chunk.length = read_u32(data + offset);
+    if (chunk.length > size - offset - 12) {
+        return false;
+    }
+    chunk.type = read_u32(data + offset + 4);
+    chunk.data = data + offset + 8;
+    chunk.next = offset + 12 + chunk.length;
+    return true;
+}
+
+inline unsigned char paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return static_cast<unsigned char>(a);
+    }
+    return static_cast<unsigned char>(pb <= pc ? b : c);
+}
+
+void unfilter_sub_scalar(unsigned char* out, const unsigned char* filtered, const unsigned char*,
+                         size_t bytes, int bpp) {
+    size_t lead = std::min(bytes, static_cast<size_t>(bpp));
+    std::memcpy(out, filtered, lead);
+    for (size_t i = lead; i < bytes; i++) {
+        out[i] = static_cast<unsigned char>(filtered[i] + out[i - bpp]);
+    }
+}
+
+void unfilter_up_scalar(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                        size_t bytes, int) {
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<unsigned char>(filtered[i] + prev[i]);
+    }
+}
+
+void unfilter_average_scalar(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                             size_t bytes, int bpp) {
+    size_t lead = std::min(bytes, static_cast<size_t>(bpp));
+    for (size_t i = 0; i < lead; i++) {
+        out[i] = static_cast<unsigned char>(filtered[i] + (prev[i] >> 1));
+    }
+    for (size_t i = lead; i < bytes; i++) {
+        out[i] = static_cast<unsigned char>(filtered[i] + ((out[i - bpp] + prev[i]) >> 1));
+    }
+}
+
+void unfilter_paeth_scalar(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                           size_t bytes, int bpp) {
+    // With nothing to the left, Paeth predicts from the byte above
+    size_t lead = std::min(bytes, static_cast<size_t>(bpp));
+    for (size_t i = 0; i < lead; i++) {
+        out[i] = static_cast<unsigned char>(filtered[i] + prev[i]);
+    }
+    for (size_t i = lead; i < bytes; i++) {
+        out[i] = static_cast<unsigned char>(filtered[i] + paeth(out[i - bpp], prev[i], prev[i - bpp]));
+    }
+}
+
+#if VANITY_X86_KERNELS
+
+// Sub, Average and Paeth depend on the pixel to the left, so they cannot
+// run across a row in wide vectors; instead each step reconstructs one
+// whole 3- or 4-byte pixel in a register (the approach of libpng's SSE2
+// filters). Up has no such dependency and runs 16 bytes at a time.
+
+template <int Bpp>
+__attribute__((target("sse2")))
+inline __m128i load_pixel(const unsigned char* p) {
+    uint32_t value = 0;
+    std::memcpy(&value, p, Bpp);
+    return _mm_cvtsi32_si128(static_cast<int>(value));
+}
+
+template <int Bpp>
+__attribute__((target("sse2")))
+inline void store_pixel(unsigned char* p, __m128i v) {
+    uint32_t value = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+    std::memcpy(p, &value, Bpp);
+}
+
+template <int Bpp>
+__attribute__((target("sse2")))
+void unfilter_sub_pixels(unsigned char* out, const unsigned char* filtered, size_t bytes) {
+    __m128i a = _mm_setzero_si128();
+    for (size_t i = 0; i < bytes; i += Bpp) {
+        a = _mm_add_epi8(a, load_pixel<Bpp>(filtered + i));
+        store_pixel<Bpp>(out + i, a);
+    }
+}
+
+template <int Bpp>
+__attribute__((target("sse2")))
+void unfilter_average_pixels(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                             size_t bytes) {
+    // The left pixel starts at zero, which makes the first pixel prev / 2
+    __m128i a = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    for (size_t i = 0; i < bytes; i += Bpp) {
+        __m128i b = load_pixel<Bpp>(prev + i);
+        // avg_epu8 rounds up; take back the carry to get (a + b) >> 1
+        __m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+        a = _mm_add_epi8(load_pixel<Bpp>(filtered + i), average);
+        store_pixel<Bpp>(out + i, a);
+    }
+}
+
+__attribute__((target("sse2")))
+inline __m128i abs_epi16(__m128i x) {
+    return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+__attribute__((target("sse2")))
+inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+template <int Bpp>
+__attribute__((target("sse2")))
+void unfilter_paeth_pixels(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                           size_t bytes) {
+    // Work in 16-bit lanes so the predictor distances cannot overflow;
+    // a left and upper-left of zero make the first pixel predict from above
+    const __m128i zero = _mm_setzero_si128();
+    __m128i a = zero, b = zero;
+    for (size_t i = 0; i < bytes; i += Bpp) {
+        __m128i c = b;
+        b = _mm_unpacklo_epi8(load_pixel<Bpp>(prev + i), zero);
+        __m128i x = _mm_unpacklo_epi8(load_pixel<Bpp>(filtered + i), zero);
+        // With p = a + b - c: |p - a| = |b - c|, |p - b| = |a - c|, |p - c| = |b - c + a - c|
+        __m128i pa = _mm_sub_epi16(b, c);
+        __m128i pb = _mm_sub_epi16(a, c);
+        __m128i pc = _mm_add_epi16(pa, pb);
+        pa = abs_epi16(pa);
+        pb = abs_epi16(pb);
+        pc = abs_epi16(pc);
+        __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+        __m128i nearest = select(_mm_cmpeq_epi16(smallest, pa), a,
+                                 select(_mm_cmpeq_epi16(smallest, pb), b, c));
+        // Byte adds keep each lane's high byte zero, so a stays 0..255
+        a = _mm_add_epi8(x, nearest);
+        store_pixel<Bpp>(out + i, _mm_packus_epi16(a, a));
+    }
+}
+
+__attribute__((target("sse2")))
+void unfilter_sub_sse2(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                       size_t bytes, int bpp) {
+    if (bpp == 3) {
+        unfilter_sub_pixels<3>(out, filtered, bytes);
+    } else if (bpp == 4) {
+        unfilter_sub_pixels<4>(out, filtered, bytes);
+    } else {
+        unfilter_sub_scalar(out, filtered, prev, bytes, bpp);
+    }
+}
+
+__attribute__((target("sse2")))
+void unfilter_up_sse2(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                      size_t bytes, int) {
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(filtered + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi8(x, b));
+    }
+    for (; i < bytes; i++) {
+        out[i] = static_cast<unsigned char>(filtered[i] + prev[i]);
+    }
+}
+
+__attribute__((target("sse2")))
+void unfilter_average_sse2(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                           size_t bytes, int bpp) {
+    if (bpp == 3) {
+        unfilter_average_pixels<3>(out, filtered, prev, bytes);
+    } else if (bpp == 4) {
+        unfilter_average_pixels<4>(out, filtered, prev, bytes);
+    } else {
+        unfilter_average_scalar(out, filtered, prev, bytes, bpp);
+    }
+}
+
+__attribute__((target("sse2")))
+void unfilter_paeth_sse2(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                         size_t bytes, int bpp) {
+    if (bpp == 3) {
+        unfilter_paeth_pixels<3>(out, filtered, prev, bytes);
+    } else if (bpp == 4) {
+        unfilter_paeth_pixels<4>(out, filtered, prev, bytes);
+    } else {
+        unfilter_paeth_scalar(out, filtered, prev, bytes, bpp);
+    }
+}
+
+#endif // VANITY_X86_KERNELS
+
+const PngKernels kScalarKernels{"scalar", unfilter_sub_scalar, unfilter_up_scalar, unfilter_average_scalar,
+                                unfilter_paeth_scalar};
+#if VANITY_X86_KERNELS
+const PngKernels kSse2Kernels{"sse2", unfilter_sub_sse2, unfilter_up_sse2, unfilter_average_sse2,
+                              unfilter_paeth_sse2};
+#endif
+
+std::vector<const PngKernels*> detect_kernels() {
+    std::vector<const PngKernels*> kernels{&kScalarKernels};
+#if VANITY_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        kernels.push_back(&kSse2Kernels);
+    }
+#endif
+    return kernels;
+}
+
+const PngKernels* select_kernels() {
+    std::span<const PngKernels* const> kernels = available_png_kernels();
+    if (const char* requested = std::getenv("VANITY_SIMD")) {
+        for (const PngKernels* k : kernels) {
+            if (std::string_view(requested) == k->name) {
+                return k;
+            }
+        }
+    }
+    return kernels.back();
+}
+
+} // namespace
+
+const PngKernels& png_kernels() {
+    static const PngKernels* selected = select_kernels();
+    return *selected;
+}
+
+std::span<const PngKernels* const> available_png_kernels() {
+    static const std::vector<const PngKernels*> kernels = detect_kernels();
+    return kernels;
+}
+
+bool is_png(const unsigned char* data, size_t size) {
+    return size >= sizeof(kSignature) && std::memcmp(data, kSignature, sizeof(kSignature)) == 0;
+}
+
+bool png_read_header(const unsigned char* data, size_t size, PngHeader& header) {
+    header = PngHeader{};
+    Chunk chunk;
+    if (!is_png(data, size) || !read_chunk(data, size, sizeof(kSignature), chunk) ||
+        chunk.type != chunk_type("IHDR") || chunk.length != 13) {
+        return false;
+    }
+    uint32_t width = read_u32(chunk.data);
+    uint32_t height = read_u32(chunk.data + 4);
+    int bit_depth = chunk.data[8];
+    header.color_type = chunk.data[9];
+    int compression = chunk.data[10], filter = chunk.data[11], interlace = chunk.data[12];
+    if (width == 0 || height == 0 || width > kMaxDimension || height > kMaxDimension || bit_depth != 8 ||
+        compression != 0 || filter != 0 || interlace != 0) {
+        return false;
+    }
+    header.width = static_cast<int>(width);
+    header.height = static_cast<int>(height);
+    switch (header.color_type) {
+        case 0: header.channels = 1; break;
+        case 2: header.channels = 3; break;
+        case 3: header.channels = 3; break;
+        case 4: header.channels = 2; break;
+        case 6: header.channels = 4; break;
+        default: return false;
+    }
+
+    for (size_t offset = chunk.next;; offset = chunk.next) {
+        if (!read_chunk(data, size, offset, chunk)) {
+            return false;
+        }
+        if (chunk.type == chunk_type("IDAT")) {
+            header.first_idat = offset;
+            break;
+        }
+        if (chunk.type == chunk_type("IEND")) {
+            return false;
+        }
+        if (chunk.type == chunk_type("PLTE") && header.color_type == 3) {
+            if (chunk.length == 0 || chunk.length % 3 != 0 || chunk.length > 256 * 3) {
+                return false;
+            }
+            header.palette_size = static_cast<int>(chunk.length / 3);
+            for (int i = 0; i < header.palette_size; i++) {
+                std::memcpy(header.palette[i], chunk.data + 3 * i, 3);
+                header.palette[i][3] = 255;
+            }
+        } else if (chunk.type == chunk_type("tRNS")) {
+            // Colour-keyed gray and RGB images gain an alpha channel in stb; leave them to it
+            if (header.color_type != 3 || header.palette_size == 0 ||
+                chunk.length > static_cast<uint32_t>(header.palette_size)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < chunk.length; i++) {
+                header.palette[i][3] = chunk.data[i];
+            }
+            header.channels = 4;
+        }
+    }
+    return header.color_type != 3 || header.palette_size > 0;
+}
+
+bool png_decode(const unsigned char* data, size_t size, const PngHeader& header, const MutableImageView& dst) {
+    // Gather the zlib stream; it is only copied when split over several
+    // IDATs. png_read_header checked the first IDAT; a cut-off chunk after
+    // the last one (such as a missing IEND) ends the stream, as in stb_image.
+    Chunk chunk;
+    size_t idat_count = 0;
+    size_t stream_size = 0;
+    for (size_t offset = header.first_idat;
+         read_chunk(data, size, offset, chunk) && chunk.type == chunk_type("IDAT"); offset = chunk.next) {
+        idat_count++;
+        stream_size += chunk.length;
+    }
+    read_chunk(data, size, header.first_idat, chunk);
+    const unsigned char* stream = chunk.data;
+    std::vector<unsigned char> joined;
+    if (idat_count > 1) {
+        joined.reserve(stream_size);
+        for (size_t offset = header.first_idat; idat_count > 0; idat_count--, offset = chunk.next) {
+            read_chunk(data, size, offset, chunk);
+            joined.insert(joined.end(), chunk.data, chunk.data + chunk.length);
+        }
+        stream = joined.data();
+    }
+
+    // Each row is a filter type byte and the filtered samples
+    const bool indexed = header.color_type == 3;
+    const int bpp = indexed ? 1 : header.channels;
+    const size_t row_bytes = static_cast<size_t>(header.width) * bpp;
+    const size_t raw_size = (row_bytes + 1) * static_cast<size_t>(header.height);
+    std::unique_ptr<unsigned char[]> raw(new (std::nothrow) unsigned char[raw_size]);
+    size_t written = 0;
+    if (!raw || !zlib_inflate(stream, stream_size, raw.get(), raw_size, written) || written != raw_size) {
+        return false;
+    }
+
+    // Non-palette rows are reconstructed straight into dst, using the row
+    // above as the prediction source; palette indices go through two rows
+    // of scratch and are expanded afterwards
+    const PngKernels& kernels = png_kernels();
+    std::vector<unsigned char> scratch(row_bytes * (indexed ? 3 : 1), 0);
+    const unsigned char* zeros = scratch.data();
+    for (int y = 0; y < header.height; y++) {
+        const unsigned char* line = raw.get() + (row_bytes + 1) * y;
+        const unsigned char* filtered = line + 1;
+        unsigned char* out = indexed ? scratch.data() + row_bytes * (1 + (y & 1)) : dst.row(y);
+        const unsigned char* prev = y == 0 ? zeros
+                                    : indexed ? scratch.data() + row_bytes * (1 + ((y - 1) & 1))
+                                              : dst.row(y - 1);
+        switch (line[0]) {
+            case 0:
+                std::memcpy(out, filtered, row_bytes);
+                break;
+            case 1:
+                kernels.unfilter_sub(out, filtered, prev, row_bytes, bpp);
+                break;
+            case 2:
+                kernels.unfilter_up(out, filtered, prev, row_bytes, bpp);
+                break;
+            case 3:
+                kernels.unfilter_average(out, filtered, prev, row_bytes, bpp);
+                break;
+            case 4:
+                kernels.unfilter_paeth(out, filtered, prev, row_bytes, bpp);
+                break;
+            default:
+                return false;
+        }
+        if (indexed) {
+            unsigned char* pixel = dst.row(y);
+            const int channels = header.channels;
+            for (size_t x = 0; x < row_bytes; x++, pixel += channels) {
+                std::memcpy(pixel, header.palette[out[x]], channels);
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace vanity::detail
@@ -0,0 +1,64 @@
+#ifndef VANITY_PNG_READER_HPP
+#define VANITY_PNG_READER_HPP
+
+#include "vanity/image_view.hpp"
+#include <cstddef>
+#include <span>
+
+namespace vanity::detail {
+
+// Decoder for the common PNG subset: 8-bit, non-interlaced gray, gray +
+// alpha, RGB, RGBA and palette images. Everything else (16-bit and packed
+// sub-byte samples, Adam7, tRNS colour keys, Apple's CgBI variant) is
+// rejected by png_read_header and left to stb_image.
+
+// Parsed IHDR, PLTE and tRNS, plus where the image data starts
+struct PngHeader {
+    int width = 0;
+    int height = 0;
+    int color_type = 0;
+    int channels = 0;               // decoded channels: palette images expand to 3, or 4 with tRNS
+    int palette_size = 0;
+    unsigned char palette[256][4] = {};     // RGBA; alpha from tRNS, else opaque
+    size_t first_idat = 0;          // byte offset of the first IDAT chunk
+};
+
+// True if the data starts with the PNG signature
+bool is_png(const unsigned char* data, size_t size);
+
+// Parse chunks up to the first IDAT; fails for malformed headers and for
+// the variants this decoder leaves to stb_image
+bool png_read_header(const unsigned char* data, size_t size, PngHeader& header);
+
+// Inflate the IDAT stream and unfilter it row by row into dst, whose
+// dimensions must match the header and whose channels are header.channels
+// Returns false for corrupt or truncated data.
+bool png_decode(const unsigned char* data, size_t size, const PngHeader& header, const MutableImageView& dst);
+
+// Inverse PNG row filters. As with PixelKernels, one table exists per
+// instruction set and the best one the CPU supports is used. Each writes
+// `bytes` reconstructed bytes to out from the filtered bytes and prev, the
+// reconstructed row above (all zeros for the first row); bpp is the
+// filter's bytes per pixel. The SIMD tables work on whole 3- and 4-byte
+// pixels (and 16 bytes at a time for Up) and use scalar code otherwise.
+struct PngKernels {
+    const char* name;
+    void (*unfilter_sub)(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                         size_t bytes, int bpp);
+    void (*unfilter_up)(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                        size_t bytes, int bpp);
+    void (*unfilter_average)(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                             size_t bytes, int bpp);
+    void (*unfilter_paeth)(unsigned char* out, const unsigned char* filtered, const unsigned char* prev,
+                           size_t bytes, int bpp);
+};
+
+// Kernels selected for this CPU (override with VANITY_SIMD=scalar|sse2)
+const PngKernels& png_kernels();
+
+// Every kernel table this CPU can run, scalar first (used by tests and benchmarks)
+std::span<const PngKernels* const> available_png_kernels();
+
+} // namespace vanity::detail
+
+#endif // VANITY_PNG_READER_HPP
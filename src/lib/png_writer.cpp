@@ -0,0 +1,315 @@
+#include "png_writer.hpp"
+#include "checksum.hpp"
+#include "deflate.hpp"
+#include "pixel_kernels.hpp"
+#include "vanity/image_sink.hpp"
+#include "vanity/thread_pool.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace vanity::detail {
+
+namespace {
+
+constexpr unsigned char kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+// Color type by channel count: gray, gray+alpha, RGB, RGBA
+constexpr unsigned char kColorType[5] = {0, 0, 4, 2, 6};
+
+// Filtered bytes compressed as one independent piece (written as one IDAT
+// chunk), and the match history each piece refilters from the rows before it
+constexpr size_t kDeflateBlock = size_t(1) << 20;
+constexpr size_t kWindow = size_t(1) << 15;
+
+inline unsigned char paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return static_cast<unsigned char>(a);
+    }
+    return static_cast<unsigned char>(pb <= pc ? b : c);
+}
+
+void put_u32(unsigned char* dst, uint32_t value) {
+    dst[0] = static_cast<unsigned char>(value >> 24);
+    dst[1] = static_cast<unsigned char>(value >> 16);
+    dst[2] = static_cast<unsigned char>(value >> 8);
+    dst[3] = static_cast<unsigned char>(value);
+}
+
+bool write_chunk(ImageSink& sink, const char type[4], const unsigned char* data, size_t size) {
+    unsigned char header[8];
+    put_u32(header, static_cast<uint32_t>(size));
+    std::memcpy(header + 4, type, 4);
+    unsigned char crc[4];
+    put_u32(crc, crc32(crc32(0, header + 4, 4), data, size));
+    return sink.write(header, 8) && (size == 0 || sink.write(data, size)) && sink.write(crc, 4);
+}
+
+// Sum of filtered bytes read as signed values, the usual estimate of how
+// well a row will compress; stops early once it exceeds limit
+unsigned long filtered_cost(const unsigned char* filtered, size_t size, unsigned long limit) {
+    unsigned long sum = 0;
+    for (size_t start = 0; start < size && sum <= limit; start += 256) {
+        size_t end = std::min(size, start + 256);
+        unsigned chunk = 0;
+        for (size_t i = start; i < end; i++) {
+            chunk += filtered[i] < 128 ? filtered[i] : 256 - filtered[i];
+        }
+        sum += chunk;
+    }
+    return sum;
+}
+
+} // namespace
+
+void png_filter_row(PngFilter filter, const unsigned char* row, const unsigned char* prev,
+                    size_t row_bytes, int bpp, unsigned char* out) {
+    size_t left = static_cast<size_t>(bpp) < row_bytes ? bpp : row_bytes;
+    unsigned char* dst = out + 1;
+    switch (filter) {
+        case PngFilter::Adaptive:
+        case PngFilter::None:
+            out[0] = 0;
+            std::memcpy(dst, row, row_bytes);
+            break;
+
+        case PngFilter::Sub:
+            out[0] = 1;
+            std::memcpy(dst, row, left);
+            for (size_t i = left; i < row_bytes; i++) {
+                dst[i] = static_cast<unsigned char>(row[i] - row[i - bpp]);
+            }
+            break;
+
+        case PngFilter::Up:
+            out[0] = 2;
+            if (!prev) {
+                std::memcpy(dst, row, row_bytes);
+                break;
+            }
+            for (size_t i = 0; i < row_bytes; i++) {
+                dst[i] = static_cast<unsigned char>(row[i] - prev[i]);
+            }
+            break;
+
+        case PngFilter::Average:
+            out[0] = 3;
+            if (!prev) {
+                std::memcpy(dst, row, left);
+                for (size_t i = left; i < row_bytes; i++) {
+                    dst[i] = static_cast<unsigned char>(row[i] - (row[i - bpp] >> 1));
+                }
+                break;
+            }
+            for (size_t i = 0; i < left; i++) {
+                dst[i] = static_cast<unsigned char>(row[i] - (prev[i] >> 1));
+            }
+            for (size_t i = left; i < row_bytes; i++) {
+                dst[i] = static_cast<unsigned char>(row[i] - ((row[i - bpp] + prev[i]) >> 1));
+            }
+            break;
+
+        case PngFilter::Paeth:
+            out[0] = 4;
+            if (!prev) {
+                // With no row above, Paeth predicts from the left (same as Sub)
+                std::memcpy(dst, row, left);
+                for (size_t i = left; i < row_bytes; i++) {
+                    dst[i] = static_cast<unsigned char>(row[i] - row[i - bpp]);
+                }
+                break;
+            }
+            for (size_t i = 0; i < left; i++) {
+                dst[i] = static_cast<unsigned char>(row[i] - prev[i]);
+            }
+            for (size_t i = left; i < row_bytes; i++) {
+                dst[i] = static_cast<unsigned char>(row[i] - paeth(row[i - bpp], prev[i], prev[i - bpp]));
+            }
+            break;
+    }
+}
+
+void png_filter_row_adaptive(const unsigned char* row, const unsigned char* prev, size_t row_bytes,
+                             int bpp, unsigned char* out, unsigned char* scratch) {
+    static const PngFilter candidates[4] = {PngFilter::Sub, PngFilter::Up, PngFilter::Average, PngFilter::Paeth};
+    png_filter_row(PngFilter::None, row, prev, row_bytes, bpp, out);
+    unsigned long best_cost = filtered_cost(out + 1, row_bytes, ~0ul);
+    int best = -1;
+    for (int i = 0; i < 4; i++) {
+        unsigned char* candidate = scratch + i * (row_bytes + 1);
+        png_filter_row(candidates[i], row, prev, row_bytes, bpp, candidate);
+        unsigned long cost = filtered_cost(candidate + 1, row_bytes, best_cost);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        std::memcpy(out, scratch + best * (row_bytes + 1), row_bytes + 1);
+    }
+}
+
+namespace {
+
+// Encode a byte view whose "channels" are bytes per pixel: 8-bit samples as
+// is, or 16-bit native samples written big-endian with bit_depth = 16
+bool encode(const ImageView& image, int channels, int bit_depth, ImageSink& sink, const WriteOptions& options) {
+
+    unsigned char ihdr[13];
+    put_u32(ihdr, static_cast<uint32_t>(image.width()));
+    put_u32(ihdr + 4, static_cast<uint32_t>(image.height()));
+    ihdr[8] = static_cast<unsigned char>(bit_depth);
+    ihdr[9] = kColorType[channels];
+    ihdr[10] = 0;                   // deflate
+    ihdr[11] = 0;                   // adaptive filtering (per-row filter byte)
+    ihdr[12] = 0;                   // no interlace
+    if (!sink.write(kSignature, sizeof(kSignature)) || !write_chunk(sink, "IHDR", ihdr, sizeof(ihdr))) {
+        return false;
+    }
+
+    int level = std::clamp(options.png_compression, 0, 9);
+    PngFilter filter = options.png_filter;
+    if (level == 0 && filter == PngFilter::Adaptive) {
+        filter = PngFilter::None;
+    }
+
+    // The image is cut into row ranges of about kDeflateBlock filtered bytes.
+    // Each range is filtered and compressed on its own, pigz-style: it
+    // refilters the rows before it for up to 32 KiB of match history, and ends
+    // with a sync flush so the pieces concatenate into one deflate stream.
+    // Ranges depend only on the source image, so the output is the same
+    // whether they run inline or on the pool.
+    size_t row_bytes = image.row_bytes();
+    int bpp = image.channels();
+    size_t filtered_row = row_bytes + 1;
+    int height = image.height();
+    int rows_per_range = static_cast<int>(std::max<size_t>(1, kDeflateBlock / filtered_row));
+    int history_rows = static_cast<int>((kWindow + filtered_row - 1) / filtered_row);
+    size_t range_count = (static_cast<size_t>(height) + rows_per_range - 1) / rows_per_range;
+
+    struct Range {
+        std::vector<unsigned char> swapped;
+        std::vector<unsigned char> filtered;
+        std::vector<unsigned char> compressed;
+        size_t size;
+        uint32_t adler;
+    };
+    auto encode_range = [&](size_t index, Range& range) {
+        int begin = static_cast<int>(index) * rows_per_range;
+        int end = std::min(height, begin + rows_per_range);
+        int first = std::max(0, begin - history_rows);
+        range.filtered.resize(static_cast<size_t>(end - first) * filtered_row);
+        std::vector<unsigned char> scratch(filter == PngFilter::Adaptive ? 4 * filtered_row : 0);
+
+        // 16-bit rows are filtered in big-endian order, from a swapped copy of
+        // the range and the row above it
+        int swapped_first = std::max(0, first - 1);
+        if (bit_depth == 16) {
+            range.swapped.resize(static_cast<size_t>(end - swapped_first) * row_bytes);
+            unsigned char* out = range.swapped.data();
+            for (int y = swapped_first; y < end; y++, out += row_bytes) {
+                pixel_kernels().swap_bytes16(out, image.row(y), row_bytes / 2);
+            }
+        }
+        auto source_row = [&](int y) {
+            if (bit_depth == 16) {
+                return static_cast<const unsigned char*>(range.swapped.data()) +
+                       static_cast<size_t>(y - swapped_first) * row_bytes;
+            }
+            return image.row(y);
+        };
+
+        for (int y = first; y < end; y++) {
+            const unsigned char* prev = y > 0 ? source_row(y - 1) : nullptr;
+            unsigned char* out = range.filtered.data() + static_cast<size_t>(y - first) * filtered_row;
+            if (filter == PngFilter::Adaptive) {
+                png_filter_row_adaptive(source_row(y), prev, row_bytes, bpp, out, scratch.data());
+            } else {
+                png_filter_row(filter, source_row(y), prev, row_bytes, bpp, out);
+            }
+        }
+
+        size_t history = static_cast<size_t>(begin - first) * filtered_row;
+        size_t size = range.filtered.size() - history;
+        range.size = size;
+        range.adler = adler32(1, range.filtered.data() + history, size);
+        range.compressed.clear();
+        DeflateEncoder deflater(level);
+        if (index == 0) {
+            range.compressed.push_back(0x78);
+            range.compressed.push_back(deflater.zlib_flags());
+        }
+        deflater.compress(range.filtered.data(), history, size, range.compressed);
+        if (end == height) {
+            deflater.finish(range.compressed);
+        } else {
+            deflater.sync_flush(range.compressed);
+        }
+    };
+
+    // Ranges are encoded a batch at a time (one per thread, twice over, to
+    // smooth out uneven rows) and written in order, which bounds memory to the
+    // batch rather than the whole compressed image
+    const ExecutionOptions& exec = options.exec;
+    bool parallel = exec.pool && exec.pool->size() >= 2 && range_count > 1 &&
+                    static_cast<size_t>(height) * row_bytes >= exec.parallel_threshold;
+    size_t batch = parallel ? 2 * (static_cast<size_t>(exec.pool->size()) + 1) : 1;
+    std::vector<Range> ranges(std::min(batch, range_count));
+
+    uint32_t adler = 1;
+    for (size_t done = 0; done < range_count; done += ranges.size()) {
+        size_t count = std::min(ranges.size(), range_count - done);
+        if (parallel && count > 1) {
+            exec.pool->parallel_for(count, 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    encode_range(done + i, ranges[i]);
+                }
+            });
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                encode_range(done + i, ranges[i]);
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            Range& range = ranges[i];
+            adler = adler32_combine(adler, range.adler, range.size);
+            if (done + i + 1 == range_count) {
+                unsigned char trailer[4];
+                put_u32(trailer, adler);
+                range.compressed.insert(range.compressed.end(), trailer, trailer + 4);
+            }
+            if (!write_chunk(sink, "IDAT", range.compressed.data(), range.compressed.size())) {
+                return false;
+            }
+        }
+    }
+
+    return write_chunk(sink, "IEND", nullptr, 0);
+}
+
+} // namespace
+
+bool png_encode(const ImageView& image, ImageSink& sink, const WriteOptions& options) {
+    int channels = image.channels();
+    if (image.empty() || channels < 1 || channels > 4) {
+        return false;
+    }
+    return encode(image, channels, 8, sink, options);
+}
+
+bool png_encode(const ImageView16& image, ImageSink& sink, const WriteOptions& options) {
+    int channels = image.channels();
+    if (image.empty() || channels < 1 || channels > 4) {
+        return false;
+    }
+    ImageView bytes(reinterpret_cast<const unsigned char*>(image.data()), image.width(), image.height(),
+                    channels * 2, image.stride());
+    return encode(bytes, channels, 16, sink, options);
+}
+
+} // namespace vanity::detail
@@ -0,0 +1,37 @@
+#ifndef VANITY_PNG_WRITER_HPP
+#define VANITY_PNG_WRITER_HPP
+
+#include "vanity/image_io.hpp"
+#include "vanity/image_view.hpp"
+#include <cstddef>
+
+namespace vanity {
+class ImageSink;
+}
+
+namespace vanity::detail {
+
+// Write the PNG row filter `filter` (never Adaptive) applied to row into
+// out[0] (the filter type byte) and out[1..row_bytes]
+// prev is the previous unfiltered row, or nullptr for the first row.
+void png_filter_row(PngFilter filter, const unsigned char* row, const unsigned char* prev,
+                    size_t row_bytes, int bpp, unsigned char* out);
+
+// Pick a filter for row with the minimum-sum-of-absolute-differences
+// heuristic and write it as png_filter_row does
+// scratch must hold 4 * (row_bytes + 1) bytes.
+void png_filter_row_adaptive(const unsigned char* row, const unsigned char* prev, size_t row_bytes,
+                             int bpp, unsigned char* out, unsigned char* scratch);
+
+// Encode an 8-bit, 1-4 channel view as PNG using options.png_compression
+// and options.png_filter; all state is per call, so concurrent encodes
+// with different settings are safe
+bool png_encode(const ImageView& image, ImageSink& sink, const WriteOptions& options);
+
+// Encode a 16-bit, 1-4 channel view as a 16-bit PNG; rows are byte-swapped
+// to big-endian a range at a time and then go through the same filters
+bool png_encode(const ImageView16& image, ImageSink& sink, const WriteOptions& options);
+
+} // namespace vanity::detail
+
+#endif // VANITY_PNG_WRITER_HPP
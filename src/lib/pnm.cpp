@@ -0,0 +1,315 @@
+#include "pnm.hpp"
+#include "pixel_kernels.hpp"
+#include "vanity/image_sink.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace vanity::detail {
+
+namespace {
+
+// Cursor over the text part of a header
+class HeaderReader {
+public:
+    HeaderReader(const unsigned char* data, size_t size) : data_(data), size_(size) {}
+
+    size_t pos() const { return pos_; }
+
+    // Skip whitespace and '#' comments (which run to the end of the line)
+    void skip_space() {
+        while (pos_ < size_) {
+            unsigned char c = data_[pos_];
+            if (c == '#') {
+                while (pos_ < size_ && data_[pos_] != '\n') {
+                    pos_++;
+                }
+            } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+                pos_++;
+            } else {
+                break;
+            }
+        }
+    }
+
+    // Unsigned decimal, after optional whitespace
+    bool number(int& out) {
+        skip_space();
+        uint64_t value = 0;
+        size_t start = pos_;
+        while (pos_ < size_ && data_[pos_] >= '0' && data_[pos_] <= '9') {
+            value = value * 10 + (data_[pos_++] - '0');
+            if (value > 0x7fffffff) {
+                return false;
+            }
+        }
+        out = static_cast<int>(value);
+        return pos_ > start;
+    }
+
+    // Run of non-whitespace characters, after optional whitespace
+    std::string_view word() {
+        skip_space();
+        size_t start = pos_;
+        while (pos_ < size_ && data_[pos_] > ' ') {
+            pos_++;
+        }
+        return std::string_view(reinterpret_cast<const char*>(data_ + start), pos_ - start);
+    }
+
+    // Consume exactly one whitespace character (ends the P5/P6 header)
+    bool single_space() {
+        if (pos_ < size_ && (data_[pos_] == ' ' || data_[pos_] == '\t' || data_[pos_] == '\n' ||
+                             data_[pos_] == '\r')) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    // Skip to just past the end of the current line
+    void next_line() {
+        while (pos_ < size_ && data_[pos_] != '\n') {
+            pos_++;
+        }
+        if (pos_ < size_) {
+            pos_++;
+        }
+    }
+
+private:
+    const unsigned char* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+bool read_pam_header(HeaderReader& reader, PnmHeader& header) {
+    // Keyword lines until ENDHDR; TUPLTYPE is informational, DEPTH decides
+    for (;;) {
+        std::string_view key = reader.word();
+        if (key.empty()) {
+            return false;
+        }
+        if (key == "ENDHDR") {
+            reader.next_line();
+            return true;
+        }
+        if (key == "WIDTH") {
+            if (!reader.number(header.width)) {
+                return false;
+            }
+        } else if (key == "HEIGHT") {
+            if (!reader.number(header.height)) {
+                return false;
+            }
+        } else if (key == "DEPTH") {
+            if (!reader.number(header.channels)) {
+                return false;
+            }
+        } else if (key == "MAXVAL") {
+            if (!reader.number(header.maxval)) {
+                return false;
+            }
+        } else {
+            reader.next_line();
+        }
+    }
+}
+
+// Write rows, keeping only the first `keep` of `channels` bytes per pixel
+bool write_rows(const ImageView& image, ImageSink& sink, int keep) {
+    if (keep == image.channels() && image.is_contiguous()) {
+        return sink.write(image.data(), image.row_bytes() * image.height());
+    }
+    if (keep == image.channels()) {
+        for (int y = 0; y < image.height(); y++) {
+            if (!sink.write(image.row(y), image.row_bytes())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<unsigned char> row(static_cast<size_t>(image.width()) * keep);
+    for (int y = 0; y < image.height(); y++) {
+        const unsigned char* src = image.row(y);
+        unsigned char* dst = row.data();
+        for (int x = 0; x < image.width(); x++, src += image.channels(), dst += keep) {
+            std::memcpy(dst, src, keep);
+        }
+        if (!sink.write(row.data(), row.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 16-bit rows go out big-endian, so every row passes through a swapped copy
+bool write_rows(const ImageView16& image, ImageSink& sink, int keep) {
+    const PixelKernels& kernels = pixel_kernels();
+    size_t samples = static_cast<size_t>(image.width()) * keep;
+    std::vector<uint16_t> row(samples);
+    for (int y = 0; y < image.height(); y++) {
+        const uint16_t* src = image.row(y);
+        if (keep == image.channels()) {
+            std::memcpy(row.data(), src, samples * 2);
+        } else {
+            uint16_t* dst = row.data();
+            for (int x = 0; x < image.width(); x++, src += image.channels(), dst += keep) {
+                std::memcpy(dst, src, keep * 2);
+            }
+        }
+        auto* bytes = reinterpret_cast<unsigned char*>(row.data());
+        kernels.swap_bytes16(bytes, bytes, samples);
+        if (!sink.write(bytes, samples * 2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Header and rows for either sample type (MAXVAL 255 or 65535)
+template <typename T>
+bool encode(const BasicImageView<T>& image, ImageSink& sink, bool pam) {
+    if (image.empty() || image.channels() < 1 || image.channels() > 4) {
+        return false;
+    }
+
+    constexpr int maxval = sizeof(T) == 1 ? 255 : 65535;
+    char header[160];
+    int length;
+    int keep = image.channels();
+    if (pam) {
+        static const char* tuple_types[] = {"GRAYSCALE", "GRAYSCALE_ALPHA", "RGB", "RGB_ALPHA"};
+        length = std::snprintf(header, sizeof(header),
+                               "P7\nWIDTH %d\nHEIGHT %d\nDEPTH %d\nMAXVAL %d\nTUPLTYPE %s\nENDHDR\n",
+                               image.width(), image.height(), image.channels(), maxval,
+                               tuple_types[image.channels() - 1]);
+    } else {
+        keep = image.channels() <= 2 ? 1 : 3;
+        length = std::snprintf(header, sizeof(header), "P%c\n%d %d\n%d\n", keep == 1 ? '5' : '6',
+                               image.width(), image.height(), maxval);
+    }
+    return sink.write(header, static_cast<size_t>(length)) && write_rows(image, sink, keep);
+}
+
+} // namespace
+
+bool is_pnm(const unsigned char* data, size_t size) {
+    return data && size >= 2 && data[0] == 'P' && (data[1] == '5' || data[1] == '6' || data[1] == '7');
+}
+
+bool pnm_read_header(const unsigned char* data, size_t size, PnmHeader& header) {
+    if (!is_pnm(data, size)) {
+        return false;
+    }
+    header = PnmHeader{};
+    HeaderReader reader(data + 2, size - 2);
+    if (data[1] == '7') {
+        if (!read_pam_header(reader, header)) {
+            return false;
+        }
+    } else {
+        header.channels = data[1] == '5' ? 1 : 3;
+        if (!reader.number(header.width) || !reader.number(header.height) || !reader.number(header.maxval) ||
+            !reader.single_space()) {
+            return false;
+        }
+    }
+    header.data_offset = 2 + reader.pos();
+
+    if (header.width <= 0 || header.height <= 0 || header.channels < 1 || header.channels > 4 ||
+        header.maxval < 1 || header.maxval > 65535) {
+        return false;
+    }
+    return header.data_offset <= size;
+}
+
+bool pnm_decode(const unsigned char* data, size_t size, const MutableImageView& dst) {
+    PnmHeader header;
+    if (!pnm_read_header(data, size, header) || header.maxval > 255 || dst.width() != header.width ||
+        dst.height() != header.height || dst.channels() != header.channels ||
+        uint64_t(dst.row_bytes()) * dst.height() > size - header.data_offset) {
+        return false;
+    }
+
+    const unsigned char* src = data + header.data_offset;
+    size_t row_bytes = dst.row_bytes();
+    if (header.maxval == 255) {
+        for (int y = 0; y < dst.height(); y++, src += row_bytes) {
+            std::memcpy(dst.row(y), src, row_bytes);
+        }
+        return true;
+    }
+
+    // Rescale to the full 0-255 range, clamping samples above maxval
+    unsigned char scale[256];
+    for (int v = 0; v < 256; v++) {
+        int clamped = v < header.maxval ? v : header.maxval;
+        scale[v] = static_cast<unsigned char>((clamped * 255 + header.maxval / 2) / header.maxval);
+    }
+    for (int y = 0; y < dst.height(); y++, src += row_bytes) {
+        unsigned char* out = dst.row(y);
+        for (size_t i = 0; i < row_bytes; i++) {
+            out[i] = scale[src[i]];
+        }
+    }
+    return true;
+}
+
+bool pnm_decode(const unsigned char* data, size_t size, const MutableImageView16& dst) {
+    PnmHeader header;
+    if (!pnm_read_header(data, size, header) || dst.width() != header.width || dst.height() != header.height ||
+        dst.channels() != header.channels) {
+        return false;
+    }
+    size_t samples = static_cast<size_t>(dst.width()) * dst.channels();
+    size_t sample_bytes = header.maxval > 255 ? 2 : 1;
+    if (uint64_t(samples) * sample_bytes * dst.height() > size - header.data_offset) {
+        return false;
+    }
+
+    const unsigned char* src = data + header.data_offset;
+    size_t row_bytes = samples * sample_bytes;
+    if (sample_bytes == 1) {
+        // Rescale to the full 0-65535 range (255 maps to 65535 exactly), clamping samples above maxval
+        uint16_t scale[256];
+        for (int v = 0; v < 256; v++) {
+            uint32_t clamped = v < header.maxval ? v : header.maxval;
+            scale[v] = static_cast<uint16_t>((clamped * 65535 + header.maxval / 2) / header.maxval);
+        }
+        for (int y = 0; y < dst.height(); y++, src += row_bytes) {
+            uint16_t* out = dst.row(y);
+            for (size_t i = 0; i < samples; i++) {
+                out[i] = scale[src[i]];
+            }
+        }
+        return true;
+    }
+
+    const PixelKernels& kernels = pixel_kernels();
+    for (int y = 0; y < dst.height(); y++, src += row_bytes) {
+        uint16_t* out = dst.row(y);
+        kernels.swap_bytes16(reinterpret_cast<unsigned char*>(out), src, samples);
+        if (header.maxval != 65535) {
+            uint32_t maxval = static_cast<uint32_t>(header.maxval);
+            for (size_t i = 0; i < samples; i++) {
+                uint32_t clamped = out[i] < maxval ? out[i] : maxval;
+                out[i] = static_cast<uint16_t>((clamped * 65535 + maxval / 2) / maxval);
+            }
+        }
+    }
+    return true;
+}
+
+bool pnm_encode(const ImageView& image, ImageSink& sink, bool pam) {
+    return encode(image, sink, pam);
+}
+
+bool pnm_encode(const ImageView16& image, ImageSink& sink, bool pam) {
+    return encode(image, sink, pam);
+}
+
+} // namespace vanity::detail
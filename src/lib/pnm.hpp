@@ -0,0 +1,52 @@
+#ifndef VANITY_PNM_HPP
+#define VANITY_PNM_HPP
+
+#include "vanity/image_view.hpp"
+#include <cstddef>
+
+namespace vanity {
+class ImageSink;
+}
+
+namespace vanity::detail {
+
+// Raw (binary) netpbm images: PGM "P5", PPM "P6" and PAM "P7"
+// Pixels are stored uncompressed after a short text header, so encoding is
+// little more than a copy and decoding can target the caller's buffer.
+
+// Parsed header of a binary netpbm image
+struct PnmHeader {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    int maxval = 0;
+    size_t data_offset = 0;  // byte offset of the first sample
+};
+
+// True if the data starts with a P5, P6 or P7 magic
+bool is_pnm(const unsigned char* data, size_t size);
+
+// Parse the header; fails if it is malformed or runs past size (the samples
+// themselves are checked by pnm_decode)
+bool pnm_read_header(const unsigned char* data, size_t size, PnmHeader& header);
+
+// Decode 8-bit samples (maxval <= 255, rescaled to 0-255) into dst, whose
+// dimensions and channels must match the header
+// Returns false if the data is shorter than the header promises
+bool pnm_decode(const unsigned char* data, size_t size, const MutableImageView& dst);
+
+// Decode samples of any depth into 16-bit dst, rescaled to 0-65535 (big-endian
+// samples at maxval 65535 are only byte-swapped)
+bool pnm_decode(const unsigned char* data, size_t size, const MutableImageView16& dst);
+
+// Write a (possibly strided) view as PPM (pam = false) or PAM (pam = true)
+// PPM has no alpha: 1- and 2-channel images become PGM, 3- and 4-channel
+// images become PPM, dropping alpha as the JPEG writer does
+bool pnm_encode(const ImageView& image, ImageSink& sink, bool pam);
+
+// Same for 16-bit samples, written with MAXVAL 65535
+bool pnm_encode(const ImageView16& image, ImageSink& sink, bool pam);
+
+} // namespace vanity::detail
+
+#endif // VANITY_PNM_HPP
@@ -0,0 +1,282 @@
+#include "qoi.hpp"
+#include "vanity/image_sink.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace vanity::detail {
+
+namespace {
+
+constexpr unsigned char kOpIndex = 0x00;
+constexpr unsigned char kOpDiff = 0x40;
+constexpr unsigned char kOpLuma = 0x80;
+constexpr unsigned char kOpRun = 0xc0;
+constexpr unsigned char kOpRgb = 0xfe;
+constexpr unsigned char kOpRgba = 0xff;
+constexpr unsigned char kMask2 = 0xc0;
+
+constexpr unsigned char kEndMarker[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+// Same limit as the reference implementation, to bound allocations
+// requested by a hostile header
+constexpr uint64_t kMaxPixels = 400000000;
+
+// Longest encoding of one pixel (QOI_OP_RGBA)
+constexpr size_t kMaxPixelBytes = 5;
+
+struct Rgba {
+    unsigned char r, g, b, a;
+
+    bool operator==(const Rgba& other) const {
+        uint32_t x, y;
+        std::memcpy(&x, this, 4);
+        std::memcpy(&y, &other, 4);
+        return x == y;
+    }
+};
+
+inline unsigned hash(const Rgba& px) {
+    return (px.r * 3u + px.g * 5u + px.b * 7u + px.a * 11u) & 63u;
+}
+
+inline void put_u32(unsigned char* dst, uint32_t value) {
+    dst[0] = static_cast<unsigned char>(value >> 24);
+    dst[1] = static_cast<unsigned char>(value >> 16);
+    dst[2] = static_cast<unsigned char>(value >> 8);
+    dst[3] = static_cast<unsigned char>(value);
+}
+
+inline uint32_t get_u32(const unsigned char* src) {
+    return (uint32_t(src[0]) << 24) | (uint32_t(src[1]) << 16) | (uint32_t(src[2]) << 8) | src[3];
+}
+
+// Read pixel x of a row with C source channels, expanding gray to RGB
+template <int C>
+inline Rgba load_pixel(const unsigned char* row, int x) {
+    const unsigned char* p = row + static_cast<size_t>(x) * C;
+    if constexpr (C == 1) {
+        return {p[0], p[0], p[0], 255};
+    } else if constexpr (C == 2) {
+        return {p[0], p[0], p[0], p[1]};
+    } else if constexpr (C == 3) {
+        return {p[0], p[1], p[2], 255};
+    } else {
+        return {p[0], p[1], p[2], p[3]};
+    }
+}
+
+// Encoder state carried across rows (runs and the cache span row ends)
+struct EncodeState {
+    Rgba index[64] = {};
+    Rgba prev{0, 0, 0, 255};
+    int run = 0;
+};
+
+// Encode one row into out (which has room for kMaxPixelBytes per pixel);
+// returns the number of bytes written
+template <int C>
+size_t encode_row(const unsigned char* row, int width, EncodeState& s, unsigned char* out) {
+    unsigned char* p = out;
+    for (int x = 0; x < width; x++) {
+        Rgba px = load_pixel<C>(row, x);
+        if (px == s.prev) {
+            if (++s.run == 62) {
+                *p++ = kOpRun | 61;
+                s.run = 0;
+            }
+            continue;
+        }
+        if (s.run > 0) {
+            *p++ = static_cast<unsigned char>(kOpRun | (s.run - 1));
+            s.run = 0;
+        }
+
+        unsigned h = hash(px);
+        if (s.index[h] == px) {
+            *p++ = static_cast<unsigned char>(kOpIndex | h);
+        } else {
+            s.index[h] = px;
+            if (px.a == s.prev.a) {
+                // Channel differences wrap, as in the reference encoder
+                signed char dr = static_cast<signed char>(px.r - s.prev.r);
+                signed char dg = static_cast<signed char>(px.g - s.prev.g);
+                signed char db = static_cast<signed char>(px.b - s.prev.b);
+                signed char dr_dg = static_cast<signed char>(dr - dg);
+                signed char db_dg = static_cast<signed char>(db - dg);
+                if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+                    *p++ = static_cast<unsigned char>(kOpDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                } else if (dr_dg > -9 && dr_dg < 8 && dg > -33 && dg < 32 && db_dg > -9 && db_dg < 8) {
+                    *p++ = static_cast<unsigned char>(kOpLuma | (dg + 32));
+                    *p++ = static_cast<unsigned char>((dr_dg + 8) << 4 | (db_dg + 8));
+                } else {
+                    *p++ = kOpRgb;
+                    *p++ = px.r;
+                    *p++ = px.g;
+                    *p++ = px.b;
+                }
+            } else {
+                *p++ = kOpRgba;
+                *p++ = px.r;
+                *p++ = px.g;
+                *p++ = px.b;
+                *p++ = px.a;
+            }
+        }
+        s.prev = px;
+    }
+    return static_cast<size_t>(p - out);
+}
+
+template <int C>
+bool encode_image(const ImageView& image, ImageSink& sink, unsigned char* buffer, size_t capacity) {
+    EncodeState state;
+    size_t used = 0;
+    size_t row_worst = static_cast<size_t>(image.width()) * kMaxPixelBytes;
+    for (int y = 0; y < image.height(); y++) {
+        if (capacity - used < row_worst) {
+            if (!sink.write(buffer, used)) {
+                return false;
+            }
+            used = 0;
+        }
+        used += encode_row<C>(image.row(y), image.width(), state, buffer + used);
+    }
+    if (state.run > 0) {
+        buffer[used++] = static_cast<unsigned char>(kOpRun | (state.run - 1));
+    }
+    return sink.write(buffer, used);
+}
+
+// Decode into rows of C output channels
+template <int C>
+bool decode_image(const unsigned char* data, size_t size, const MutableImageView& dst) {
+    Rgba index[64] = {};
+    Rgba px{0, 0, 0, 255};
+    int run = 0;
+    size_t p = kQoiHeaderSize;
+    size_t end = size - sizeof(kEndMarker);
+
+    for (int y = 0; y < dst.height(); y++) {
+        unsigned char* row = dst.row(y);
+        for (int x = 0; x < dst.width(); x++) {
+            if (run > 0) {
+                run--;
+            } else {
+                if (p >= end) {
+                    return false;
+                }
+                unsigned char b1 = data[p++];
+                if (b1 == kOpRgb) {
+                    if (end - p < 3) {
+                        return false;
+                    }
+                    px.r = data[p];
+                    px.g = data[p + 1];
+                    px.b = data[p + 2];
+                    p += 3;
+                } else if (b1 == kOpRgba) {
+                    if (end - p < 4) {
+                        return false;
+                    }
+                    std::memcpy(&px, data + p, 4);
+                    p += 4;
+                } else if ((b1 & kMask2) == kOpIndex) {
+                    px = index[b1];
+                } else if ((b1 & kMask2) == kOpDiff) {
+                    px.r = static_cast<unsigned char>(px.r + ((b1 >> 4) & 3) - 2);
+                    px.g = static_cast<unsigned char>(px.g + ((b1 >> 2) & 3) - 2);
+                    px.b = static_cast<unsigned char>(px.b + (b1 & 3) - 2);
+                } else if ((b1 & kMask2) == kOpLuma) {
+                    if (p >= end) {
+                        return false;
+                    }
+                    unsigned char b2 = data[p++];
+                    int dg = (b1 & 0x3f) - 32;
+                    px.r = static_cast<unsigned char>(px.r + dg - 8 + ((b2 >> 4) & 0x0f));
+                    px.g = static_cast<unsigned char>(px.g + dg);
+                    px.b = static_cast<unsigned char>(px.b + dg - 8 + (b2 & 0x0f));
+                } else {
+                    run = b1 & 0x3f;
+                }
+                index[hash(px)] = px;
+            }
+
+            unsigned char* out = row + static_cast<size_t>(x) * C;
+            out[0] = px.r;
+            out[1] = px.g;
+            out[2] = px.b;
+            if constexpr (C == 4) {
+                out[3] = px.a;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool is_qoi(const unsigned char* data, size_t size) {
+    return data && size >= 4 && std::memcmp(data, "qoif", 4) == 0;
+}
+
+bool qoi_read_header(const unsigned char* data, size_t size, int& width, int& height, int& channels) {
+    if (size < kQoiHeaderSize + sizeof(kEndMarker) || !is_qoi(data, size)) {
+        return false;
+    }
+    uint32_t w = get_u32(data + 4);
+    uint32_t h = get_u32(data + 8);
+    unsigned char c = data[12];
+    unsigned char colorspace = data[13];
+    if (w == 0 || h == 0 || w > 0x7fffffff || h > 0x7fffffff || (c != 3 && c != 4) || colorspace > 1 ||
+        uint64_t(w) * h > kMaxPixels) {
+        return false;
+    }
+    width = static_cast<int>(w);
+    height = static_cast<int>(h);
+    channels = c;
+    return true;
+}
+
+bool qoi_decode(const unsigned char* data, size_t size, const MutableImageView& dst) {
+    int width, height, channels;
+    if (!qoi_read_header(data, size, width, height, channels) ||
+        dst.width() != width || dst.height() != height || dst.channels() != channels) {
+        return false;
+    }
+    return channels == 3 ? decode_image<3>(data, size, dst) : decode_image<4>(data, size, dst);
+}
+
+bool qoi_encode(const ImageView& image, ImageSink& sink) {
+    int channels = image.channels();
+    if (image.empty() || channels < 1 || channels > 4 ||
+        uint64_t(image.width()) * image.height() > kMaxPixels) {
+        return false;
+    }
+
+    // Rows are encoded into one buffer that is handed to the sink whenever
+    // the next row might not fit, so the sink sees few, large writes
+    size_t capacity = std::max<size_t>(size_t(64) << 10, static_cast<size_t>(image.width()) * kMaxPixelBytes + 1);
+    std::vector<unsigned char> buffer(capacity);
+
+    unsigned char header[kQoiHeaderSize] = {'q', 'o', 'i', 'f'};
+    put_u32(header + 4, static_cast<uint32_t>(image.width()));
+    put_u32(header + 8, static_cast<uint32_t>(image.height()));
+    header[12] = static_cast<unsigned char>(channels == 1 || channels == 3 ? 3 : 4);
+    header[13] = 0; // sRGB with linear alpha
+    if (!sink.write(header, sizeof(header))) {
+        return false;
+    }
+
+    bool ok = false;
+    switch (channels) {
+        case 1: ok = encode_image<1>(image, sink, buffer.data(), capacity); break;
+        case 2: ok = encode_image<2>(image, sink, buffer.data(), capacity); break;
+        case 3: ok = encode_image<3>(image, sink, buffer.data(), capacity); break;
+        case 4: ok = encode_image<4>(image, sink, buffer.data(), capacity); break;
+    }
+    return ok && sink.write(kEndMarker, sizeof(kEndMarker));
+}
+
+} // namespace vanity::detail
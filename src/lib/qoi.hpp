@@ -0,0 +1,35 @@
+#ifndef VANITY_QOI_HPP
+#define VANITY_QOI_HPP
+
+#include "vanity/image_view.hpp"
+#include <cstddef>
+
+namespace vanity {
+class ImageSink;
+}
+
+namespace vanity::detail {
+
+// QOI ("Quite OK Image") codec: a single-pass lossless format built from
+// run-length, 64-entry colour cache and small delta ops (qoiformat.org)
+
+// Size of the fixed file header
+constexpr size_t kQoiHeaderSize = 14;
+
+// True if the data starts with the "qoif" magic
+bool is_qoi(const unsigned char* data, size_t size);
+
+// Parse the header; channels is 3 or 4
+bool qoi_read_header(const unsigned char* data, size_t size, int& width, int& height, int& channels);
+
+// Decode into dst, whose dimensions and channels must match the header
+// Returns false on a malformed or truncated stream
+bool qoi_decode(const unsigned char* data, size_t size, const MutableImageView& dst);
+
+// Encode a (possibly strided) view; 1- and 2-channel images are written as
+// RGB and RGBA since QOI only stores 3 or 4 channels
+bool qoi_encode(const ImageView& image, ImageSink& sink);
+
+} // namespace vanity::detail
+
+#endif // VANITY_QOI_HPP
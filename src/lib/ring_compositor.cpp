@@ -0,0 +1,187 @@
+#include "ring_compositor.hpp"
+#include "pixel_kernels.hpp"
+#include <cstring>
+#include <vector>
+
+namespace vanity::detail {
+
+namespace {
+
+// Fills shorter than this are written pixel by pixel; longer ones go to the
+// dispatched vector kernel
+constexpr size_t kVectorFillBytes = 256;
+
+// Bytes per pixel as a compile-time constant; 0 means "only known at runtime"
+template <int C>
+struct Channels {
+    int runtime;
+    constexpr int get() const { return C ? C : runtime; }
+};
+
+template <int C>
+inline void fill_pixels(unsigned char* dst, size_t count, const unsigned char* pixel, Channels<C> ch) {
+    if constexpr (C != 0) {
+        if (count * C < kVectorFillBytes) {
+            // Constant-size memcpy compiles to a single store per pixel
+            for (size_t i = 0; i < count; i++) {
+                std::memcpy(dst + i * C, pixel, C);
+            }
+            return;
+        }
+    }
+    pixel_kernels().fill_pattern(dst, count, pixel, ch.get());
+}
+
+// Pixel of ring k in a table of the rings' colors in the image's sample
+// type, one entry every step bytes
+struct RingColors {
+    const unsigned char* base;
+    size_t step;
+    const unsigned char* operator()(int k) const { return base + k * step; }
+};
+
+// src and dst are byte views whose "channels" are bytes per pixel
+template <int C>
+void compose_rings_impl(const ImageView& src, const MutableImageView& dst, std::span<const BorderSpec> rings,
+                        RingColors color, int y_begin, int y_end, Channels<C> ch) {
+    const int channels = ch.get();
+    const PixelKernels& kernels = pixel_kernels();
+
+    int total = 0;
+    for (const BorderSpec& ring : rings) {
+        total += ring.width;
+    }
+
+    int new_width = dst.width();
+    int new_height = dst.height();
+    size_t interior_row = static_cast<size_t>(new_width - 2 * total) * channels;
+    size_t dst_row = dst.row_bytes();
+    int ring_count = static_cast<int>(rings.size());
+
+    // Ring whose top/bottom band contains row y, or -1 for interior rows
+    auto ring_for_row = [&](int y) {
+        int depth = y < new_height - 1 - y ? y : new_height - 1 - y;
+        for (int k = ring_count - 1; k >= 0; k--) {
+            if (depth < rings[k].width) {
+                return k;
+            }
+            depth -= rings[k].width;
+        }
+        return -1;
+    };
+
+    // Band rows: outer rings' side bands, this ring across the middle, then
+    // the outer rings' side bands again
+    auto paint_band_row = [&](unsigned char* row, int ring_index) {
+        int outer = 0;
+        for (int k = ring_count - 1; k > ring_index; k--) {
+            outer += rings[k].width;
+        }
+        unsigned char* out = row;
+        for (int k = ring_count - 1; k > ring_index; k--) {
+            fill_pixels(out, rings[k].width, color(k), ch);
+            out += static_cast<size_t>(rings[k].width) * channels;
+        }
+        size_t span_pixels = static_cast<size_t>(new_width) - 2 * static_cast<size_t>(outer);
+        fill_pixels(out, span_pixels, color(ring_index), ch);
+        out += span_pixels * channels;
+        for (int k = ring_index + 1; k < ring_count; k++) {
+            fill_pixels(out, rings[k].width, color(k), ch);
+            out += static_cast<size_t>(rings[k].width) * channels;
+        }
+    };
+
+    // Interior rows: left bands outermost first, one copy of the source row
+    // (unless it is already in place), then right bands innermost first
+    auto paint_interior_row = [&](unsigned char* out, int src_y) {
+        for (int k = ring_count - 1; k >= 0; k--) {
+            fill_pixels(out, rings[k].width, color(k), ch);
+            out += static_cast<size_t>(rings[k].width) * channels;
+        }
+        if (!src.empty()) {
+            kernels.copy_row(out, src.row(src_y), interior_row);
+        }
+        out += interior_row;
+        for (int k = 0; k < ring_count; k++) {
+            fill_pixels(out, rings[k].width, color(k), ch);
+            out += static_cast<size_t>(rings[k].width) * channels;
+        }
+    };
+
+    // Every row within the same ring's band is identical, so only the first
+    // one in this range is painted and the rest are copied from it
+    int previous_ring = -1;
+    for (int y = y_begin; y < y_end; y++) {
+        int ring = ring_for_row(y);
+        if (ring < 0) {
+            paint_interior_row(dst.row(y), y - total);
+        } else if (ring == previous_ring) {
+            kernels.copy_row(dst.row(y), dst.row(y - 1), dst_row);
+        } else {
+            paint_band_row(dst.row(y), ring);
+        }
+        previous_ring = ring;
+    }
+}
+
+template <typename T>
+ImageView as_bytes(const BasicImageView<T>& view) {
+    return ImageView(reinterpret_cast<const unsigned char*>(view.data()), view.width(), view.height(),
+                     view.channels() * static_cast<int>(sizeof(T)), view.stride());
+}
+
+template <typename T>
+MutableImageView as_bytes(const BasicMutableImageView<T>& view) {
+    return MutableImageView(reinterpret_cast<unsigned char*>(view.data()), view.width(), view.height(),
+                            view.channels() * static_cast<int>(sizeof(T)), view.stride());
+}
+
+void compose_bytes(const ImageView& src, const MutableImageView& dst, std::span<const BorderSpec> rings,
+                   RingColors color, int y_begin, int y_end, bool specialize) {
+    int bytes = dst.channels();
+    if (specialize) {
+        switch (bytes) {
+            case 1: return compose_rings_impl(src, dst, rings, color, y_begin, y_end, Channels<1>{1});
+            case 2: return compose_rings_impl(src, dst, rings, color, y_begin, y_end, Channels<2>{2});
+            case 3: return compose_rings_impl(src, dst, rings, color, y_begin, y_end, Channels<3>{3});
+            case 4: return compose_rings_impl(src, dst, rings, color, y_begin, y_end, Channels<4>{4});
+            case 6: return compose_rings_impl(src, dst, rings, color, y_begin, y_end, Channels<6>{6});
+            case 8: return compose_rings_impl(src, dst, rings, color, y_begin, y_end, Channels<8>{8});
+            case 12: return compose_rings_impl(src, dst, rings, color, y_begin, y_end, Channels<12>{12});
+            case 16: return compose_rings_impl(src, dst, rings, color, y_begin, y_end, Channels<16>{16});
+            default: break;
+        }
+    }
+    compose_rings_impl(src, dst, rings, color, y_begin, y_end, Channels<0>{bytes});
+}
+
+} // namespace
+
+void compose_rings(const ImageView& src, const MutableImageView& dst,
+                   std::span<const BorderSpec> rings, bool specialize) {
+    compose_rings(src, dst, rings, 0, dst.height(), specialize);
+}
+
+template <typename T>
+void compose_rings(const BasicImageView<T>& src, const BasicMutableImageView<T>& dst,
+                   std::span<const BorderSpec> rings, int y_begin, int y_end, bool specialize) {
+    constexpr size_t kMaxPixel = 4 * sizeof(T);
+    std::vector<unsigned char> colors(rings.size() * kMaxPixel);
+    for (size_t k = 0; k < rings.size(); k++) {
+        if constexpr (sizeof(T) == 1) {
+            std::memcpy(colors.data() + k * kMaxPixel, rings[k].color, kMaxPixel);
+        } else {
+            widen_color<T>(rings[k].color, dst.channels(), colors.data() + k * kMaxPixel);
+        }
+    }
+    compose_bytes(as_bytes(src), as_bytes(dst), rings, RingColors{colors.data(), kMaxPixel}, y_begin, y_end,
+                  specialize);
+}
+
+template void compose_rings(const ImageView&, const MutableImageView&, std::span<const BorderSpec>, int, int, bool);
+template void compose_rings(const ImageView16&, const MutableImageView16&, std::span<const BorderSpec>, int, int,
+                            bool);
+template void compose_rings(const ImageViewF&, const MutableImageViewF&, std::span<const BorderSpec>, int, int,
+                            bool);
+
+} // namespace vanity::detail
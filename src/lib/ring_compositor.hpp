@@ -0,0 +1,52 @@
+#ifndef VANITY_RING_COMPOSITOR_HPP
+#define VANITY_RING_COMPOSITOR_HPP
+
+#include "vanity/image_ops.hpp"
+#include "vanity/image_view.hpp"
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace vanity::detail {
+
+// Paint rings into dst around its interior (rings innermost first, already
+// validated). When src is empty the interior is assumed to already be in
+// place and is skipped.
+// Dispatches to a kernel specialized for the pixel size (1-4 bytes for 8-bit
+// images, up to 16 for 16-bit and float ones); specialize = false forces the
+// runtime-size kernel (used by benchmarks for comparison).
+void compose_rings(const ImageView& src, const MutableImageView& dst,
+                   std::span<const BorderSpec> rings, bool specialize = true);
+
+// Same, restricted to destination rows [y_begin, y_end); disjoint row ranges
+// may be composed concurrently
+// 16-bit and float images share the 8-bit kernels: rows are handled as
+// pixels of channels * sizeof(T) bytes, and ring colors are widened with
+// widen_color (1-4 channels only).
+template <typename T>
+void compose_rings(const BasicImageView<T>& src, const BasicMutableImageView<T>& dst,
+                   std::span<const BorderSpec> rings, int y_begin, int y_end,
+                   bool specialize = true);
+
+// Write an 8-bit color as one pixel of `channels` (at most 4) samples of
+// type T: 16-bit samples are c * 257 and float samples c / 255, so 255 maps
+// to full scale. out receives channels * sizeof(T) bytes.
+template <typename T>
+void widen_color(const unsigned char color[4], int channels, unsigned char* out) {
+    for (int c = 0; c < channels; c++) {
+        T sample;
+        if constexpr (std::is_same_v<T, float>) {
+            sample = color[c] / 255.0f;
+        } else if constexpr (std::is_same_v<T, uint16_t>) {
+            sample = static_cast<uint16_t>(color[c] * 257);
+        } else {
+            sample = color[c];
+        }
+        std::memcpy(out + c * sizeof(T), &sample, sizeof(T));
+    }
+}
+
+} // namespace vanity::detail
+
+#endif // VANITY_RING_COMPOSITOR_HPP
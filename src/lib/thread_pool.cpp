@@ -0,0 +1,153 @@
+#include "vanity/thread_pool.hpp"
+#include <atomic>
+#include <memory>
+
+namespace vanity {
+
+namespace {
+
+// Pool and queue index of the worker running on this thread, if any
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) {
+            threads = 1;
+        }
+    }
+    queues_.reserve(threads);
+    for (unsigned i = 0; i < threads; i++) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; i++) {
+        workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t index = current_pool == this
+        ? current_index
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    pending_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+
+    // Taking the lock orders this wake-up after any worker's predicate check
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    sleep_cv_.notify_one();
+}
+
+bool ThreadPool::try_pop(size_t index, std::function<void()>& task) {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::try_steal(size_t thief, std::function<void()>& task) {
+    for (size_t offset = 1; offset < queues_.size(); offset++) {
+        WorkerQueue& queue = *queues_[(thief + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    current_pool = this;
+    current_index = index;
+
+    for (;;) {
+        std::function<void()> task;
+        if (try_pop(index, task) || try_steal(index, task)) {
+            pending_.fetch_sub(1);
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+        if (stopping_ && pending_.load() == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    if (grain == 0) {
+        grain = 1;
+    }
+    size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1) {
+        fn(0, count);
+        return;
+    }
+
+    // Shared so that helpers which only start after the loop has finished
+    // can still safely observe that there is nothing left to do
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto state = std::make_shared<State>();
+
+    auto run_chunks = [state, count, grain, chunks, &fn] {
+        for (;;) {
+            size_t chunk = state->next.fetch_add(1);
+            if (chunk >= chunks) {
+                return;
+            }
+            size_t begin = chunk * grain;
+            size_t end = begin + grain < count ? begin + grain : count;
+            fn(begin, end);
+            if (state->done.fetch_add(1) + 1 == chunks) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->cv.notify_all();
+            }
+        }
+    };
+
+    // `fn` is only touched while chunks remain, and the caller does not
+    // return before every chunk is done, so capturing it by reference is safe
+    size_t helpers = chunks - 1 < workers_.size() ? chunks - 1 : workers_.size();
+    for (size_t i = 0; i < helpers; i++) {
+        submit(run_chunks);
+    }
+    run_chunks();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&] { return state->done.load() == chunks; });
+}
+
+} // namespace vanity
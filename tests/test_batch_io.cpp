@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "vanity/batch_io.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace vanity;
+
+namespace {
+
+// Run each test against both backends
+class BatchFileIOTest : public ::testing::TestWithParam<bool> {
+protected:
+    std::unique_ptr<BatchFileIO> make_io() {
+        // A small queue forces read_files/write_files to split into chunks
+        return GetParam() ? BatchFileIO::create(4) : BatchFileIO::create_fallback();
+    }
+};
+
+std::vector<unsigned char> pattern(size_t size, unsigned seed) {
+    std::vector<unsigned char> bytes(size);
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = static_cast<unsigned char>(i * 31 + seed);
+    }
+    return bytes;
+}
+
+} // namespace
+
+TEST_P(BatchFileIOTest, WriteThenReadRoundTrips) {
+    auto io = make_io();
+    std::vector<std::string> paths;
+    std::vector<std::vector<unsigned char>> contents;
+    for (unsigned i = 0; i < 7; i++) {
+        paths.push_back("/tmp/test_vanity_batch_" + std::to_string(i) + ".bin");
+        contents.push_back(pattern(1000 + i * 70001, i));
+    }
+
+    std::vector<FileWriteRequest> requests;
+    for (size_t i = 0; i < paths.size(); i++) {
+        requests.push_back({paths[i], contents[i]});
+    }
+    std::vector<bool> written;
+    io->write_files(requests, written);
+    ASSERT_EQ(written.size(), paths.size());
+    for (bool ok : written) {
+        EXPECT_TRUE(ok);
+    }
+
+    std::vector<FileReadResult> results;
+    io->read_files(paths, results);
+    ASSERT_EQ(results.size(), paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        EXPECT_TRUE(results[i].ok);
+        EXPECT_EQ(results[i].bytes, contents[i]);
+        std::remove(paths[i].c_str());
+    }
+}
+
+TEST_P(BatchFileIOTest, WriteTruncatesExistingFile) {
+    auto io = make_io();
+    const std::string path = "/tmp/test_vanity_batch_truncate.bin";
+    std::ofstream(path, std::ios::binary) << std::string(5000, 'z');
+
+    std::vector<unsigned char> bytes = pattern(10, 3);
+    std::vector<FileWriteRequest> requests{{path, bytes}};
+    std::vector<bool> written;
+    io->write_files(requests, written);
+    ASSERT_TRUE(written[0]);
+
+    std::vector<FileReadResult> results;
+    io->read_files(std::vector<std::string>{path}, results);
+    std::remove(path.c_str());
+    EXPECT_EQ(results[0].bytes, bytes);
+}
+
+TEST_P(BatchFileIOTest, MissingFileFailsAlone) {
+    auto io = make_io();
+    const std::string path = "/tmp/test_vanity_batch_present.bin";
+    std::ofstream(path, std::ios::binary) << "hello";
+
+    std::vector<FileReadResult> results;
+    io->read_files(std::vector<std::string>{"nonexistent_file_xyz.bin", path}, results);
+    std::remove(path.c_str());
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_FALSE(results[0].ok);
+    EXPECT_TRUE(results[0].bytes.empty());
+    EXPECT_TRUE(results[1].ok);
+    EXPECT_EQ(std::string(results[1].bytes.begin(), results[1].bytes.end()), "hello");
+}
+
+TEST_P(BatchFileIOTest, EmptyFileIsReadable) {
+    auto io = make_io();
+    const std::string path = "/tmp/test_vanity_batch_empty.bin";
+    std::ofstream(path, std::ios::binary).close();
+
+    std::vector<FileReadResult> results;
+    io->read_files(std::vector<std::string>{path}, results);
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(results[0].ok);
+    EXPECT_TRUE(results[0].bytes.empty());
+}
+
+TEST_P(BatchFileIOTest, WriteToMissingDirectoryFails) {
+    auto io = make_io();
+    std::vector<unsigned char> bytes = pattern(16, 0);
+    std::vector<FileWriteRequest> requests{{"/nonexistent_dir_xyz/out.bin", bytes}};
+    std::vector<bool> written;
+    io->write_files(requests, written);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_FALSE(written[0]);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, BatchFileIOTest, ::testing::Values(true, false),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                             return info.param ? "Best" : "Pread";
+                         });
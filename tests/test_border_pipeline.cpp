@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "../src/cli/border_pipeline.hpp"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_sink.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace vanity;
+
+TEST(BorderPipelineTest, EstimateCountsInputPaddedFrameAndScratch) {
+    // 100x50 RGB, 10px border: 120x70 padded frame; stored PNG keeps about
+    // one padded frame of output, which outweighs the decoder's scratch
+    size_t frame = 100 * 50 * 3;
+    size_t padded = 120 * 70 * 3;
+    EXPECT_EQ(estimate_peak_bytes(100, 50, 3, 10, 1234, ImageFormat::PNG), 1234 + padded + padded);
+
+    // JPEG output is smaller, so a thin border leaves the decoder's frame as
+    // the larger scratch
+    EXPECT_EQ(estimate_peak_bytes(100, 50, 3, 1, 0, ImageFormat::JPG),
+              size_t(102 * 52 * 3) + std::max(frame, size_t(102 * 52 * 3) / 2));
+}
+
+TEST(BorderPipelineTest, EstimateDoesNotOverflowInt) {
+    // Each padded side fits in an int but their product does not
+    int side = 40000;
+    int border = 5000;
+    size_t padded_side = static_cast<size_t>(side) + 2 * border;
+    size_t padded = padded_side * padded_side * 4;
+    EXPECT_EQ(estimate_peak_bytes(side, side, 4, border, 0, ImageFormat::PNG), 2 * padded);
+}
+
+TEST(BorderPipelineTest, LosslessEstimateCountsCoefficientsAndOutput) {
+    // 64x32 YCbCr with a 10px border rounded up to 16: 96x64 samples per
+    // component at two bytes each, plus the input and its re-encoded copy
+    size_t padded = 96 * 64 * 3;
+    EXPECT_EQ(estimate_lossless_peak_bytes(64, 32, 3, 10, 1000), 2000 + 2 * padded);
+}
+
+TEST(BorderPipelineTest, KeepsSixteenBitPamAtSixteenBits) {
+    // stb cannot read PAM, so the pipeline must take the depth from its own probe
+    namespace fs = std::filesystem;
+    fs::path dir = "/tmp/test_vanity_pipeline16";
+    fs::create_directories(dir);
+    std::string input = (dir / "in.pam").string();
+    std::string output = (dir / "out.pam").string();
+    std::vector<uint16_t> pixels(5 * 3 * 2);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<uint16_t>(i * 2099 + 3);
+    }
+    {
+        FileSink sink(input.c_str());
+        ASSERT_TRUE(write_image(sink, ImageView16(pixels.data(), 5, 3, 2), ImageFormat::PAM));
+        ASSERT_TRUE(sink.close());
+    }
+
+    std::vector<BorderTask> tasks = {{input, output}};
+    std::vector<BorderSpec> rings = {{2, {255, 255, 255, 255}}};
+    std::vector<BorderTaskResult> results;
+    run_border_pipeline(tasks, rings, PipelineConfig{}, [&](const BorderTaskResult& result) {
+        results.push_back(result);
+    });
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_TRUE(results[0].ok) << results[0].error;
+
+    ImageInfo info;
+    ASSERT_TRUE(probe_image(output.c_str(), info));
+    EXPECT_EQ(info.bits_per_channel, 16);
+    int width, height, channels;
+    LoadedImage16 img = LoadedImage16::load(output.c_str(), width, height, channels);
+    fs::remove_all(dir);
+    ASSERT_NE(img.get(), nullptr);
+    ASSERT_EQ(width, 9);
+    ASSERT_EQ(channels, 2);
+    for (int y = 0; y < 3; y++) {
+        EXPECT_EQ(std::memcmp(img.view().pixel(2, y + 2), &pixels[y * 5 * 2], 5 * 2 * sizeof(uint16_t)), 0);
+    }
+    EXPECT_EQ(img.get()[0], 65535);
+}
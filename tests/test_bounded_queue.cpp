@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "vanity/bounded_queue.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace vanity;
+
+TEST(BoundedQueueTest, PopsInFifoOrder) {
+    BoundedQueue<int> queue(3);
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.pop(), 3);
+}
+
+TEST(BoundedQueueTest, CloseDrainsThenStops) {
+    BoundedQueue<int> queue(2);
+    queue.push(7);
+    queue.close();
+    EXPECT_FALSE(queue.push(8));
+    EXPECT_EQ(queue.pop(), 7);
+    EXPECT_EQ(queue.pop(), std::nullopt);
+}
+
+TEST(BoundedQueueTest, TryPopDoesNotBlock) {
+    BoundedQueue<int> queue(2);
+    EXPECT_EQ(queue.try_pop(), std::nullopt);
+    queue.push(4);
+    EXPECT_EQ(queue.try_pop(), 4);
+    EXPECT_EQ(queue.try_pop(), std::nullopt);
+}
+
+TEST(BoundedQueueTest, ZeroCapacityIsTreatedAsOne) {
+    BoundedQueue<int> queue(0);
+    EXPECT_EQ(queue.capacity(), 1u);
+}
+
+TEST(BoundedQueueTest, ProducerBlocksWhileFull) {
+    BoundedQueue<int> queue(2);
+    std::atomic<int> pushed{0};
+    std::thread producer([&] {
+        for (int i = 0; i < 5; i++) {
+            queue.push(i);
+            pushed++;
+        }
+        queue.close();
+    });
+
+    // Give the producer time to fill the queue; it must stop at capacity
+    while (pushed.load() < 2) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(pushed.load(), 2);
+
+    std::vector<int> received;
+    while (auto item = queue.pop()) {
+        received.push_back(*item);
+    }
+    producer.join();
+    EXPECT_EQ(received, (std::vector<int>{0, 1, 2, 3, 4}));
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "test_images.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace vanity;
+using vanity::test::make_jpeg;
+using vanity::test::photo_like;
+
+namespace {
+
+// Decode many randomly damaged copies of a valid file: flipped and
+// overwritten bytes, truncation and duplicated runs. Nothing is checked
+// about the result; the point is that the in-tree decoders never read or
+// write out of bounds, which the sanitizer builds report
+void decode_mutations(const std::vector<std::byte>& valid, const std::string& name, int iterations) {
+    int width, height, channels;
+    const auto* data = reinterpret_cast<const unsigned char*>(valid.data());
+    ASSERT_TRUE(decode_from_memory(valid).get() ||
+                LoadedImage16::load_from_memory(data, valid.size(), width, height, channels).get())
+        << name;
+    std::mt19937 rng(7);
+    for (int i = 0; i < iterations; i++) {
+        std::vector<std::byte> bytes = valid;
+        int edits = 1 + static_cast<int>(rng() % 8);
+        for (int e = 0; e < edits && !bytes.empty(); e++) {
+            size_t at = rng() % bytes.size();
+            switch (rng() % 5) {
+                case 0:
+                    bytes[at] ^= static_cast<std::byte>(1u << (rng() % 8));
+                    break;
+                case 1:
+                    bytes[at] = static_cast<std::byte>(rng());
+                    break;
+                case 2:
+                    bytes[at] = std::byte{0xff};
+                    break;
+                case 3:
+                    bytes.resize(at);
+                    break;
+                default: {
+                    size_t length = std::min<size_t>(1 + rng() % 64, bytes.size() - at);
+                    std::vector<std::byte> run(bytes.begin() + at, bytes.begin() + at + length);
+                    bytes.insert(bytes.begin() + rng() % (bytes.size() + 1), run.begin(), run.end());
+                    break;
+                }
+            }
+        }
+        ImageInfo info;
+        probe_image(bytes, info);
+        decode_from_memory(bytes);
+        LoadedImage16::load_from_memory(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size(), width,
+                                        height, channels);
+    }
+}
+
+std::vector<std::byte> encode(int width, int height, int channels, ImageFormat format) {
+    std::vector<unsigned char> pixels = photo_like(width, height, channels);
+    return encode_to_memory(ImageView(pixels.data(), width, height, channels), format);
+}
+
+std::vector<std::byte> encode16(int width, int height, int channels, ImageFormat format) {
+    std::vector<uint16_t> pixels(static_cast<size_t>(width) * height * channels);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<uint16_t>(i * 2731 + 1);
+    }
+    return encode_to_memory(ImageView16(pixels.data(), width, height, channels), format);
+}
+
+} // namespace
+
+TEST(CorruptInputTest, JpegDecoderSurvivesDamage) {
+    decode_mutations(make_jpeg(40, 24, 3, 75), "jpeg 4:2:0", 1500);
+    decode_mutations(make_jpeg(24, 16, 1, 90), "jpeg gray", 1500);
+}
+
+TEST(CorruptInputTest, PngDecoderSurvivesDamage) {
+    decode_mutations(encode(24, 16, 4, ImageFormat::PNG), "png", 1500);
+    decode_mutations(encode16(12, 8, 3, ImageFormat::PNG), "png 16-bit", 1500);
+}
+
+TEST(CorruptInputTest, QoiDecoderSurvivesDamage) {
+    decode_mutations(encode(24, 16, 4, ImageFormat::QOI), "qoi", 1500);
+}
+
+TEST(CorruptInputTest, PnmDecoderSurvivesDamage) {
+    decode_mutations(encode(24, 16, 3, ImageFormat::PPM), "ppm", 1000);
+    decode_mutations(encode16(12, 8, 2, ImageFormat::PAM), "pam 16-bit", 1000);
+}
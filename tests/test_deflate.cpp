@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "../src/lib/checksum.hpp"
+#include "../src/lib/deflate.hpp"
+#include "stb_image.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace vanity::detail;
+
+namespace {
+
+// Text-like data with repeats at many distances, plus a long run and noise
+std::vector<unsigned char> sample_data(size_t size) {
+    std::vector<unsigned char> data(size);
+    std::mt19937 rng(3);
+    const std::string words[] = {"vanity ", "border ", "pixel ", "deflate ", "ring "};
+    size_t i = 0;
+    while (i < size) {
+        unsigned r = rng() % 10;
+        if (r < 6) {
+            const std::string& w = words[rng() % 5];
+            for (size_t k = 0; k < w.size() && i < size; k++) {
+                data[i++] = static_cast<unsigned char>(w[k]);
+            }
+        } else if (r < 8) {
+            size_t run = 1 + rng() % 600;
+            for (size_t k = 0; k < run && i < size; k++) {
+                data[i++] = 0;
+            }
+        } else {
+            data[i++] = static_cast<unsigned char>(rng());
+        }
+    }
+    return data;
+}
+
+// Inflate with stb's decoder, which only accepts valid streams
+std::vector<unsigned char> inflate(const std::vector<unsigned char>& deflated) {
+    int size = 0;
+    char* raw = stbi_zlib_decode_noheader_malloc(reinterpret_cast<const char*>(deflated.data()),
+                                                 static_cast<int>(deflated.size()), &size);
+    std::vector<unsigned char> out;
+    if (raw) {
+        out.assign(raw, raw + size);
+        std::free(raw);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(ChecksumTest, KnownValues) {
+    const auto* digits = reinterpret_cast<const unsigned char*>("123456789");
+    EXPECT_EQ(crc32(0, digits, 9), 0xcbf43926u);
+    EXPECT_EQ(crc32(crc32(0, digits, 4), digits + 4, 5), 0xcbf43926u);
+    EXPECT_EQ(crc32(0, digits, 0), 0u);
+
+    const auto* wiki = reinterpret_cast<const unsigned char*>("Wikipedia");
+    EXPECT_EQ(adler32(1, wiki, 9), 0x11e60398u);
+    EXPECT_EQ(adler32(adler32(1, wiki, 3), wiki + 3, 6), 0x11e60398u);
+}
+
+TEST(ChecksumTest, Adler32SurvivesLongRunsOfHighBytes) {
+    // Long enough that the sums must be reduced mid-way
+    std::vector<unsigned char> data(100000, 0xff);
+    uint32_t a = 1, b = 0;
+    for (unsigned char c : data) {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    EXPECT_EQ(adler32(1, data.data(), data.size()), (b << 16) | a);
+}
+
+TEST(ChecksumTest, Adler32CombineMatchesWholeBuffer) {
+    std::vector<unsigned char> data = sample_data(200000);
+    std::fill(data.begin() + 1000, data.begin() + 80000, 0xff);
+    uint32_t whole = adler32(1, data.data(), data.size());
+    for (size_t split : {size_t(0), size_t(1), size_t(5552), size_t(65521), size_t(123457), data.size()}) {
+        uint32_t first = adler32(1, data.data(), split);
+        uint32_t second = adler32(1, data.data() + split, data.size() - split);
+        EXPECT_EQ(adler32_combine(first, second, data.size() - split), whole) << "split at " << split;
+    }
+}
+
+TEST(DeflateTest, EveryLevelRoundTrips) {
+    std::vector<unsigned char> data = sample_data(300000);
+    for (int level = 0; level <= 9; level++) {
+        DeflateEncoder encoder(level);
+        std::vector<unsigned char> out;
+        encoder.compress(data.data(), 0, data.size(), out);
+        encoder.finish(out);
+        EXPECT_EQ(inflate(out), data) << "level " << level;
+        if (level >= 1) {
+            EXPECT_LT(out.size(), data.size()) << "level " << level;
+        }
+    }
+}
+
+TEST(DeflateTest, PiecesMayReferenceEarlierHistory) {
+    std::vector<unsigned char> data = sample_data(200000);
+    DeflateEncoder encoder(6);
+    std::vector<unsigned char> out;
+    // Feed uneven pieces, each with the whole preceding stream as history
+    size_t pos = 0;
+    for (size_t piece : {1000u, 70000u, 3u, 50000u}) {
+        encoder.compress(data.data(), pos, piece, out);
+        pos += piece;
+    }
+    encoder.compress(data.data(), pos, data.size() - pos, out);
+    encoder.finish(out);
+    EXPECT_EQ(inflate(out), data);
+}
+
+TEST(DeflateTest, SyncFlushedPiecesConcatenate) {
+    std::vector<unsigned char> data = sample_data(100000);
+    std::vector<unsigned char> out;
+    DeflateEncoder first(4);
+    first.compress(data.data(), 0, 60000, out);
+    first.sync_flush(out);
+    // A separate encoder continues at a byte boundary
+    DeflateEncoder second(4);
+    second.compress(data.data(), 60000, data.size() - 60000, out);
+    second.finish(out);
+    EXPECT_EQ(inflate(out), data);
+}
+
+TEST(DeflateTest, ZlibHeaderIsValid) {
+    for (int level = 0; level <= 9; level++) {
+        DeflateEncoder encoder(level);
+        EXPECT_EQ((0x78 * 256 + encoder.zlib_flags()) % 31, 0);
+    }
+}
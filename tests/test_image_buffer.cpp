@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 #include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/image_sink.hpp"
+#include <cstdio>
+#include <cstring>
+#include <vector>
 
 using namespace vanity;
 
@@ -65,3 +70,74 @@ TEST(LoadedImageTest, MoveConstructorTransfersOwnership) {
     EXPECT_EQ(img2.get(), nullptr);
     EXPECT_EQ(img1.get(), nullptr);
 }
+
+TEST(LoadedImageTest, LoadPaddedPlacesPixelsInInterior) {
+    const char* path = "/tmp/test_vanity_padded.png";
+    unsigned char data[3 * 2 * 3];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = static_cast<unsigned char>(i * 11);
+    }
+    ASSERT_TRUE(write_image(path, 3, 2, 3, data));
+
+    int w, h, c;
+    LoadedImage img = LoadedImage::load_padded(path, Padding{1, 2, 3, 4}, w, h, c);
+    std::remove(path);
+
+    ASSERT_NE(img.get(), nullptr);
+    EXPECT_EQ(w, 3 + 2 + 3);
+    EXPECT_EQ(h, 2 + 1 + 4);
+    EXPECT_EQ(c, 3);
+    EXPECT_EQ(img.width(), w);
+    EXPECT_EQ(img.height(), h);
+    for (int y = 0; y < 2; y++) {
+        EXPECT_EQ(std::memcmp(img.get() + ((y + 1) * w + 2) * c, data + y * 3 * 3, 3 * 3), 0);
+    }
+}
+
+TEST(LoadedImageTest, LoadPaddedInvalidPathReturnsNull) {
+    int w, h, c;
+    LoadedImage img = LoadedImage::load_padded("nonexistent_file_xyz.png", Padding{1, 1, 1, 1}, w, h, c);
+    EXPECT_EQ(img.get(), nullptr);
+}
+
+TEST(LoadedImageTest, WideLoadsKeepOrWidenSamples) {
+    const char* path = "/tmp/test_vanity_wide.png";
+    uint16_t data[3 * 2 * 3];
+    for (size_t i = 0; i < 3 * 2 * 3; i++) {
+        data[i] = static_cast<uint16_t>(i * 3001 + 7);
+    }
+    FileSink sink(path);
+    ASSERT_TRUE(write_image(sink, ImageView16(data, 3, 2, 3), ImageFormat::PNG));
+    ASSERT_TRUE(sink.close());
+
+    ImageInfo info;
+    ASSERT_TRUE(probe_image(path, info));
+    EXPECT_EQ(info.bits_per_channel, 16);
+
+    int w, h, c;
+    LoadedImage16 img = LoadedImage16::load_padded(path, Padding{1, 2, 3, 4}, w, h, c);
+    ASSERT_NE(img.get(), nullptr);
+    EXPECT_EQ(w, 3 + 2 + 3);
+    EXPECT_EQ(h, 2 + 1 + 4);
+    EXPECT_EQ(img.byte_size(), static_cast<size_t>(w) * h * c * 2);
+    for (int y = 0; y < 2; y++) {
+        EXPECT_EQ(std::memcmp(img.view().pixel(2, y + 1), data + y * 3 * 3, 3 * 3 * 2), 0);
+    }
+
+    // The 8-bit loader keeps only the high byte
+    LoadedImage narrow = LoadedImage::load(path, w, h, c);
+    std::remove(path);
+    ASSERT_NE(narrow.get(), nullptr);
+    EXPECT_EQ(narrow.get()[4], data[4] >> 8);
+
+    // Formats stb cannot read are widened after an 8-bit decode
+    unsigned char rgba[2 * 2 * 4] = {0, 64, 128, 255, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    std::vector<std::byte> qoi = encode_to_memory(ImageView(rgba, 2, 2, 4), ImageFormat::QOI);
+    LoadedImage16 wide = LoadedImage16::load_from_memory(reinterpret_cast<const unsigned char*>(qoi.data()),
+                                                         qoi.size(), w, h, c);
+    ASSERT_NE(wide.get(), nullptr);
+    ASSERT_EQ(c, 4);
+    for (int i = 0; i < 16; i++) {
+        EXPECT_EQ(wide.get()[i], rgba[i] * 257);
+    }
+}
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include "vanity/image_io.hpp"
+#include "vanity/image_buffer.hpp"
 #include <fstream>
 #include <cstdio>
+#include <cstring>
+#include <vector>
 
 using namespace vanity;
 
@@ -33,6 +36,44 @@ TEST(ImageIOTest, DetectFormatUnknown) {
     EXPECT_EQ(detect_format("file.gif"), ImageFormat::UNKNOWN);
 }
 
+TEST(ImageIOTest, HdrRoundTripsFloatViews) {
+    EXPECT_EQ(detect_format("scene.HDR"), ImageFormat::HDR);
+
+    std::vector<float> pixels(6 * 5 * 3);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = 0.01f + static_cast<float>(i) * 0.37f;
+    }
+    ImageViewF strided(pixels.data(), 4, 5, 3, 6 * 3 * sizeof(float));
+    std::vector<std::byte> hdr = encode_to_memory(strided, ImageFormat::HDR);
+    ASSERT_FALSE(hdr.empty());
+
+    int w, h, c;
+    LoadedImageF img = LoadedImageF::load_from_memory(reinterpret_cast<const unsigned char*>(hdr.data()),
+                                                      hdr.size(), w, h, c);
+    ASSERT_NE(img.get(), nullptr);
+    ASSERT_EQ(w, 4);
+    ASSERT_EQ(c, 3);
+    for (int y = 0; y < 5; y++) {
+        for (int i = 0; i < 4 * 3; i++) {
+            // RGBE keeps 8 mantissa bits of the brightest channel
+            float expected = strided.row(y)[i];
+            EXPECT_NEAR(img.view().row(y)[i], expected, expected / 64 + 0.05f) << y << ", " << i;
+        }
+    }
+}
+
+TEST(ImageIOTest, WideViewsOnlyWriteFormatsThatHoldThem) {
+    std::vector<uint16_t> deep(4 * 4 * 3, 1000);
+    std::vector<float> linear(4 * 4 * 3, 0.5f);
+    std::vector<unsigned char> narrow(4 * 4 * 3, 100);
+    EXPECT_TRUE(supports_16_bit(ImageFormat::PAM));
+    EXPECT_FALSE(supports_16_bit(ImageFormat::JPG));
+    EXPECT_TRUE(encode_to_memory(ImageView16(deep.data(), 4, 4, 3), ImageFormat::JPG).empty());
+    EXPECT_TRUE(encode_to_memory(ImageView16(deep.data(), 4, 4, 3), ImageFormat::QOI).empty());
+    EXPECT_TRUE(encode_to_memory(ImageViewF(linear.data(), 4, 4, 3), ImageFormat::PNG).empty());
+    EXPECT_TRUE(encode_to_memory(ImageView(narrow.data(), 4, 4, 3), ImageFormat::HDR).empty());
+}
+
 // Integration test with actual file I/O
 class ImageIOIntegrationTest : public ::testing::Test {
 protected:
@@ -101,3 +142,126 @@ TEST_F(ImageIOIntegrationTest, WriteImageUnknownFormat) {
     bool write_success = write_image("/tmp/test.tiff", 1, 1, 1, data);
     EXPECT_FALSE(write_success);
 }
+
+TEST(ImageIOTest, EncodeToMemoryRoundTripsPackedPixels) {
+    unsigned char data[2 * 2 * 3] = {
+        255, 0, 0,    0, 255, 0,
+        0, 0, 255,    255, 255, 255
+    };
+
+    std::vector<std::byte> encoded = encode_to_memory(ImageView(data, 2, 2, 3), ImageFormat::PNG);
+    ASSERT_GT(encoded.size(), 8u);
+    EXPECT_EQ(encoded[1], std::byte{'P'});
+
+    int w, h, c;
+    LoadedImage img = LoadedImage::load_from_memory(reinterpret_cast<const unsigned char*>(encoded.data()),
+                                                    encoded.size(), w, h, c);
+    ASSERT_NE(img.get(), nullptr);
+    EXPECT_EQ(w, 2);
+    EXPECT_EQ(h, 2);
+    EXPECT_EQ(c, 3);
+    EXPECT_EQ(std::memcmp(img.get(), data, sizeof(data)), 0);
+}
+
+TEST(ImageIOTest, EncodeToMemoryUnknownFormatFails) {
+    unsigned char data[1] = {0};
+    std::vector<std::byte> encoded;
+    EXPECT_FALSE(encode_to_memory(ImageView(data, 1, 1, 1), ImageFormat::UNKNOWN, WriteOptions{}, encoded));
+}
+
+TEST(ImageIOTest, EncodeToMemoryAndDecodeFromMemoryRoundTrip) {
+    ImageBuffer image(5, 4, 4);
+    for (size_t i = 0; i < image.byte_size(); i++) {
+        image.get()[i] = static_cast<unsigned char>(i * 5);
+    }
+
+    std::vector<std::byte> encoded = encode_to_memory(image.view(), ImageFormat::PNG);
+    ASSERT_FALSE(encoded.empty());
+
+    LoadedImage decoded = decode_from_memory(encoded);
+    ASSERT_NE(decoded.get(), nullptr);
+    EXPECT_EQ(decoded.width(), 5);
+    EXPECT_EQ(decoded.height(), 4);
+    EXPECT_EQ(decoded.channels(), 4);
+    EXPECT_EQ(std::memcmp(decoded.get(), image.get(), image.byte_size()), 0);
+}
+
+TEST(ImageIOTest, EncodeToMemoryHandlesStridedViews) {
+    // Encode the 3x2 centre of a 5x4 gray image, as PNG (native stride) and BMP (packed copy)
+    ImageBuffer image(5, 4, 1);
+    for (size_t i = 0; i < image.byte_size(); i++) {
+        image.get()[i] = static_cast<unsigned char>(i * 10);
+    }
+    ImageView centre = ImageView(image.view()).subview(1, 1, 3, 2);
+
+    for (ImageFormat format : {ImageFormat::PNG, ImageFormat::BMP}) {
+        std::vector<std::byte> encoded;
+        ASSERT_TRUE(encode_to_memory(centre, format, WriteOptions{}, encoded));
+
+        LoadedImage decoded = decode_from_memory(encoded);
+        ASSERT_NE(decoded.get(), nullptr);
+        ASSERT_EQ(decoded.width(), 3);
+        ASSERT_EQ(decoded.height(), 2);
+        for (int y = 0; y < 2; y++) {
+            for (int x = 0; x < 3; x++) {
+                EXPECT_EQ(decoded.get()[(y * 3 + x) * decoded.channels()], *centre.pixel(x, y));
+            }
+        }
+    }
+}
+
+TEST(ImageIOTest, EncodeToMemoryReusesBuffer) {
+    ImageBuffer image(8, 8, 3);
+    for (size_t i = 0; i < image.byte_size(); i++) {
+        image.get()[i] = static_cast<unsigned char>(i);
+    }
+
+    std::vector<std::byte> buffer;
+    ASSERT_TRUE(encode_to_memory(image.view(), ImageFormat::JPG, WriteOptions{80}, buffer));
+    size_t first_size = buffer.size();
+    buffer.reserve(first_size * 2);
+    const std::byte* storage = buffer.data();
+
+    ASSERT_TRUE(encode_to_memory(image.view(), ImageFormat::JPG, WriteOptions{80}, buffer));
+    EXPECT_EQ(buffer.size(), first_size);
+    EXPECT_EQ(buffer.data(), storage);
+}
+
+TEST(ImageIOTest, DecodeFromMemoryRejectsGarbage) {
+    std::byte garbage[16] = {};
+    LoadedImage decoded = decode_from_memory(garbage);
+    EXPECT_EQ(decoded.get(), nullptr);
+
+    EXPECT_TRUE(encode_to_memory(ImageView(), ImageFormat::PNG).empty());
+}
+
+TEST_F(ImageIOIntegrationTest, ProbeImageReadsHeader) {
+    std::vector<unsigned char> pixels(7 * 5 * 4, 200);
+    ASSERT_TRUE(write_image(test_image_png.c_str(), 7, 5, 4, pixels.data()));
+    ASSERT_TRUE(write_image(test_image_jpg.c_str(), 7, 5, 4, pixels.data()));
+
+    ImageInfo info;
+    ASSERT_TRUE(probe_image(test_image_png.c_str(), info));
+    EXPECT_EQ(info.width, 7);
+    EXPECT_EQ(info.height, 5);
+    EXPECT_EQ(info.channels, 4);
+    EXPECT_EQ(info.bits_per_channel, 8);
+    EXPECT_FALSE(info.is_hdr);
+    std::ifstream png(test_image_png, std::ios::binary | std::ios::ate);
+    EXPECT_EQ(info.file_size, static_cast<size_t>(png.tellg()));
+
+    // JPEG drops alpha
+    ASSERT_TRUE(probe_image(test_image_jpg.c_str(), info));
+    EXPECT_EQ(info.width, 7);
+    EXPECT_EQ(info.height, 5);
+    EXPECT_EQ(info.channels, 3);
+}
+
+TEST_F(ImageIOIntegrationTest, ProbeImageRejectsMissingAndGarbage) {
+    ImageInfo info;
+    EXPECT_FALSE(probe_image("nonexistent_file_xyz.png", info));
+
+    std::ofstream(test_image_bmp, std::ios::binary) << "not an image at all";
+    EXPECT_FALSE(probe_image(test_image_bmp.c_str(), info));
+    EXPECT_EQ(info.width, 0);
+}
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include "vanity/image_ops.hpp"
 #include "vanity/image_buffer.hpp"
+#include "vanity/thread_pool.hpp"
+#include "../src/lib/ring_compositor.hpp"
 #include <cstring>
+#include <vector>
 
 using namespace vanity;
 
@@ -128,3 +131,236 @@ TEST(ImageOpsTest, AddBorderWithZeroBorder) {
         EXPECT_EQ(dst.get()[i], src[i]);
     }
 }
+
+TEST(ImageOpsTest, AddBorderMatchesReferenceForAllChannelCounts) {
+    const int src_w = 7, src_h = 5, border = 4;
+    const unsigned char color[4] = {10, 20, 30, 40};
+
+    for (int channels = 1; channels <= 4; channels++) {
+        std::vector<unsigned char> src(static_cast<size_t>(src_w) * src_h * channels);
+        for (size_t i = 0; i < src.size(); i++) {
+            src[i] = static_cast<unsigned char>(100 + i % 97);
+        }
+
+        int new_w, new_h;
+        calculate_bordered_dimensions(src_w, src_h, border, new_w, new_h);
+        ImageBuffer dst(new_w, new_h, channels);
+        ASSERT_TRUE(add_border(src.data(), src_w, src_h, channels, dst.get(), border, color));
+
+        for (int y = 0; y < new_h; y++) {
+            for (int x = 0; x < new_w; x++) {
+                bool interior = x >= border && x < border + src_w && y >= border && y < border + src_h;
+                for (int c = 0; c < channels; c++) {
+                    unsigned char expected = interior
+                        ? src[((y - border) * src_w + (x - border)) * channels + c]
+                        : color[c];
+                    ASSERT_EQ(dst.get()[(y * new_w + x) * channels + c], expected)
+                        << "channels=" << channels << " x=" << x << " y=" << y << " c=" << c;
+                }
+            }
+        }
+    }
+}
+
+TEST(ImageOpsTest, AddBordersMatchesNestedAddBorder) {
+    const int src_w = 5, src_h = 3, channels = 3;
+    unsigned char src[src_w * src_h * channels];
+    for (size_t i = 0; i < sizeof(src); i++) {
+        src[i] = static_cast<unsigned char>(i * 7);
+    }
+
+    BorderSpec rings[] = {
+        {2, {0, 0, 0, 255}},
+        {0, {1, 2, 3, 4}},
+        {3, {255, 255, 255, 255}},
+    };
+
+    // Reference: apply each ring with add_border into an intermediate buffer
+    int inner_w, inner_h;
+    calculate_bordered_dimensions(src_w, src_h, 2, inner_w, inner_h);
+    ImageBuffer inner(inner_w, inner_h, channels);
+    ASSERT_TRUE(add_border(src, src_w, src_h, channels, inner.get(), 2, rings[0].color));
+    int ref_w, ref_h;
+    calculate_bordered_dimensions(inner_w, inner_h, 3, ref_w, ref_h);
+    ImageBuffer reference(ref_w, ref_h, channels);
+    ASSERT_TRUE(add_border(inner.get(), inner_w, inner_h, channels, reference.get(), 3, rings[2].color));
+
+    int new_w, new_h;
+    calculate_bordered_dimensions(src_w, src_h, rings, new_w, new_h);
+    EXPECT_EQ(new_w, ref_w);
+    EXPECT_EQ(new_h, ref_h);
+
+    ImageBuffer dst(new_w, new_h, channels);
+    ASSERT_TRUE(add_borders(src, src_w, src_h, channels, dst.get(), rings));
+    EXPECT_EQ(std::memcmp(dst.get(), reference.get(), dst.byte_size()), 0);
+}
+
+TEST(ImageOpsTest, AddBordersRejectsNegativeRing) {
+    unsigned char src[1] = {0};
+    unsigned char dst[9] = {0};
+    BorderSpec rings[] = {{1, {0, 0, 0, 0}}, {-1, {0, 0, 0, 0}}};
+    EXPECT_FALSE(add_borders(src, 1, 1, 1, dst, rings));
+}
+
+TEST(ImageOpsTest, AddBordersWithNoRingsCopiesImage) {
+    unsigned char src[4] = {1, 2, 3, 4};
+    unsigned char dst[4] = {0};
+    EXPECT_TRUE(add_borders(src, 2, 2, 1, dst, {}));
+    EXPECT_EQ(std::memcmp(src, dst, 4), 0);
+}
+
+TEST(ImageOpsTest, PaintBordersLeavesInteriorUntouched) {
+    const int src_w = 3, src_h = 2, channels = 4;
+    unsigned char src[src_w * src_h * channels];
+    for (size_t i = 0; i < sizeof(src); i++) {
+        src[i] = static_cast<unsigned char>(i + 1);
+    }
+    BorderSpec rings[] = {{1, {0, 0, 0, 255}}, {2, {200, 150, 100, 50}}};
+
+    int new_w, new_h;
+    calculate_bordered_dimensions(src_w, src_h, rings, new_w, new_h);
+    ImageBuffer expected(new_w, new_h, channels);
+    ASSERT_TRUE(add_borders(src, src_w, src_h, channels, expected.get(), rings));
+
+    // Place the source in the interior by hand, then paint around it
+    ImageBuffer padded(new_w, new_h, channels);
+    std::memset(padded.get(), 0xAB, padded.byte_size());
+    for (int y = 0; y < src_h; y++) {
+        std::memcpy(padded.get() + ((y + 3) * new_w + 3) * channels, src + y * src_w * channels, src_w * channels);
+    }
+    ASSERT_TRUE(paint_borders(padded.get(), new_w, new_h, channels, rings));
+    EXPECT_EQ(std::memcmp(padded.get(), expected.get(), padded.byte_size()), 0);
+}
+
+TEST(ImageOpsTest, PaintBordersRejectsRingsLargerThanImage) {
+    unsigned char image[4 * 4] = {0};
+    BorderSpec rings[] = {{2, {0, 0, 0, 0}}};
+    EXPECT_FALSE(paint_borders(image, 4, 4, 1, rings));
+}
+
+TEST(ImageOpsTest, ParallelAddBordersMatchesSerial) {
+    const int src_w = 131, src_h = 257, channels = 3;
+    ImageBuffer src(src_w, src_h, channels);
+    for (size_t i = 0; i < src.byte_size(); i++) {
+        src.get()[i] = static_cast<unsigned char>(i * 13);
+    }
+    BorderSpec rings[] = {{10, {0, 0, 0, 255}}, {37, {255, 255, 255, 255}}};
+
+    int new_w, new_h;
+    calculate_bordered_dimensions(src_w, src_h, rings, new_w, new_h);
+    ImageBuffer serial(new_w, new_h, channels);
+    ImageBuffer parallel(new_w, new_h, channels);
+    ASSERT_TRUE(add_borders(src.view(), serial.view(), rings));
+
+    ThreadPool pool(4);
+    ExecutionOptions exec;
+    exec.pool = &pool;
+    exec.parallel_threshold = 0;
+    ASSERT_TRUE(add_borders(src.view(), parallel.view(), rings, exec));
+    EXPECT_EQ(std::memcmp(serial.get(), parallel.get(), serial.byte_size()), 0);
+
+    // Painting in place over the same interior must reproduce the result
+    std::memset(parallel.get(), 0, parallel.byte_size());
+    for (int y = 0; y < src_h; y++) {
+        std::memcpy(parallel.view().pixel(47, y + 47), src.view().row(y), src.view().row_bytes());
+    }
+    ASSERT_TRUE(paint_borders(parallel.view(), rings, exec));
+    EXPECT_EQ(std::memcmp(serial.get(), parallel.get(), serial.byte_size()), 0);
+}
+
+TEST(ImageOpsTest, ParallelFillBufferFillsEveryPixel) {
+    ImageBuffer buf(97, 301, 4);
+    ThreadPool pool(3);
+    ExecutionOptions exec;
+    exec.pool = &pool;
+    exec.parallel_threshold = 0;
+    const unsigned char color[4] = {9, 8, 7, 6};
+    fill_buffer(buf.view(), color, exec);
+    for (size_t i = 0; i < buf.byte_size(); i++) {
+        ASSERT_EQ(buf.get()[i], color[i % 4]);
+    }
+}
+
+TEST(ImageOpsTest, WideSamplesMatchEightBitBorders) {
+    const int src_w = 37, src_h = 29;
+    BorderSpec rings[] = {{3, {0, 10, 20, 255}}, {70, {255, 128, 1, 40}}};
+    int new_w, new_h;
+    calculate_bordered_dimensions(src_w, src_h, rings, new_w, new_h);
+
+    for (int channels = 1; channels <= 4; channels++) {
+        ImageBuffer src(src_w, src_h, channels);
+        for (size_t i = 0; i < src.byte_size(); i++) {
+            src.get()[i] = static_cast<unsigned char>(i * 29 + 3);
+        }
+        ImageBuffer expected(new_w, new_h, channels);
+        ASSERT_TRUE(add_borders(src.view(), expected.view(), rings));
+
+        ImageBuffer16 src16(src_w, src_h, channels);
+        ImageBufferF srcf(src_w, src_h, channels);
+        size_t samples = static_cast<size_t>(src_w) * src_h * channels;
+        for (size_t i = 0; i < samples; i++) {
+            src16.get()[i] = static_cast<uint16_t>(src.get()[i] * 257);
+            srcf.get()[i] = src.get()[i] / 255.0f;
+        }
+        ImageBuffer16 dst16(new_w, new_h, channels);
+        ImageBufferF dstf(new_w, new_h, channels);
+        ASSERT_TRUE(add_borders(src16.view(), dst16.view(), rings));
+        ASSERT_TRUE(add_borders(srcf.view(), dstf.view(), rings));
+
+        // Painting in place gives the same result
+        ImageBuffer16 painted(new_w, new_h, channels);
+        for (int y = 0; y < src_h; y++) {
+            std::memcpy(painted.view().pixel(73, y + 73), src16.view().row(y), src16.view().row_bytes());
+        }
+        ASSERT_TRUE(paint_borders(painted.view(), rings));
+        EXPECT_EQ(std::memcmp(painted.get(), dst16.get(), dst16.byte_size()), 0) << channels;
+
+        for (size_t i = 0; i < static_cast<size_t>(new_w) * new_h * channels; i++) {
+            ASSERT_EQ(dst16.get()[i], expected.get()[i] * 257) << channels << "ch sample " << i;
+            ASSERT_EQ(dstf.get()[i], expected.get()[i] / 255.0f) << channels << "ch sample " << i;
+        }
+    }
+}
+
+TEST(ImageOpsTest, WideFillBufferWidensColor) {
+    ImageBuffer16 buf(33, 17, 3);
+    const unsigned char color[4] = {255, 1, 128, 0};
+    fill_buffer(buf.view(), color);
+    for (size_t i = 0; i < 33 * 17 * 3; i++) {
+        ASSERT_EQ(buf.get()[i], color[i % 3] * 257);
+    }
+
+    // Channels beyond RGBA have no color to widen
+    ImageBufferF five(4, 4, 5);
+    BorderSpec ring[] = {{1, {0, 0, 0, 0}}};
+    EXPECT_FALSE(paint_borders(five.view(), ring));
+}
+
+TEST(ImageOpsTest, SpecializedKernelsMatchRuntimeSizeKernel) {
+    const int src_w = 41, src_h = 23;
+    BorderSpec rings[] = {{2, {9, 200, 31, 77}}, {65, {255, 0, 128, 3}}, {1, {1, 2, 3, 4}}};
+    int new_w, new_h;
+    calculate_bordered_dimensions(src_w, src_h, rings, new_w, new_h);
+
+    // Every pixel size with a specialized kernel: 1-4 bytes (8-bit), 2-8
+    // (16-bit) and 4-16 (float)
+    auto check = [&](auto sample) {
+        using T = decltype(sample);
+        for (int channels = 1; channels <= 4; channels++) {
+            BasicImageBuffer<T> src(src_w, src_h, channels);
+            unsigned char* src_bytes = reinterpret_cast<unsigned char*>(src.get());
+            for (size_t i = 0; i < src.byte_size(); i++) {
+                src_bytes[i] = static_cast<unsigned char>(i * 13 + 5);
+            }
+            BasicImageBuffer<T> specialized(new_w, new_h, channels);
+            BasicImageBuffer<T> generic(new_w, new_h, channels);
+            vanity::detail::compose_rings<T>(src.view(), specialized.view(), rings, 0, new_h, true);
+            vanity::detail::compose_rings<T>(src.view(), generic.view(), rings, 0, new_h, false);
+            EXPECT_EQ(std::memcmp(specialized.get(), generic.get(), generic.byte_size()), 0)
+                << sizeof(T) * channels << " bytes per pixel";
+        }
+    };
+    check(static_cast<unsigned char>(0));
+    check(static_cast<uint16_t>(0));
+    check(0.0f);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "vanity/image_sink.hpp"
+#include "vanity/image_io.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace vanity;
+
+namespace {
+
+std::vector<unsigned char> read_all(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), {});
+}
+
+} // namespace
+
+TEST(ImageSinkTest, MemorySinkAppends) {
+    std::vector<unsigned char> out = {1};
+    MemorySink sink(out);
+    EXPECT_TRUE(sink.write("\x02\x03", 2));
+    EXPECT_TRUE(sink.flush());
+    EXPECT_EQ(out, (std::vector<unsigned char>{1, 2, 3}));
+}
+
+TEST(ImageSinkTest, FileSinkCoalescesSmallAndPassesLargeWrites) {
+    const char* path = "/tmp/test_vanity_sink.bin";
+    std::vector<unsigned char> expected;
+    {
+        FileSink sink(path, 4096);
+        ASSERT_TRUE(sink.ok());
+        for (int i = 0; i < 1000; i++) {
+            unsigned char byte = static_cast<unsigned char>(i);
+            ASSERT_TRUE(sink.write(&byte, 1));
+            expected.push_back(byte);
+        }
+        std::vector<unsigned char> large(10000, 0x5A);
+        ASSERT_TRUE(sink.write(large.data(), large.size()));
+        expected.insert(expected.end(), large.begin(), large.end());
+        EXPECT_TRUE(sink.close());
+    }
+    EXPECT_EQ(read_all(path), expected);
+    std::remove(path);
+}
+
+TEST(ImageSinkTest, FileSinkFailsForUnwritablePath) {
+    FileSink sink("/nonexistent_dir_xyz/out.png");
+    EXPECT_FALSE(sink.ok());
+    EXPECT_FALSE(sink.write("x", 1));
+    EXPECT_FALSE(sink.close());
+}
+
+TEST(ImageSinkTest, FileSinkOnlyReplacesTheFileOnClose) {
+    const char* path = "/tmp/test_vanity_replace.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "old";
+    }
+
+    // Abandoned, as after a failed encode: the old file stays and the
+    // temporary one is gone
+    {
+        FileSink sink(path, 16);
+        ASSERT_TRUE(sink.ok());
+        ASSERT_TRUE(sink.write("partial output", 14));
+        EXPECT_EQ(read_all(path), (std::vector<unsigned char>{'o', 'l', 'd'}));
+    }
+    EXPECT_EQ(read_all(path), (std::vector<unsigned char>{'o', 'l', 'd'}));
+    for (const auto& entry : std::filesystem::directory_iterator("/tmp")) {
+        EXPECT_NE(entry.path().filename().string().rfind("test_vanity_replace.bin.tmp", 0), 0u)
+            << entry.path();
+    }
+
+    {
+        FileSink sink(path, 16);
+        ASSERT_TRUE(sink.write("new", 3));
+        EXPECT_TRUE(sink.close());
+    }
+    EXPECT_EQ(read_all(path), (std::vector<unsigned char>{'n', 'e', 'w'}));
+    std::remove(path);
+}
+
+TEST(ImageSinkTest, FdSinkWritesToPipeWithoutClosingIt) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    {
+        FdSink sink(fds[1], 16);
+        EXPECT_TRUE(sink.write("hello ", 6));
+        EXPECT_TRUE(sink.write("pipe", 4));
+    }
+    EXPECT_EQ(::write(fds[1], "!", 1), 1);
+    close(fds[1]);
+
+    char buf[32] = {0};
+    ssize_t n = read(fds[0], buf, sizeof(buf));
+    close(fds[0]);
+    EXPECT_EQ(std::string(buf, n > 0 ? n : 0), "hello pipe!");
+}
+
+TEST(ImageSinkTest, CallbackSinkStopsAfterFailure) {
+    int calls = 0;
+    CallbackSink sink([&](const void*, size_t) { return ++calls < 2; });
+    EXPECT_TRUE(sink.write("a", 1));
+    EXPECT_FALSE(sink.write("b", 1));
+    EXPECT_FALSE(sink.write("c", 1));
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(ImageSinkTest, WriteImageToSinkMatchesEncodeToMemory) {
+    unsigned char data[3 * 2 * 3];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = static_cast<unsigned char>(i * 9);
+    }
+
+    std::vector<unsigned char> via_callback;
+    CallbackSink sink([&](const void* bytes, size_t size) {
+        auto* p = static_cast<const unsigned char*>(bytes);
+        via_callback.insert(via_callback.end(), p, p + size);
+        return true;
+    });
+    ASSERT_TRUE(write_image(sink, ImageFormat::BMP, 3, 2, 3, data));
+
+    std::vector<std::byte> via_memory = encode_to_memory(ImageView(data, 3, 2, 3), ImageFormat::BMP);
+    ASSERT_EQ(via_callback.size(), via_memory.size());
+    EXPECT_EQ(std::memcmp(via_callback.data(), via_memory.data(), via_memory.size()), 0);
+}
+
+TEST(ImageSinkTest, WriteImageReportsSinkFailure) {
+    unsigned char data[4] = {0};
+    CallbackSink sink([](const void*, size_t) { return false; });
+    EXPECT_FALSE(write_image(sink, ImageFormat::PNG, 2, 2, 1, data));
+}
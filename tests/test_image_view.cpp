@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "vanity/image_view.hpp"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_ops.hpp"
+#include <cstring>
+#include <vector>
+
+using namespace vanity;
+
+TEST(ImageViewTest, PackedConstructorComputesStride) {
+    unsigned char data[4 * 3 * 3] = {0};
+    ImageView view(data, 4, 3, 3);
+    EXPECT_EQ(view.stride(), 12u);
+    EXPECT_EQ(view.row_bytes(), 12u);
+    EXPECT_TRUE(view.is_contiguous());
+    EXPECT_FALSE(view.empty());
+    EXPECT_EQ(view.row(2), data + 24);
+    EXPECT_EQ(view.pixel(1, 2), data + 27);
+}
+
+TEST(ImageViewTest, WideSamplesKeepByteStrides) {
+    uint16_t data[5 * 3 * 2] = {0};
+    MutableImageView16 view(data, 4, 3, 2, 5 * 2 * sizeof(uint16_t));
+    EXPECT_EQ(view.row_bytes(), 16u);
+    EXPECT_FALSE(view.is_contiguous());
+    EXPECT_EQ(view.row(2), data + 20);
+    EXPECT_EQ(view.pixel(1, 2), data + 22);
+    EXPECT_EQ(view.subview(1, 1, 2, 2).row(1), data + 22);
+
+    float pixels[2 * 2 * 4] = {0};
+    ImageViewF packed(pixels, 2, 2, 4);
+    EXPECT_EQ(packed.stride(), 32u);
+    EXPECT_TRUE(packed.is_contiguous());
+}
+
+TEST(ImageViewTest, DefaultViewIsEmpty) {
+    ImageView view;
+    MutableImageView mutable_view;
+    EXPECT_TRUE(view.empty());
+    EXPECT_TRUE(mutable_view.empty());
+}
+
+TEST(ImageViewTest, SubviewSharesStride) {
+    unsigned char data[10 * 8 * 2] = {0};
+    MutableImageView view(data, 10, 8, 2);
+    MutableImageView sub = view.subview(3, 2, 4, 5);
+    EXPECT_EQ(sub.data(), data + (2 * 10 + 3) * 2);
+    EXPECT_EQ(sub.width(), 4);
+    EXPECT_EQ(sub.height(), 5);
+    EXPECT_EQ(sub.stride(), 20u);
+    EXPECT_FALSE(sub.is_contiguous());
+
+    ImageView read_only = sub;
+    EXPECT_EQ(read_only.data(), sub.data());
+    EXPECT_EQ(read_only.stride(), sub.stride());
+}
+
+TEST(ImageViewTest, BuffersExposeViews) {
+    ImageBuffer buf(6, 4, 3);
+    MutableImageView view = buf.view();
+    EXPECT_EQ(view.data(), buf.get());
+    EXPECT_EQ(view.width(), 6);
+    EXPECT_EQ(view.height(), 4);
+    EXPECT_EQ(view.channels(), 3);
+    EXPECT_EQ(view.stride(), 18u);
+
+    LoadedImage img(nullptr, 0, 0, 0);
+    EXPECT_TRUE(img.view().empty());
+}
+
+TEST(ImageViewTest, FillBufferRespectsStride) {
+    std::vector<unsigned char> data(8 * 6 * 3, 0);
+    MutableImageView whole(data.data(), 8, 6, 3);
+    const unsigned char color[4] = {1, 2, 3, 4};
+    fill_buffer(whole.subview(2, 1, 3, 4), color);
+
+    for (int y = 0; y < 6; y++) {
+        for (int x = 0; x < 8; x++) {
+            bool inside = x >= 2 && x < 5 && y >= 1 && y < 5;
+            for (int c = 0; c < 3; c++) {
+                EXPECT_EQ(whole.pixel(x, y)[c], inside ? color[c] : 0);
+            }
+        }
+    }
+}
+
+TEST(ImageViewTest, AddBorderFromSubviewIntoSubview) {
+    // Source is the centre 2x2 of a 4x4 gray image
+    unsigned char src_data[16];
+    for (int i = 0; i < 16; i++) {
+        src_data[i] = static_cast<unsigned char>(i);
+    }
+    ImageView src = ImageView(src_data, 4, 4, 1).subview(1, 1, 2, 2);
+
+    // Destination is a 4x4 window inside a 6x6 canvas
+    std::vector<unsigned char> canvas(36, 99);
+    MutableImageView dst = MutableImageView(canvas.data(), 6, 6, 1).subview(1, 1, 4, 4);
+
+    const unsigned char color[4] = {7, 7, 7, 7};
+    ASSERT_TRUE(add_border(src, dst, 1, color));
+
+    const unsigned char expected[36] = {
+        99, 99, 99, 99, 99, 99,
+        99,  7,  7,  7,  7, 99,
+        99,  7,  5,  6,  7, 99,
+        99,  7,  9, 10,  7, 99,
+        99,  7,  7,  7,  7, 99,
+        99, 99, 99, 99, 99, 99,
+    };
+    EXPECT_EQ(std::memcmp(canvas.data(), expected, 36), 0);
+}
+
+TEST(ImageViewTest, AddBordersRejectsMismatchedViews) {
+    unsigned char src[4] = {0};
+    unsigned char dst[64] = {0};
+    BorderSpec rings[] = {{1, {0, 0, 0, 0}}};
+    EXPECT_FALSE(add_borders(ImageView(src, 2, 2, 1), MutableImageView(dst, 5, 4, 1), rings));
+    EXPECT_FALSE(add_borders(ImageView(src, 2, 2, 1), MutableImageView(dst, 4, 4, 2), rings));
+    EXPECT_TRUE(add_borders(ImageView(src, 2, 2, 1), MutableImageView(dst, 4, 4, 1), rings));
+}
@@ -0,0 +1,43 @@
+#ifndef VANITY_TEST_IMAGES_HPP
+#define VANITY_TEST_IMAGES_HPP
+
+#include "vanity/image_io.hpp"
+#include "vanity/image_view.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// Synthetic images shared by the codec tests
+namespace vanity::test {
+
+// Smooth gradients with mild noise, the content JPEG is meant for and a
+// realistic load for PNG's filters; the noise comes from a fixed seed, so
+// every call gives the same pixels
+inline std::vector<unsigned char> photo_like(int width, int height, int channels) {
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * channels);
+    std::mt19937 rng(5);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            for (int c = 0; c < channels; c++) {
+                double value = 128 + 80 * std::sin((x * (c + 1) + y * 2) / 40.0) + static_cast<int>(rng() % 5);
+                pixels[(static_cast<size_t>(y) * width + x) * channels + c] =
+                    static_cast<unsigned char>(std::clamp(value, 0.0, 255.0));
+            }
+        }
+    }
+    return pixels;
+}
+
+// photo_like pixels encoded as a JPEG by the in-tree encoder
+inline std::vector<std::byte> make_jpeg(int width, int height, int channels, int quality) {
+    std::vector<unsigned char> pixels = photo_like(width, height, channels);
+    WriteOptions options;
+    options.quality = quality;
+    return encode_to_memory(ImageView(pixels.data(), width, height, channels), ImageFormat::JPG, options);
+}
+
+} // namespace vanity::test
+
+#endif // VANITY_TEST_IMAGES_HPP
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "../src/lib/jpeg_reader.hpp"
+#include "../src/lib/jpeg_writer.hpp"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/image_sink.hpp"
+#include "vanity/thread_pool.hpp"
+#include "test_images.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace vanity;
+using vanity::test::make_jpeg;
+using vanity::test::photo_like;
+
+namespace {
+
+std::vector<std::byte> border_jpeg(const std::vector<std::byte>& jpeg, const std::vector<BorderSpec>& rings,
+                                   const ExecutionOptions& exec = {}) {
+    std::vector<unsigned char> out;
+    MemorySink sink(out);
+    if (!add_borders_jpeg(jpeg, rings, sink, exec)) {
+        return {};
+    }
+    const auto* bytes = reinterpret_cast<const std::byte*>(out.data());
+    return std::vector<std::byte>(bytes, bytes + out.size());
+}
+
+const unsigned char* pixel(const LoadedImage& image, int x, int y) {
+    return image.get() + (static_cast<size_t>(y) * image.width() + x) * image.channels();
+}
+
+} // namespace
+
+TEST(JpegBorderTest, CoefficientsRoundTripUnchanged) {
+    for (int channels : {1, 3}) {
+        for (int quality : {95, 75}) {
+            std::vector<std::byte> jpeg = make_jpeg(80, 48, channels, quality);
+            const auto* data = reinterpret_cast<const unsigned char*>(jpeg.data());
+            detail::JpegHeader header;
+            std::string error;
+            ASSERT_TRUE(detail::jpeg_read_header(data, jpeg.size(), header, error)) << error;
+
+            detail::JpegCoefficientFrame frame;
+            frame.width = header.width;
+            frame.height = header.height;
+            frame.components = header.components;
+            std::copy(&header.quant[0][0], &header.quant[0][0] + 4 * 64, &frame.quant[0][0]);
+            std::vector<std::vector<int16_t>> storage;
+            for (const detail::JpegComponent& c : header.components) {
+                size_t stride = static_cast<size_t>(header.mcus_x) * c.h;
+                storage.emplace_back(stride * header.mcus_y * c.v * 64);
+                frame.planes.push_back(detail::JpegCoefficientPlane{storage.back().data(), stride});
+            }
+            ASSERT_TRUE(detail::jpeg_decode_coefficients(data, jpeg.size(), header, frame.planes, error)) << error;
+
+            std::vector<unsigned char> reencoded;
+            MemorySink sink(reencoded);
+            ASSERT_TRUE(detail::jpeg_encode_coefficients(frame, sink, {}));
+            const auto* bytes = reinterpret_cast<const std::byte*>(reencoded.data());
+            EXPECT_EQ(std::vector<std::byte>(bytes, bytes + reencoded.size()), jpeg)
+                << channels << "ch quality " << quality;
+        }
+    }
+}
+
+TEST(JpegBorderTest, InteriorIsLossless) {
+    // Quality 95 is 4:4:4, so decoded pixels depend on their own block only
+    const int width = 64, height = 40;
+    std::vector<std::byte> jpeg = make_jpeg(width, height, 3, 95);
+    JpegBlockLayout layout;
+    ASSERT_TRUE(probe_jpeg_blocks(jpeg, layout));
+    EXPECT_EQ(layout.width, width);
+    EXPECT_EQ(layout.channels, 3);
+    EXPECT_EQ(layout.mcu_width, 8);
+    EXPECT_EQ(layout.mcu_height, 8);
+
+    // The rings meet inside a block, which then goes through the forward DCT
+    std::vector<BorderSpec> rings = {{5, {0, 0, 0, 255}}, {11, {255, 255, 255, 255}}};
+    std::vector<std::byte> bordered = border_jpeg(jpeg, rings);
+    ASSERT_FALSE(bordered.empty());
+
+    LoadedImage original = decode_from_memory(jpeg);
+    LoadedImage result = decode_from_memory(bordered);
+    ASSERT_NE(result.get(), nullptr);
+    ASSERT_EQ(result.width(), width + 32);
+    ASSERT_EQ(result.height(), height + 32);
+    for (int y = 0; y < height; y++) {
+        ASSERT_EQ(std::memcmp(pixel(result, 16, y + 16), pixel(original, 0, y), width * 3), 0) << "row " << y;
+    }
+
+    // Well inside each ring the colour is flat
+    for (int c = 0; c < 3; c++) {
+        EXPECT_GE(pixel(result, 2, 2)[c], 252);
+        EXPECT_GE(pixel(result, result.width() - 3, result.height() / 2)[c], 252);
+        EXPECT_LE(pixel(result, 14, result.height() / 2)[c], 3);
+    }
+}
+
+TEST(JpegBorderTest, SubsampledAndGrayscale) {
+    for (int channels : {1, 3}) {
+        const int width = 96, height = 64;
+        std::vector<std::byte> jpeg = make_jpeg(width, height, channels, 75);
+        JpegBlockLayout layout;
+        ASSERT_TRUE(probe_jpeg_blocks(jpeg, layout));
+        EXPECT_EQ(layout.mcu_width, channels == 1 ? 8 : 16);
+
+        std::vector<std::byte> bordered = border_jpeg(jpeg, {{32, {255, 255, 255, 255}}});
+        ASSERT_FALSE(bordered.empty());
+        LoadedImage original = decode_from_memory(jpeg);
+        LoadedImage result = decode_from_memory(bordered);
+        ASSERT_NE(result.get(), nullptr);
+        ASSERT_EQ(result.width(), width + 64);
+        ASSERT_EQ(result.channels(), channels);
+
+        // Chroma upsampling blends across the interior edge, so compare on average
+        double sum = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width * channels; x++) {
+                sum += std::abs(pixel(result, 32, y + 32)[x] - pixel(original, 0, y)[x]);
+            }
+        }
+        EXPECT_LT(sum / (width * height * channels), 1.0) << channels << "ch";
+        EXPECT_GE(pixel(result, 5, 5)[0], 252);
+    }
+}
+
+TEST(JpegBorderTest, RejectsUnalignedInputs) {
+    // Dimensions that are not whole MCUs would expose the encoder's padding
+    JpegBlockLayout layout;
+    std::vector<std::byte> ragged = make_jpeg(37, 29, 3, 95);
+    EXPECT_FALSE(probe_jpeg_blocks(ragged, layout));
+    EXPECT_TRUE(border_jpeg(ragged, {{8, {255, 255, 255, 255}}}).empty());
+
+    // Borders must keep the interior on the block grid
+    std::vector<std::byte> jpeg = make_jpeg(64, 64, 3, 75);
+    EXPECT_TRUE(border_jpeg(jpeg, {{8, {255, 255, 255, 255}}}).empty());
+    EXPECT_FALSE(border_jpeg(jpeg, {{16, {255, 255, 255, 255}}}).empty());
+
+    std::vector<std::byte> garbage(100, std::byte{0x42});
+    EXPECT_FALSE(probe_jpeg_blocks(garbage, layout));
+}
+
+TEST(JpegBorderTest, RejectsCoefficientsBeyondBaselineTables) {
+    // 8x8 grayscale coded with its own Huffman tables: DC difference 0, then
+    // an AC of 1500 (category 11, which the Annex K tables cannot code) and
+    // an end of block
+    std::vector<unsigned char> bytes = {0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00};
+    bytes.insert(bytes.end(), 64, 1);   // quantizer 1 throughout
+    bytes.insert(bytes.end(), {
+        0xFF, 0xC0, 0x00, 0x0B, 8, 0x00, 0x08, 0x00, 0x08, 1, 1, 0x11, 0,
+        0xFF, 0xC4, 0x00, 0x14, 0x00, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x00,
+        0xFF, 0xC4, 0x00, 0x15, 0x10, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x0B, 0x00,
+        0xFF, 0xDA, 0x00, 0x08, 1, 1, 0x00, 0, 63, 0,
+        0x2E, 0xE5,   // 0 | 0 10111011100 | 10, padded with ones
+        0xFF, 0xD9,
+    });
+    std::vector<std::byte> jpeg(bytes.size());
+    std::memcpy(jpeg.data(), bytes.data(), bytes.size());
+    JpegBlockLayout layout;
+    ASSERT_TRUE(probe_jpeg_blocks(jpeg, layout));
+    EXPECT_NE(decode_from_memory(jpeg).get(), nullptr);
+
+    // Rejected before anything reaches the sink, so callers can fall back
+    // to decoding and re-encoding
+    std::vector<BorderSpec> rings = {{8, {255, 255, 255, 255}}};
+    std::vector<unsigned char> out;
+    MemorySink sink(out);
+    EXPECT_FALSE(add_borders_jpeg(jpeg, rings, sink));
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(JpegBorderTest, ParallelMatchesSingleThreaded) {
+    ThreadPool pool(4);
+    ExecutionOptions exec;
+    exec.pool = &pool;
+    exec.parallel_threshold = 0;
+    std::vector<std::byte> jpeg = make_jpeg(1024, 768, 3, 80);
+    std::vector<BorderSpec> rings = {{10, {0, 0, 0, 255}}, {54, {255, 255, 255, 255}}};
+    std::vector<std::byte> serial = border_jpeg(jpeg, rings);
+    ASSERT_FALSE(serial.empty());
+    EXPECT_EQ(border_jpeg(jpeg, rings, exec), serial);
+}
@@ -0,0 +1,495 @@
+#include <gtest/gtest.h>
+#include "../src/lib/dct.hpp"
+#include "../src/lib/jpeg_common.hpp"
+#include "../src/lib/jpeg_reader.hpp"
+#include "stb_image.h"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/thread_pool.hpp"
+#include "test_images.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace vanity;
+using vanity::test::make_jpeg;
+using vanity::test::photo_like;
+
+namespace {
+
+LoadedImage decode(const std::vector<std::byte>& jpeg, int scale_denom = 1, ThreadPool* pool = nullptr) {
+    DecodeOptions options;
+    options.scale_denom = scale_denom;
+    options.exec.pool = pool;
+    options.exec.parallel_threshold = 0;
+    return decode_from_memory(jpeg, options);
+}
+
+// Mean and largest absolute difference from stb_image's decode
+void compare_with_stb(const std::vector<std::byte>& jpeg, const LoadedImage& ours, double& mean, int& max) {
+    int width, height, channels;
+    unsigned char* reference = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(jpeg.data()),
+                                                     static_cast<int>(jpeg.size()), &width, &height, &channels, 0);
+    ASSERT_NE(reference, nullptr);
+    ASSERT_EQ(ours.width(), width);
+    ASSERT_EQ(ours.height(), height);
+    ASSERT_EQ(ours.channels(), channels);
+    size_t count = static_cast<size_t>(width) * height * channels;
+    double sum = 0;
+    max = 0;
+    for (size_t i = 0; i < count; i++) {
+        int diff = std::abs(ours.get()[i] - reference[i]);
+        sum += diff;
+        max = std::max(max, diff);
+    }
+    mean = sum / count;
+    stbi_image_free(reference);
+}
+
+// Minimal progressive encoder for the coefficients of a baseline JPEG:
+// an interleaved DC scan at half precision, its refinement scan, then two
+// spectral bands per component, all with the Annex K luminance tables
+class ProgressiveWriter {
+public:
+    std::vector<std::byte> write(const detail::JpegHeader& header,
+                                 const std::vector<detail::JpegCoefficientPlane>& planes) {
+        marker(0xd8);
+        for (int t = 0; t < 4; t++) {
+            if (header.has_quant[t]) {
+                segment(0xdb, 65);
+                byte(t);
+                for (int k = 0; k < 64; k++) {
+                    byte(header.quant[t][detail::kJpegZigzag[k]]);
+                }
+            }
+        }
+        segment(0xc2, 6 + 3 * header.components.size());
+        byte(8);
+        word(header.height);
+        word(header.width);
+        byte(header.components.size());
+        for (const detail::JpegComponent& c : header.components) {
+            byte(c.id);
+            byte(c.h << 4 | c.v);
+            byte(c.quant_table);
+        }
+        huffman_table(0x00, detail::kJpegDcLuminance, dc_codes_);
+        huffman_table(0x10, detail::kJpegAcLuminance, ac_codes_);
+
+        // DC first (Al = 1) and refinement, interleaved in MCU order
+        for (int refine = 0; refine < 2; refine++) {
+            scan_header(header, {}, 0, 0, refine, refine ? 0 : 1);
+            std::vector<int> predictors(header.components.size());
+            for (int my = 0; my < header.mcus_y; my++) {
+                for (int mx = 0; mx < header.mcus_x; mx++) {
+                    for (size_t i = 0; i < header.components.size(); i++) {
+                        const detail::JpegComponent& c = header.components[i];
+                        for (int v = 0; v < c.v; v++) {
+                            for (int h = 0; h < c.h; h++) {
+                                int dc = planes[i].block(mx * c.h + h, my * c.v + v)[0];
+                                if (refine) {
+                                    bits(dc & 1, 1);
+                                } else {
+                                    int value = dc >> 1;
+                                    encode_value(dc_codes_, 0, value - predictors[i]);
+                                    predictors[i] = value;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            flush();
+        }
+
+        // AC bands, one component per scan over the blocks its samples cover
+        for (size_t i = 0; i < header.components.size(); i++) {
+            const detail::JpegComponent& c = header.components[i];
+            for (auto [first, last] : {std::pair{1, 5}, std::pair{6, 63}}) {
+                scan_header(header, {i}, first, last, 0, 0);
+                for (int by = 0; by < c.blocks_y; by++) {
+                    for (int bx = 0; bx < c.blocks_x; bx++) {
+                        const int16_t* block = planes[i].block(bx, by);
+                        int run = 0;
+                        for (int k = first; k <= last; k++) {
+                            int value = block[detail::kJpegZigzag[k]];
+                            if (value == 0) {
+                                run++;
+                                continue;
+                            }
+                            for (; run >= 16; run -= 16) {
+                                code(ac_codes_[0xf0]);
+                            }
+                            encode_value(ac_codes_, run << 4, value);
+                            run = 0;
+                        }
+                        if (run > 0) {
+                            code(ac_codes_[0x00]);
+                        }
+                    }
+                }
+                flush();
+            }
+        }
+        marker(0xd9);
+        return out_;
+    }
+
+private:
+    struct Code {
+        uint16_t bits = 0;
+        int length = 0;
+    };
+
+    void byte(int value) { out_.push_back(static_cast<std::byte>(value)); }
+    void word(int value) {
+        byte(value >> 8);
+        byte(value & 0xff);
+    }
+    void marker(int type) {
+        byte(0xff);
+        byte(type);
+    }
+    void segment(int type, size_t payload) {
+        marker(type);
+        word(static_cast<int>(payload) + 2);
+    }
+
+    void huffman_table(int id, const detail::JpegHuffmanSpec& spec, Code* codes) {
+        segment(0xc4, 17 + spec.symbol_count);
+        byte(id);
+        for (int count : spec.counts) {
+            byte(count);
+        }
+        int code = 0, k = 0;
+        for (int length = 1; length <= 16; length++) {
+            for (int n = 0; n < spec.counts[length - 1]; n++, k++) {
+                byte(spec.symbols[k]);
+                codes[spec.symbols[k]] = Code{static_cast<uint16_t>(code++), length};
+            }
+            code <<= 1;
+        }
+    }
+
+    // Scan of the given components (all of them when empty)
+    void scan_header(const detail::JpegHeader& header, std::vector<size_t> components, int first, int last,
+                     int ah, int al) {
+        if (components.empty()) {
+            for (size_t i = 0; i < header.components.size(); i++) {
+                components.push_back(i);
+            }
+        }
+        segment(0xda, 4 + 2 * components.size());
+        byte(components.size());
+        for (size_t i : components) {
+            byte(header.components[i].id);
+            byte(0x00);
+        }
+        byte(first);
+        byte(last);
+        byte(ah << 4 | al);
+    }
+
+    void bits(int value, int count) {
+        for (int b = count - 1; b >= 0; b--) {
+            accumulator_ = accumulator_ << 1 | ((value >> b) & 1);
+            if (++filled_ == 8) {
+                byte(accumulator_);
+                if (accumulator_ == 0xff) {
+                    byte(0x00);
+                }
+                accumulator_ = 0;
+                filled_ = 0;
+            }
+        }
+    }
+    void code(const Code& c) { bits(c.bits, c.length); }
+    void flush() {
+        while (filled_ != 0) {
+            bits(1, 1);
+        }
+    }
+
+    // Magnitude category symbol (combined with a run for AC) then the value bits
+    void encode_value(const Code* codes, int symbol, int value) {
+        int magnitude = std::abs(value);
+        int size = 0;
+        while (magnitude >> size) {
+            size++;
+        }
+        code(codes[symbol | size]);
+        bits(value < 0 ? value - 1 : value, size);
+    }
+
+    std::vector<std::byte> out_;
+    Code dc_codes_[256];
+    Code ac_codes_[256];
+    int accumulator_ = 0;
+    int filled_ = 0;
+};
+
+} // namespace
+
+TEST(JpegReaderTest, InverseKernelsMatchReference) {
+    uint8_t table[64];
+    detail::jpeg_quant_table(false, 75, table);
+    uint16_t quant[64];
+    std::copy(table, table + 64, quant);
+    float scales[64];
+    detail::inverse_dct_scales(quant, scales);
+
+    std::mt19937 rng(3);
+    int16_t coefficients[64];
+    for (int i = 0; i < 64; i++) {
+        coefficients[i] = static_cast<int16_t>(i == 0 ? static_cast<int>(rng() % 100) - 50
+                                                      : static_cast<int>(rng() % 7) - 3);
+    }
+
+    // Direct evaluation of the 2-D inverse DCT with JPEG's normalisation
+    int reference[64];
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            double sum = 0;
+            for (int v = 0; v < 8; v++) {
+                for (int u = 0; u < 8; u++) {
+                    double cu = u == 0 ? std::sqrt(0.5) : 1.0;
+                    double cv = v == 0 ? std::sqrt(0.5) : 1.0;
+                    sum += cu * cv * coefficients[v * 8 + u] * quant[v * 8 + u] *
+                           std::cos((2 * x + 1) * u * M_PI / 16) * std::cos((2 * y + 1) * v * M_PI / 16);
+                }
+            }
+            reference[y * 8 + x] = static_cast<int>(std::clamp(std::lround(0.25 * sum + 128), 0L, 255L));
+        }
+    }
+
+    std::vector<uint8_t> first;
+    for (const detail::DctKernels* kernels : detail::available_dct_kernels()) {
+        uint8_t out[8 * 12];
+        kernels->inverse_dequantize(coefficients, scales, out, 12);
+        std::vector<uint8_t> block;
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < 8; x++) {
+                EXPECT_LE(std::abs(out[y * 12 + x] - reference[y * 8 + x]), 1) << kernels->name;
+                block.push_back(out[y * 12 + x]);
+            }
+        }
+        if (first.empty()) {
+            first = block;
+        } else {
+            EXPECT_EQ(block, first) << kernels->name;
+        }
+    }
+}
+
+TEST(JpegReaderTest, ColorKernelsAgree) {
+    const size_t count = 301;
+    std::vector<uint8_t> y(count), cb(count), cr(count);
+    std::mt19937 rng(4);
+    for (size_t i = 0; i < count; i++) {
+        y[i] = static_cast<uint8_t>(rng());
+        cb[i] = static_cast<uint8_t>(rng());
+        cr[i] = static_cast<uint8_t>(rng());
+    }
+    std::vector<uint8_t> first;
+    for (const detail::DctKernels* kernels : detail::available_dct_kernels()) {
+        std::vector<uint8_t> rgb(count * 3);
+        kernels->ycc_to_rgb(y.data(), cb.data(), cr.data(), rgb.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            double red = y[i] + 1.402 * (cr[i] - 128);
+            EXPECT_LE(std::abs(rgb[i * 3] - std::clamp(red, 0.0, 255.0)), 0.51) << kernels->name;
+        }
+        if (first.empty()) {
+            first = rgb;
+        } else {
+            EXPECT_EQ(rgb, first) << kernels->name;
+        }
+    }
+}
+
+TEST(JpegReaderTest, MatchesStbDecode) {
+    // Gray, 4:4:4 and 4:2:0, at sizes that are not whole MCUs
+    for (int channels : {1, 3}) {
+        for (int quality : {95, 75}) {
+            for (auto [width, height] : {std::pair{37, 29}, std::pair{64, 48}}) {
+                std::vector<std::byte> jpeg = make_jpeg(width, height, channels, quality);
+                LoadedImage ours = decode(jpeg);
+                ASSERT_NE(ours.get(), nullptr);
+                double mean;
+                int max;
+                compare_with_stb(jpeg, ours, mean, max);
+                EXPECT_LT(mean, 0.2) << channels << "ch quality " << quality << " " << width << "x" << height;
+                EXPECT_LE(max, 4) << channels << "ch quality " << quality << " " << width << "x" << height;
+            }
+        }
+    }
+}
+
+TEST(JpegReaderTest, RestartIntervalsDecode) {
+    // Large enough for the encoder to cut restart stripes
+    std::vector<std::byte> jpeg = make_jpeg(1000, 700, 3, 80);
+    LoadedImage ours = decode(jpeg);
+    ASSERT_NE(ours.get(), nullptr);
+    double mean;
+    int max;
+    compare_with_stb(jpeg, ours, mean, max);
+    EXPECT_LT(mean, 0.2);
+}
+
+TEST(JpegReaderTest, RestartSegmentsDecodeInParallel) {
+    ThreadPool pool(4);
+    for (int channels : {1, 3}) {
+        std::vector<std::byte> jpeg = make_jpeg(1000, 700, channels, 80);
+        const auto* data = reinterpret_cast<const unsigned char*>(jpeg.data());
+        detail::JpegHeader header;
+        std::string error;
+        ASSERT_TRUE(detail::jpeg_read_header(data, jpeg.size(), header, error)) << error;
+        ASSERT_GT(header.restart_interval, 0);
+
+        // Coefficients decoded a segment per task match the serial decode
+        std::vector<std::vector<int16_t>> serial, parallel;
+        for (auto* storage : {&serial, &parallel}) {
+            std::vector<detail::JpegCoefficientPlane> planes;
+            for (const detail::JpegComponent& c : header.components) {
+                size_t stride = static_cast<size_t>(header.mcus_x) * c.h;
+                storage->emplace_back(stride * header.mcus_y * c.v * 64);
+                planes.push_back(detail::JpegCoefficientPlane{storage->back().data(), stride});
+            }
+            ExecutionOptions exec;
+            exec.pool = storage == &parallel ? &pool : nullptr;
+            exec.parallel_threshold = 0;
+            ASSERT_TRUE(detail::jpeg_decode_coefficients(data, jpeg.size(), header, planes, error, exec)) << error;
+        }
+        EXPECT_EQ(parallel, serial) << channels << "ch";
+
+        LoadedImage expected = decode(jpeg);
+        LoadedImage result = decode(jpeg, 1, &pool);
+        ASSERT_NE(result.get(), nullptr);
+        size_t bytes = static_cast<size_t>(result.width()) * result.height() * result.channels();
+        EXPECT_TRUE(std::equal(result.get(), result.get() + bytes, expected.get())) << channels << "ch";
+
+        // A segment whose entropy data is corrupt fails the whole decode
+        std::vector<std::byte> corrupt = jpeg;
+        size_t marker = 0;
+        for (size_t i = jpeg.size() / 2; i + 1 < jpeg.size(); i++) {
+            if (jpeg[i] == std::byte{0xff} && (static_cast<int>(jpeg[i + 1]) & 0xf8) == 0xd0) {
+                marker = i;
+                break;
+            }
+        }
+        ASSERT_NE(marker, 0u);
+        std::fill(corrupt.begin() + marker + 2, corrupt.begin() + marker + 40, std::byte{0xfe});
+        EXPECT_EQ(decode(corrupt, 1, &pool).get(), nullptr) << channels << "ch";
+    }
+}
+
+TEST(JpegReaderTest, ScaledDecodeApproximatesBoxFilter) {
+    const int width = 203, height = 117;
+    // 4:4:4, so every output pixel comes from the blocks it lies in
+    std::vector<std::byte> jpeg = make_jpeg(width, height, 3, 95);
+    LoadedImage full = decode(jpeg);
+    ASSERT_NE(full.get(), nullptr);
+    for (int scale : {2, 4, 8}) {
+        LoadedImage small = decode(jpeg, scale);
+        ASSERT_NE(small.get(), nullptr) << scale;
+        ASSERT_EQ(small.width(), (width + scale - 1) / scale);
+        ASSERT_EQ(small.height(), (height + scale - 1) / scale);
+        double sum = 0;
+        for (int y = 0; y < small.height(); y++) {
+            for (int x = 0; x < small.width(); x++) {
+                for (int c = 0; c < 3; c++) {
+                    double box = 0;
+                    int count = 0;
+                    for (int dy = 0; dy < scale && y * scale + dy < height; dy++) {
+                        for (int dx = 0; dx < scale && x * scale + dx < width; dx++) {
+                            box += full.get()[((static_cast<size_t>(y) * scale + dy) * width + x * scale + dx) * 3 + c];
+                            count++;
+                        }
+                    }
+                    sum += std::abs(box / count - small.get()[(static_cast<size_t>(y) * small.width() + x) * 3 + c]);
+                }
+            }
+        }
+        EXPECT_LT(sum / (small.width() * small.height() * 3), 3.0) << "1/" << scale;
+    }
+
+    LoadedImage invalid = decode(jpeg, 3);
+    EXPECT_EQ(invalid.get(), nullptr);
+}
+
+TEST(JpegReaderTest, ParallelMatchesSingleThreaded) {
+    ThreadPool pool(4);
+    std::vector<std::byte> jpeg = make_jpeg(640, 480, 3, 85);
+    for (int scale : {1, 2}) {
+        LoadedImage serial = decode(jpeg, scale);
+        LoadedImage parallel = decode(jpeg, scale, &pool);
+        ASSERT_NE(serial.get(), nullptr);
+        ASSERT_NE(parallel.get(), nullptr);
+        size_t bytes = static_cast<size_t>(serial.width()) * serial.height() * 3;
+        EXPECT_TRUE(std::equal(serial.get(), serial.get() + bytes, parallel.get())) << scale;
+    }
+}
+
+TEST(JpegReaderTest, ProgressiveMatchesBaseline) {
+    for (int channels : {1, 3}) {
+        std::vector<std::byte> baseline = make_jpeg(85, 51, channels, 75);
+        const auto* data = reinterpret_cast<const unsigned char*>(baseline.data());
+        detail::JpegHeader header;
+        std::string error;
+        ASSERT_TRUE(detail::jpeg_read_header(data, baseline.size(), header, error)) << error;
+        std::vector<std::vector<int16_t>> storage;
+        std::vector<detail::JpegCoefficientPlane> planes;
+        for (const detail::JpegComponent& c : header.components) {
+            size_t stride = static_cast<size_t>(header.mcus_x) * c.h;
+            storage.emplace_back(stride * header.mcus_y * c.v * 64);
+            planes.push_back(detail::JpegCoefficientPlane{storage.back().data(), stride});
+        }
+        ASSERT_TRUE(detail::jpeg_decode_coefficients(data, baseline.size(), header, planes, error)) << error;
+
+        std::vector<std::byte> progressive = ProgressiveWriter().write(header, planes);
+        detail::JpegHeader progressive_header;
+        ASSERT_TRUE(detail::jpeg_read_header(reinterpret_cast<const unsigned char*>(progressive.data()),
+                                             progressive.size(), progressive_header, error)) << error;
+        EXPECT_TRUE(progressive_header.progressive);
+
+        LoadedImage expected = decode(baseline);
+        LoadedImage result = decode(progressive);
+        ASSERT_NE(result.get(), nullptr) << stbi_failure_reason();
+        ASSERT_EQ(result.width(), expected.width());
+        size_t bytes = static_cast<size_t>(result.width()) * result.height() * result.channels();
+        EXPECT_TRUE(std::equal(result.get(), result.get() + bytes, expected.get())) << channels << "ch";
+
+        // stb agrees about the stream itself
+        double mean;
+        int max;
+        compare_with_stb(progressive, result, mean, max);
+        EXPECT_LT(mean, 0.2) << channels << "ch";
+    }
+}
+
+TEST(JpegReaderTest, RejectsOverfullHuffmanTable) {
+    // Length 1 holds two codes; a DHT listing more must be rejected before
+    // its lookup table is filled
+    for (int count : {3, 40, 255}) {
+        std::vector<unsigned char> bytes = {0xff, 0xd8, 0xff, 0xc4};
+        size_t length = 2 + 17 + count;
+        bytes.push_back(static_cast<unsigned char>(length >> 8));
+        bytes.push_back(static_cast<unsigned char>(length));
+        bytes.push_back(0x00);
+        bytes.push_back(static_cast<unsigned char>(count));
+        bytes.insert(bytes.end(), 15, 0);
+        bytes.insert(bytes.end(), count, 0);
+        bytes.insert(bytes.end(), {0xff, 0xd9});
+
+        detail::JpegHeader header;
+        std::string error;
+        EXPECT_FALSE(detail::jpeg_read_header(bytes.data(), bytes.size(), header, error)) << count;
+        EXPECT_EQ(error, "corrupt Huffman table") << count;
+        std::vector<std::byte> jpeg(bytes.size());
+        std::memcpy(jpeg.data(), bytes.data(), bytes.size());
+        EXPECT_EQ(decode_from_memory(jpeg).get(), nullptr) << count;
+    }
+}
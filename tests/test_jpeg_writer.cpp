@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "../src/lib/dct.hpp"
+#include "../src/lib/jpeg_common.hpp"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/thread_pool.hpp"
+#include "test_images.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace vanity;
+using vanity::test::photo_like;
+
+namespace {
+
+// Mean absolute difference between the decoded image and channel c of the source
+double mean_error(const LoadedImage& decoded, const std::vector<unsigned char>& pixels, int channels) {
+    int width = decoded.width(), height = decoded.height();
+    int decoded_channels = decoded.channels();
+    double sum = 0;
+    for (int i = 0; i < width * height; i++) {
+        for (int c = 0; c < decoded_channels; c++) {
+            sum += std::abs(decoded.get()[i * decoded_channels + c] - pixels[i * channels + c]);
+        }
+    }
+    return sum / (static_cast<double>(width) * height * decoded_channels);
+}
+
+size_t count_markers(const std::vector<std::byte>& jpeg, unsigned char first, unsigned char last) {
+    size_t count = 0;
+    for (size_t i = 0; i + 1 < jpeg.size(); i++) {
+        auto marker = static_cast<unsigned char>(jpeg[i + 1]);
+        if (jpeg[i] == std::byte{0xff} && marker >= first && marker <= last) {
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(JpegWriterTest, DctKernelsMatchReference) {
+    uint8_t table[64];
+    detail::jpeg_quant_table(false, 90, table);
+    uint16_t quant[64];
+    std::copy(table, table + 64, quant);
+    float scales[64];
+    detail::forward_dct_scales(quant, scales);
+
+    std::mt19937 rng(9);
+    float block[8 * 10];
+    for (float& sample : block) {
+        sample = static_cast<float>(static_cast<int>(rng() % 256) - 128);
+    }
+
+    // Direct evaluation of the 2-D DCT-II with JPEG's normalisation
+    int reference[64];
+    for (int v = 0; v < 8; v++) {
+        for (int u = 0; u < 8; u++) {
+            double sum = 0;
+            for (int y = 0; y < 8; y++) {
+                for (int x = 0; x < 8; x++) {
+                    sum += block[y * 10 + x] * std::cos((2 * x + 1) * u * M_PI / 16) *
+                           std::cos((2 * y + 1) * v * M_PI / 16);
+                }
+            }
+            double cu = u == 0 ? std::sqrt(0.5) : 1.0;
+            double cv = v == 0 ? std::sqrt(0.5) : 1.0;
+            reference[v * 8 + u] = static_cast<int>(std::lround(0.25 * cu * cv * sum / quant[v * 8 + u]));
+        }
+    }
+
+    std::vector<int16_t> first;
+    for (const detail::DctKernels* kernels : detail::available_dct_kernels()) {
+        int16_t out[64];
+        kernels->forward_quantize(block, 10, scales, out);
+        for (int i = 0; i < 64; i++) {
+            EXPECT_LE(std::abs(out[i] - reference[i]), 1) << kernels->name << " coefficient " << i;
+        }
+        // Every kernel performs the same float operations
+        if (first.empty()) {
+            first.assign(out, out + 64);
+        } else {
+            EXPECT_EQ(std::vector<int16_t>(out, out + 64), first) << kernels->name;
+        }
+    }
+}
+
+TEST(JpegWriterTest, ChannelCountsAndSubsamplingDecode) {
+    const int width = 37, height = 29;     // not a multiple of the MCU size
+    for (int channels = 1; channels <= 4; channels++) {
+        std::vector<unsigned char> pixels = photo_like(width, height, channels);
+        for (int quality : {95, 75}) {
+            WriteOptions options;
+            options.quality = quality;
+            std::vector<std::byte> jpeg =
+                encode_to_memory(ImageView(pixels.data(), width, height, channels), ImageFormat::JPG, options);
+            ASSERT_FALSE(jpeg.empty());
+            LoadedImage decoded = decode_from_memory(jpeg);
+            ASSERT_NE(decoded.get(), nullptr) << channels << "ch quality " << quality;
+            EXPECT_EQ(decoded.width(), width);
+            EXPECT_EQ(decoded.height(), height);
+            EXPECT_EQ(decoded.channels(), channels < 3 ? 1 : 3);
+            EXPECT_LT(mean_error(decoded, pixels, channels), quality == 95 ? 2.0 : 4.0)
+                << channels << "ch quality " << quality;
+        }
+    }
+}
+
+TEST(JpegWriterTest, LargeImagesUseRestartIntervals) {
+    const int width = 1000, height = 700, channels = 3;
+    std::vector<unsigned char> pixels = photo_like(width, height, channels);
+    std::vector<std::byte> jpeg =
+        encode_to_memory(ImageView(pixels.data(), width, height, channels), ImageFormat::JPG);
+    EXPECT_EQ(count_markers(jpeg, 0xdd, 0xdd), 1u);
+    EXPECT_GT(count_markers(jpeg, 0xd0, 0xd7), 1u);
+
+    LoadedImage decoded = decode_from_memory(jpeg);
+    ASSERT_NE(decoded.get(), nullptr);
+    EXPECT_LT(mean_error(decoded, pixels, channels), 2.0);
+}
+
+TEST(JpegWriterTest, ParallelEncodeMatchesSingleThreaded) {
+    ThreadPool pool(4);
+    const int width = 900, height = 650;
+    for (int channels : {1, 3}) {
+        std::vector<unsigned char> pixels = photo_like(width, height, channels);
+        ImageView view(pixels.data(), width, height, channels);
+        for (int quality : {95, 80}) {
+            WriteOptions serial;
+            serial.quality = quality;
+            WriteOptions parallel = serial;
+            parallel.exec.pool = &pool;
+            parallel.exec.parallel_threshold = 0;
+            EXPECT_EQ(encode_to_memory(view, ImageFormat::JPG, parallel),
+                      encode_to_memory(view, ImageFormat::JPG, serial))
+                << channels << "ch quality " << quality;
+        }
+    }
+}
+
+TEST(JpegWriterTest, StridedViewMatchesPacked) {
+    std::vector<unsigned char> wide = photo_like(40, 24, 3);
+    ImageView strided(wide.data() + 7 * 3, 25, 24, 3, 40 * 3);
+    std::vector<unsigned char> packed(25 * 24 * 3);
+    for (int y = 0; y < 24; y++) {
+        std::memcpy(&packed[y * 25 * 3], strided.row(y), 25 * 3);
+    }
+    EXPECT_EQ(encode_to_memory(strided, ImageFormat::JPG),
+              encode_to_memory(ImageView(packed.data(), 25, 24, 3), ImageFormat::JPG));
+}
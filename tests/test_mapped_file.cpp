@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "../src/lib/mapped_file.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace vanity::detail;
+
+TEST(MappedFileTest, MissingFileFails) {
+    MappedFile file = MappedFile::open("nonexistent_file_xyz.bin");
+    EXPECT_FALSE(file.ok());
+    EXPECT_EQ(file.size(), 0u);
+}
+
+TEST(MappedFileTest, RegularFileIsMapped) {
+    const char* path = "/tmp/test_vanity_mapped.bin";
+    std::string contents(10000, 'x');
+    contents[1234] = 'y';
+    std::ofstream(path, std::ios::binary) << contents;
+
+    MappedFile file = MappedFile::open(path);
+    std::remove(path);
+
+    ASSERT_TRUE(file.ok());
+    EXPECT_TRUE(file.is_mapped());
+    ASSERT_EQ(file.size(), contents.size());
+    EXPECT_EQ(std::memcmp(file.data(), contents.data(), contents.size()), 0);
+
+    MappedFile moved(std::move(file));
+    EXPECT_FALSE(file.ok());
+    EXPECT_EQ(moved.data()[1234], 'y');
+}
+
+TEST(MappedFileTest, EmptyFileIsReadable) {
+    const char* path = "/tmp/test_vanity_mapped_empty.bin";
+    std::ofstream(path, std::ios::binary).close();
+
+    MappedFile file = MappedFile::open(path);
+    std::remove(path);
+
+    EXPECT_TRUE(file.ok());
+    EXPECT_FALSE(file.is_mapped());
+    EXPECT_EQ(file.size(), 0u);
+}
+
+TEST(MappedFileTest, FifoFallsBackToBufferedReads) {
+    const char* path = "/tmp/test_vanity_mapped.fifo";
+    std::remove(path);
+    ASSERT_EQ(mkfifo(path, 0600), 0);
+
+    std::string contents(3 << 20, 'p');
+    std::thread writer([&] {
+        std::ofstream(path, std::ios::binary) << contents;
+    });
+    MappedFile file = MappedFile::open(path);
+    writer.join();
+    std::remove(path);
+
+    ASSERT_TRUE(file.ok());
+    EXPECT_FALSE(file.is_mapped());
+    ASSERT_EQ(file.size(), contents.size());
+    EXPECT_EQ(std::memcmp(file.data(), contents.data(), contents.size()), 0);
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include "vanity/memory_budget.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace vanity;
+
+TEST(MemoryBudgetTest, UnlimitedNeverBlocks) {
+    MemoryBudget budget(0);
+    budget.acquire(size_t(1) << 40);
+    budget.acquire(size_t(1) << 40);
+    EXPECT_EQ(budget.in_use(), size_t(2) << 40);
+}
+
+TEST(MemoryBudgetTest, OversizedRequestRunsAlone) {
+    MemoryBudget budget(100);
+    budget.acquire(500);
+    EXPECT_EQ(budget.in_use(), 500u);
+    budget.release(500);
+    EXPECT_EQ(budget.in_use(), 0u);
+}
+
+TEST(MemoryBudgetTest, TryAcquireFailsWhenFull) {
+    MemoryBudget budget(100);
+    EXPECT_TRUE(budget.try_acquire(60));
+    EXPECT_FALSE(budget.try_acquire(60));
+    EXPECT_TRUE(budget.try_acquire(40));
+    EXPECT_EQ(budget.in_use(), 100u);
+}
+
+TEST(MemoryBudgetTest, AcquireWaitsForRelease) {
+    MemoryBudget budget(100);
+    budget.acquire(70);
+
+    std::atomic<bool> admitted{false};
+    std::thread waiter([&] {
+        budget.acquire(50);
+        admitted = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(admitted.load());
+
+    budget.release(70);
+    waiter.join();
+    EXPECT_TRUE(admitted.load());
+    EXPECT_EQ(budget.in_use(), 50u);
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "../src/lib/pixel_kernels.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace vanity::detail;
+
+TEST(PixelKernelsTest, ScalarIsAlwaysAvailable) {
+    auto kernels = available_pixel_kernels();
+    ASSERT_FALSE(kernels.empty());
+    EXPECT_STREQ(kernels.front()->name, "scalar");
+    EXPECT_NE(pixel_kernels().fill_pattern, nullptr);
+}
+
+TEST(PixelKernelsTest, FillPatternMatchesReference) {
+    const unsigned char pixel[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    const size_t counts[] = {0, 1, 5, 31, 85, 86, 200, 1000, 4099};
+
+    for (const PixelKernels* kernels : available_pixel_kernels()) {
+        for (int pixel_bytes = 1; pixel_bytes <= 16; pixel_bytes++) {
+            for (size_t count : counts) {
+                size_t total = count * pixel_bytes;
+                std::vector<unsigned char> out(total + 8, 0xEE);
+                kernels->fill_pattern(out.data(), count, pixel, pixel_bytes);
+                for (size_t i = 0; i < total; i++) {
+                    ASSERT_EQ(out[i], pixel[i % pixel_bytes])
+                        << kernels->name << " pixel_bytes=" << pixel_bytes << " count=" << count << " i=" << i;
+                }
+                for (size_t i = total; i < out.size(); i++) {
+                    ASSERT_EQ(out[i], 0xEE) << kernels->name << " wrote past the end";
+                }
+            }
+        }
+    }
+}
+
+TEST(PixelKernelsTest, CopyRowMatchesSource) {
+    std::vector<unsigned char> src(3000);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<unsigned char>(i * 31 + 7);
+    }
+
+    for (const PixelKernels* kernels : available_pixel_kernels()) {
+        for (size_t bytes : {size_t(0), size_t(1), size_t(63), size_t(129), size_t(257), size_t(2999)}) {
+            std::vector<unsigned char> dst(bytes + 4, 0);
+            kernels->copy_row(dst.data(), src.data() + 1, bytes);
+            for (size_t i = 0; i < bytes; i++) {
+                ASSERT_EQ(dst[i], src[i + 1]) << kernels->name << " bytes=" << bytes;
+            }
+            for (size_t i = bytes; i < dst.size(); i++) {
+                ASSERT_EQ(dst[i], 0) << kernels->name << " wrote past the end";
+            }
+        }
+    }
+}
+
+TEST(PixelKernelsTest, SwapBytes16MatchesReference) {
+    std::vector<unsigned char> src(2 * 1000 + 1);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<unsigned char>(i * 37 + 3);
+    }
+
+    for (const PixelKernels* kernels : available_pixel_kernels()) {
+        for (size_t count : {size_t(0), size_t(1), size_t(7), size_t(17), size_t(33), size_t(999)}) {
+            std::vector<unsigned char> dst(2 * count + 4, 0);
+            kernels->swap_bytes16(dst.data(), src.data() + 1, count);
+            for (size_t i = 0; i < count; i++) {
+                ASSERT_EQ(dst[2 * i], src[2 * i + 2]) << kernels->name << " count=" << count;
+                ASSERT_EQ(dst[2 * i + 1], src[2 * i + 1]) << kernels->name << " count=" << count;
+            }
+            for (size_t i = 2 * count; i < dst.size(); i++) {
+                ASSERT_EQ(dst[i], 0) << kernels->name << " wrote past the end";
+            }
+
+            // In place
+            std::vector<unsigned char> in_place(src.begin() + 1, src.begin() + 1 + 2 * count);
+            kernels->swap_bytes16(in_place.data(), in_place.data(), count);
+            ASSERT_TRUE(std::equal(in_place.begin(), in_place.end(), dst.begin())) << kernels->name;
+        }
+    }
+}
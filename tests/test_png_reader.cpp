@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include "../src/lib/inflate.hpp"
+#include "../src/lib/png_reader.hpp"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "test_images.hpp"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace vanity;
+using vanity::test::photo_like;
+
+namespace {
+
+// The in-tree encoder only writes fixed Huffman blocks, so the dynamic
+// blocks below come from Python's zlib, or were built by hand and checked
+// against it
+
+// zlib stream holding one hand-built dynamic block whose literal code has
+// every length from 1 to 15 bits, so 12- to 15-bit codes take the slow path
+const unsigned char kLongCodes[] = {
+    0x78, 0x01, 0x05, 0xe0, 0x01, 0x82, 0x24, 0x49, 0x92, 0x24, 0x49, 0xbe, 0x0d, 0x90, 0x58, 0xd4,
+    0x3c, 0xb2, 0x7a, 0xf6, 0xfe, 0xff, 0x9b, 0x03, 0xed, 0xde, 0xf7, 0xfb, 0xfb, 0xf7, 0xdf, 0xff,
+    0xfe, 0xef, 0xff, 0xfd, 0x7f, 0xff, 0x3f, 0xed, 0xde, 0xf7, 0xfb, 0xfb, 0xf7, 0xdf, 0xff, 0xfe,
+    0xef, 0xff, 0xfd, 0x7f, 0xff, 0x3f, 0xed, 0xde, 0xf7, 0xfb, 0xfb, 0xf7, 0xdf, 0xff, 0xfe, 0xef,
+    0xff, 0xfd, 0x7f, 0xff, 0xbf, 0xff, 0xdf, 0xff, 0xf7, 0xff, 0xfe, 0xef, 0x7f, 0xff, 0xfd, 0xfb,
+    0xfb, 0x7d, 0xef, 0x96, 0xff, 0x3f, 0x00, 0xda, 0x10, 0xe1,
+};
+const char kLongCodesText[] = "ABCDEFGHIJKLMNOABCDEFGHIJKLMNOABCDEFGHIJKLMNOONMLKJIHGFEDCBA";
+
+// 13x7 RGB cycling through all five filter types, IDAT split in three
+const unsigned char kRgbFilters[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x07, 0x08, 0x02, 0x00, 0x00, 0x00, 0x5c, 0x12, 0x50,
+    0x4d, 0x00, 0x00, 0x00, 0x56, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x1d, 0x8f, 0xbf, 0x2b, 0x85,
+    0x61, 0x14, 0xc7, 0xef, 0xcb, 0xf3, 0x9c, 0xdf, 0xef, 0x53, 0x96, 0xbb, 0x5a, 0x4c, 0x36, 0xdd,
+    0x41, 0x32, 0xd0, 0x5b, 0x0a, 0x89, 0x89, 0x0c, 0x0c, 0x52, 0x4a, 0x48, 0xb8, 0x49, 0x52, 0x7e,
+    0x2c, 0x97, 0xc4, 0x62, 0x30, 0x50, 0x06, 0x37, 0xe5, 0x6e, 0xee, 0x42, 0x06, 0x36, 0x9b, 0xd5,
+    0x62, 0xb2, 0xd9, 0xfc, 0x0b, 0xce, 0x7b, 0x3b, 0x75, 0xce, 0xa9, 0x73, 0xce, 0xf7, 0x7c, 0x3f,
+    0x95, 0xac, 0xb6, 0x22, 0x43, 0x6b, 0x3d, 0xc5, 0x4e, 0x75, 0xf2, 0xa0, 0x77, 0xe6, 0xb8, 0x72,
+    0x7d, 0x0f, 0xeb, 0x00, 0x00, 0x00, 0x56, 0x49, 0x44, 0x41, 0x54, 0x6f, 0xbe, 0xd1, 0xbf, 0x78,
+    0x59, 0x5b, 0xbe, 0x1e, 0xde, 0xb8, 0x2b, 0xea, 0xcd, 0xf1, 0xbd, 0xd6, 0xf4, 0x49, 0x7b, 0xee,
+    0xec, 0x35, 0x4b, 0xa3, 0x5b, 0x18, 0x31, 0x10, 0x70, 0x44, 0x64, 0x88, 0x24, 0x08, 0x41, 0x00,
+    0x81, 0x25, 0x86, 0x20, 0xcc, 0x31, 0x22, 0x60, 0xec, 0x22, 0x36, 0x31, 0x51, 0x35, 0xb5, 0xdc,
+    0x2c, 0xa9, 0x78, 0x97, 0xc4, 0x72, 0xf6, 0x2e, 0x19, 0xa9, 0x59, 0xae, 0x49, 0xb5, 0xbb, 0x3a,
+    0x30, 0xa1, 0xec, 0x67, 0x24, 0x9e, 0x04, 0xc9, 0xab, 0x90, 0x90, 0x12, 0xb2, 0x7a, 0x10, 0x75,
+    0x12, 0xcb, 0xf0, 0x6b, 0x97, 0x00, 0x00, 0x00, 0x56, 0x49, 0x44, 0x41, 0x54, 0x05, 0x53, 0x21,
+    0x17, 0x06, 0x5f, 0x41, 0x24, 0x20, 0x37, 0x11, 0x29, 0xf8, 0x5d, 0x40, 0xea, 0xfc, 0x24, 0xf7,
+    0x23, 0x58, 0x19, 0x5c, 0xbf, 0x19, 0xd9, 0xbe, 0x1f, 0xdb, 0x7f, 0x9c, 0x3a, 0x7a, 0x9a, 0x3d,
+    0x7d, 0x5e, 0xb8, 0x78, 0x5f, 0xba, 0xfa, 0x58, 0xbd, 0xfd, 0xdc, 0x6c, 0x7e, 0xed, 0xb6, 0xbe,
+    0x0f, 0xdb, 0x3f, 0x8d, 0x97, 0xdf, 0xf3, 0xb7, 0xbf, 0xac, 0xa8, 0x3f, 0x08, 0x3a, 0x01, 0x39,
+    0x42, 0xc9, 0x00, 0xe0, 0xaa, 0x25, 0x49, 0x29, 0x2a, 0x4e, 0xc8, 0x3e, 0x43, 0xfa, 0x07, 0xe5,
+    0x66, 0x2d, 0xa7, 0x22, 0xe8, 0x02, 0x9f, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae,
+    0x42, 0x60, 0x82,
+};
+
+// 9x5 palette image with a six-colour PLTE and a four-entry tRNS
+const unsigned char kPaletteAlpha[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x05, 0x08, 0x03, 0x00, 0x00, 0x00, 0xa0, 0x8d, 0x36,
+    0x59, 0x00, 0x00, 0x00, 0x12, 0x50, 0x4c, 0x54, 0x45, 0x0a, 0x14, 0x1e, 0xc8, 0x64, 0x32, 0x00,
+    0xff, 0x00, 0xff, 0xff, 0xff, 0x07, 0x08, 0x09, 0x5a, 0x5a, 0x5a, 0xf4, 0x46, 0xf4, 0x2b, 0x00,
+    0x00, 0x00, 0x04, 0x74, 0x52, 0x4e, 0x53, 0x00, 0x80, 0xff, 0x40, 0xb7, 0x5e, 0xc1, 0xf8, 0x00,
+    0x00, 0x00, 0x2b, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x60, 0x64, 0x62, 0x66, 0x61,
+    0x05, 0x92, 0x40, 0xc8, 0xc8, 0xf8, 0x1b, 0x88, 0x19, 0x99, 0x98, 0x98, 0xfe, 0xfc, 0x61, 0x02,
+    0x91, 0xcc, 0xff, 0xfe, 0x83, 0xe9, 0xff, 0x4c, 0x2c, 0x10, 0x59, 0x20, 0x09, 0x00, 0xb4, 0xe9,
+    0x09, 0x28, 0x44, 0x7d, 0xa0, 0x5c, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42,
+    0x60, 0x82,
+};
+
+// 3x2 16-bit gray and 1x1 Adam7-interlaced gray, both left to stb_image
+const unsigned char kGray16[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02, 0x10, 0x00, 0x00, 0x00, 0x00, 0xe8, 0x8f, 0xe5,
+    0x85, 0x00, 0x00, 0x00, 0x16, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x10, 0x32, 0x09, 0xab,
+    0x98, 0xb5, 0x87, 0xe1, 0xff, 0x7f, 0x06, 0x86, 0x06, 0x06, 0x00, 0x23, 0x09, 0x04, 0xe9, 0x98,
+    0x0a, 0xc5, 0x62, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+const unsigned char kInterlaced[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x00, 0x00, 0x00, 0x01, 0x4d, 0x79, 0xab,
+    0xc3, 0x00, 0x00, 0x00, 0x0a, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x68, 0x00, 0x00, 0x00,
+    0x82, 0x00, 0x81, 0xda, 0x45, 0x08, 0x3b, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae,
+    0x42, 0x60, 0x82,
+};
+
+template <size_t N>
+std::vector<std::byte> bytes_of(const unsigned char (&data)[N]) {
+    std::vector<std::byte> out(N);
+    std::memcpy(out.data(), data, N);
+    return out;
+}
+
+LoadedImage decode(const std::vector<std::byte>& png, bool use_stb = false) {
+    DecodeOptions options;
+    options.use_stb = use_stb;
+    return decode_from_memory(png, options);
+}
+
+// The in-tree decode must reproduce stb_image's byte for byte
+void expect_matches_stb(const std::vector<std::byte>& png) {
+    LoadedImage ours = decode(png);
+    LoadedImage reference = decode(png, true);
+    ASSERT_NE(ours.get(), nullptr);
+    ASSERT_NE(reference.get(), nullptr);
+    ASSERT_EQ(ours.width(), reference.width());
+    ASSERT_EQ(ours.height(), reference.height());
+    ASSERT_EQ(ours.channels(), reference.channels());
+    EXPECT_EQ(std::memcmp(ours.get(), reference.get(), ours.byte_size()), 0);
+}
+
+} // namespace
+
+TEST(PngReaderTest, UnfilterKernelsMatchScalar) {
+    auto kernels = detail::available_png_kernels();
+    ASSERT_FALSE(kernels.empty());
+    EXPECT_STREQ(kernels.front()->name, "scalar");
+
+    std::mt19937 rng(9);
+    for (int bpp = 1; bpp <= 4; bpp++) {
+        for (size_t pixels : {1, 2, 5, 16, 37}) {
+            size_t bytes = pixels * bpp;
+            std::vector<unsigned char> filtered(bytes), prev(bytes);
+            for (size_t i = 0; i < bytes; i++) {
+                filtered[i] = static_cast<unsigned char>(rng());
+                prev[i] = static_cast<unsigned char>(rng());
+            }
+            for (int filter = 1; filter <= 4; filter++) {
+                std::vector<unsigned char> expected(bytes);
+                const detail::PngKernels& scalar = *kernels.front();
+                auto pick = [filter](const detail::PngKernels& k) {
+                    return filter == 1 ? k.unfilter_sub
+                         : filter == 2 ? k.unfilter_up
+                         : filter == 3 ? k.unfilter_average
+                                       : k.unfilter_paeth;
+                };
+                pick(scalar)(expected.data(), filtered.data(), prev.data(), bytes, bpp);
+                for (const detail::PngKernels* k : kernels) {
+                    std::vector<unsigned char> out(bytes + 4, 0xEE);
+                    pick(*k)(out.data(), filtered.data(), prev.data(), bytes, bpp);
+                    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), out.begin()))
+                        << k->name << " filter=" << filter << " bpp=" << bpp << " pixels=" << pixels;
+                    EXPECT_EQ(out[bytes], 0xEE) << k->name << " wrote past the end";
+                }
+            }
+        }
+    }
+}
+
+TEST(PngReaderTest, InflatesLongCodes) {
+    std::string out(sizeof(kLongCodesText) - 1, '\0');
+    size_t written = 0;
+    ASSERT_TRUE(detail::zlib_inflate(kLongCodes, sizeof(kLongCodes), reinterpret_cast<unsigned char*>(out.data()),
+                                     out.size(), written));
+    EXPECT_EQ(written, out.size());
+    EXPECT_EQ(out, kLongCodesText);
+
+    // A larger buffer stops at the final block
+    std::vector<unsigned char> roomy(200);
+    ASSERT_TRUE(detail::zlib_inflate(kLongCodes, sizeof(kLongCodes), roomy.data(), roomy.size(), written));
+    EXPECT_EQ(written, out.size());
+
+    // Cutting the stream short is an error, not zero-filled output
+    EXPECT_FALSE(detail::zlib_inflate(kLongCodes, sizeof(kLongCodes) - 10, roomy.data(), roomy.size(), written));
+}
+
+TEST(PngReaderTest, DecodesZlibStreams) {
+    expect_matches_stb(bytes_of(kRgbFilters));
+    expect_matches_stb(bytes_of(kPaletteAlpha));
+
+    LoadedImage palette = decode(bytes_of(kPaletteAlpha));
+    ASSERT_EQ(palette.channels(), 4);
+    // Pixel (1, 0) is index 1: (200, 100, 50) with alpha 128
+    const unsigned char expected[4] = {200, 100, 50, 128};
+    EXPECT_EQ(std::memcmp(palette.get() + 4, expected, 4), 0);
+}
+
+TEST(PngReaderTest, RoundTripsEveryLevelAndFilter) {
+    for (int channels = 1; channels <= 4; channels++) {
+        std::vector<unsigned char> pixels = photo_like(41, 23, channels);
+        ImageView view(pixels.data(), 41, 23, channels);
+        for (int level : {0, 1, 6}) {
+            for (PngFilter filter : {PngFilter::None, PngFilter::Sub, PngFilter::Up, PngFilter::Average,
+                                     PngFilter::Paeth, PngFilter::Adaptive}) {
+                WriteOptions options;
+                options.png_compression = level;
+                options.png_filter = filter;
+                std::vector<std::byte> png = encode_to_memory(view, ImageFormat::PNG, options);
+                LoadedImage image = decode(png);
+                ASSERT_NE(image.get(), nullptr) << "channels=" << channels << " level=" << level;
+                ASSERT_EQ(image.channels(), channels);
+                EXPECT_EQ(std::memcmp(image.get(), pixels.data(), pixels.size()), 0)
+                    << "channels=" << channels << " level=" << level << " filter=" << static_cast<int>(filter);
+            }
+        }
+    }
+}
+
+TEST(PngReaderTest, RejectsCorruptData) {
+    std::vector<unsigned char> pixels = photo_like(16, 8, 3);
+    WriteOptions stored;
+    stored.png_compression = 0;
+    std::vector<std::byte> png = encode_to_memory(ImageView(pixels.data(), 16, 8, 3), ImageFormat::PNG, stored);
+
+    // Stored blocks leave the first filter type byte visible: signature,
+    // IHDR, the IDAT length and type, two zlib bytes and five block header bytes
+    size_t filter_byte = 8 + 25 + 8 + 2 + 5;
+    ASSERT_EQ(png[filter_byte], std::byte{0});
+    std::vector<std::byte> bad_filter = png;
+    bad_filter[filter_byte] = std::byte{7};
+    EXPECT_EQ(decode(bad_filter).get(), nullptr);
+
+    // Garbage in a compressed stream must fail cleanly or decode something
+    std::vector<std::byte> compressed = encode_to_memory(ImageView(pixels.data(), 16, 8, 3), ImageFormat::PNG);
+    std::mt19937 rng(1);
+    for (int trial = 0; trial < 200; trial++) {
+        std::vector<std::byte> damaged = compressed;
+        size_t at = 8 + 25 + 8 + 2 + rng() % 40;
+        damaged[at] = static_cast<std::byte>(rng());
+        decode(damaged);
+    }
+
+    std::vector<std::byte> truncated(compressed.begin(), compressed.begin() + compressed.size() / 2);
+    EXPECT_EQ(decode(truncated).get(), nullptr);
+}
+
+TEST(PngReaderTest, LeavesOtherVariantsToStb) {
+    detail::PngHeader header;
+    EXPECT_FALSE(detail::png_read_header(kGray16, sizeof(kGray16), header));
+    EXPECT_FALSE(detail::png_read_header(kInterlaced, sizeof(kInterlaced), header));
+    EXPECT_TRUE(detail::png_read_header(kRgbFilters, sizeof(kRgbFilters), header));
+    EXPECT_EQ(header.channels, 3);
+
+    LoadedImage gray16 = decode(bytes_of(kGray16));
+    ASSERT_NE(gray16.get(), nullptr);
+    EXPECT_EQ(gray16.channels(), 1);
+    EXPECT_EQ(gray16.get()[0], 0x12);
+    LoadedImage interlaced = decode(bytes_of(kInterlaced));
+    ASSERT_NE(interlaced.get(), nullptr);
+    EXPECT_EQ(interlaced.get()[0], 0x80);
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "../src/lib/png_writer.hpp"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/image_sink.hpp"
+#include "vanity/thread_pool.hpp"
+#include "test_images.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace vanity;
+using vanity::test::photo_like;
+
+namespace {
+
+LoadedImage decode(const std::vector<std::byte>& png) {
+    return decode_from_memory(png);
+}
+
+} // namespace
+
+TEST(PngWriterTest, FiltersInvertExactly) {
+    std::vector<unsigned char> prev = photo_like(9, 1, 3);
+    std::vector<unsigned char> row = photo_like(9, 2, 3);
+    row.erase(row.begin(), row.begin() + 27);
+    for (PngFilter filter : {PngFilter::None, PngFilter::Sub, PngFilter::Up, PngFilter::Average, PngFilter::Paeth}) {
+        std::vector<unsigned char> out(28);
+        detail::png_filter_row(filter, row.data(), prev.data(), 27, 3, out.data());
+        // Undo the filter as a decoder would
+        std::vector<unsigned char> raw(27);
+        for (size_t i = 0; i < 27; i++) {
+            int a = i >= 3 ? raw[i - 3] : 0;
+            int b = prev[i];
+            int c = i >= 3 ? prev[i - 3] : 0;
+            int pred = 0;
+            switch (out[0]) {
+                case 1: pred = a; break;
+                case 2: pred = b; break;
+                case 3: pred = (a + b) / 2; break;
+                case 4: {
+                    int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                    pred = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+                    break;
+                }
+            }
+            raw[i] = static_cast<unsigned char>(out[i + 1] + pred);
+        }
+        EXPECT_EQ(raw, row) << "filter type " << int(out[0]);
+    }
+}
+
+TEST(PngWriterTest, EveryLevelAndFilterDecodes) {
+    const int width = 61, height = 37;
+    for (int channels = 1; channels <= 4; channels++) {
+        std::vector<unsigned char> pixels = photo_like(width, height, channels);
+        ImageView view(pixels.data(), width, height, channels);
+        for (int level : {0, 1, 2, 6, 9}) {
+            for (PngFilter filter : {PngFilter::Adaptive, PngFilter::None, PngFilter::Sub, PngFilter::Up,
+                                     PngFilter::Average, PngFilter::Paeth}) {
+                WriteOptions options;
+                options.png_compression = level;
+                options.png_filter = filter;
+                std::vector<std::byte> png = encode_to_memory(view, ImageFormat::PNG, options);
+                LoadedImage img = decode(png);
+                ASSERT_NE(img.get(), nullptr) << channels << "ch level " << level;
+                ASSERT_EQ(img.channels(), channels);
+                EXPECT_EQ(std::memcmp(img.get(), pixels.data(), pixels.size()), 0)
+                    << channels << "ch level " << level << " filter " << static_cast<int>(filter);
+            }
+        }
+    }
+}
+
+TEST(PngWriterTest, LargeImageSpansSeveralBlocksAndChunks) {
+    // Several MiB of filtered data exercise the deflate history and IDAT splitting
+    const int width = 1500, height = 1100, channels = 3;
+    std::vector<unsigned char> pixels = photo_like(width, height, channels);
+    std::vector<std::byte> png = encode_to_memory(ImageView(pixels.data(), width, height, channels),
+                                                  ImageFormat::PNG);
+    LoadedImage img = decode(png);
+    ASSERT_NE(img.get(), nullptr);
+    EXPECT_EQ(std::memcmp(img.get(), pixels.data(), pixels.size()), 0);
+}
+
+TEST(PngWriterTest, LowerLevelsTradeSizeForSpeed) {
+    // Linear ramps, which Sub and Up filter into runs, so even run-length
+    // matching finds work to do
+    std::vector<unsigned char> pixels(200 * 150 * 3);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        size_t x = i / 3 % 200, y = i / 600, c = i % 3;
+        pixels[i] = static_cast<unsigned char>((x * (c + 2) + y * 3) % 256);
+    }
+    ImageView view(pixels.data(), 200, 150, 3);
+    WriteOptions stored, fast, best;
+    stored.png_compression = 0;
+    fast.png_compression = 1;
+    best.png_compression = 9;
+    size_t stored_size = encode_to_memory(view, ImageFormat::PNG, stored).size();
+    size_t fast_size = encode_to_memory(view, ImageFormat::PNG, fast).size();
+    size_t best_size = encode_to_memory(view, ImageFormat::PNG, best).size();
+    EXPECT_GT(stored_size, pixels.size());
+    EXPECT_LT(best_size, fast_size);
+    EXPECT_LT(fast_size, stored_size);
+}
+
+TEST(PngWriterTest, StridedViewMatchesPacked) {
+    std::vector<unsigned char> wide = photo_like(30, 20, 4);
+    ImageView strided(wide.data() + 5 * 4, 20, 20, 4, 30 * 4);
+    std::vector<unsigned char> packed(20 * 20 * 4);
+    for (int y = 0; y < 20; y++) {
+        std::memcpy(&packed[y * 20 * 4], strided.row(y), 20 * 4);
+    }
+    EXPECT_EQ(encode_to_memory(strided, ImageFormat::PNG),
+              encode_to_memory(ImageView(packed.data(), 20, 20, 4), ImageFormat::PNG));
+}
+
+TEST(PngWriterTest, ParallelEncodeMatchesSingleThreaded) {
+    ThreadPool pool(4);
+    struct Shape {
+        int width, height, channels;
+    };
+    // Several row ranges; rows wider than the match window; one tall narrow range
+    for (Shape shape : {Shape{900, 800, 3}, Shape{12000, 40, 4}, Shape{3, 4000, 1}}) {
+        std::vector<unsigned char> pixels = photo_like(shape.width, shape.height, shape.channels);
+        ImageView view(pixels.data(), shape.width, shape.height, shape.channels);
+        for (int level : {0, 1, 6}) {
+            WriteOptions serial;
+            serial.png_compression = level;
+            WriteOptions parallel = serial;
+            parallel.exec.pool = &pool;
+            parallel.exec.parallel_threshold = 0;
+            std::vector<std::byte> expected = encode_to_memory(view, ImageFormat::PNG, serial);
+            std::vector<std::byte> png = encode_to_memory(view, ImageFormat::PNG, parallel);
+            EXPECT_EQ(png, expected) << shape.width << "x" << shape.height << " level " << level;
+
+            LoadedImage img = decode(png);
+            ASSERT_NE(img.get(), nullptr);
+            EXPECT_EQ(std::memcmp(img.get(), pixels.data(), pixels.size()), 0);
+        }
+    }
+}
+
+TEST(PngWriterTest, SixteenBitRoundTripsEveryFilter) {
+    const int width = 45, height = 23;
+    for (int channels = 1; channels <= 4; channels++) {
+        // Wide rows with a stride, so the byte-swapped copies are exercised
+        std::vector<uint16_t> pixels(static_cast<size_t>(width + 3) * height * channels);
+        std::mt19937 rng(5);
+        for (size_t i = 0; i < pixels.size(); i++) {
+            pixels[i] = static_cast<uint16_t>(i * 611 + rng() % 300);
+        }
+        ImageView16 view(pixels.data(), width, height, channels, (width + 3) * channels * sizeof(uint16_t));
+        for (PngFilter filter : {PngFilter::Adaptive, PngFilter::None, PngFilter::Sub, PngFilter::Paeth}) {
+            WriteOptions options;
+            options.png_filter = filter;
+            std::vector<std::byte> png = encode_to_memory(view, ImageFormat::PNG, options);
+            ASSERT_FALSE(png.empty());
+            EXPECT_EQ(static_cast<int>(png[24]), 16);   // IHDR bit depth
+
+            int w, h, c;
+            LoadedImage16 img = LoadedImage16::load_from_memory(reinterpret_cast<const unsigned char*>(png.data()),
+                                                                png.size(), w, h, c);
+            ASSERT_NE(img.get(), nullptr);
+            ASSERT_EQ(c, channels);
+            for (int y = 0; y < height; y++) {
+                ASSERT_EQ(std::memcmp(img.view().row(y), view.row(y), view.row_bytes()), 0)
+                    << channels << "ch filter " << static_cast<int>(filter) << " row " << y;
+            }
+        }
+    }
+}
+
+TEST(PngWriterTest, SixteenBitParallelEncodeMatchesSingleThreaded) {
+    ThreadPool pool(4);
+    std::vector<uint16_t> pixels(700 * 600 * 3);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<uint16_t>(i * 37);
+    }
+    ImageView16 view(pixels.data(), 700, 600, 3);
+    WriteOptions parallel;
+    parallel.png_compression = 1;
+    parallel.exec.pool = &pool;
+    parallel.exec.parallel_threshold = 0;
+    WriteOptions serial = parallel;
+    serial.exec = {};
+    EXPECT_EQ(encode_to_memory(view, ImageFormat::PNG, parallel), encode_to_memory(view, ImageFormat::PNG, serial));
+}
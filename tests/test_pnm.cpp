@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include "../src/lib/pnm.hpp"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/image_sink.hpp"
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace vanity;
+
+namespace {
+
+std::vector<unsigned char> ramp(int width, int height, int channels) {
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * channels);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<unsigned char>(i * 7);
+    }
+    return pixels;
+}
+
+std::vector<unsigned char> encode(const ImageView& image, bool pam) {
+    std::vector<unsigned char> out;
+    MemorySink sink(out);
+    EXPECT_TRUE(detail::pnm_encode(image, sink, pam));
+    return out;
+}
+
+std::vector<unsigned char> bytes_of(const std::string& text) {
+    return std::vector<unsigned char>(text.begin(), text.end());
+}
+
+} // namespace
+
+TEST(PnmTest, DetectFormat) {
+    EXPECT_EQ(detect_format("frame.ppm"), ImageFormat::PPM);
+    EXPECT_EQ(detect_format("frame.PGM"), ImageFormat::PPM);
+    EXPECT_EQ(detect_format("frame.pam"), ImageFormat::PAM);
+}
+
+TEST(PnmTest, PamRoundTripsEveryChannelCount) {
+    for (int channels = 1; channels <= 4; channels++) {
+        std::vector<unsigned char> pixels = ramp(5, 3, channels);
+        std::vector<unsigned char> encoded = encode(ImageView(pixels.data(), 5, 3, channels), true);
+
+        detail::PnmHeader header;
+        ASSERT_TRUE(detail::pnm_read_header(encoded.data(), encoded.size(), header));
+        EXPECT_EQ(header.width, 5);
+        EXPECT_EQ(header.height, 3);
+        EXPECT_EQ(header.channels, channels);
+        EXPECT_EQ(header.maxval, 255);
+        EXPECT_EQ(encoded.size(), header.data_offset + pixels.size());
+
+        std::vector<unsigned char> decoded(pixels.size());
+        ASSERT_TRUE(detail::pnm_decode(encoded.data(), encoded.size(),
+                                       MutableImageView(decoded.data(), 5, 3, channels)));
+        EXPECT_EQ(decoded, pixels);
+    }
+}
+
+TEST(PnmTest, PpmDropsAlpha) {
+    std::vector<unsigned char> rgba = ramp(4, 2, 4);
+    std::vector<unsigned char> encoded = encode(ImageView(rgba.data(), 4, 2, 4), false);
+    ASSERT_EQ(std::string(encoded.begin(), encoded.begin() + 2), "P6");
+
+    detail::PnmHeader header;
+    ASSERT_TRUE(detail::pnm_read_header(encoded.data(), encoded.size(), header));
+    ASSERT_EQ(header.channels, 3);
+    const unsigned char* samples = encoded.data() + header.data_offset;
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(std::memcmp(samples + i * 3, &rgba[i * 4], 3), 0);
+    }
+
+    std::vector<unsigned char> gray = ramp(4, 2, 1);
+    encoded = encode(ImageView(gray.data(), 4, 2, 1), false);
+    EXPECT_EQ(std::string(encoded.begin(), encoded.begin() + 2), "P5");
+}
+
+TEST(PnmTest, StridedViewIsWrittenRowByRow) {
+    std::vector<unsigned char> wide = ramp(6, 4, 3);
+    ImageView left(wide.data(), 4, 4, 3, 6 * 3);
+    std::vector<unsigned char> encoded = encode(left, true);
+
+    detail::PnmHeader header;
+    ASSERT_TRUE(detail::pnm_read_header(encoded.data(), encoded.size(), header));
+    for (int y = 0; y < 4; y++) {
+        EXPECT_EQ(std::memcmp(encoded.data() + header.data_offset + y * 12, left.row(y), 12), 0);
+    }
+}
+
+TEST(PnmTest, ParsesCommentsAndRescalesMaxval) {
+    std::vector<unsigned char> data = bytes_of("P5 # a comment\n2 # width done\n1\n15\n");
+    data.push_back(15);
+    data.push_back(5);
+    std::vector<unsigned char> decoded(2);
+    ASSERT_TRUE(detail::pnm_decode(data.data(), data.size(), MutableImageView(decoded.data(), 2, 1, 1)));
+    EXPECT_EQ(decoded[0], 255);
+    EXPECT_EQ(decoded[1], 85);
+}
+
+TEST(PnmTest, RejectsTruncatedAndMalformedInput) {
+    detail::PnmHeader header;
+    std::vector<unsigned char> no_size = bytes_of("P6\n");
+    EXPECT_FALSE(detail::pnm_read_header(no_size.data(), no_size.size(), header));
+    std::vector<unsigned char> no_end = bytes_of("P7\nWIDTH 2\nHEIGHT 2\nDEPTH 3\nMAXVAL 255\n");
+    EXPECT_FALSE(detail::pnm_read_header(no_end.data(), no_end.size(), header));
+    std::vector<unsigned char> bad_depth = bytes_of("P7\nWIDTH 2\nHEIGHT 2\nDEPTH 9\nMAXVAL 255\nENDHDR\n");
+    EXPECT_FALSE(detail::pnm_read_header(bad_depth.data(), bad_depth.size(), header));
+
+    std::vector<unsigned char> short_data = bytes_of("P6\n2 2\n255\nabc");
+    std::vector<unsigned char> decoded(12);
+    EXPECT_FALSE(detail::pnm_decode(short_data.data(), short_data.size(), MutableImageView(decoded.data(), 2, 2, 3)));
+}
+
+TEST(PnmTest, LoadsPamPaddedAndProbes) {
+    const char* path = "/tmp/test_vanity_image.pam";
+    std::vector<unsigned char> pixels = ramp(6, 4, 2);
+    ASSERT_TRUE(write_image(path, 6, 4, 2, pixels.data()));
+
+    ImageInfo info;
+    ASSERT_TRUE(probe_image(path, info));
+    EXPECT_EQ(info.width, 6);
+    EXPECT_EQ(info.height, 4);
+    EXPECT_EQ(info.channels, 2);
+
+    int width, height, channels;
+    LoadedImage img = LoadedImage::load_padded(path, Padding{1, 2, 3, 4}, width, height, channels);
+    std::remove(path);
+    ASSERT_NE(img.get(), nullptr);
+    EXPECT_EQ(width, 11);
+    EXPECT_EQ(height, 9);
+    EXPECT_EQ(channels, 2);
+    for (int y = 0; y < 4; y++) {
+        EXPECT_EQ(std::memcmp(img.view().row(y + 1) + 2 * 2, &pixels[y * 6 * 2], 6 * 2), 0);
+    }
+}
+
+TEST(PnmTest, ProbesHeadersLongerThanTheFirstRead) {
+    // A comment pushes ENDHDR well past the first block probe_image reads
+    std::vector<unsigned char> data =
+        bytes_of("P7\n# " + std::string(3000, 'x') + "\nWIDTH 3\nHEIGHT 2\nDEPTH 1\nMAXVAL 65535\nENDHDR\n");
+    data.resize(data.size() + 3 * 2 * 2, 0x7f);
+    const char* path = "/tmp/test_vanity_long_header.pam";
+    FILE* file = std::fopen(path, "wb");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(std::fwrite(data.data(), 1, data.size(), file), data.size());
+    std::fclose(file);
+
+    ImageInfo info;
+    bool probed = probe_image(path, info);
+    std::remove(path);
+    ASSERT_TRUE(probed);
+    EXPECT_EQ(info.width, 3);
+    EXPECT_EQ(info.height, 2);
+    EXPECT_EQ(info.channels, 1);
+    EXPECT_EQ(info.bits_per_channel, 16);
+    EXPECT_EQ(info.file_size, data.size());
+
+    ImageInfo from_memory;
+    ASSERT_TRUE(probe_image(std::as_bytes(std::span(data)), from_memory));
+    EXPECT_EQ(from_memory.width, 3);
+    EXPECT_EQ(from_memory.bits_per_channel, 16);
+
+    // Cut off before ENDHDR, the header never parses
+    data.resize(1000);
+    EXPECT_FALSE(probe_image(std::as_bytes(std::span(data)), from_memory));
+}
+
+TEST(PnmTest, SixteenBitRoundTripsThroughPamAndPpm) {
+    std::vector<uint16_t> pixels(7 * 3 * 4);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<uint16_t>(i * 2731 + 1);
+    }
+    for (bool pam : {true, false}) {
+        std::vector<unsigned char> encoded;
+        MemorySink sink(encoded);
+        ASSERT_TRUE(detail::pnm_encode(ImageView16(pixels.data(), 7, 3, 4), sink, pam));
+
+        detail::PnmHeader header;
+        ASSERT_TRUE(detail::pnm_read_header(encoded.data(), encoded.size(), header));
+        EXPECT_EQ(header.maxval, 65535);
+        // Samples are stored big-endian
+        EXPECT_EQ(encoded[header.data_offset], pixels[0] >> 8);
+        EXPECT_EQ(encoded[header.data_offset + 1], pixels[0] & 0xff);
+
+        int width, height, channels;
+        LoadedImage16 img = LoadedImage16::load_from_memory(encoded.data(), encoded.size(), width, height, channels);
+        ASSERT_NE(img.get(), nullptr);
+        ASSERT_EQ(channels, pam ? 4 : 3);
+        for (size_t i = 0; i < 7 * 3; i++) {
+            EXPECT_EQ(std::memcmp(img.get() + i * channels, &pixels[i * 4], channels * 2), 0) << "pam " << pam;
+        }
+    }
+}
+
+TEST(PnmTest, SixteenBitLoadRescalesShallowerSamples) {
+    // 8-bit samples widen exactly (255 -> 65535), other maxvals round to full scale
+    std::vector<unsigned char> data = bytes_of("P5\n3 1\n255\n");
+    data.insert(data.end(), {0, 128, 255});
+    std::vector<uint16_t> decoded(3);
+    ASSERT_TRUE(detail::pnm_decode(data.data(), data.size(), MutableImageView16(decoded.data(), 3, 1, 1)));
+    EXPECT_EQ(decoded, (std::vector<uint16_t>{0, 128 * 257, 65535}));
+
+    data = bytes_of("P5\n2 1\n1000\n");
+    data.insert(data.end(), {0x01, 0xf4, 0x07, 0xd0});     // 500, 2000 (clamped to 1000)
+    ASSERT_TRUE(detail::pnm_decode(data.data(), data.size(), MutableImageView16(decoded.data(), 2, 1, 1)));
+    EXPECT_EQ(decoded[0], 32768);
+    EXPECT_EQ(decoded[1], 65535);
+
+    data.pop_back();
+    EXPECT_FALSE(detail::pnm_decode(data.data(), data.size(), MutableImageView16(decoded.data(), 2, 1, 1)));
+}
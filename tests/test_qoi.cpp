@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "../src/lib/qoi.hpp"
+#include "vanity/image_buffer.hpp"
+#include "vanity/image_io.hpp"
+#include "vanity/image_sink.hpp"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace vanity;
+
+namespace {
+
+// Mix of flat runs, smooth gradients (diff/luma ops), repeats (index op)
+// and noise (full RGB/RGBA ops), so every opcode is exercised
+std::vector<unsigned char> test_pattern(int width, int height, int channels) {
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * channels);
+    std::mt19937 rng(42);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            unsigned char* p = &pixels[(static_cast<size_t>(y) * width + x) * channels];
+            for (int c = 0; c < channels; c++) {
+                if (y < height / 4) {
+                    p[c] = 200;
+                } else if (y < height / 2) {
+                    p[c] = static_cast<unsigned char>(x + y * (c + 1));
+                } else if (y < 3 * height / 4) {
+                    p[c] = static_cast<unsigned char>((x / 3) % 2 ? 10 * c : 250 - c);
+                } else {
+                    p[c] = static_cast<unsigned char>(rng());
+                }
+            }
+        }
+    }
+    return pixels;
+}
+
+std::vector<unsigned char> encode(const ImageView& image) {
+    std::vector<unsigned char> out;
+    MemorySink sink(out);
+    EXPECT_TRUE(detail::qoi_encode(image, sink));
+    return out;
+}
+
+} // namespace
+
+TEST(QoiTest, RoundTripsRgbAndRgba) {
+    for (int channels : {3, 4}) {
+        std::vector<unsigned char> pixels = test_pattern(97, 64, channels);
+        std::vector<unsigned char> encoded = encode(ImageView(pixels.data(), 97, 64, channels));
+
+        int width, height, header_channels;
+        ASSERT_TRUE(detail::qoi_read_header(encoded.data(), encoded.size(), width, height, header_channels));
+        EXPECT_EQ(width, 97);
+        EXPECT_EQ(height, 64);
+        EXPECT_EQ(header_channels, channels);
+
+        std::vector<unsigned char> decoded(pixels.size());
+        ASSERT_TRUE(detail::qoi_decode(encoded.data(), encoded.size(),
+                                       MutableImageView(decoded.data(), 97, 64, channels)));
+        EXPECT_EQ(decoded, pixels) << channels << " channels";
+    }
+}
+
+TEST(QoiTest, LongRunsSpanRowsAndRunLimit) {
+    std::vector<unsigned char> pixels(300 * 3 * 3, 77);
+    std::vector<unsigned char> encoded = encode(ImageView(pixels.data(), 300, 3, 3));
+    // 900 identical pixels compress to a handful of run ops
+    EXPECT_LT(encoded.size(), 14u + 8u + 20u);
+
+    std::vector<unsigned char> decoded(pixels.size());
+    ASSERT_TRUE(detail::qoi_decode(encoded.data(), encoded.size(), MutableImageView(decoded.data(), 300, 3, 3)));
+    EXPECT_EQ(decoded, pixels);
+}
+
+TEST(QoiTest, GrayIsWidenedToRgb) {
+    std::vector<unsigned char> gray = test_pattern(20, 10, 1);
+    std::vector<unsigned char> encoded = encode(ImageView(gray.data(), 20, 10, 1));
+
+    int width, height, channels;
+    ASSERT_TRUE(detail::qoi_read_header(encoded.data(), encoded.size(), width, height, channels));
+    ASSERT_EQ(channels, 3);
+    std::vector<unsigned char> decoded(20 * 10 * 3);
+    ASSERT_TRUE(detail::qoi_decode(encoded.data(), encoded.size(), MutableImageView(decoded.data(), 20, 10, 3)));
+    for (size_t i = 0; i < gray.size(); i++) {
+        ASSERT_EQ(decoded[i * 3], gray[i]);
+        ASSERT_EQ(decoded[i * 3 + 2], gray[i]);
+    }
+}
+
+TEST(QoiTest, StridedViewMatchesPacked) {
+    std::vector<unsigned char> pixels = test_pattern(16, 12, 4);
+    std::vector<unsigned char> wide(24 * 12 * 4, 0);
+    for (int y = 0; y < 12; y++) {
+        std::memcpy(&wide[y * 24 * 4], &pixels[y * 16 * 4], 16 * 4);
+    }
+    ImageView strided(wide.data(), 16, 12, 4, 24 * 4);
+    EXPECT_EQ(encode(strided), encode(ImageView(pixels.data(), 16, 12, 4)));
+}
+
+TEST(QoiTest, RejectsTruncatedAndCorruptStreams) {
+    std::vector<unsigned char> pixels = test_pattern(32, 32, 3);
+    std::vector<unsigned char> encoded = encode(ImageView(pixels.data(), 32, 32, 3));
+    std::vector<unsigned char> decoded(pixels.size());
+    MutableImageView dst(decoded.data(), 32, 32, 3);
+
+    EXPECT_FALSE(detail::qoi_decode(encoded.data(), encoded.size() / 2, dst));
+    EXPECT_FALSE(detail::qoi_decode(encoded.data(), 10, dst));
+
+    std::vector<unsigned char> bad_channels = encoded;
+    bad_channels[12] = 5;
+    EXPECT_FALSE(detail::qoi_decode(bad_channels.data(), bad_channels.size(), dst));
+
+    // Mismatched destination
+    EXPECT_FALSE(detail::qoi_decode(encoded.data(), encoded.size(), MutableImageView(decoded.data(), 31, 32, 3)));
+}
+
+TEST(QoiTest, LoadsPaddedThroughLoadedImage) {
+    std::vector<unsigned char> pixels = test_pattern(10, 8, 4);
+    std::vector<std::byte> encoded = encode_to_memory(ImageView(pixels.data(), 10, 8, 4), ImageFormat::QOI);
+    ASSERT_FALSE(encoded.empty());
+
+    int width, height, channels;
+    LoadedImage img = LoadedImage::load_padded_from_memory(
+        reinterpret_cast<const unsigned char*>(encoded.data()), encoded.size(), Padding{2, 3, 1, 4},
+        width, height, channels);
+    ASSERT_NE(img.get(), nullptr);
+    EXPECT_EQ(width, 14);
+    EXPECT_EQ(height, 14);
+    EXPECT_EQ(channels, 4);
+    for (int y = 0; y < 8; y++) {
+        EXPECT_EQ(std::memcmp(img.view().row(y + 2) + 3 * 4, &pixels[y * 10 * 4], 10 * 4), 0);
+    }
+
+    LoadedImage plain = decode_from_memory(encoded);
+    ASSERT_NE(plain.get(), nullptr);
+    EXPECT_EQ(std::memcmp(plain.get(), pixels.data(), pixels.size()), 0);
+}
+
+TEST(QoiTest, WritesAndProbesQoiFiles) {
+    const char* path = "/tmp/test_vanity_image.qoi";
+    EXPECT_EQ(detect_format(path), ImageFormat::QOI);
+    EXPECT_EQ(detect_format("IMAGE.QOI"), ImageFormat::QOI);
+
+    std::vector<unsigned char> pixels = test_pattern(9, 7, 3);
+    ASSERT_TRUE(write_image(path, 9, 7, 3, pixels.data()));
+
+    ImageInfo info;
+    ASSERT_TRUE(probe_image(path, info));
+    EXPECT_EQ(info.width, 9);
+    EXPECT_EQ(info.height, 7);
+    EXPECT_EQ(info.channels, 3);
+    EXPECT_EQ(info.bits_per_channel, 8);
+
+    int width, height, channels;
+    LoadedImage img = LoadedImage::load(path, width, height, channels);
+    std::remove(path);
+    ASSERT_NE(img.get(), nullptr);
+    EXPECT_EQ(std::memcmp(img.get(), pixels.data(), pixels.size()), 0);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "vanity/thread_pool.hpp"
+#include <atomic>
+#include <vector>
+
+using namespace vanity;
+
+TEST(ThreadPoolTest, DefaultSizeIsAtLeastOne) {
+    ThreadPool pool;
+    EXPECT_GE(pool.size(), 1u);
+}
+
+TEST(ThreadPoolTest, DestructorRunsQueuedTasks) {
+    std::atomic<int> ran{0};
+    {
+        ThreadPool pool(2);
+        for (int i = 0; i < 100; i++) {
+            pool.submit([&ran] { ran++; });
+        }
+    }
+    EXPECT_EQ(ran.load(), 100);
+}
+
+TEST(ThreadPoolTest, ParallelForCoversEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(1003);
+    pool.parallel_for(hits.size(), 10, [&](size_t begin, size_t end) {
+        EXPECT_LE(end - begin, 10u);
+        for (size_t i = begin; i < end; i++) {
+            hits[i]++;
+        }
+    });
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTest, ParallelForHandlesEmptyAndSingleChunk) {
+    ThreadPool pool(2);
+    int calls = 0;
+    pool.parallel_for(0, 8, [&](size_t, size_t) { calls++; });
+    EXPECT_EQ(calls, 0);
+    pool.parallel_for(5, 8, [&](size_t begin, size_t end) {
+        calls++;
+        EXPECT_EQ(begin, 0u);
+        EXPECT_EQ(end, 5u);
+    });
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(ThreadPoolTest, NestedParallelForDoesNotDeadlock) {
+    ThreadPool pool(2);
+    std::atomic<int> total{0};
+    pool.parallel_for(8, 1, [&](size_t, size_t) {
+        pool.parallel_for(16, 2, [&](size_t begin, size_t end) {
+            total += static_cast<int>(end - begin);
+        });
+    });
+    EXPECT_EQ(total.load(), 8 * 16);
+}
+
+TEST(ThreadPoolTest, IdleWorkersStealTasksQueuedByABusyWorker) {
+    ThreadPool pool(3);
+    std::atomic<int> ran{0};
+    std::atomic<bool> finished{false};
+
+    // The producer queues tasks on its own deque and then blocks until they
+    // have all run, which only happens if other workers steal them
+    pool.submit([&] {
+        for (int i = 0; i < 50; i++) {
+            pool.submit([&ran] { ran++; });
+        }
+        while (ran.load() < 50) {
+            std::this_thread::yield();
+        }
+        finished = true;
+    });
+
+    while (!finished.load()) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(ran.load(), 50);
+}